@@ -0,0 +1 @@
+# CROPGRO Benchmarks Package
\ No newline at end of file
@@ -0,0 +1,615 @@
+#!/usr/bin/env python3
+"""
+CROPGRO Benchmark Suite
+Pinned micro- and macro-benchmarks with regression checks against a stored baseline.
+
+Micro-benchmarks drive each sub-model's daily_update with the same kind of
+inputs the simulator passes it (generated from a fixed seed); macro-benchmarks
+run a full 120-day NFT lettuce simulation and a 1000-scenario batch. Every
+case runs in a fresh child process so its peak RSS is its own.
+
+Usage (from the repository root):
+    python -m benchmarks.run_benchmarks                    # run and compare
+    python -m benchmarks.run_benchmarks --save-baseline    # record a new baseline
+    python -m benchmarks.run_benchmarks --only micro --repeats 5
+
+The exit status is 1 when any case is slower (steps/sec) or larger (peak
+RSS) than the baseline by more than the given thresholds.
+"""
+
+import sys
+import json
+import time
+import platform
+import argparse
+import resource
+import multiprocessing
+from pathlib import Path
+from typing import Any, Callable, Dict, List, Optional, Tuple
+
+import numpy as np
+
+REPO_ROOT = Path(__file__).resolve().parent.parent
+if str(REPO_ROOT) not in sys.path:
+    sys.path.insert(0, str(REPO_ROOT))
+
+DEFAULT_BASELINE = Path(__file__).resolve().parent / 'baseline.json'
+BENCHMARK_SEED = 20240101
+
+STRESS_KEYS = ('temperature', 'water', 'light', 'nitrogen', 'salinity', 'ph', 'oxygen')
+ORGANS = ('leaves', 'stems', 'roots')
+
+
+# =========================
+# Pinned daily inputs
+# =========================
+
+def _daily_stress_levels(rng: np.random.RandomState) -> Dict[str, float]:
+    return {key: float(rng.uniform(0.0, 0.3)) for key in STRESS_KEYS}
+
+
+def _daily_growth_rates(rng: np.random.RandomState, day: int) -> Dict[str, float]:
+    total = 0.05 + 0.02 * day * rng.uniform(0.8, 1.2)
+    return {'leaves': 0.6 * total, 'stems': 0.2 * total, 'roots': 0.2 * total}
+
+
+# =========================
+# Micro-benchmarks (sub-model daily_update)
+# =========================
+# Each builder returns a step(day) callable; model construction is not timed.
+
+def _build_canopy(light_integration: str = "layered") -> Callable[[int], Any]:
+    from src.models.canopy_architecture import create_lettuce_canopy_model, LightEnvironment
+    model = create_lettuce_canopy_model()
+    model.params.light_integration = light_integration
+    rng = np.random.RandomState(BENCHMARK_SEED)
+
+    def step(day: int):
+        light = LightEnvironment(
+            ppfd_above_canopy=float(rng.uniform(300.0, 700.0)),
+            direct_beam_fraction=0.6,
+            diffuse_fraction=0.4,
+            solar_zenith_angle=30.0 + 20.0 * np.sin(day * 2 * np.pi / 365)
+        )
+        lai = min(6.0, 0.05 + 0.05 * (day % 120))
+        return model.daily_update(total_lai=lai, canopy_height=min(0.25, 0.045 + 0.002 * (day % 120)),
+                                  light_env=light, air_temperature=float(rng.uniform(18.0, 26.0)),
+                                  co2_concentration=800.0)
+    return step
+
+
+def _build_senescence() -> Callable[[int], Any]:
+    from src.models.senescence_model import create_lettuce_senescence_model
+    model = create_lettuce_senescence_model()
+    rng = np.random.RandomState(BENCHMARK_SEED)
+
+    def step(day: int):
+        age = day % 120
+        cohorts = {
+            i: {
+                'age_gdd': age * 12.0,
+                'area': (1.0 + age) * 0.18,
+                'biomass': 1.0 + age * (0.6 - 0.2 * i),
+                'canopy_position': 0.8 if organ == 'leaves' else 0.5,
+                'nutrient_content': {'nitrogen': 0.04, 'phosphorus': 0.010, 'potassium': 0.028}
+            }
+            for i, organ in enumerate(ORGANS)
+        }
+        stress = _daily_stress_levels(rng)
+        return model.daily_update(
+            cohorts,
+            {key: stress[key] for key in ('water', 'nitrogen', 'temperature', 'light')},
+            {'is_reproductive': age > 100}
+        )
+    return step
+
+
+def _build_nitrogen() -> Callable[[int], Any]:
+    from src.models.nitrogen_balance import create_lettuce_nitrogen_balance_model
+    model = create_lettuce_nitrogen_balance_model()
+    rng = np.random.RandomState(BENCHMARK_SEED)
+
+    def step(day: int):
+        return model.update_nitrogen_pools(
+            external_nitrogen_input=float(rng.uniform(0.005, 0.05)),
+            organ_growth_rates=_daily_growth_rates(rng, day % 120),
+            environmental_factors={'temperature_factor': 0.95, 'water_status': 0.97, 'ph_factor': 1.0},
+            growth_stage='vegetative',
+            stress_factors=_daily_stress_levels(rng),
+            senescence_rates={'leaves': 0.002, 'stems': 0.001, 'roots': 0.0005}
+        )
+    return step
+
+
+def _build_mobility() -> Callable[[int], Any]:
+    from src.models.nutrient_models import create_lettuce_nutrient_mobility_model
+    model = create_lettuce_nutrient_mobility_model()
+    rng = np.random.RandomState(BENCHMARK_SEED)
+
+    def step(day: int):
+        growth = _daily_growth_rates(rng, day % 120)
+        demands = {
+            organ: {'nitrogen': rate * 0.045, 'phosphorus': rate * 0.008, 'potassium': rate * 0.035,
+                    'calcium': rate * 0.015, 'magnesium': rate * 0.006}
+            for organ, rate in growth.items()
+        }
+        return model.daily_update(
+            organ_demands=demands,
+            stress_factors=_daily_stress_levels(rng),
+            senescence_rates={'leaves': 0.002, 'stems': 0.001, 'roots': 0.0005},
+            growth_stage='vegetative',
+            water_fluxes={'leaves': 0.25, 'stems': 0.15, 'roots': 0.35},
+            assimilate_fluxes={'leaves': 0.12, 'stems': 0.08, 'roots': 0.05},
+            temperature=float(rng.uniform(18.0, 26.0))
+        )
+    return step
+
+
+def _build_root_architecture() -> Callable[[int], Any]:
+    from src.models.root_system_model import create_enhanced_root_uptake_model, HydroponicSystemType
+    model = create_enhanced_root_uptake_model(HydroponicSystemType.NFT, 500.0)
+    model.root_architecture.seed(BENCHMARK_SEED)
+    rng = np.random.RandomState(BENCHMARK_SEED)
+
+    def step(day: int):
+        solution = {'N-NO3': 180.0, 'P-PO4': 45.0, 'K': 280.0, 'Ca': 140.0, 'Mg': 45.0}
+        environment = {'temperature': float(rng.uniform(18.0, 24.0)), 'flow_rate': 1.5,
+                       'oxygen_level': 8.0, 'ph': 6.0, 'nutrient_concentrations': solution}
+        growth_factors = {'nitrogen_stress': 0.95, 'water_stress': 0.97, 'temperature_stress': 0.95}
+        uptake_conc = {'NO3': 180.0, 'PO4': 45.0, 'K': 280.0, 'Ca': 140.0, 'Mg': 45.0}
+        return model.daily_update(environment, growth_factors, uptake_conc)
+    return step
+
+
+def _build_integrated_stress() -> Callable[[int], Any]:
+    from src.models.stress_models import create_lettuce_integrated_stress_model
+    model = create_lettuce_integrated_stress_model()
+    rng = np.random.RandomState(BENCHMARK_SEED)
+
+    def step(day: int):
+        return model.daily_update(current_stress_levels=_daily_stress_levels(rng))
+    return step
+
+
+def _build_integrated_stress_batch() -> Callable[[int], Any]:
+    from src.models.stress_models import create_lettuce_integrated_stress_model
+    kernel = create_lettuce_integrated_stress_model().kernel
+    memory = kernel.initial_memory(256)
+    rng = np.random.RandomState(BENCHMARK_SEED)
+
+    def step(day: int):
+        # One batched day of 256 plants on the compiled kernel
+        kernel.update(memory, rng.uniform(0.0, 1.0, (256, len(kernel.stress_types))))
+        return kernel.evaluate(memory).overall_stress_factor
+    return step
+
+
+def _build_temperature_stress() -> Callable[[int], Any]:
+    from src.models.stress_models import create_lettuce_temperature_stress_model
+    model = create_lettuce_temperature_stress_model()
+    rng = np.random.RandomState(BENCHMARK_SEED)
+
+    def step(day: int):
+        return model.daily_update(temperature=float(rng.uniform(12.0, 32.0)))
+    return step
+
+
+def _build_leaf_cohorts() -> Callable[[int], Any]:
+    from src.models.leaf_development import LeafDevelopmentModel
+    from src.models.senescence_model import create_lettuce_senescence_model
+    leaf_model = LeafDevelopmentModel()
+    senescence_model = create_lettuce_senescence_model()
+    rng = np.random.RandomState(BENCHMARK_SEED)
+
+    def step(day: int):
+        stress = _daily_stress_levels(rng)
+        temperature = float(rng.uniform(18.0, 26.0))
+        response = senescence_model.update_table(
+            leaf_model.cohorts,
+            {key: stress[key] for key in ('water', 'nitrogen', 'temperature', 'light')},
+            {'is_reproductive': False}
+        )
+        daily_tt = leaf_model.calculate_thermal_time(temperature)
+        factors = leaf_model.calculate_stress_factors(stress['water'], stress['nitrogen'], stress['temperature'])
+        leaf_model.update_v_stage(daily_tt, factors)
+        leaf_model.update_leaf_areas(daily_tt, factors)
+        return response
+    return step
+
+
+def _build_temperature_responses(use_tables: bool = False) -> Callable[[int], Any]:
+    from src.models.photosynthesis_model import PhotosynthesisModel
+    from src.models.respiration_model import create_lettuce_respiration_model
+    from src.models.phenology_model import create_lettuce_phenology_model
+    from src.models.leaf_development import LeafDevelopmentModel
+    from src.models.stress_models import create_lettuce_temperature_stress_model
+    from src.models.root_zone_temperature import RootZoneTemperatureModel
+    photosynthesis = PhotosynthesisModel()
+    respiration = create_lettuce_respiration_model()
+    phenology = create_lettuce_phenology_model()
+    leaf_model = LeafDevelopmentModel()
+    temperature_stress = create_lettuce_temperature_stress_model()
+    rzt_model = RootZoneTemperatureModel()
+    if use_tables:
+        for model in (photosynthesis, respiration, phenology, leaf_model, temperature_stress, rzt_model):
+            model.use_response_tables()
+    rng = np.random.RandomState(BENCHMARK_SEED)
+
+    def step(day: int):
+        temperature = float(rng.uniform(12.0, 32.0))
+        rzt = temperature + float(rng.uniform(-4.0, 6.0))
+        return (photosynthesis.calculate_daily_assimilation(400.0, 800.0, temperature, 2.0),
+                respiration.calculate_temperature_factor(temperature),
+                phenology.calculate_thermal_time(temperature),
+                leaf_model.calculate_thermal_time(temperature),
+                temperature_stress.calculate_base_stress_level(temperature),
+                rzt_model.calculate_rzt_growth_factor(rzt, temperature),
+                rzt_model.calculate_nutrient_uptake_factor(rzt, temperature))
+    return step
+
+
+def _build_cultivar_screening() -> Callable[[int], Any]:
+    from src.models.genetic_parameters import create_lettuce_genetic_system, GeneticTrait
+    from src.models.cultivar_matrix import CultivarTraitMatrix
+    _, ge_model, _ = create_lettuce_genetic_system()
+    rng = np.random.RandomState(BENCHMARK_SEED)
+    n_cultivars = 5000
+    catalog = CultivarTraitMatrix.from_columns(
+        [f"C{i:05d}" for i in range(n_cultivars)],
+        {trait.value: rng.uniform(0.2, 1.0, n_cultivars) for trait in GeneticTrait}
+    )
+
+    def step(day: int):
+        environments = [_daily_stress_levels(rng) for _ in range(20)]
+        return ge_model.screen_cultivars(environments, top_n=10, metric='yield_index', matrix=catalog)
+    return step
+
+
+def _build_simulator_reset() -> Callable[[int], Any]:
+    from src.cropgro_hydroponic_simulator import CROPGROHydroponicSimulator
+    simulator = CROPGROHydroponicSimulator.from_prototype('HYDRO_001', 'NFT')
+
+    def step(day: int):
+        return simulator.reset()
+    return step
+
+
+def _build_digital_twin() -> Callable[[int], Any]:
+    from src.digital_twin import DigitalTwinPool, SensorObservation
+    pool = DigitalTwinPool()
+    twin = pool.register('RACK01', start_time=0.0)
+    rng = np.random.RandomState(BENCHMARK_SEED)
+    ticks_per_day = 144  # 10-minute sensor interval
+
+    def step(day: int):
+        # One day of ticks; the first tick of the next day runs the daily step
+        base = twin.day * 86400.0
+        for tick in range(ticks_per_day):
+            lit = tick < 96
+            pool.advance(SensorObservation(
+                'RACK01', base + tick * 600.0,
+                ph=6.0, ec=1.8, temperature=float(rng.uniform(18.0, 26.0)), humidity=65.0,
+                co2=800.0 if lit else 420.0, par=300.0 if lit else 0.0
+            ))
+        return twin.last_result
+    return step
+
+
+def _build_uptake_kernel() -> Callable[[int], Any]:
+    from src.models.root_system_model import create_enhanced_root_uptake_model, HydroponicSystemType
+    model = create_enhanced_root_uptake_model(HydroponicSystemType.NFT, 500.0)
+    model.root_architecture.seed(BENCHMARK_SEED)
+    rng = np.random.RandomState(BENCHMARK_SEED)
+    n_positions = 2000
+    length = rng.uniform(50.0, 400.0, (n_positions, 3))
+    architecture = {
+        'total_root_surface_area': length.sum(axis=1) * 0.05,
+        'average_root_activity': rng.uniform(0.6, 1.0, n_positions),
+        'fine_root_length': length[:, 0],
+        'medium_root_length': length[:, 1],
+        'coarse_root_length': length[:, 2],
+    }
+
+    def step(day: int):
+        # Every ion at every plant position of a room in one call
+        solution = {ion: rng.uniform(20.0, 250.0, n_positions) for ion in ('NO3', 'PO4', 'K', 'Ca', 'Mg')}
+        environment = {'temperature': rng.uniform(18.0, 24.0, n_positions), 'flow_rate': 1.5}
+        return model.calculate_nutrient_uptake(architecture, environment, solution)
+    return step
+
+
+def _build_ensemble_step(backend: str = 'numpy') -> Callable[[int], Any]:
+    from src.ensemble_engine import EnsembleMember, create_lettuce_ensemble_simulator
+    from src.data.hydroponic_system import DefaultConfigurations, HydroInputData
+    from src.utils.weather_generator import WeatherGenerator
+    from datetime import datetime
+    horizon = 60
+    weather = WeatherGenerator().generate_weather_series(datetime(2024, 1, 1), horizon)
+    input_data = HydroInputData(
+        system_config=DefaultConfigurations.get_nft_lettuce_system(),
+        crop_params=DefaultConfigurations.get_lettuce_parameters(),
+        weather_data=weather,
+        nutrient_params=DefaultConfigurations.get_default_nutrients(),
+        simulation_days=horizon
+    )
+    members = [EnsembleMember(input_data) for _ in range(256)]
+    ensemble = create_lettuce_ensemble_simulator(backend=backend)
+    target_table = ensemble._target_table("harvest")
+    state = {}
+
+    def step(day: int):
+        # One lock-step day of 256 members; state stays on the backend
+        sim_day = day % horizon + 1
+        if sim_day == 1 or 'st' not in state:
+            state['st'] = ensemble._initialize_state(members, horizon)
+        record = ensemble._step(state['st'], sim_day)
+        ensemble._close_day(state['st'], sim_day, target_table)
+        ensemble.backend.synchronize()
+        return record
+    return step
+
+
+def _build_emulator_query() -> Callable[[int], Any]:
+    from src.emulator import EmulatorDataset, EmulatorDesign, EmulatorService
+    # Served-model latency only: train on synthetic outputs instead of simulator runs
+    design = EmulatorDesign(cultivars=('HYDRO_001', 'HYDRO_002'))
+    queries = design.sample(200, BENCHMARK_SEED)
+    features = design.encode(queries)
+    outputs = np.stack([features[:, :3].sum(axis=1), features[:, 3], features[:, 0] ** 2], axis=1)
+    dataset = EmulatorDataset(queries, outputs, np.ones(len(queries), dtype=bool))
+    service = EmulatorService.train(design, dataset, model_options={'epochs': 200})
+    rng = np.random.RandomState(BENCHMARK_SEED)
+
+    def step(day: int):
+        # One dashboard query inside the training envelope
+        return service.predict({'ec': rng.uniform(1.2, 2.2), 'rzt': rng.uniform(18.0, 26.0),
+                                'photoperiod': rng.uniform(13.0, 19.0), 'cultivar_id': 'HYDRO_002'})
+    return step
+
+
+def _build_server_cached_request() -> Callable[[int], Any]:
+    from src.simulation_server import SimulationService, SimulatorPool, normalize_request, request_key
+    # Cache path of the server (normalize, hash, lookup); the batcher is not started
+    service = SimulationService(SimulatorPool(), cache_size=64)
+    payloads = [{'cultivar': 'HYDRO_001', 'days': 60, 'weather_seed': seed} for seed in range(32)]
+    for payload in payloads:
+        scenario, engine = normalize_request(payload)
+        service.cache.put(request_key(scenario, engine, service.pool.config_hash),
+                          {'key': '', 'label': scenario.label, 'engine': 'simulator', 'outputs': {},
+                           'maturity_reached': True, 'summary_stats': {}, 'metadata': {}})
+
+    def step(day: int):
+        return service.simulate(payloads[day % len(payloads)])
+    return step
+
+
+MICRO_BENCHMARKS: Dict[str, Callable[[], Callable[[int], Any]]] = {
+    'micro.canopy_architecture': _build_canopy,
+    'micro.canopy_analytic': lambda: _build_canopy("analytic"),
+    'micro.senescence': _build_senescence,
+    'micro.leaf_cohorts': _build_leaf_cohorts,
+    'micro.nitrogen_balance': _build_nitrogen,
+    'micro.nutrient_mobility': _build_mobility,
+    'micro.root_architecture': _build_root_architecture,
+    'micro.integrated_stress': _build_integrated_stress,
+    'micro.integrated_stress_batch': _build_integrated_stress_batch,
+    'micro.temperature_stress': _build_temperature_stress,
+    'micro.temperature_responses': _build_temperature_responses,
+    'micro.response_tables': lambda: _build_temperature_responses(use_tables=True),
+    'micro.cultivar_screening': _build_cultivar_screening,
+    'micro.simulator_reset': _build_simulator_reset,
+    'micro.digital_twin': _build_digital_twin,
+    'micro.uptake_kernel': _build_uptake_kernel,
+    'micro.ensemble_step': _build_ensemble_step,
+    'micro.emulator_query': _build_emulator_query,
+    'micro.server_cached_request': _build_server_cached_request,
+}
+
+
+def run_micro(name: str, steps: int) -> Tuple[int, float]:
+    """Time `steps` daily updates of one sub-model; returns (steps, seconds)."""
+    step = MICRO_BENCHMARKS[name]()
+    step(0)  # Warm-up (lazy tables, first-call allocations)
+    start = time.perf_counter()
+    for day in range(1, steps + 1):
+        step(day)
+    return steps, time.perf_counter() - start
+
+
+# =========================
+# Macro-benchmarks
+# =========================
+
+def run_full_season(days: int = 120) -> Tuple[int, float]:
+    """One pinned NFT lettuce season; steps are simulated days."""
+    from src.batch_runner import ScenarioSpec, run_scenario
+    scenario = ScenarioSpec(cultivar_id='HYDRO_001', system_type='NFT',
+                            weather_seed=BENCHMARK_SEED, max_days=days)
+    start = time.perf_counter()
+    result = run_scenario(scenario)
+    elapsed = time.perf_counter() - start
+    if not result.ok:
+        raise RuntimeError(result.error)
+    return int(result.summary_stats.get('total_days', days)), elapsed
+
+
+def run_scenario_batch(n_scenarios: int = 1000, days: int = 30,
+                       workers: Optional[int] = None) -> Tuple[int, float]:
+    """Pinned scenario batch on the worker pool; steps are simulated days over all scenarios."""
+    from src.batch_runner import build_scenario_matrix, run_batch
+    cultivars = ('HYDRO_001', 'BUTT_001')
+    systems = ('NFT', 'DWC')
+    seeds_needed = -(-n_scenarios // (len(cultivars) * len(systems)))
+    scenarios = build_scenario_matrix(
+        cultivars=cultivars, systems=systems,
+        weather_seeds=[BENCHMARK_SEED + i for i in range(seeds_needed)],
+        day_limits=[days]
+    )[:n_scenarios]
+
+    start = time.perf_counter()
+    total_days = 0
+    failures = []
+    for result in run_batch(scenarios, max_workers=workers):
+        if result.ok:
+            total_days += int(result.summary_stats.get('total_days', 0))
+        else:
+            failures.append(result.error)
+    elapsed = time.perf_counter() - start
+    if failures:
+        raise RuntimeError(f"{len(failures)} scenarios failed, first: {failures[0]}")
+    return total_days, elapsed
+
+
+# =========================
+# Harness
+# =========================
+
+def _peak_rss_mb() -> float:
+    """Peak RSS of this process and its finished children (MB)."""
+    scale = 1.0 / (1024 * 1024) if sys.platform == 'darwin' else 1.0 / 1024  # bytes on macOS, KB on Linux
+    own = resource.getrusage(resource.RUSAGE_SELF).ru_maxrss
+    children = resource.getrusage(resource.RUSAGE_CHILDREN).ru_maxrss
+    return max(own, children) * scale
+
+
+def _case_worker(case: str, options: Dict[str, Any], queue):
+    import logging
+    logging.disable(logging.WARNING)
+    try:
+        if case.startswith('micro.'):
+            steps, seconds = run_micro(case, options['micro_steps'])
+        elif case == 'macro.full_season_nft_120d':
+            steps, seconds = run_full_season(120)
+        elif case == 'macro.batch_1000_scenarios':
+            steps, seconds = run_scenario_batch(options['batch_scenarios'], options['batch_days'],
+                                                options['workers'])
+        else:
+            raise KeyError(case)
+        queue.put({'steps': steps, 'seconds': seconds, 'peak_rss_mb': _peak_rss_mb()})
+    except Exception as e:
+        queue.put({'error': f"{type(e).__name__}: {e}"})
+
+
+def run_case(case: str, options: Dict[str, Any]) -> Dict[str, Any]:
+    """Run one case in a fresh process; best of `repeats` by throughput."""
+    context = multiprocessing.get_context()
+    best: Optional[Dict[str, Any]] = None
+    repeats = 1 if case.startswith('macro.batch') else options['repeats']
+    for _ in range(repeats):
+        queue = context.Queue()
+        process = context.Process(target=_case_worker, args=(case, options, queue))
+        process.start()
+        outcome = queue.get()
+        process.join()
+        if 'error' in outcome:
+            return outcome
+        outcome['steps_per_sec'] = outcome['steps'] / outcome['seconds'] if outcome['seconds'] > 0 else 0.0
+        if best is None or outcome['steps_per_sec'] > best['steps_per_sec']:
+            best = outcome
+        best['peak_rss_mb'] = max(best['peak_rss_mb'], outcome['peak_rss_mb'])
+    return best
+
+
+def compare_to_baseline(results: Dict[str, Dict[str, Any]], baseline: Dict[str, Any],
+                        speed_threshold: float, rss_threshold: float) -> List[str]:
+    """Regressions relative to the baseline cases."""
+    regressions = []
+    for case, result in results.items():
+        reference = baseline.get('cases', {}).get(case)
+        if reference is None or 'error' in result:
+            continue
+        if result['steps_per_sec'] < reference['steps_per_sec'] * (1.0 - speed_threshold):
+            regressions.append(
+                f"{case}: {result['steps_per_sec']:.1f} steps/s vs baseline {reference['steps_per_sec']:.1f}")
+        if result['peak_rss_mb'] > reference['peak_rss_mb'] * (1.0 + rss_threshold):
+            regressions.append(
+                f"{case}: peak RSS {result['peak_rss_mb']:.1f} MB vs baseline {reference['peak_rss_mb']:.1f} MB")
+    return regressions
+
+
+def main(argv: Optional[List[str]] = None) -> int:
+    parser = argparse.ArgumentParser(description="CROPGRO benchmark suite")
+    parser.add_argument('--only', choices=['micro', 'macro'], help='Run only one group')
+    parser.add_argument('--cases', type=str, help='Comma-separated case names')
+    parser.add_argument('--micro-steps', type=int, default=1000, help='Daily updates per micro-benchmark')
+    parser.add_argument('--repeats', type=int, default=3, help='Repeats per case (best throughput kept)')
+    parser.add_argument('--batch-scenarios', type=int, default=1000, help='Scenarios in the batch benchmark')
+    parser.add_argument('--batch-days', type=int, default=30, help='Simulated days per batch scenario')
+    parser.add_argument('--workers', type=int, default=None, help='Batch worker processes (default: core count)')
+    parser.add_argument('--baseline', type=str, default=str(DEFAULT_BASELINE), help='Baseline JSON path')
+    parser.add_argument('--save-baseline', action='store_true', help='Write results as the new baseline')
+    parser.add_argument('--speed-threshold', type=float, default=0.15,
+                        help='Allowed steps/sec drop before failing (fraction)')
+    parser.add_argument('--rss-threshold', type=float, default=0.20,
+                        help='Allowed peak RSS growth before failing (fraction)')
+    parser.add_argument('--output-json', type=str, help='Write this run\'s results to a JSON file')
+    args = parser.parse_args(argv)
+
+    cases = list(MICRO_BENCHMARKS) + ['macro.full_season_nft_120d', 'macro.batch_1000_scenarios']
+    if args.only:
+        cases = [case for case in cases if case.startswith(args.only + '.')]
+    if args.cases:
+        wanted = {case.strip() for case in args.cases.split(',')}
+        cases = [case for case in cases if case in wanted]
+
+    options = {
+        'micro_steps': args.micro_steps,
+        'repeats': max(1, args.repeats),
+        'batch_scenarios': args.batch_scenarios,
+        'batch_days': args.batch_days,
+        'workers': args.workers,
+    }
+
+    print("CROPGRO Benchmark Suite")
+    print("=" * 80)
+    print(f"{'Case':<36} {'Steps':>8} {'Seconds':>9} {'Steps/s':>11} {'Peak RSS (MB)':>14}")
+    print("-" * 80)
+    results: Dict[str, Dict[str, Any]] = {}
+    for case in cases:
+        result = run_case(case, options)
+        results[case] = result
+        if 'error' in result:
+            print(f"{case:<36} FAILED: {result['error']}")
+        else:
+            print(f"{case:<36} {result['steps']:>8} {result['seconds']:>9.3f} "
+                  f"{result['steps_per_sec']:>11.1f} {result['peak_rss_mb']:>14.1f}")
+
+    report = {
+        'created': time.strftime('%Y-%m-%dT%H:%M:%S'),
+        'machine': {'platform': platform.platform(), 'python': platform.python_version(),
+                    'processor': platform.processor(), 'cpu_count': multiprocessing.cpu_count()},
+        'options': options,
+        'cases': results
+    }
+    if args.output_json:
+        Path(args.output_json).write_text(json.dumps(report, indent=2))
+
+    failed = any('error' in result for result in results.values())
+    baseline_path = Path(args.baseline)
+    if args.save_baseline:
+        if failed:
+            print("\nNot saving baseline: some cases failed")
+            return 1
+        baseline_path.write_text(json.dumps(report, indent=2))
+        print(f"\nSaved baseline: {baseline_path}")
+        return 0
+
+    if not baseline_path.exists():
+        print(f"\nNo baseline at {baseline_path}; run with --save-baseline to record one")
+        return 1 if failed else 0
+
+    baseline = json.loads(baseline_path.read_text())
+    if baseline.get('machine', {}).get('platform') != report['machine']['platform']:
+        print(f"\nNote: baseline recorded on {baseline.get('machine', {}).get('platform')}")
+    regressions = compare_to_baseline(results, baseline, args.speed_threshold, args.rss_threshold)
+    if regressions:
+        print("\nRegressions:")
+        for line in regressions:
+            print(f"- {line}")
+        return 1
+    print("\nNo regressions against baseline")
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -7,14 +7,19 @@ Professional DSSAT-style crop modeling system
 import sys
 import json
 import argparse
+from dataclasses import replace
 from pathlib import Path
 from datetime import datetime
 from typing import Any, Dict
 
 # Import CROPGRO system
 from src.cropgro_hydroponic_simulator import CROPGROHydroponicSimulator
+from src.data.checkpoint import SimulationCheckpoint
 from src.data.hydroponic_system import DefaultConfigurations, HydroInputData
+from src.data.streaming_output import StreamingResultsWriter
+from src.data.weather_source import MemmapWeatherSource
 from src.utils.weather_generator import WeatherGenerator
+from src.batch_runner import ScenarioSpec, build_scenario_matrix, run_batch
 
 
 def to_serializable(value: Any) -> Any:
@@ -41,7 +46,11 @@ def daily_result_to_dict(dr: Any) -> Dict[str, Any]:
     return data
 
 
-def run_simulation(days: int, cultivar_id: str, system_type: str, print_daily: bool) -> Any:
+def run_simulation(days: int, cultivar_id: str, system_type: str, print_daily: bool,
+                   timestep: str = 'daily', light_shape: str = 'sine',
+                   output_writer: Any = None, profile: bool = False,
+                   weather_file: str = None, resume: str = None,
+                   save_checkpoint: str = None, diagnostics: str = None) -> Any:
     print("🌱 CROPGRO Hydroponic Simulator - CLI Version")
     print("=" * 50)
 
@@ -54,13 +63,17 @@ def run_simulation(days: int, cultivar_id: str, system_type: str, print_daily: b
     crop_params = DefaultConfigurations.get_lettuce_parameters()
     nutrient_params = DefaultConfigurations.get_default_nutrients()
 
-    # Generate weather data
-    generator = WeatherGenerator()
-    start_date = datetime.now()
-    weather_list = generator.generate_weather_series(
-        start_date=start_date,
-        days=days
-    )
+    # Measured weather from a memory-mapped file, or generated weather
+    if weather_file:
+        weather_list = MemmapWeatherSource(weather_file)
+        print(f"Weather: {weather_list.site} ({len(weather_list)} days from {weather_list.start_date:%Y-%m-%d})")
+    else:
+        generator = WeatherGenerator()
+        start_date = datetime.now()
+        weather_list = generator.generate_weather_series(
+            start_date=start_date,
+            days=days
+        )
 
     # Create input data
     input_data = HydroInputData(
@@ -80,8 +93,23 @@ def run_simulation(days: int, cultivar_id: str, system_type: str, print_daily: b
     print(f"Starting simulation until harvest maturity...")
     print(f"Cultivar: {simulator.cultivar_profile.cultivar_name}")
     print(f"System: {system_config.system_type}")
+    print(f"Timestep: {timestep}")
+
+    resume_from = SimulationCheckpoint.load(resume) if resume else None
+    if resume_from is not None:
+        print(f"Resuming from day {resume_from.day} ({resume})")
 
-    results = simulator.run_simulation(input_data, max_days=days, target_maturity='harvest')
+    results = simulator.run_simulation(input_data, max_days=days, target_maturity='harvest',
+                                       timestep=timestep, light_shape=light_shape,
+                                       output_writer=output_writer,
+                                       profile=True if profile else None,
+                                       diagnostics=diagnostics,
+                                       resume_from=resume_from)
+
+    if save_checkpoint:
+        checkpoint = simulator.checkpoint()
+        checkpoint.save(save_checkpoint)
+        print(f"Saved checkpoint at day {checkpoint.day}: {save_checkpoint} ({checkpoint.size_bytes / 1024:.1f} KiB)")
 
     if print_daily:
         for dr in results.daily_results:
@@ -91,23 +119,399 @@ def run_simulation(days: int, cultivar_id: str, system_type: str, print_daily: b
     print(f"Duration: {len(results.daily_results)} days")
     print(f"Final stage: {getattr(results.daily_results[-1], 'growth_stage', 'Unknown')}")
 
+    if 'profile' in getattr(results, 'metadata', {}):
+        print()
+        print(simulator.profiler.format_table(results.metadata['profile']))
+
     return results
 
 
+def _csv_list(value: str, cast=str):
+    return [cast(item.strip()) for item in value.split(',') if item.strip()]
+
+
+def batch_main(argv):
+    """`cropgro_cli.py batch ...`: run a scenario matrix on a worker pool."""
+    parser = argparse.ArgumentParser(prog="cropgro_cli.py batch",
+                                     description="Run a CROPGRO scenario matrix in parallel")
+    parser.add_argument('--cultivars', type=str, default='HYDRO_001', help='Comma-separated cultivar IDs')
+    parser.add_argument('--systems', type=str, default='NFT', help='Comma-separated system types (NFT,DWC,AEROPONICS)')
+    parser.add_argument('--seeds', type=str, default='0', help='Comma-separated weather seeds')
+    parser.add_argument('--days', type=str, default='120', help='Comma-separated day limits')
+    parser.add_argument('--timestep', type=str, default='daily', choices=['daily', 'hourly'], help='Integration timestep')
+    parser.add_argument('--workers', type=int, default=None, help='Worker processes (default: core count)')
+    parser.add_argument('--output-jsonl', type=str, help='Stream one JSON summary line per scenario to this file')
+    parser.add_argument('--weather-files', type=str,
+                        help='Comma-separated weather files (.cwx/.parquet), one per site; replaces --seeds')
+    args = parser.parse_args(argv)
+
+    scenarios = build_scenario_matrix(
+        cultivars=_csv_list(args.cultivars),
+        systems=_csv_list(args.systems),
+        weather_seeds=_csv_list(args.seeds, int),
+        day_limits=_csv_list(args.days, int),
+        timestep=args.timestep,
+        weather_files=_csv_list(args.weather_files) if args.weather_files else None
+    )
+    print(f"🌱 CROPGRO batch: {len(scenarios)} scenarios")
+    print("=" * 50)
+
+    out_file = None
+    if args.output_jsonl:
+        out_path = Path(args.output_jsonl)
+        out_path.parent.mkdir(parents=True, exist_ok=True)
+        out_file = open(out_path, 'w')
+
+    failures = 0
+    try:
+        for result in run_batch(scenarios, max_workers=args.workers):
+            if result.ok:
+                print(f"✅ {result.scenario.label}: {result.summary_stats.get('total_days', 0)} days, "
+                      f"{result.summary_stats.get('total_biomass_g', 0.0):.2f} g ({result.elapsed_seconds:.1f}s)")
+            else:
+                failures += 1
+                print(f"❌ {result.scenario.label}: {result.error}")
+            if out_file:
+                record = {
+                    'index': result.index,
+                    'scenario': vars(result.scenario),
+                    'summary_stats': {k: to_serializable(v) for k, v in result.summary_stats.items()},
+                    'elapsed_seconds': result.elapsed_seconds,
+                    'error': result.error
+                }
+                out_file.write(json.dumps(record) + "\n")
+                out_file.flush()
+    finally:
+        if out_file:
+            out_file.close()
+
+    print(f"\n🎯 Batch completed: {len(scenarios) - failures}/{len(scenarios)} scenarios succeeded")
+    return 1 if failures else 0
+
+
+def optimize_main(argv):
+    """`cropgro_cli.py optimize ...`: search the most profitable VPD/CO2/RZT setpoint schedule."""
+    from src.setpoint_optimizer import create_lettuce_setpoint_optimizer, default_phase_starts
+    parser = argparse.ArgumentParser(prog="cropgro_cli.py optimize",
+                                     description="Optimize daily VPD, CO2 and root zone temperature setpoints")
+    parser.add_argument('--cultivar', type=str, default='HYDRO_001', help='Cultivar ID')
+    parser.add_argument('--system', type=str, default='NFT', choices=['NFT', 'DWC', 'AEROPONICS'], help='Hydroponic system type')
+    parser.add_argument('--seed', type=int, default=0, help='Weather seed')
+    parser.add_argument('--days', type=int, default=60, help='Season length (max simulation days)')
+    parser.add_argument('--phases', type=int, default=3, help='Setpoint phases (equal lengths)')
+    parser.add_argument('--initial', type=int, default=None, help='Latin hypercube design size')
+    parser.add_argument('--generations', type=int, default=8, help='CMA-ES generations')
+    parser.add_argument('--workers', type=int, default=None, help='Worker processes (default: core count)')
+    parser.add_argument('--output-json', type=str, help='Write every evaluated schedule to this file')
+    args = parser.parse_args(argv)
+
+    scenario = ScenarioSpec(cultivar_id=args.cultivar, system_type=args.system,
+                            weather_seed=args.seed, max_days=args.days)
+    optimizer = create_lettuce_setpoint_optimizer(scenario, phase_starts=default_phase_starts(args.days, args.phases),
+                                                  max_workers=args.workers)
+    print(f"🌱 CROPGRO setpoint optimization: {scenario.label}, {optimizer.n_phases} phases")
+    print("=" * 50)
+    result = optimizer.optimize(n_initial=args.initial, generations=args.generations)
+
+    best = result.best
+    if not best.ok:
+        print(f"❌ No schedule could be simulated: {best.error}")
+        return 1
+    schedule = best.schedule
+    for i, start in enumerate(schedule.phase_starts):
+        print(f"  Phase {i + 1} (from day {start}): VPD {schedule.target_vpd[i]:.2f} kPa, "
+              f"CO2 {schedule.target_co2[i]:.0f} ppm, RZT {schedule.target_rzt[i]:.1f} °C")
+    print(f"\n🎯 {best.fresh_weight_g:.1f} g fresh weight/plant, value ${best.harvest_value:.2f}, "
+          f"setpoint cost ${best.setpoint_cost:.2f}")
+    print(f"   {len(result.evaluations)} schedules, {result.simulations} simulations "
+          f"({result.resumed_runs} resumed), {result.cache_hits} cache hits, {result.elapsed_seconds:.1f}s")
+
+    if args.output_json:
+        out_path = Path(args.output_json)
+        out_path.parent.mkdir(parents=True, exist_ok=True)
+        with open(out_path, 'w') as f:
+            json.dump({
+                'scenario': {k: v for k, v in vars(scenario).items() if k != 'setpoint_schedule'},
+                'history': result.history,
+                'evaluations': [{**vars(e.schedule), 'score': e.score, 'fresh_weight_g': e.fresh_weight_g,
+                                 'setpoint_cost': e.setpoint_cost, 'cost_breakdown': e.cost_breakdown,
+                                 'days': e.days, 'error': e.error}
+                                for e in result.evaluations]
+            }, f, indent=2, default=to_serializable)
+        print(f"Saved JSON: {out_path}")
+    return 0
+
+
+def spatial_main(argv):
+    """`cropgro_cli.py spatial ...`: simulate every plant position along the NFT channels."""
+    from src.spatial_nft import create_lettuce_spatial_nft_simulator
+    parser = argparse.ArgumentParser(prog="cropgro_cli.py spatial",
+                                     description="Plant-by-plant NFT channel simulation with solution gradients")
+    parser.add_argument('--cultivar', type=str, default='HYDRO_001', help='Cultivar ID')
+    parser.add_argument('--days', type=int, default=60, help='Max simulation days')
+    parser.add_argument('--plants', type=int, default=None, help='Plants in the room (default: system default)')
+    parser.add_argument('--channels', type=int, default=None, help='Number of channels')
+    parser.add_argument('--channel-length', type=float, default=None, help='Channel length (m)')
+    parser.add_argument('--flow', type=float, default=None, help='Total flow rate (L/h)')
+    parser.add_argument('--tank-volume', type=float, default=None, help='Tank volume (L)')
+    parser.add_argument('--seed', type=int, default=0, help='Weather seed')
+    parser.add_argument('--output-json', type=str, help='Write final per-position values and the tank history')
+    args = parser.parse_args(argv)
+
+    system_config = DefaultConfigurations.get_nft_lettuce_system()
+    if args.plants is not None:
+        system_config.n_plants = args.plants
+    if args.flow is not None:
+        system_config.flow_rate = args.flow
+    if args.tank_volume is not None:
+        system_config.tank_volume = args.tank_volume
+    input_data = HydroInputData(
+        system_config=system_config,
+        crop_params=DefaultConfigurations.get_lettuce_parameters(),
+        weather_data=WeatherGenerator().generate_weather_arrays(start_date=datetime(2024, 1, 1),
+                                                                days=args.days, rng=args.seed),
+        nutrient_params=DefaultConfigurations.get_default_nutrients(),
+        simulation_days=args.days
+    )
+    simulator = create_lettuce_spatial_nft_simulator()
+    overrides = {'n_channels': args.channels, 'channel_length': args.channel_length}
+    simulator.channel_params = replace(simulator.channel_params,
+                                       **{name: value for name, value in overrides.items() if value is not None})
+
+    print(f"🌱 CROPGRO spatial NFT: {system_config.n_plants} plants, "
+          f"{simulator.channel_params.n_channels} channels, cultivar {args.cultivar}")
+    print("=" * 50)
+    results = simulator.run(input_data, cultivar_id=args.cultivar, max_days=args.days)
+    summary = results.summary()
+    print(f"🎯 {results.days} days, mean biomass {summary['mean_biomass_g']:.2f} g/plant "
+          f"(CV {summary['biomass_cv']:.1%})")
+    print(f"   Inlet {summary['inlet_biomass_g']:.2f} g vs outlet {summary['outlet_biomass_g']:.2f} g, "
+          f"lowest outlet DO {summary['min_outlet_oxygen_mg_L']:.2f} mg/L")
+    print(f"   {summary['step_seconds_per_day'] * 1000:.1f} ms per simulated day")
+
+    if args.output_json:
+        out_path = Path(args.output_json)
+        out_path.parent.mkdir(parents=True, exist_ok=True)
+        with open(out_path, 'w') as f:
+            json.dump({
+                'summary': summary,
+                'layout': vars(results.layout),
+                'final': {name: results.final(name).tolist() for name in results.positions},
+                'tank': results.tank
+            }, f, indent=2, default=to_serializable)
+        print(f"Saved JSON: {out_path}")
+    return 0
+
+
+def sensitivity_main(argv):
+    """`cropgro_cli.py sensitivity ...`: Sobol or Morris indices of config entries."""
+    from src.sensitivity import SensitivityParameter, create_lettuce_sensitivity_analysis
+    parser = argparse.ArgumentParser(prog="cropgro_cli.py sensitivity",
+                                     description="Global sensitivity analysis of cropgro_config.json entries")
+    parser.add_argument('--method', type=str, default=None, choices=['sobol', 'morris'], help='Design and estimator')
+    parser.add_argument('--samples', type=int, default=None, help='Sobol base points or Morris trajectories')
+    parser.add_argument('--parameters', type=str, default=None,
+                        help='Comma-separated config entries (section.KEY), varied ±--range around their values')
+    parser.add_argument('--range', type=float, default=0.2, help='Relative range of --parameters')
+    parser.add_argument('--cultivars', type=str, default='HYDRO_001', help='Comma-separated cultivar IDs')
+    parser.add_argument('--systems', type=str, default='NFT', help='Comma-separated system types')
+    parser.add_argument('--seeds', type=str, default='0', help='Comma-separated weather seeds')
+    parser.add_argument('--days', type=int, default=60, help='Max simulation days')
+    parser.add_argument('--backend', type=str, default='batch', choices=['batch', 'ensemble'], help='Evaluation engine')
+    parser.add_argument('--chunk-size', type=int, default=None, help='Samples per chunk')
+    parser.add_argument('--workers', type=int, default=None, help='Worker processes (default: core count)')
+    parser.add_argument('--store', type=str, default=None, help='.npz sample store (resumed if it exists)')
+    parser.add_argument('--output-json', type=str, help='Write the indices to this file')
+    args = parser.parse_args(argv)
+
+    scenarios = build_scenario_matrix(
+        cultivars=_csv_list(args.cultivars),
+        systems=_csv_list(args.systems),
+        weather_seeds=_csv_list(args.seeds, int),
+        day_limits=[args.days]
+    )
+    options = {name: value for name, value in (('method', args.method), ('n_samples', args.samples))
+               if value is not None}
+    if args.parameters:
+        options['parameters'] = [SensitivityParameter.around(path, relative_range=args.range)
+                                 for path in _csv_list(args.parameters)]
+    analysis = create_lettuce_sensitivity_analysis(scenarios, store_path=args.store, **options)
+    print(f"🌱 CROPGRO sensitivity ({analysis.method}): {len(analysis.parameters)} parameters, "
+          f"{analysis.n_runs} samples × {len(scenarios)} scenarios, {analysis.n_pending} pending")
+    print("=" * 50)
+    analysis.evaluate(chunk_size=args.chunk_size, backend=args.backend, max_workers=args.workers)
+    if analysis.n_pending:
+        print(f"⚠️  {analysis.n_pending} samples failed; rerun with --store to retry them")
+
+    indices = analysis.analyze()
+    for output, result in indices.items():
+        print(f"\n{output}")
+        for name, value in result.ranking():
+            print(f"  {name:<36} {value:>8.3f}")
+
+    if args.output_json:
+        out_path = Path(args.output_json)
+        out_path.parent.mkdir(parents=True, exist_ok=True)
+        with open(out_path, 'w') as f:
+            json.dump({
+                'method': analysis.method,
+                'parameters': [vars(p) for p in analysis.parameters],
+                'scenarios': [s.label for s in scenarios],
+                'samples': analysis.n_runs,
+                'pending': analysis.n_pending,
+                'indices': {output: result.to_dict() for output, result in indices.items()}
+            }, f, indent=2, default=to_serializable)
+        print(f"Saved JSON: {out_path}")
+    return 1 if analysis.n_pending else 0
+
+
+def emulator_main(argv):
+    """`cropgro_cli.py emulator ...`: train the surrogate model, then answer queries from it."""
+    from src.emulator import EmulatorQuery, EmulatorService, create_lettuce_emulator, create_lettuce_emulator_design
+    parser = argparse.ArgumentParser(prog="cropgro_cli.py emulator",
+                                     description="Train or query the simulator emulator")
+    parser.add_argument('--model', type=str, required=True, help='.npz emulator file (written by --train)')
+    parser.add_argument('--train', action='store_true', help='Run the design and train the emulator')
+    parser.add_argument('--samples', type=int, default=None, help='Design points (simulator runs)')
+    parser.add_argument('--cultivars', type=str, default=None, help='Comma-separated cultivar IDs (default: all)')
+    parser.add_argument('--days', type=int, default=None, help='Max simulation days of the design runs')
+    parser.add_argument('--dataset', type=str, default=None, help='.npz dataset store (reused if it exists)')
+    parser.add_argument('--workers', type=int, default=None, help='Worker processes (default: core count)')
+    parser.add_argument('--query', type=str, action='append', default=[],
+                        help='ec,rzt,photoperiod[,cultivar] to predict (repeatable)')
+    parser.add_argument('--no-fallback', action='store_true', help='Never run the simulator for queries')
+    args = parser.parse_args(argv)
+
+    if args.train:
+        options = {}
+        if args.cultivars:
+            options['cultivars'] = _csv_list(args.cultivars)
+        if args.days:
+            options['base_scenario'] = ScenarioSpec(max_days=args.days)
+        design = create_lettuce_emulator_design(**options)
+        print(f"🌱 CROPGRO emulator: training on {args.samples or 'config'} design points, "
+              f"{len(design.cultivars)} cultivars")
+        print("=" * 50)
+        service = create_lettuce_emulator(design, n_samples=args.samples, dataset_path=args.dataset,
+                                          max_workers=args.workers)
+        service.save(args.model)
+        for name, m in service.validation.items():
+            print(f"  {name:<28} R² {m['r2']:>6.3f}  RMSE {m['rmse']:>9.3f}  95% coverage {m['coverage_95']:>4.0%}")
+        print(f"Saved emulator: {args.model}")
+
+    if args.query:
+        service = EmulatorService.load(args.model, fallback=not args.no_fallback, max_workers=args.workers)
+        queries = []
+        for text in args.query:
+            fields = _csv_list(text)
+            queries.append(EmulatorQuery(*map(float, fields[:3]), *fields[3:4]))
+        predictions = service.predict_many(queries)
+        print(json.dumps([p.to_dict() for p in predictions], indent=2, default=to_serializable))
+    return 0
+
+
+def serve_main(argv):
+    """`cropgro_cli.py serve ...`: long-running HTTP simulation server with a warm simulator pool."""
+    from src.simulation_server import create_lettuce_simulation_server
+    parser = argparse.ArgumentParser(prog="cropgro_cli.py serve",
+                                     description="Serve scenario runs over HTTP (POST /simulate, GET /metrics)")
+    parser.add_argument('--host', type=str, default=None, help='Bind address (default: config or 127.0.0.1)')
+    parser.add_argument('--port', type=int, default=None, help='Port (default: config or 8470)')
+    parser.add_argument('--cultivars', type=str, default=None, help='Comma-separated cultivar IDs to pre-initialize')
+    parser.add_argument('--systems', type=str, default=None, help='Comma-separated system types to pre-initialize')
+    parser.add_argument('--batch-window-ms', type=float, default=None, help='Micro-batch collection window')
+    parser.add_argument('--max-batch', type=int, default=None, help='Maximum requests per micro-batch')
+    parser.add_argument('--cache-size', type=int, default=None, help='Cached results (0: no cache)')
+    parser.add_argument('--weather-dir', type=str, default=None,
+                        help='Directory request weather_file names resolve in (default: config; none refuses them)')
+    args = parser.parse_args(argv)
+
+    options = {}
+    if args.cultivars:
+        options['cultivars'] = _csv_list(args.cultivars)
+    if args.systems:
+        options['systems'] = _csv_list(args.systems)
+    if args.batch_window_ms is not None:
+        options['batch_window_ms'] = args.batch_window_ms
+    if args.max_batch is not None:
+        options['max_batch'] = args.max_batch
+    if args.cache_size is not None:
+        options['cache_size'] = args.cache_size
+    if args.weather_dir is not None:
+        options['weather_dir'] = args.weather_dir
+
+    print("🌱 CROPGRO simulation server: warming simulator pool")
+    print("=" * 50)
+    server = create_lettuce_simulation_server(host=args.host, port=args.port, **options)
+    host, port = server.server_address[:2]
+    print(f"Listening on http://{host}:{port} (POST /simulate, GET /metrics, GET /health)")
+    try:
+        server.serve_forever()
+    except KeyboardInterrupt:
+        print("\nShutting down")
+    finally:
+        server.service.stop()
+        server.server_close()
+    return 0
+
+
 def main():
+    if len(sys.argv) > 1 and sys.argv[1] == 'batch':
+        sys.exit(batch_main(sys.argv[2:]))
+    if len(sys.argv) > 1 and sys.argv[1] == 'optimize':
+        sys.exit(optimize_main(sys.argv[2:]))
+    if len(sys.argv) > 1 and sys.argv[1] == 'spatial':
+        sys.exit(spatial_main(sys.argv[2:]))
+    if len(sys.argv) > 1 and sys.argv[1] == 'sensitivity':
+        sys.exit(sensitivity_main(sys.argv[2:]))
+    if len(sys.argv) > 1 and sys.argv[1] == 'emulator':
+        sys.exit(emulator_main(sys.argv[2:]))
+    if len(sys.argv) > 1 and sys.argv[1] == 'serve':
+        sys.exit(serve_main(sys.argv[2:]))
+
     parser = argparse.ArgumentParser(description="CROPGRO Hydroponic Simulator CLI")
     parser.add_argument('--days', type=int, default=120, help='Max simulation days')
     parser.add_argument('--cultivar', type=str, default='HYDRO_001', help='Cultivar ID')
     parser.add_argument('--system', type=str, default='NFT', choices=['NFT', 'DWC', 'AEROPONICS'], help='Hydroponic system type')
     parser.add_argument('--output-csv', type=str, help='Path to write CSV of daily results')
     parser.add_argument('--output-json', type=str, help='Path to write JSON with all daily details')
+    parser.add_argument('--output-parquet', type=str,
+                        help='Stream flattened daily results to Parquet, or to an Arrow IPC stream '
+                             '(.arrows/.arrow/.ipc) that can be read during the run')
+    parser.add_argument('--row-group-days', type=int, default=30, help='Simulated days per streamed row group')
+    parser.add_argument('--profile', action='store_true', help='Time each sub-model of the daily step and print a breakdown')
+    parser.add_argument('--weather-file', type=str, help='Drive the run with a memory-mapped weather file (.cwx/.parquet)')
     parser.add_argument('--print-daily', action='store_true', help='Print detailed per-day results to stdout')
     parser.add_argument('--print-summary', action='store_true', help='Print summary stats to stdout')
+    parser.add_argument('--timestep', type=str, default='daily', choices=['daily', 'hourly'], help='Integration timestep')
+    parser.add_argument('--light-shape', type=str, default='sine', choices=['sine', 'square'], help='Hourly light schedule (square = LED)')
+    parser.add_argument('--save-checkpoint', type=str, help='Write the final simulator state to this checkpoint file')
+    parser.add_argument('--resume', type=str,
+                        help='Continue from a trusted checkpoint file (up to --days); requires --weather-file')
+    parser.add_argument('--diagnostics', type=str, default=None, choices=['off', 'summary', 'events', 'debug'],
+                        help='Run event level (default: system.DIAGNOSTICS_LEVEL of the config)')
 
     args = parser.parse_args()
+    if args.resume and not args.weather_file:
+        # Generated weather starts today from the global RNG, so it would not
+        # be the weather of the checkpointed days
+        parser.error("--resume requires --weather-file (the run's weather must be reproducible)")
 
+    writer = None
     try:
-        results = run_simulation(args.days, args.cultivar, args.system, args.print_daily)
+        if args.output_parquet:
+            writer = StreamingResultsWriter(args.output_parquet, row_group_days=args.row_group_days)
+
+        results = run_simulation(args.days, args.cultivar, args.system, args.print_daily,
+                                 args.timestep, args.light_shape, output_writer=writer,
+                                 profile=args.profile, weather_file=args.weather_file,
+                                 resume=args.resume, save_checkpoint=args.save_checkpoint,
+                                 diagnostics=args.diagnostics)
+
+        if writer:
+            writer.close()
+            print(f"Saved {writer.output_format.upper()}: {writer.path} "
+                  f"({writer.row_groups_written} row groups, {writer.rows_written} days)")
 
         # Output CSV via DataFrame (curated columns)
         if args.output_csv:
@@ -122,6 +526,7 @@ def main():
             out = {
                 'metadata': getattr(results, 'metadata', {}),
                 'summary_stats': results.summary_stats,
+                'diagnostics': getattr(results, 'diagnostics', []),
                 'daily_results': [daily_result_to_dict(dr) for dr in results.daily_results],
             }
             out_path = Path(args.output_json)
@@ -140,6 +545,9 @@ def main():
         print(f"❌ Simulation failed: {e}")
         import traceback
         traceback.print_exc()
+    finally:
+        if writer:
+            writer.close()
 
 
 if __name__ == "__main__":
@@ -0,0 +1,355 @@
+"""
+CROPGRO Batch Runner - Parallel Scenario Execution
+
+Runs a matrix of CROPGRO hydroponic scenarios (cultivars × systems × weather
+seeds × day limits) across a pool of worker processes. The configuration file
+and the cultivar database are loaded once in the parent process and shared
+read-only with the workers: on platforms with fork() the workers inherit the
+already built tables, elsewhere each worker builds them once in its
+initializer rather than once per scenario.
+
+Key concepts implemented:
+1. Scenario matrix expansion (Cartesian product of the scenario axes)
+2. Process pool sized to the available cores
+3. Shared read-only configuration and genetic parameter tables
+4. Streaming of results in completion order
+5. Per-scenario error capture so one failure does not stop the batch
+6. Simulators cloned from a per-process prototype and reused via reset()
+7. Branching from a shared checkpoint (scenario trees: simulate a prefix
+   once, fan the remaining days out over many branches)
+8. Per-scenario configuration overrides (sensitivity and what-if samples)
+
+Research basis:
+- Jones et al. (2003) DSSAT seasonal and sensitivity analysis batch runs
+- Wallach et al. (2014) Working with Dynamic Crop Models (scenario analysis)
+"""
+
+import os
+import time
+import logging
+import itertools
+import multiprocessing
+from concurrent.futures import ProcessPoolExecutor, as_completed
+from dataclasses import dataclass, field
+from datetime import datetime
+from typing import Any, Dict, Iterator, List, Optional, Sequence, Tuple
+
+from .cropgro_hydroponic_simulator import CROPGROHydroponicSimulator
+from .models.genetic_parameters import get_shared_lettuce_genetic_system
+from .models.environmental_control import SetpointSchedule
+from .data.hydroponic_system import DefaultConfigurations, HydroInputData, SimulationResults
+from .data.checkpoint import SimulationCheckpoint
+from .data.weather_series import as_weather_series
+from .data.weather_source import MemmapWeatherSource
+from .utils.config_loader import config_overrides, get_config_loader
+from .utils.weather_generator import WeatherGenerator
+
+logger = logging.getLogger(__name__)
+
+# Simulators of this process per (cultivar, system type, config hash), reset between scenarios
+_worker_simulators: Dict[Tuple[str, str, str], CROPGROHydroponicSimulator] = {}
+
+# Checkpoint every scenario of the current batch branches from (set per worker)
+_branch_checkpoint: Optional[SimulationCheckpoint] = None
+
+# Simulator of the last overridden configuration (one slot: override sets are
+# usually unique per sample, so caching them all would grow without bound)
+_override_simulator: Optional[Tuple[Tuple[str, str, str], CROPGROHydroponicSimulator]] = None
+
+
+@dataclass
+class ScenarioSpec:
+    """One scenario of a batch run."""
+    cultivar_id: str = 'HYDRO_001'
+    system_type: str = 'NFT'
+    weather_seed: int = 0
+    max_days: int = 120
+    target_maturity: str = 'harvest'
+    timestep: str = 'daily'
+    weather_file: Optional[str] = None  # Memory-mapped historical weather (replaces generated weather)
+    temperature_offset: float = 0.0  # °C added to every weather temperature (what-if branches)
+    setpoint_schedule: Optional[SetpointSchedule] = None  # Daily VPD/CO2/RZT setpoints
+    config_overrides: Tuple[Tuple[str, Any], ...] = ()  # ('section.KEY', value) config replacements
+    photoperiod_hours: Optional[float] = None  # Fixed lighting photoperiod (h); None: seasonal
+    solution_strength: float = 1.0  # Multiplier of the fresh nutrient solution concentrations
+    label: Optional[str] = None
+
+    def __post_init__(self):
+        self.system_type = self.system_type.upper()
+        if self.label is None:
+            weather = f"w{os.path.splitext(os.path.basename(self.weather_file))[0]}" if self.weather_file \
+                else f"s{self.weather_seed}"
+            self.label = f"{self.cultivar_id}_{self.system_type}_{weather}_d{self.max_days}"
+            if self.temperature_offset:
+                self.label += f"_t{self.temperature_offset:+g}"
+            if self.setpoint_schedule is not None:
+                self.label += f"_sp{self.setpoint_schedule.n_phases}"
+            if self.config_overrides:
+                self.label += f"_cfg{len(self.config_overrides)}"
+            if self.photoperiod_hours is not None:
+                self.label += f"_pp{self.photoperiod_hours:g}"
+            if self.solution_strength != 1.0:
+                self.label += f"_ns{self.solution_strength:g}"
+
+
+@dataclass
+class BatchResult:
+    """Outcome of one scenario."""
+    index: int
+    scenario: ScenarioSpec
+    summary_stats: Dict[str, Any] = field(default_factory=dict)
+    metadata: Dict[str, Any] = field(default_factory=dict)
+    results: Optional[SimulationResults] = None
+    elapsed_seconds: float = 0.0
+    worker_pid: int = 0
+    error: Optional[str] = None
+
+    @property
+    def ok(self) -> bool:
+        return self.error is None
+
+
+def build_scenario_matrix(cultivars: Sequence[str] = ('HYDRO_001',),
+                          systems: Sequence[str] = ('NFT',),
+                          weather_seeds: Sequence[int] = (0,),
+                          day_limits: Sequence[int] = (120,),
+                          target_maturity: str = 'harvest',
+                          timestep: str = 'daily',
+                          weather_files: Optional[Sequence[str]] = None) -> List[ScenarioSpec]:
+    """Expand the scenario axes into the full Cartesian product.
+
+    With weather_files, each file (one site) replaces the weather seed axis.
+    """
+    weather_axis = [(0, path) for path in weather_files] if weather_files else \
+        [(seed, None) for seed in weather_seeds]
+    return [
+        ScenarioSpec(cultivar_id=cultivar, system_type=system, weather_seed=seed,
+                     max_days=days, target_maturity=target_maturity, timestep=timestep,
+                     weather_file=weather_file)
+        for cultivar, system, (seed, weather_file), days in itertools.product(
+            cultivars, systems, weather_axis, day_limits)
+    ]
+
+
+def build_scenario_input(scenario: ScenarioSpec) -> HydroInputData:
+    """Default lettuce inputs for a scenario; its weather and root cohort draws are seeded by weather_seed."""
+    system_config = DefaultConfigurations.get_nft_lettuce_system()
+    system_config.system_type = scenario.system_type
+
+    if scenario.weather_file:
+        weather = MemmapWeatherSource(scenario.weather_file)
+    else:
+        weather = WeatherGenerator().generate_weather_arrays(
+            start_date=datetime(2024, 1, 1),
+            days=scenario.max_days,
+            rng=scenario.weather_seed
+        )
+    if scenario.temperature_offset:
+        weather = as_weather_series(weather).with_temperature_offset(scenario.temperature_offset)
+    return HydroInputData(
+        system_config=system_config,
+        crop_params=DefaultConfigurations.get_lettuce_parameters(),
+        weather_data=weather,
+        nutrient_params=DefaultConfigurations.get_default_nutrients(),
+        simulation_days=scenario.max_days,
+        photoperiod_hours=scenario.photoperiod_hours,
+        solution_strength=scenario.solution_strength,
+        random_seed=scenario.weather_seed
+    )
+
+
+def load_shared_tables(config_path: Optional[str] = None):
+    """Load configuration and cultivar tables into this process (idempotent)."""
+    if config_path:
+        get_config_loader(config_path)
+    else:
+        get_config_loader()
+    return get_shared_lettuce_genetic_system()
+
+
+def _initialize_worker(config_path: Optional[str], log_level: int,
+                       checkpoint: Optional[SimulationCheckpoint] = None):
+    """Worker initializer: reuse fork-inherited tables or build them once."""
+    global _branch_checkpoint
+    logging.getLogger().setLevel(log_level)
+    load_shared_tables(config_path)
+    _branch_checkpoint = checkpoint
+
+
+def scenario_simulator(scenario: ScenarioSpec) -> CROPGROHydroponicSimulator:
+    """Freshly reset simulator for a scenario (cloned from the prototype on first use).
+
+    Scenarios with config_overrides must be set up inside config_overrides()
+    (run_scenario does this); their simulators are built directly for the
+    derived configuration and only the most recent one is kept.
+    """
+    global _override_simulator
+    key = (scenario.cultivar_id, scenario.system_type, get_config_loader().source_hash)
+    if scenario.config_overrides:
+        if _override_simulator is not None and _override_simulator[0] == key:
+            return _override_simulator[1].reset()
+        # Overridden genetics weights must reach the cultivar tables too
+        genetics = any(path.startswith('genetics.') for path, _ in scenario.config_overrides)
+        simulator = CROPGROHydroponicSimulator(
+            cultivar_id=scenario.cultivar_id,
+            system_type=scenario.system_type,
+            genetic_system=None if genetics else get_shared_lettuce_genetic_system()
+        )
+        _override_simulator = (key, simulator)
+        return simulator
+    simulator = _worker_simulators.get(key)
+    if simulator is None:
+        simulator = CROPGROHydroponicSimulator.from_prototype(
+            cultivar_id=scenario.cultivar_id,
+            system_type=scenario.system_type,
+            genetic_system=get_shared_lettuce_genetic_system()
+        )
+        _worker_simulators[key] = simulator
+    else:
+        simulator.reset()
+    return simulator
+
+
+def run_scenario(scenario: ScenarioSpec, index: int = 0, keep_results: bool = False,
+                 resume_from: Optional[SimulationCheckpoint] = None) -> BatchResult:
+    """Run one scenario with the process-wide shared tables (optionally as a branch of a checkpoint)."""
+    start = time.perf_counter()
+    try:
+        with config_overrides(scenario.config_overrides):
+            simulator = scenario_simulator(scenario)
+            results = simulator.run_simulation(
+                build_scenario_input(scenario),
+                max_days=scenario.max_days,
+                target_maturity=scenario.target_maturity,
+                timestep=scenario.timestep,
+                resume_from=resume_from,
+                setpoint_schedule=scenario.setpoint_schedule
+            )
+        return BatchResult(
+            index=index,
+            scenario=scenario,
+            summary_stats=results.summary_stats,
+            metadata=getattr(results, 'metadata', {}),
+            results=results if keep_results else None,
+            elapsed_seconds=time.perf_counter() - start,
+            worker_pid=os.getpid()
+        )
+    except Exception as e:
+        logger.error(f"Scenario {scenario.label} failed: {e}")
+        return BatchResult(
+            index=index,
+            scenario=scenario,
+            elapsed_seconds=time.perf_counter() - start,
+            worker_pid=os.getpid(),
+            error=f"{type(e).__name__}: {e}"
+        )
+
+
+def _run_branch(scenario: ScenarioSpec, index: int, keep_results: bool) -> BatchResult:
+    """Worker entry point for branches of the worker's checkpoint."""
+    return run_scenario(scenario, index, keep_results, _branch_checkpoint)
+
+
+def run_batch(scenarios: Sequence[ScenarioSpec],
+              max_workers: Optional[int] = None,
+              keep_results: bool = False,
+              config_path: Optional[str] = None,
+              worker_log_level: int = logging.WARNING,
+              resume_from: Optional[SimulationCheckpoint] = None) -> Iterator[BatchResult]:
+    """
+    Run scenarios in parallel and yield results in completion order.
+
+    Args:
+        scenarios: Scenarios to run
+        max_workers: Worker processes (default: number of cores)
+        keep_results: Ship full SimulationResults back (otherwise summary
+            statistics and metadata only, which keeps inter-process traffic small)
+        config_path: Optional configuration file shared by all workers
+        worker_log_level: Logging level inside the workers
+        resume_from: Checkpoint every scenario branches from (sent to each
+            worker once; the scenarios must use its cultivar)
+
+    Yields:
+        BatchResult for each scenario as soon as it finishes
+    """
+    scenarios = list(scenarios)
+    if not scenarios:
+        return
+
+    workers = max(1, min(max_workers or os.cpu_count() or 1, len(scenarios)))
+
+    # Load once in the parent so forked workers inherit the built tables
+    load_shared_tables(config_path)
+
+    if workers == 1:
+        for index, scenario in enumerate(scenarios):
+            yield run_scenario(scenario, index, keep_results, resume_from)
+        return
+
+    methods = multiprocessing.get_all_start_methods()
+    context = multiprocessing.get_context('fork' if 'fork' in methods else None)
+    logger.info(f"Running {len(scenarios)} scenarios on {workers} workers ({context.get_start_method()})")
+
+    with ProcessPoolExecutor(max_workers=workers, mp_context=context,
+                             initializer=_initialize_worker,
+                             initargs=(config_path, worker_log_level, resume_from)) as pool:
+        futures = [pool.submit(_run_branch if resume_from is not None else run_scenario,
+                               scenario, index, keep_results)
+                   for index, scenario in enumerate(scenarios)]
+        for future in as_completed(futures):
+            yield future.result()
+
+
+def run_scenario_tree(prefix: ScenarioSpec, branches: Sequence[ScenarioSpec],
+                      **batch_options) -> Iterator[BatchResult]:
+    """
+    Simulate a shared prefix once and run every branch from its final state.
+
+    The prefix's max_days is the branch day; each branch simulates the
+    remaining days up to its own max_days (same cultivar, system type and
+    tank volume as the prefix).
+    batch_options are passed to run_batch.
+    """
+    load_shared_tables(batch_options.get('config_path'))
+    simulator = scenario_simulator(prefix)
+    simulator.run_simulation(
+        build_scenario_input(prefix),
+        max_days=prefix.max_days,
+        target_maturity=prefix.target_maturity,
+        timestep=prefix.timestep
+    )
+    checkpoint = simulator.checkpoint()
+    logger.info(f"Prefix {prefix.label} checkpointed at day {checkpoint.day} "
+                f"({checkpoint.size_bytes / 1024:.1f} KiB), {len(branches)} branches")
+    yield from run_batch(branches, resume_from=checkpoint, **batch_options)
+
+
+def demonstrate_batch_runner():
+    """Demonstrate a small parallel scenario batch."""
+    print("CROPGRO Batch Runner Demonstration")
+    print("=" * 80)
+
+    scenarios = build_scenario_matrix(
+        cultivars=['HYDRO_001', 'BUTT_001'],
+        systems=['NFT', 'DWC'],
+        weather_seeds=[1, 2],
+        day_limits=[45]
+    )
+    print(f"Scenarios: {len(scenarios)}, cores: {os.cpu_count()}")
+    print(f"\n{'#':>3} {'Scenario':<28} {'Days':>5} {'Biomass (g)':>12} {'Time (s)':>9} {'PID':>7}")
+    print("-" * 80)
+
+    start = time.perf_counter()
+    for result in run_batch(scenarios):
+        if result.ok:
+            print(f"{result.index:>3} {result.scenario.label:<28} "
+                  f"{result.summary_stats.get('total_days', 0):>5} "
+                  f"{result.summary_stats.get('total_biomass_g', 0.0):>12.2f} "
+                  f"{result.elapsed_seconds:>9.2f} {result.worker_pid:>7}")
+        else:
+            print(f"{result.index:>3} {result.scenario.label:<28} FAILED: {result.error}")
+    print(f"\nWall time: {time.perf_counter() - start:.2f} s")
+
+
+if __name__ == "__main__":
+    demonstrate_batch_runner()
@@ -0,0 +1,698 @@
+"""
+CROPGRO Parameter Calibration - Gradient-Based Fitting of a Differentiable Core
+
+Fits photosynthesis, respiration, phenology, leaf, nitrogen uptake and
+cultivar (genetic coefficient) parameters to observed fresh weight, LAI and
+cumulative N-uptake trajectories of one or more sites. Instead of rerunning
+the full simulator for every parameter perturbation, the calibration runs a
+reduced daily core of the simulator's carbon, phenology and nitrate uptake
+step that is written once against an array namespace:
+
+- with JAX installed, the core is traced with jax.numpy, scanned over days
+  (lax.scan), vectorized over sites (vmap) and compiled together with its
+  gradient (jit(value_and_grad)), so one loss evaluation returns the exact
+  gradient with respect to every calibrated parameter;
+- without JAX, the core runs on NumPy and the gradient comes from central
+  finite differences, with all 2·P perturbed parameter sets evaluated in
+  one broadcast run of the core (parameter sets × sites).
+
+The core follows EnsembleSimulator's vectorized step for the processes it
+covers (cardinal-temperature thermal time, Farquhar daily assimilation,
+Q10 maintenance respiration, stage-dependent allocation, SLA-based LAI) in
+a stress-free environment with the solution held at its initial nitrate
+concentration. Stage changes are smoothed with a logistic switch around the
+end of vegetative development so that the loss is differentiable.
+
+Key concepts implemented:
+1. Named calibration parameters ("group.attribute") with bounds, fitted in
+   the unit cube
+2. One backend-agnostic daily core shared by the JAX and NumPy paths
+3. JIT-compiled autodiff gradients vectorized over sites (JAX), batched
+   central differences otherwise
+4. Weighted relative least squares over observed trajectories with
+   missing observations masked
+5. Bounded quasi-Newton refinement (L-BFGS-B) and write-back of the fitted
+   values into a simulator's models
+
+Research basis:
+- Wallach et al. (2019) Working with Dynamic Crop Models, ch. 6 (calibration)
+- Baydin et al. (2018) Automatic differentiation in machine learning: a survey
+- Byrd et al. (1995) A limited memory algorithm for bound constrained optimization
+"""
+
+import copy
+import time
+import logging
+from dataclasses import dataclass, field
+from typing import Any, Callable, Dict, List, Optional, Sequence, Tuple, TYPE_CHECKING
+
+import numpy as np
+
+from .batch_runner import ScenarioSpec, build_scenario_input, scenario_simulator
+from .data.weather_series import as_weather_series
+from .models.phenology_model import LettuceGrowthStage
+
+try:
+    import jax
+    import jax.numpy as jnp
+    JAX_AVAILABLE = True
+except ImportError:  # Optional autodiff backend
+    jax = None
+    jnp = None
+    JAX_AVAILABLE = False
+
+if TYPE_CHECKING:
+    from .cropgro_hydroponic_simulator import CROPGROHydroponicSimulator
+    from .data.hydroponic_system import SimulationResults
+    from .utils.config_loader import ConfigSnapshot
+
+logger = logging.getLogger(__name__)
+
+# Observed trajectories the core reproduces
+TARGETS = ('fresh_weight', 'lai', 'n_uptake')
+
+# Model parameters of the core by group: simulator attribute path of the
+# parameter object and the attributes the core reads
+PARAMETER_GROUPS = {
+    'photosynthesis': (('photosynthesis_model', 'params'),
+                       ('vcmax_25', 'jmax_25', 'alpha', 'theta', 'eav', 'eaj', 'r', 'kc', 'ko',
+                        'gamma_star', 'o2_mmol_mol', 'ci_fraction')),
+    'respiration': (('respiration_model', 'params'),
+                    ('maintenance_base_rate', 'reference_temperature', 'q10_factor',
+                     'age_effect_coefficient', 'max_age_effect')),
+    'phenology': (('phenology_model', 'params'),
+                  ('base_temperature', 'optimal_temperature_min', 'optimal_temperature_max',
+                   'maximum_temperature', 'thermal_time_scale')),
+    'genetics': (('cultivar_profile', 'genetic_coefficients'),
+                 ('PHOTOSYNTHETIC_CAPACITY', 'NITRATE_EFFICIENCY')),
+    'leaf': (('leaf_model', 'params'), ('specific_leaf_area',)),
+    'nitrogen': (('nitrogen_model', 'params'), ('NO3_vmax', 'NO3_km', 'root_zone_exploration')),
+}
+
+# Default search ranges
+CALIBRATION_BOUNDS = {
+    'photosynthesis.vcmax_25': (30.0, 150.0),
+    'photosynthesis.jmax_25': (60.0, 300.0),
+    'photosynthesis.alpha': (0.03, 0.12),
+    'photosynthesis.theta': (0.5, 0.99),
+    'photosynthesis.ci_fraction': (0.65, 0.85),
+    'respiration.maintenance_base_rate': (0.005, 0.04),
+    'respiration.reference_temperature': (15.0, 30.0),
+    'respiration.q10_factor': (1.5, 3.0),
+    'respiration.age_effect_coefficient': (0.0, 0.01),
+    'phenology.base_temperature': (0.0, 8.0),
+    'phenology.thermal_time_scale': (0.5, 1.0),
+    'genetics.PHOTOSYNTHETIC_CAPACITY': (0.5, 3.0),
+    'genetics.NITRATE_EFFICIENCY': (0.5, 1.0),
+    'leaf.specific_leaf_area': (150.0, 400.0),
+    'nitrogen.NO3_vmax': (0.01, 1.2),
+    'nitrogen.NO3_km': (2.0, 60.0),
+}
+
+DEFAULT_CALIBRATION_PARAMETERS = (
+    'photosynthesis.vcmax_25', 'photosynthesis.alpha',
+    'respiration.maintenance_base_rate', 'respiration.q10_factor',
+    'phenology.thermal_time_scale', 'genetics.PHOTOSYNTHETIC_CAPACITY',
+    'leaf.specific_leaf_area', 'nitrogen.NO3_vmax',
+)
+
+
+def _parameter_object(simulator: 'CROPGROHydroponicSimulator', group: str):
+    owner_name, attribute = PARAMETER_GROUPS[group][0]
+    return getattr(getattr(simulator, owner_name), attribute)
+
+
+def _read_parameter(parameters, group: str, attribute: str) -> float:
+    if group == 'nitrogen' and attribute.startswith('NO3_'):
+        return float(parameters.uptake_kinetics['NO3'][attribute[4:]])
+    return float(getattr(parameters, attribute))
+
+
+def _write_parameter(parameters, group: str, attribute: str, value: float):
+    if group == 'nitrogen' and attribute.startswith('NO3_'):
+        parameters.uptake_kinetics['NO3'][attribute[4:]] = value
+    else:
+        setattr(parameters, attribute, value)
+
+
+def _split_name(name: str) -> Tuple[str, str]:
+    group, _, attribute = name.partition('.')
+    if group not in PARAMETER_GROUPS or attribute not in PARAMETER_GROUPS[group][1]:
+        raise ValueError(f"Unknown calibration parameter {name!r}")
+    return group, attribute
+
+
+@dataclass(frozen=True)
+class CalibrationParameter:
+    """One calibrated parameter and its search range."""
+    name: str              # "group.attribute", e.g. "photosynthesis.vcmax_25"
+    lower: float
+    upper: float
+
+    def __post_init__(self):
+        _split_name(self.name)
+        if not self.upper > self.lower:
+            raise ValueError(f"Invalid bounds for {self.name}: [{self.lower}, {self.upper}]")
+
+    @classmethod
+    def named(cls, name: str, bounds: Optional[Tuple[float, float]] = None) -> 'CalibrationParameter':
+        """Parameter with explicit bounds or the default range of CALIBRATION_BOUNDS."""
+        if bounds is None:
+            if name not in CALIBRATION_BOUNDS:
+                raise ValueError(f"No default bounds for {name!r}; pass bounds explicitly")
+            bounds = CALIBRATION_BOUNDS[name]
+        return cls(name, float(bounds[0]), float(bounds[1]))
+
+    def from_unit(self, unit):
+        return self.lower + unit * (self.upper - self.lower)
+
+    def to_unit(self, value: float) -> float:
+        return min(1.0, max(0.0, (value - self.lower) / (self.upper - self.lower)))
+
+
+@dataclass
+class CoreConstants:
+    """
+    Everything the calibration core needs from a simulator.
+
+    values holds every model parameter the core reads by "group.attribute"
+    name (the calibrated ones are overridden per evaluation); the remaining
+    fields are fixed for a calibration run.
+    """
+    values: Dict[str, float]
+    initial_mass: Tuple[float, float, float]          # g DW/plant (leaf, stem, root)
+    initial_age: float                                # days
+    initial_thermal_time: float                       # GDD
+    vegetative_thermal_time: float                    # GDD at the end of vegetative development
+    development_multiplier: float = 1.0               # Photoperiod/stress factor on thermal time
+    stage_smoothing: float = 10.0                     # GDD width of the vegetative/reproductive switch
+    tissue_factors: Tuple[float, float, float] = (1.0, 0.7, 0.8)
+    leaf_nitrogen_factor: float = 1.0
+    carbon_to_biomass_ratio: float = 0.45
+    growth_respiration_fraction: float = 0.25
+    vegetative_allocation: Tuple[float, float, float] = (0.60, 0.20, 0.20)
+    reproductive_allocation: Tuple[float, float, float] = (0.40, 0.35, 0.25)
+    shoot_dry_matter_fraction: float = 0.05           # g DW per g FW of lettuce shoots
+    stress_factor: float = 1.0                        # Overall stress multiplier on photosynthesis
+
+    @classmethod
+    def from_simulator(cls, simulator: 'CROPGROHydroponicSimulator') -> 'CoreConstants':
+        """Constants of a freshly initialized (or reset) simulator."""
+        values = {}
+        for group, (_, attributes) in PARAMETER_GROUPS.items():
+            parameters = _parameter_object(simulator, group)
+            for attribute in attributes:
+                values[f'{group}.{attribute}'] = _read_parameter(parameters, group, attribute)
+
+        phenology = simulator.phenology_model
+        p = phenology.params
+        state = phenology.developmental_state
+        # Thermal time left until the first non-vegetative stage
+        stage = state.current_stage
+        remaining = state.thermal_time_required - state.thermal_time_accumulated
+        vegetative_end = state.total_thermal_time
+        while _is_vegetative(stage):
+            vegetative_end += max(0.0, remaining)
+            next_stage = phenology.get_next_stage(stage, False)
+            if next_stage == stage:
+                break
+            remaining = phenology.get_thermal_requirement(next_stage, phenology.get_next_stage(next_stage, False))
+            stage = next_stage
+
+        # Pre-stress phenology call of the simulator (see EnsembleSimulator._phenology)
+        water_factor = p.stress_acceleration_factor if 0.0 < p.drought_threshold else 1.0
+
+        rp = simulator.respiration_model.params
+        tissue = tuple(float(rp.tissue_factors.get(name, 1.0)) for name in ('leaves', 'stems', 'roots'))
+        pools = simulator.biomass_pools
+        leaf_n = pools[0].nitrogen_content
+        leaf_n_factor = max(0.5, min(2.0, 1.0 + rp.n_effect_slope * (leaf_n / rp.reference_leaf_n - 1.0)))
+
+        sp = simulator.params
+        return cls(
+            values=values,
+            initial_mass=tuple(float(pool.dry_mass) for pool in pools[:3]),
+            initial_age=float(pools[0].age_days),
+            initial_thermal_time=float(state.total_thermal_time),
+            vegetative_thermal_time=float(vegetative_end),
+            development_multiplier=float(max(water_factor, 1.0)),
+            tissue_factors=tissue,
+            leaf_nitrogen_factor=float(leaf_n_factor),
+            carbon_to_biomass_ratio=sp.carbon_to_biomass_ratio,
+            growth_respiration_fraction=max(0.0, sp.growth_respiration_fraction),
+            vegetative_allocation=(sp.vegetative_leaf_allocation, sp.vegetative_stem_allocation,
+                                   sp.vegetative_root_allocation),
+            reproductive_allocation=(sp.reproductive_leaf_allocation, sp.reproductive_stem_allocation,
+                                     sp.reproductive_root_allocation),
+        )
+
+
+def _is_vegetative(stage: LettuceGrowthStage) -> bool:
+    return stage.value.startswith('V') or stage == LettuceGrowthStage.EMERGENCE
+
+
+@dataclass
+class SiteDrivers:
+    """Daily forcing of each site, arrays of shape (sites, days)."""
+    temperature: np.ndarray      # °C
+    ppfd: np.ndarray             # μmol/m²/s
+    co2: np.ndarray              # μmol/mol
+    daylength: np.ndarray        # h
+    nitrate: np.ndarray          # mg N/L in the solution
+    plant_density: np.ndarray    # plants/m² (sites,)
+    labels: List[str] = field(default_factory=list)
+
+    @property
+    def n_sites(self) -> int:
+        return self.temperature.shape[0]
+
+    @property
+    def n_days(self) -> int:
+        return self.temperature.shape[1]
+
+    def forcing(self) -> Tuple[np.ndarray, ...]:
+        return (self.temperature, self.ppfd, self.co2, self.daylength, self.nitrate)
+
+    @classmethod
+    def from_scenarios(cls, scenarios: Sequence[ScenarioSpec], days: Optional[int] = None,
+                       simulator: Optional['CROPGROHydroponicSimulator'] = None) -> 'SiteDrivers':
+        """Drivers of batch scenarios (weather, CO2 setpoints, initial nitrate, planting density)."""
+        days = days or max(s.max_days for s in scenarios)
+        rows = {name: [] for name in ('temperature', 'ppfd', 'co2', 'daylength', 'nitrate')}
+        density = []
+        for scenario in scenarios:
+            controller = (simulator or scenario_simulator(scenario)).environmental_control
+            inputs = build_scenario_input(scenario)
+            weather = as_weather_series(inputs.weather_data)
+            index = np.arange(days) % len(weather)
+            solar = weather.solar_radiation[index]
+            if scenario.setpoint_schedule is not None:
+                target_co2 = scenario.setpoint_schedule.daily_arrays(days)[1]
+            else:
+                target_co2 = np.full(days, float(controller.setpoints.target_co2))
+            day_numbers = np.arange(1, days + 1)
+            rows['temperature'].append(weather.temp_avg[index])
+            rows['ppfd'].append(solar * 45.0)
+            rows['co2'].append(np.where(solar > 5.0, target_co2, float(controller.setpoints.ambient_co2)))
+            rows['daylength'].append(13.5 + 1.5 * np.sin(day_numbers * 2 * np.pi / 365))
+            nitrate = inputs.nutrient_params.get('N-NO3')
+            rows['nitrate'].append(np.full(days, float(nitrate.initial_conc) if nitrate else 0.0))
+            system = inputs.system_config
+            density.append(max(0.1, system.n_plants / max(0.1, system.system_area)))
+        return cls(**{name: np.array(values, dtype=float) for name, values in rows.items()},
+                   plant_density=np.array(density), labels=[s.label for s in scenarios])
+
+
+@dataclass
+class Observations:
+    """Observed trajectories (sites, days); NaN marks days without an observation."""
+    fresh_weight: np.ndarray     # g FW/plant (shoot)
+    lai: np.ndarray              # m²/m²
+    n_uptake: np.ndarray         # mg N/plant, cumulative
+
+    def arrays(self) -> Dict[str, np.ndarray]:
+        return {name: np.asarray(getattr(self, name), dtype=float) for name in TARGETS}
+
+    @classmethod
+    def from_results(cls, results: Sequence['SimulationResults'], days: int,
+                     shoot_dry_matter_fraction: float = 0.05) -> 'Observations':
+        """Trajectories of simulator runs (e.g. to fit the core to the full model)."""
+        columns = {name: np.full((len(results), days), np.nan) for name in TARGETS}
+        for i, result in enumerate(results):
+            daily = list(result.daily_results)[:days]
+            n = len(daily)
+            columns['fresh_weight'][i, :n] = [(r.leaf_biomass + r.stem_biomass) / shoot_dry_matter_fraction
+                                              for r in daily]
+            columns['lai'][i, :n] = [r.lai for r in daily]
+            columns['n_uptake'][i, :n] = np.cumsum([r.nitrogen_uptake_mg for r in daily])
+        return cls(**columns)
+
+
+def initial_state(xp, values: Dict[str, Any], k: CoreConstants, plant_density):
+    """Core state (leaf, stem, root, thermal time, age, LAI, cumulative N uptake)."""
+    leaf, stem, root = (xp.zeros_like(plant_density) + mass for mass in k.initial_mass)
+    lai = xp.minimum(8.0, leaf * values['leaf.specific_leaf_area'] / 10000.0 * plant_density)
+    return (leaf, stem, root, xp.zeros_like(plant_density) + k.initial_thermal_time,
+            xp.zeros_like(plant_density) + k.initial_age, lai, xp.zeros_like(plant_density))
+
+
+def core_step(xp, values: Dict[str, Any], k: CoreConstants, state: Tuple, forcing: Tuple,
+              plant_density) -> Tuple[Tuple, Tuple]:
+    """
+    One day of the calibration core for any array namespace (numpy or jax.numpy).
+
+    Returns the new state and the observed quantities (fresh weight, LAI,
+    cumulative N uptake) at the end of the day.
+    """
+    leaf, stem, root, thermal, age, lai, n_uptake = state
+    T, ppfd, co2, daylength, nitrate = forcing
+    v = values
+
+    # Phenology: cardinal-temperature thermal time and a smoothed stage switch
+    tb, t1 = v['phenology.base_temperature'], v['phenology.optimal_temperature_min']
+    t2, tmax = v['phenology.optimal_temperature_max'], v['phenology.maximum_temperature']
+    scale = v['phenology.thermal_time_scale']
+    tt = xp.where((T <= tb) | (T >= tmax), 0.0,
+                  xp.where(T <= t1, scale * (T - tb) * (T - tb) / (t1 - tb),
+                           xp.where(T <= t2, scale * (T - tb), scale * (tmax - T) / (tmax - t2) * (T - tb))))
+    thermal = thermal + tt * k.development_multiplier
+    vegetative = 1.0 / (1.0 + xp.exp((thermal - k.vegetative_thermal_time) / k.stage_smoothing))
+
+    # Daily Farquhar assimilation (PhotosynthesisModel.calculate_daily_assimilation)
+    ci = co2 * v['photosynthesis.ci_fraction']
+    temp_k = T + 273.15
+    arrhenius = (temp_k - 298.15) / (298.15 * v['photosynthesis.r'] * temp_k)
+    vcmax = v['photosynthesis.vcmax_25'] * xp.exp(v['photosynthesis.eav'] * arrhenius)
+    jmax = v['photosynthesis.jmax_25'] * xp.exp(v['photosynthesis.eaj'] * arrhenius)
+    gamma_star, theta = v['photosynthesis.gamma_star'], v['photosynthesis.theta']
+    o2 = v['photosynthesis.o2_mmol_mol'] * 1000.0
+    ac = vcmax * (ci - gamma_star) / (ci + v['photosynthesis.kc'] * (1 + o2 / v['photosynthesis.ko']))
+    i2 = v['photosynthesis.alpha'] * ppfd
+    j = (i2 + jmax - xp.sqrt((i2 + jmax) ** 2 - 4 * theta * i2 * jmax)) / (2 * theta)
+    aj = j * (ci - gamma_star) / (4 * (ci + 2 * gamma_star))
+    gross = xp.maximum(0.0, xp.minimum(ac, aj)) * xp.maximum(0.0, daylength) * 3600.0 * 1.201e-5 * lai
+    canopy = gross * k.stress_factor * v['genetics.PHOTOSYNTHETIC_CAPACITY']
+
+    # Q10 maintenance respiration with tissue, age and leaf N factors
+    temp_factor = v['respiration.q10_factor'] ** ((T - v['respiration.reference_temperature']) / 10.0)
+    temp_factor = xp.maximum(0.1, xp.where(T > 40.0, temp_factor * xp.exp(-0.1 * (T - 40.0)), temp_factor))
+    age_factor = xp.minimum(1.0 + v['respiration.age_effect_coefficient'] * age, v['respiration.max_age_effect'])
+    tissue_leaf, tissue_stem, tissue_root = k.tissue_factors
+    maintenance = (v['respiration.maintenance_base_rate'] * temp_factor * age_factor *
+                   (leaf * tissue_leaf * k.leaf_nitrogen_factor + stem * tissue_stem + root * tissue_root))
+
+    # Nitrate uptake of the day's root mass (NO3 Michaelis-Menten kinetics)
+    vmax, km = v['nitrogen.NO3_vmax'], v['nitrogen.NO3_km']
+    n_uptake = n_uptake + (1000.0 * vmax * nitrate / (km + nitrate) * root *
+                           v['nitrogen.root_zone_exploration'] * v['genetics.NITRATE_EFFICIENCY'])
+
+    # Growth and stage-dependent allocation
+    c_bm = k.carbon_to_biomass_ratio
+    available = xp.maximum(0.0, canopy - maintenance) / (c_bm * (1.0 + k.growth_respiration_fraction))
+    veg, rep = k.vegetative_allocation, k.reproductive_allocation
+    leaf = leaf + available * (vegetative * veg[0] + (1.0 - vegetative) * rep[0])
+    stem = stem + available * (vegetative * veg[1] + (1.0 - vegetative) * rep[1])
+    root = root + available * (vegetative * veg[2] + (1.0 - vegetative) * rep[2])
+    lai = xp.minimum(8.0, xp.maximum(0.0, leaf * v['leaf.specific_leaf_area'] / 10000.0 * plant_density))
+
+    fresh_weight = (leaf + stem) / k.shoot_dry_matter_fraction
+    return (leaf, stem, root, thermal, age + 1.0, lai, n_uptake), (fresh_weight, lai, n_uptake)
+
+
+def simulate_core_numpy(values: Dict[str, Any], k: CoreConstants, drivers: SiteDrivers) -> Dict[str, np.ndarray]:
+    """
+    Core trajectories with NumPy.
+
+    Parameter values may be arrays of shape (batch, 1) to evaluate several
+    parameter sets at once; results then have shape (batch, sites, days).
+    """
+    forcing = drivers.forcing()
+    density = drivers.plant_density
+    state = initial_state(np, values, k, density)
+    outputs = []
+    for day in range(drivers.n_days):
+        state, observed = core_step(np, values, k, state, tuple(f[:, day] for f in forcing), density)
+        outputs.append(observed)
+    shape = np.broadcast(*outputs[0]).shape if outputs else (drivers.n_sites,)
+    return {name: np.stack([np.broadcast_to(day[i], shape) for day in outputs], axis=-1)
+            for i, name in enumerate(TARGETS)}
+
+
+def _simulate_core_jax(values: Dict[str, Any], k: CoreConstants, forcing: Tuple, density):
+    """Core trajectories (sites, days) with lax.scan over days and vmap over sites."""
+    def site(temperature, ppfd, co2, daylength, nitrate, plant_density):
+        def step(state, day_forcing):
+            return core_step(jnp, values, k, state, day_forcing, plant_density)
+        init = initial_state(jnp, values, k, plant_density)
+        _, observed = jax.lax.scan(step, init, (temperature, ppfd, co2, daylength, nitrate))
+        return observed
+
+    observed = jax.vmap(site)(*forcing, density)
+    return dict(zip(TARGETS, observed))
+
+
+def trajectory_loss(xp, simulated: Dict[str, Any], observed: Dict[str, np.ndarray],
+                    masks: Dict[str, np.ndarray], scales: Dict[str, float],
+                    weights: Dict[str, float]):
+    """Weighted mean squared relative error over observed entries (per parameter set)."""
+    total = 0.0
+    for name, weight in weights.items():
+        mask = masks[name]
+        count = max(1, int(mask.sum()))
+        error = (simulated[name] - observed[name]) / scales[name]
+        total = total + weight * xp.sum(xp.where(mask, error * error, 0.0), axis=(-2, -1)) / count
+    return total
+
+
+@dataclass
+class CalibrationResult:
+    """Outcome of a calibration run."""
+    parameters: List[CalibrationParameter]
+    values: Dict[str, float]
+    initial_values: Dict[str, float]
+    loss: float
+    initial_loss: float
+    iterations: int
+    evaluations: int
+    backend: str
+    elapsed_seconds: float
+    success: bool = True
+    message: str = ""
+
+    def overrides(self) -> Dict[str, Dict[str, float]]:
+        """Fitted values by parameter group."""
+        grouped: Dict[str, Dict[str, float]] = {}
+        for name, value in self.values.items():
+            group, attribute = _split_name(name)
+            grouped.setdefault(group, {})[attribute] = value
+        return grouped
+
+    def apply_to(self, simulator: 'CROPGROHydroponicSimulator') -> 'CROPGROHydroponicSimulator':
+        """Write the fitted values into a simulator (copy-on-write of shared parameter objects)."""
+        for group, changes in self.overrides().items():
+            (owner_name, attribute), _ = PARAMETER_GROUPS[group]
+            owner = getattr(simulator, owner_name)
+            if group == 'genetics':
+                # Profiles come from the shared cultivar database
+                owner = copy.copy(owner)
+                setattr(simulator, owner_name, owner)
+            parameters = copy.deepcopy(getattr(owner, attribute))
+            for name, value in changes.items():
+                _write_parameter(parameters, group, name, value)
+            setattr(owner, attribute, parameters)
+        if simulator.config_snapshot.environment.get('RESPONSE_TABLES', False):
+            simulator.use_response_tables()
+        return simulator
+
+
+class CoreCalibrator:
+    """
+    Fit core parameters to observed trajectories.
+
+    Args:
+        constants: Core constants (CoreConstants.from_simulator)
+        drivers: Daily forcing of the observed sites
+        observations: Observed trajectories on the same (sites, days) grid
+        parameters: Parameters to fit (default DEFAULT_CALIBRATION_PARAMETERS)
+        weights: Loss weight of each target (default 1 for each)
+        backend: 'jax', 'numpy' or None (JAX when installed)
+        finite_difference_step: Unit-cube step of the NumPy gradient
+    """
+
+    def __init__(self, constants: CoreConstants, drivers: SiteDrivers, observations: Observations,
+                 parameters: Optional[Sequence[CalibrationParameter]] = None,
+                 weights: Optional[Dict[str, float]] = None,
+                 backend: Optional[str] = None,
+                 finite_difference_step: float = 1e-4):
+        self.constants = constants
+        self.drivers = drivers
+        self.parameters = list(parameters) if parameters is not None else [
+            CalibrationParameter.named(name) for name in DEFAULT_CALIBRATION_PARAMETERS]
+        self.weights = {name: w for name, w in (weights or {name: 1.0 for name in TARGETS}).items() if w > 0}
+        self.finite_difference_step = finite_difference_step
+
+        if backend is None:
+            backend = 'jax' if JAX_AVAILABLE else 'numpy'
+        if backend == 'jax' and not JAX_AVAILABLE:
+            raise RuntimeError("JAX calibration backend requested but jax is not installed")
+        if backend not in ('jax', 'numpy'):
+            raise ValueError(f"Unknown calibration backend {backend!r}")
+        self.backend = backend
+
+        observed = observations.arrays()
+        expected = (drivers.n_sites, drivers.n_days)
+        for name in self.weights:
+            if observed[name].shape != expected:
+                raise ValueError(f"Observations {name} have shape {observed[name].shape}, expected {expected}")
+        self.masks = {name: ~np.isnan(observed[name]) for name in self.weights}
+        self.observed = {name: np.where(self.masks[name], observed[name], 0.0) for name in self.weights}
+        self.scales = {name: max(1e-9, float(np.abs(observed[name][self.masks[name]]).mean()))
+                       if self.masks[name].any() else 1.0 for name in self.weights}
+        self.evaluations = 0
+        self._jax_value_and_grad: Optional[Callable] = None
+
+    # ------------------------------------------------------------------
+
+    def values_from_unit(self, unit) -> Dict[str, Any]:
+        """Full core parameter set with the calibrated entries taken from a unit vector."""
+        values = dict(self.constants.values)
+        for i, parameter in enumerate(self.parameters):
+            values[parameter.name] = parameter.from_unit(unit[..., i])
+        return values
+
+    def initial_unit(self) -> np.ndarray:
+        return np.array([p.to_unit(self.constants.values[p.name]) for p in self.parameters])
+
+    def simulate(self, values: Optional[Dict[str, float]] = None) -> Dict[str, np.ndarray]:
+        """Core trajectories (sites, days) for parameter values (default: the constants)."""
+        return simulate_core_numpy({**self.constants.values, **(values or {})}, self.constants, self.drivers)
+
+    def loss(self, unit: np.ndarray) -> float:
+        unit = np.asarray(unit, dtype=float)
+        simulated = simulate_core_numpy(self.values_from_unit(unit), self.constants, self.drivers)
+        self.evaluations += 1
+        return float(trajectory_loss(np, simulated, self.observed, self.masks, self.scales, self.weights))
+
+    def value_and_gradient(self, unit: np.ndarray) -> Tuple[float, np.ndarray]:
+        """Loss and its gradient with respect to the unit-cube parameter vector."""
+        unit = np.asarray(unit, dtype=float)
+        if self.backend == 'jax':
+            value, gradient = self._jax_function()(jnp.asarray(unit))
+            self.evaluations += 1
+            return float(value), np.asarray(gradient, dtype=float)
+        return self._finite_difference(unit)
+
+    def _jax_function(self) -> Callable:
+        """jit(value_and_grad) of the loss, compiled on first use."""
+        if self._jax_value_and_grad is None:
+            jax.config.update('jax_enable_x64', True)
+            forcing = tuple(jnp.asarray(f) for f in self.drivers.forcing())
+            density = jnp.asarray(self.drivers.plant_density)
+            observed = {name: jnp.asarray(a) for name, a in self.observed.items()}
+            masks = {name: jnp.asarray(a) for name, a in self.masks.items()}
+
+            def loss(unit):
+                simulated = _simulate_core_jax(self.values_from_unit(unit), self.constants, forcing, density)
+                return trajectory_loss(jnp, simulated, observed, masks, self.scales, self.weights)
+
+            self._jax_value_and_grad = jax.jit(jax.value_and_grad(loss))
+        return self._jax_value_and_grad
+
+    def _finite_difference(self, unit: np.ndarray) -> Tuple[float, np.ndarray]:
+        """Central differences with every perturbed parameter set in one batched core run."""
+        n = len(unit)
+        h = self.finite_difference_step
+        upper = np.minimum(1.0, unit + h)
+        lower = np.maximum(0.0, unit - h)
+        batch = np.repeat(unit[None, :], 2 * n + 1, axis=0)
+        batch[1 + np.arange(n), np.arange(n)] = upper
+        batch[1 + n + np.arange(n), np.arange(n)] = lower
+        simulated = simulate_core_numpy(self.values_from_unit(batch[:, None, :]), self.constants, self.drivers)
+        losses = trajectory_loss(np, simulated, self.observed, self.masks, self.scales, self.weights)
+        self.evaluations += 2 * n + 1
+        gradient = (losses[1:n + 1] - losses[n + 1:]) / (upper - lower)
+        return float(losses[0]), gradient
+
+    # ------------------------------------------------------------------
+
+    def fit(self, max_iterations: int = 200, tolerance: float = 1e-10,
+            start: Optional[Dict[str, float]] = None) -> CalibrationResult:
+        """
+        Bounded L-BFGS-B fit in the unit cube.
+
+        Args:
+            max_iterations: Maximum optimizer iterations
+            tolerance: Relative loss reduction at which to stop
+            start: Starting values by parameter name (default: the constants)
+        """
+        from scipy.optimize import minimize
+
+        begin = time.perf_counter()
+        self.evaluations = 0
+        unit0 = self.initial_unit()
+        if start:
+            unit0 = np.array([p.to_unit(start.get(p.name, self.constants.values[p.name])) for p in self.parameters])
+        initial_loss, _ = self.value_and_gradient(unit0)
+
+        outcome = minimize(self.value_and_gradient, unit0, jac=True, method='L-BFGS-B',
+                           bounds=[(0.0, 1.0)] * len(self.parameters),
+                           options={'maxiter': max_iterations, 'ftol': tolerance})
+        unit = np.clip(outcome.x, 0.0, 1.0)
+        result = CalibrationResult(
+            parameters=self.parameters,
+            values={p.name: float(p.from_unit(unit[i])) for i, p in enumerate(self.parameters)},
+            initial_values={p.name: float(p.from_unit(unit0[i])) for i, p in enumerate(self.parameters)},
+            loss=float(outcome.fun),
+            initial_loss=initial_loss,
+            iterations=int(outcome.nit),
+            evaluations=self.evaluations,
+            backend=self.backend,
+            elapsed_seconds=time.perf_counter() - begin,
+            success=bool(outcome.success),
+            message=str(outcome.message),
+        )
+        logger.info("Calibration (%s): loss %.4g -> %.4g in %d iterations, %d core evaluations",
+                    self.backend, result.initial_loss, result.loss, result.iterations, result.evaluations)
+        return result
+
+
+def create_lettuce_calibrator(scenarios: Sequence[ScenarioSpec], observations: Observations,
+                              config: Optional['ConfigSnapshot'] = None,
+                              **options) -> CoreCalibrator:
+    """
+    Calibrator for batch scenarios of one cultivar, configured from the JSON
+    config (environment.CALIBRATION: PARAMETERS, BOUNDS, WEIGHTS, BACKEND).
+    """
+    from .utils.config_loader import get_config_snapshot
+    calibration_config = dict((config or get_config_snapshot()).environment.get('CALIBRATION', {}))
+
+    simulator = scenario_simulator(scenarios[0])
+    constants = CoreConstants.from_simulator(simulator)
+    days = observations.fresh_weight.shape[1]
+    drivers = SiteDrivers.from_scenarios(scenarios, days, simulator)
+
+    if 'parameters' not in options:
+        bounds = calibration_config.get('BOUNDS', {})
+        names = calibration_config.get('PARAMETERS', DEFAULT_CALIBRATION_PARAMETERS)
+        options['parameters'] = [CalibrationParameter.named(name, bounds.get(name)) for name in names]
+    options.setdefault('weights', calibration_config.get('WEIGHTS'))
+    options.setdefault('backend', calibration_config.get('BACKEND'))
+    return CoreCalibrator(constants, drivers, observations, **options)
+
+
+def demonstrate_calibration():
+    """Recover perturbed parameters of the core from simulator trajectories."""
+    from .batch_runner import run_batch
+
+    print("=" * 80)
+    print("PARAMETER CALIBRATION DEMONSTRATION")
+    print("=" * 80)
+
+    days = 35
+    scenarios = [ScenarioSpec(max_days=days, weather_seed=seed) for seed in range(3)]
+    batch = sorted(run_batch(scenarios, keep_results=True), key=lambda r: r.index)
+    observations = Observations.from_results([r.results for r in batch if r.ok], days)
+    calibrator = create_lettuce_calibrator([r.scenario for r in batch if r.ok], observations)
+
+    # Start away from the simulator's values
+    start = {p.name: p.lower + 0.25 * (p.upper - p.lower) for p in calibrator.parameters}
+    result = calibrator.fit(start=start)
+
+    print(f"Backend: {result.backend}, sites: {calibrator.drivers.n_sites}, days: {days}")
+    print(f"Loss: {result.initial_loss:.4g} -> {result.loss:.4g} "
+          f"({result.iterations} iterations, {result.evaluations} core evaluations, "
+          f"{result.elapsed_seconds:.2f} s)")
+    print(f"\n{'Parameter':<38} {'Start':>10} {'Fitted':>10} {'Simulator':>10}")
+    print("-" * 80)
+    for name, value in result.values.items():
+        print(f"{name:<38} {result.initial_values[name]:>10.4g} {value:>10.4g} "
+              f"{calibrator.constants.values[name]:>10.4g}")
+
+    simulated = calibrator.simulate(result.values)
+    final = {name: (simulated[name][:, -1].mean(), getattr(observations, name)[:, -1].mean()) for name in TARGETS}
+    print("\nDay-{} means (core / simulator): ".format(days) +
+          ", ".join(f"{name} {core:.2f} / {observed:.2f}" for name, (core, observed) in final.items()))
+
+
+if __name__ == "__main__":
+    demonstrate_calibration()
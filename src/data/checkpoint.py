@@ -0,0 +1,146 @@
+"""
+Simulator Checkpoints
+Compact snapshots of the complete mutable simulator state at the end of a day.
+
+A checkpoint carries everything a run accumulates: biomass pools, leaf and
+senescence cohorts, root cohorts per zone, nitrogen organ states, stress
+memory and acclimation, the solution state of the run loop (tank volume,
+nutrient concentrations, pH) and the daily results written so far.
+run_simulation(resume_from=checkpoint) continues with the next day, so a
+shared prefix of days can fan out into many what-if branches without being
+recomputed.
+
+Objects that are shared rather than simulated (configuration, parameters,
+genetic tables) are pickled as references and resolved against the simulator
+the checkpoint is restored into, which keeps checkpoints small; the state
+itself is pickled and zlib-compressed.
+
+Checkpoints are trusted input: loading one unpickles it, and unpickling can
+execute arbitrary code. Only resume from checkpoint files this simulator (or
+someone you trust) wrote; never from uploads or other untrusted sources.
+"""
+
+import io
+import pickle
+import zlib
+from dataclasses import dataclass, field, replace
+from pathlib import Path
+from typing import Any, Dict, Optional, Tuple
+
+CHECKPOINT_FORMAT = 2
+
+SharedReferences = Dict[Tuple[str, ...], Any]
+
+
+@dataclass
+class RunLoopState:
+    """Solution state of the run loop after the checkpointed day."""
+    day: int                                   # Last completed day
+    tank_volume: float                         # L
+    concentrations: Dict[str, float] = field(default_factory=dict)  # mg/L
+    ph: float = 6.0
+    maturity_reached: bool = False
+
+
+class _ReferencePickler(pickle.Pickler):
+    def __init__(self, file, shared: SharedReferences):
+        super().__init__(file, protocol=pickle.HIGHEST_PROTOCOL)
+        self._paths: Dict[int, Tuple[str, ...]] = {}
+        for path, obj in shared.items():
+            self._paths.setdefault(id(obj), path)
+
+    def persistent_id(self, obj):
+        return self._paths.get(id(obj))
+
+
+class _ReferenceUnpickler(pickle.Unpickler):
+    def __init__(self, file, shared: SharedReferences):
+        super().__init__(file)
+        self._shared = shared
+
+    def persistent_load(self, path):
+        try:
+            return self._shared[tuple(path)]
+        except KeyError:
+            raise pickle.UnpicklingError(f"Checkpoint references {'.'.join(path)}, "
+                                         f"which this simulator does not have")
+
+
+def encode_state(state: Any, shared: SharedReferences, level: int = 6) -> bytes:
+    """Compressed pickle of state, with the shared objects stored as references."""
+    buffer = io.BytesIO()
+    _ReferencePickler(buffer, shared).dump(state)
+    return zlib.compress(buffer.getvalue(), level)
+
+
+def decode_state(blob: bytes, shared: SharedReferences) -> Any:
+    """Inverse of encode_state, resolving references against `shared`."""
+    return _ReferenceUnpickler(io.BytesIO(zlib.decompress(blob)), shared).load()
+
+
+@dataclass
+class SimulationCheckpoint:
+    """
+    Mutable simulator state at the end of one day.
+
+    Attributes:
+        day: Last completed day (a resumed run starts at day + 1)
+        cultivar_id: Cultivar of the checkpointed simulator
+        config_hash: SHA-256 of the configuration file it ran with
+        system_type: Root model system type (HydroponicSystemType name, e.g. 'NFT')
+        tank_volume: Configured tank volume of the system (L)
+        loop: Solution state of the run loop
+        state: Compressed model state and daily results (see encode_state)
+    """
+    day: int
+    cultivar_id: str
+    config_hash: str
+    system_type: str
+    tank_volume: float
+    loop: RunLoopState
+    state: bytes
+    format: int = CHECKPOINT_FORMAT
+
+    @property
+    def size_bytes(self) -> int:
+        return len(self.state)
+
+    def with_solution(self, concentrations: Optional[Dict[str, float]] = None,
+                      tank_volume: Optional[float] = None,
+                      ph: Optional[float] = None) -> 'SimulationCheckpoint':
+        """Branch with a changed nutrient solution from the next day on."""
+        loop = replace(
+            self.loop,
+            concentrations={**self.loop.concentrations, **(concentrations or {})},
+            tank_volume=self.loop.tank_volume if tank_volume is None else tank_volume,
+            ph=self.loop.ph if ph is None else ph
+        )
+        return replace(self, loop=loop)
+
+    def to_bytes(self) -> bytes:
+        return pickle.dumps(self, protocol=pickle.HIGHEST_PROTOCOL)
+
+    @classmethod
+    def from_bytes(cls, data: bytes) -> 'SimulationCheckpoint':
+        """Unpickle a checkpoint. Trusted input only: unpickling can execute code."""
+        checkpoint = pickle.loads(data)
+        if not isinstance(checkpoint, cls):
+            raise ValueError("Not a simulation checkpoint")
+        if checkpoint.format != CHECKPOINT_FORMAT:
+            raise ValueError(f"Unsupported checkpoint format {checkpoint.format}")
+        return checkpoint
+
+    def save(self, path: str) -> Path:
+        path = Path(path)
+        path.parent.mkdir(parents=True, exist_ok=True)
+        path.write_bytes(self.to_bytes())
+        return path
+
+    @classmethod
+    def load(cls, path: str) -> 'SimulationCheckpoint':
+        """Read a checkpoint file (trusted input only, see from_bytes)."""
+        return cls.from_bytes(Path(path).read_bytes())
+
+    def __repr__(self) -> str:
+        return (f"SimulationCheckpoint(day={self.day}, cultivar={self.cultivar_id!r}, "
+                f"system={self.system_type}, {self.size_bytes / 1024:.1f} KiB)")
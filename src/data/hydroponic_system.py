@@ -3,7 +3,7 @@ Hydroponic System Data Classes and Configuration
 """
 
 from dataclasses import dataclass, field
-from typing import Dict, List, Optional
+from typing import Any, Dict, List, Optional, Sequence
 from datetime import datetime
 import pandas as pd
 
@@ -52,9 +52,12 @@ class HydroInputData:
     """Complete input data for hydroponic simulation."""
     system_config: HydroSystemConfig
     crop_params: CropParameters
-    weather_data: List[WeatherData]
+    weather_data: Sequence[WeatherData]  # List[WeatherData] or a columnar WeatherSeries
     nutrient_params: Dict = field(default_factory=dict)
     simulation_days: int = 30
+    photoperiod_hours: Optional[float] = None  # Constant photoperiod (sole-source lighting); None: seasonal
+    solution_strength: float = 1.0  # Multiplier of the fresh solution concentrations (sets the EC)
+    random_seed: Optional[int] = None  # Seed of the root cohort draws; None: fresh entropy every run
 
 
 @dataclass
@@ -238,11 +241,20 @@ class SimulationResults:
     start_date: datetime
     end_date: datetime
     total_days: int
-    daily_results: List[DailyResults]
+    daily_results: Sequence[DailyResults]
     summary_stats: Dict = field(default_factory=dict)
+    store: Optional[Any] = None  # ColumnarResultsStore backing daily_results, if any
     
-    def to_dataframe(self) -> pd.DataFrame:
-        """Convert results to pandas DataFrame for analysis."""
+    def to_dataframe(self, round_floats: bool = True) -> pd.DataFrame:
+        """
+        Convert results to pandas DataFrame for analysis.
+
+        With a columnar store the frame is built from its column arrays;
+        round_floats=False then returns unrounded views without copying.
+        """
+        if self.store is not None:
+            return self.store.to_dataframe(self.system_id, self.crop_id, round_floats=round_floats)
+
         data = []
         for result in self.daily_results:
             row = {
@@ -303,7 +315,7 @@ class SimulationResults:
                 'Tank_Volume_L': 2,
             }
             for key, value in row.items():
-                if isinstance(value, float):
+                if round_floats and isinstance(value, float):
                     decimals = precision_overrides.get(key, 2)
                     row[key] = round(value, decimals)
 
@@ -313,6 +325,10 @@ class SimulationResults:
     
     def calculate_summary_stats(self):
         """Calculate summary statistics for the simulation."""
+        if self.store is not None:
+            self.summary_stats = self.store.summary_stats(self.total_days)
+            return
+
         df = self.to_dataframe()
         
         self.summary_stats = {
@@ -0,0 +1,382 @@
+"""
+Columnar Results Store
+Preallocated per-field arrays for daily simulation outputs.
+
+The simulator writes each day's values straight into NumPy columns sized to the
+maximum simulation length, so a run holds one contiguous array per output
+variable instead of one DailyResults object (and nutrient dict) per day.
+DataFrames and summary statistics are built from views of these columns, and
+DailyResults objects are only materialized when they are accessed.
+"""
+
+import dataclasses
+import typing
+from collections.abc import Sequence as SequenceABC
+from datetime import datetime
+from typing import Any, Dict, Iterator, List, Optional, Sequence
+
+import numpy as np
+import pandas as pd
+
+from .hydroponic_system import DailyResults
+
+
+# DataFrame column name -> DailyResults field (same layout as SimulationResults.to_dataframe)
+DATAFRAME_COLUMNS = [
+    ('Day', 'day'),
+    ('ETO_Ref_mm', 'eto_ref'),
+    ('ETC_Prime_mm', 'etc_prime'),
+    ('Transpiration_mm', 'transpiration'),
+    ('Water_Total_L', 'water_uptake_total'),
+    ('Tank_Volume_L', 'tank_volume'),
+    ('Temp_C', 'temp_avg'),
+    ('Solar_Rad_MJ', 'solar_radiation'),
+    ('VPD_kPa', 'vpd'),
+    ('WUE_kg_m3', 'water_use_efficiency'),
+    ('pH', 'ph'),
+    ('EC', 'ec'),
+    ('RZT_C', 'rzt'),
+    ('RZT_Growth_Factor', 'rzt_growth_factor'),
+    ('RZT_Nutrient_Factor', 'rzt_nutrient_factor'),
+    ('V_Stage', 'v_stage'),
+    ('Leaf_Number', 'leaf_number'),
+    ('Leaf_Area_m2', 'leaf_area_m2'),
+    ('Avg_Leaf_Area_cm2', 'average_leaf_area_cm2'),
+    ('CO2_umol_mol', 'co2_concentration'),
+    ('VPD_Actual_kPa', 'vpd_actual'),
+    ('Env_Photo_Factor', 'env_photosynthesis_factor'),
+    ('Env_Transp_Factor', 'env_transpiration_factor'),
+]
+
+# Optional crop variables appended after the nutrient columns when present
+OPTIONAL_DATAFRAME_COLUMNS = [
+    ('LAI', 'lai'),
+    ('Height_m', 'height'),
+    ('Kcb_dynamic', 'kcb_dynamic'),
+    ('Growth_Stage', 'growth_stage'),
+    ('Total_Biomass_g', 'total_biomass'),
+    ('Fresh_Weight_g', 'fresh_weight'),
+]
+
+PRECISION_OVERRIDES = {
+    'WUE_kg_m3': 3,
+    'Leaf_Area_m2': 3,
+    'LAI': 3,
+    'EC': 2,
+    'pH': 2,
+    'Water_Total_L': 2,
+    'Tank_Volume_L': 2,
+}
+
+
+def _field_dtype(annotation) -> Any:
+    """NumPy dtype for a DailyResults field annotation."""
+    if annotation in (float, 'float'):
+        return np.float64
+    if annotation in (int, 'int'):
+        return np.int64
+    if annotation in (bool, 'bool'):
+        return np.bool_
+    return object
+
+
+class DailyResultsRow:
+    """
+    Attribute view of one day in a ColumnarResultsStore.
+
+    Behaves like a DailyResults instance for reading and writing attributes,
+    but the values live in the store's columns.
+    """
+
+    __slots__ = ('_store', '_index')
+
+    def __init__(self, store: 'ColumnarResultsStore', index: int):
+        object.__setattr__(self, '_store', store)
+        object.__setattr__(self, '_index', index)
+
+    def __getattr__(self, name: str) -> Any:
+        return self._store.get_value(self._index, name)
+
+    def __setattr__(self, name: str, value: Any):
+        self._store.set_value(self._index, name, value)
+
+    def to_daily_results(self) -> DailyResults:
+        return self._store.to_daily_results(self._index)
+
+    def __repr__(self) -> str:
+        return f"DailyResultsRow(day={self.day})"
+
+
+class LazyDailyResults(SequenceABC):
+    """Read-only sequence of DailyResults materialized on first access."""
+
+    def __init__(self, store: 'ColumnarResultsStore'):
+        self._store = store
+        self._cache: Dict[int, DailyResults] = {}
+
+    def __len__(self) -> int:
+        return self._store.n_days
+
+    def __getitem__(self, index):
+        if isinstance(index, slice):
+            return [self[i] for i in range(*index.indices(len(self)))]
+        n = len(self)
+        if index < 0:
+            index += n
+        if not 0 <= index < n:
+            raise IndexError("daily results index out of range")
+        result = self._cache.get(index)
+        if result is None:
+            result = self._store.to_daily_results(index)
+            self._cache[index] = result
+        return result
+
+    def __iter__(self) -> Iterator[DailyResults]:
+        for i in range(len(self)):
+            yield self[i]
+
+
+class ColumnarResultsStore:
+    """Preallocated column arrays holding the daily outputs of one simulation."""
+
+    def __init__(self, capacity: int, nutrient_ids: Sequence[str] = ()):
+        self.capacity = max(1, int(capacity))
+        self.n_days = 0
+        self.columns: Dict[str, np.ndarray] = {}
+        self.defaults: Dict[str, Any] = {}
+        self.dynamic_set: Dict[str, np.ndarray] = {}  # Attributes beyond the DailyResults fields
+
+        hints = typing.get_type_hints(DailyResults)
+        for f in dataclasses.fields(DailyResults):
+            if f.name == 'nutrient_concentrations':
+                continue
+            if f.name == 'date':
+                self.columns['date'] = np.empty(self.capacity, dtype=object)
+                continue
+            dtype = _field_dtype(hints.get(f.name, f.type))
+            if f.default is not dataclasses.MISSING:
+                default = f.default
+            elif f.default_factory is not dataclasses.MISSING:
+                default = None  # Per-row default (e.g. dict) created on materialization
+            else:
+                default = 0 if dtype is not object else None
+            self.defaults[f.name] = default
+            self.columns[f.name] = self._allocate(dtype, default)
+        self.required_fields = [f.name for f in dataclasses.fields(DailyResults)
+                                if f.default is dataclasses.MISSING and f.default_factory is dataclasses.MISSING]
+
+        self.nutrient_ids: List[str] = list(nutrient_ids)
+        self.nutrients = np.full((self.capacity, len(self.nutrient_ids)), np.nan)
+
+    # ------------------------------------------------------------------
+    # Writing
+    # ------------------------------------------------------------------
+
+    def _allocate(self, dtype, default, capacity: Optional[int] = None) -> np.ndarray:
+        capacity = capacity or self.capacity
+        if dtype is object:
+            array = np.empty(capacity, dtype=object)
+            array[:] = default
+            return array
+        return np.full(capacity, default, dtype=dtype)
+
+    def _grow(self, minimum: int):
+        """Double the capacity (only when a run exceeds its preallocated size)."""
+        new_capacity = max(minimum, self.capacity * 2)
+        for name, column in self.columns.items():
+            extra = self._allocate(column.dtype if column.dtype != object else object,
+                                   self.defaults.get(name), new_capacity - self.capacity)
+            self.columns[name] = np.concatenate([column, extra])
+        for name, mask in self.dynamic_set.items():
+            self.dynamic_set[name] = np.concatenate([mask, np.zeros(new_capacity - self.capacity, dtype=bool)])
+        self.nutrients = np.concatenate(
+            [self.nutrients, np.full((new_capacity - self.capacity, self.nutrients.shape[1]), np.nan)])
+        self.capacity = new_capacity
+
+    def new_row(self, **values) -> DailyResultsRow:
+        """Append a day and write the given field values into it."""
+        index = self.n_days
+        if index >= self.capacity:
+            self._grow(index + 1)
+        self.n_days += 1
+        row = DailyResultsRow(self, index)
+        for name, value in values.items():
+            self.set_value(index, name, value)
+        return row
+
+    def set_value(self, index: int, name: str, value: Any):
+        if name == 'nutrient_concentrations':
+            self._set_nutrients(index, value)
+            return
+        column = self.columns.get(name)
+        if column is None:
+            column = self._add_dynamic_column(name, value)
+        if column.dtype == np.int64 and isinstance(value, float):
+            # Field annotated int but written as float: widen the column once
+            column = column.astype(np.float64)
+            self.columns[name] = column
+        column[index] = value
+        if name in self.dynamic_set:
+            self.dynamic_set[name][index] = True
+
+    def _add_dynamic_column(self, name: str, value: Any) -> np.ndarray:
+        if isinstance(value, (bool, np.bool_)):
+            dtype, default = np.bool_, False
+        elif isinstance(value, (int, float, np.integer, np.floating)):
+            dtype, default = np.float64, np.nan
+        else:
+            dtype, default = object, None
+        column = self._allocate(dtype, default)
+        self.columns[name] = column
+        self.defaults[name] = default
+        self.dynamic_set[name] = np.zeros(self.capacity, dtype=bool)
+        return column
+
+    def _set_nutrients(self, index: int, concentrations: Dict[str, float]):
+        for nutrient_id, value in concentrations.items():
+            if nutrient_id not in self.nutrient_ids:
+                self.nutrient_ids.append(nutrient_id)
+                self.nutrients = np.concatenate([self.nutrients, np.full((self.capacity, 1), np.nan)], axis=1)
+            self.nutrients[index, self.nutrient_ids.index(nutrient_id)] = value
+
+    def resized(self, capacity: int) -> 'ColumnarResultsStore':
+        """Copy of the written days in columns of the given capacity (at least n_days).
+
+        resized(n_days) is the compact form stored in checkpoints; a resumed run
+        resizes it back to its own maximum length.
+        """
+        n = self.n_days
+        capacity = max(1, n, int(capacity))
+        copy = object.__new__(type(self))
+        copy.capacity = capacity
+        copy.n_days = n
+        copy.defaults = dict(self.defaults)
+        copy.required_fields = list(self.required_fields)
+        copy.nutrient_ids = list(self.nutrient_ids)
+        copy.columns = {}
+        for name, column in self.columns.items():
+            array = self._allocate(column.dtype if column.dtype != object else object,
+                                   self.defaults.get(name), capacity)
+            array[:n] = column[:n]
+            copy.columns[name] = array
+        copy.dynamic_set = {}
+        for name, mask in self.dynamic_set.items():
+            copy.dynamic_set[name] = np.zeros(capacity, dtype=bool)
+            copy.dynamic_set[name][:n] = mask[:n]
+        copy.nutrients = np.full((capacity, len(copy.nutrient_ids)), np.nan)
+        copy.nutrients[:n] = self.nutrients[:n]
+        return copy
+
+    # ------------------------------------------------------------------
+    # Reading
+    # ------------------------------------------------------------------
+
+    def get_value(self, index: int, name: str) -> Any:
+        if name == 'nutrient_concentrations':
+            return self.nutrient_row(index)
+        column = self.columns.get(name)
+        if column is None or (name in self.dynamic_set and not self.dynamic_set[name][index]):
+            raise AttributeError(name)
+        value = column[index]
+        if value is None and name in self.defaults and self.defaults[name] is None and column.dtype == object:
+            field_info = {f.name: f for f in dataclasses.fields(DailyResults)}.get(name)
+            if field_info is not None and field_info.default_factory is not dataclasses.MISSING:
+                value = field_info.default_factory()
+                column[index] = value
+        return value.item() if isinstance(value, np.generic) else value
+
+    def nutrient_row(self, index: int) -> Dict[str, float]:
+        row = self.nutrients[index]
+        return {nid: float(row[j]) for j, nid in enumerate(self.nutrient_ids) if not np.isnan(row[j])}
+
+    def column(self, name: str) -> np.ndarray:
+        """View of a column over the simulated days."""
+        return self.columns[name][:self.n_days]
+
+    def nutrient_column(self, nutrient_id: str) -> np.ndarray:
+        """View of one nutrient concentration over the simulated days."""
+        return self.nutrients[:self.n_days, self.nutrient_ids.index(nutrient_id)]
+
+    def has_column(self, name: str) -> bool:
+        if name not in self.columns:
+            return False
+        if name in self.dynamic_set:
+            return bool(self.dynamic_set[name][:self.n_days].any())
+        return True
+
+    def to_daily_results(self, index: int) -> DailyResults:
+        """Materialize one day as a DailyResults instance."""
+        if not 0 <= index < self.n_days:
+            raise IndexError("daily results index out of range")
+        kwargs = {name: self.get_value(index, name) for name in self.required_fields
+                  if name != 'nutrient_concentrations'}
+        kwargs['nutrient_concentrations'] = self.nutrient_row(index)
+        result = DailyResults(**kwargs)
+        for name in self.columns:
+            if name in kwargs:
+                continue
+            try:
+                value = self.get_value(index, name)
+            except AttributeError:
+                continue
+            setattr(result, name, value)
+        return result
+
+    def daily_results(self) -> LazyDailyResults:
+        return LazyDailyResults(self)
+
+    # ------------------------------------------------------------------
+    # Tables
+    # ------------------------------------------------------------------
+
+    def to_dataframe(self, system_id: str, crop_id: str, round_floats: bool = True) -> pd.DataFrame:
+        """
+        DataFrame in the SimulationResults.to_dataframe layout.
+
+        With round_floats=False the numeric columns are views of the store
+        (no copy); with rounding each float column is rounded in one
+        vectorized pass using the same per-column precision.
+        """
+        n = self.n_days
+        data: Dict[str, Any] = {}
+        dates = self.column('date')
+        data['Date'] = np.array([d.strftime('%Y-%m-%d') if isinstance(d, datetime) else d for d in dates],
+                                dtype=object)
+        data['Day'] = self.column('day')
+        data['System_ID'] = np.full(n, system_id, dtype=object)
+        data['Crop_ID'] = np.full(n, crop_id, dtype=object)
+        for label, name in DATAFRAME_COLUMNS[1:]:
+            data[label] = self.column(name)
+        for j, nutrient_id in enumerate(self.nutrient_ids):
+            data[f'{nutrient_id}_mg_L'] = self.nutrients[:n, j]
+        for label, name in OPTIONAL_DATAFRAME_COLUMNS:
+            if self.has_column(name):
+                data[label] = self.column(name)
+
+        if round_floats:
+            for label, values in data.items():
+                if isinstance(values, np.ndarray) and values.dtype == np.float64:
+                    data[label] = np.round(values, PRECISION_OVERRIDES.get(label, 2))
+        return pd.DataFrame(data, copy=False)
+
+    def summary_stats(self, total_days: int) -> Dict[str, Any]:
+        """Summary statistics of SimulationResults.calculate_summary_stats from column views."""
+        if self.n_days == 0:
+            return {'simulation_period_days': total_days}
+        # Same precision as the rounded DataFrame columns the row-based path summarizes
+        water = np.round(self.column('water_uptake_total'), PRECISION_OVERRIDES['Water_Total_L'])
+        tank = np.round(self.column('tank_volume'), PRECISION_OVERRIDES['Tank_Volume_L'])
+        temperature = np.round(self.column('temp_avg'), 2)
+        wue = np.round(self.column('water_use_efficiency'), PRECISION_OVERRIDES['WUE_kg_m3'])
+        return {
+            'total_water_consumption_L': float(water.sum()),
+            'average_daily_consumption_L': float(water.mean()),
+            'final_tank_volume_L': float(tank[-1]),
+            'volume_reduction_L': float(tank[0] - tank[-1]),
+            'average_eto_mm': float(np.round(self.column('eto_ref'), 2).mean()),
+            'average_transpiration_mm': float(np.round(self.column('transpiration'), 2).mean()),
+            'max_temperature_C': float(temperature.max()),
+            'min_temperature_C': float(temperature.min()),
+            'average_wue_kg_m3': float(wue.mean()),
+            'simulation_period_days': total_days
+        }
@@ -0,0 +1,221 @@
+"""
+Streaming Results Output
+Writes daily simulation outputs to Parquet (or Arrow IPC) in row groups while
+a run is in progress.
+
+Every `row_group_days` simulated days the writer takes the new rows from the
+run's ColumnarResultsStore, flattens nested dictionaries (nutrient
+concentrations, stress interactions, acclimation and damage by stress type)
+into typed scalar columns and appends one compressed row group. The writer
+never buffers more than one row group.
+
+Only the Arrow IPC stream format (.arrows/.arrow/.ipc, read with
+pyarrow.ipc.open_stream) and CSV can be consumed while the simulation
+continues: each row group is a complete record batch or block of lines as
+soon as it is written. A Parquet file is readable only after close(), which
+writes its footer.
+
+Without pyarrow the same flattened columns are appended to a CSV file.
+"""
+
+import csv
+import json
+import logging
+from datetime import datetime
+from pathlib import Path
+from typing import Any, Dict, List, Optional
+
+import numpy as np
+
+try:
+    import pyarrow as pa
+    import pyarrow.parquet as pq
+    import pyarrow.ipc as pa_ipc
+    PYARROW_AVAILABLE = True
+except ImportError:
+    pa = None
+    pq = None
+    pa_ipc = None
+    PYARROW_AVAILABLE = False
+
+from .results_store import ColumnarResultsStore
+
+logger = logging.getLogger(__name__)
+
+FORMAT_PARQUET = "parquet"
+FORMAT_ARROW = "arrow"
+FORMAT_CSV = "csv"
+
+ARROW_SUFFIXES = {'.arrows', '.arrow', '.ipc'}
+
+
+def flatten_store_rows(store: ColumnarResultsStore, start: int, end: int) -> Dict[str, np.ndarray]:
+    """
+    Typed, flat columns for rows [start, end) of a results store.
+
+    Numeric and boolean columns are slices of the store; string fields become
+    object arrays; dictionary fields are expanded to one float column per key
+    (`<field>_<key>`); nutrient concentrations become `<nutrient>_mg_L`.
+    """
+    columns: Dict[str, np.ndarray] = {}
+    for name, column in store.columns.items():
+        values = column[start:end]
+        if name == 'date':
+            columns[name] = np.array([v if isinstance(v, datetime) else None for v in values], dtype=object)
+        elif column.dtype != object:
+            columns[name] = values
+        else:
+            sample = next((v for v in values if v is not None), None)
+            if isinstance(sample, dict):
+                keys = sorted({key for v in values if isinstance(v, dict) for key in v})
+                for key in keys:
+                    columns[f'{name}_{key}'] = np.array(
+                        [float(v.get(key, np.nan)) if isinstance(v, dict) else np.nan for v in values])
+            elif isinstance(sample, (list, tuple)):
+                columns[name] = np.array([json.dumps(list(v)) if v is not None else None for v in values],
+                                         dtype=object)
+            elif sample is not None:
+                columns[name] = np.array([str(v) if v is not None else None for v in values], dtype=object)
+    for j, nutrient_id in enumerate(store.nutrient_ids):
+        columns[f'{nutrient_id}_mg_L'] = store.nutrients[start:end, j]
+    return columns
+
+
+def _arrow_type(values: np.ndarray):
+    if values.dtype == np.bool_:
+        return pa.bool_()
+    if values.dtype.kind in 'iu':
+        return pa.int64()
+    if values.dtype.kind == 'f':
+        return pa.float64()
+    sample = next((v for v in values if v is not None), None)
+    if isinstance(sample, datetime):
+        return pa.timestamp('ms')
+    return pa.string()
+
+
+class StreamingResultsWriter:
+    """
+    Incremental writer of daily results.
+
+    The schema is fixed by the first row group: columns missing from a later
+    group are written as nulls, and a column that only appears later (e.g. a
+    stress key first reported mid-run) raises ValueError rather than being
+    dropped from the output.
+    """
+
+    def __init__(self, path: str, row_group_days: int = 30, output_format: Optional[str] = None,
+                 compression: str = "zstd"):
+        self.path = Path(path)
+        self.row_group_days = max(1, int(row_group_days))
+        self.compression = compression
+        self.output_format = output_format or self._infer_format(self.path)
+        if self.output_format in (FORMAT_PARQUET, FORMAT_ARROW) and not PYARROW_AVAILABLE:
+            logger.warning("pyarrow not available; streaming results as CSV instead")
+            self.output_format = FORMAT_CSV
+            self.path = self.path.with_suffix('.csv')
+
+        self.rows_written = 0
+        self.row_groups_written = 0
+        self._schema = None
+        self._column_names: Optional[List[str]] = None
+        self._writer = None
+        self._csv_file = None
+        self._csv_writer = None
+
+    @staticmethod
+    def _infer_format(path: Path) -> str:
+        suffix = path.suffix.lower()
+        if suffix in ARROW_SUFFIXES:
+            return FORMAT_ARROW
+        if suffix == '.csv':
+            return FORMAT_CSV
+        return FORMAT_PARQUET
+
+    def append(self, store: ColumnarResultsStore):
+        """Write a row group once a full group of unwritten days has accumulated."""
+        while store.n_days - self.rows_written >= self.row_group_days:
+            self._write_rows(store, self.rows_written, self.rows_written + self.row_group_days)
+
+    def flush(self, store: ColumnarResultsStore):
+        """Write all remaining days (the final, possibly partial, row group)."""
+        if store.n_days > self.rows_written:
+            self._write_rows(store, self.rows_written, store.n_days)
+
+    def close(self):
+        if self._writer is not None:
+            self._writer.close()
+            self._writer = None
+        if self._csv_file is not None:
+            self._csv_file.close()
+            self._csv_file = None
+            self._csv_writer = None
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, exc_type, exc, tb):
+        self.close()
+
+    def _aligned_columns(self, columns: Dict[str, np.ndarray], n_rows: int) -> Dict[str, np.ndarray]:
+        """Columns in first-group order (missing ones as nulls)."""
+        extra = set(columns) - set(self._column_names)
+        if extra:
+            raise ValueError(f"Row group {self.row_groups_written + 1} of {self.path} has columns not in "
+                             f"the schema fixed by the first row group: {sorted(extra)}")
+        aligned = {}
+        for name in self._column_names:
+            values = columns.get(name)
+            aligned[name] = values if values is not None else np.full(n_rows, None, dtype=object)
+        return aligned
+
+    def _write_rows(self, store: ColumnarResultsStore, start: int, end: int):
+        columns = flatten_store_rows(store, start, end)
+        if self._column_names is None:
+            self._column_names = list(columns)
+        columns = self._aligned_columns(columns, end - start)
+
+        if self.output_format == FORMAT_CSV:
+            self._write_csv(columns)
+        else:
+            self._write_arrow(columns)
+
+        self.rows_written = end
+        self.row_groups_written += 1
+        logger.debug(f"Wrote row group {self.row_groups_written} (days {start + 1}-{end}) to {self.path}")
+
+    def _write_arrow(self, columns: Dict[str, np.ndarray]):
+        if self._schema is None:
+            self._schema = pa.schema([(name, _arrow_type(values)) for name, values in columns.items()])
+            self.path.parent.mkdir(parents=True, exist_ok=True)
+            if self.output_format == FORMAT_ARROW:
+                options = pa_ipc.IpcWriteOptions(compression=self.compression)
+                self._writer = pa_ipc.new_stream(str(self.path), self._schema, options=options)
+            else:
+                self._writer = pq.ParquetWriter(str(self.path), self._schema, compression=self.compression)
+
+        arrays = []
+        for schema_field in self._schema:
+            values = columns[schema_field.name]
+            if values.dtype == object:
+                values = values.tolist()
+            arrays.append(pa.array(values, type=schema_field.type, from_pandas=True))
+        table = pa.Table.from_arrays(arrays, schema=self._schema)
+        self._writer.write_table(table)
+
+    def _write_csv(self, columns: Dict[str, np.ndarray]):
+        if self._csv_file is None:
+            self.path.parent.mkdir(parents=True, exist_ok=True)
+            self._csv_file = open(self.path, 'w', newline='')
+            self._csv_writer = csv.writer(self._csv_file)
+            self._csv_writer.writerow(self._column_names)
+        rows = zip(*[self._csv_values(values) for values in columns.values()])
+        self._csv_writer.writerows(rows)
+        self._csv_file.flush()
+
+    @staticmethod
+    def _csv_values(values: np.ndarray) -> List[Any]:
+        if values.dtype == object:
+            return ['' if v is None else (v.isoformat() if isinstance(v, datetime) else v) for v in values]
+        return values.tolist()
+
@@ -0,0 +1,136 @@
+"""
+Columnar Weather Series
+Daily weather held as one array per variable instead of one WeatherData per day.
+
+WeatherSeries is a drop-in Sequence[WeatherData] (indexing materializes a
+single day on demand), while the simulator and the ensemble engine read its
+column arrays directly. WeatherBlock holds a scenario × day block of the same
+columns, as produced by one vectorized WeatherGenerator call.
+"""
+
+from dataclasses import dataclass
+from datetime import datetime, timedelta
+from typing import Dict, List, Optional, Sequence
+
+import numpy as np
+
+from .hydroponic_system import WeatherData
+
+
+WEATHER_COLUMNS = ('temp_avg', 'temp_min', 'temp_max', 'solar_radiation',
+                   'rel_humidity', 'wind_speed', 'rainfall')
+
+
+@dataclass
+class WeatherSeries:
+    """Daily weather columns for one site/scenario (arrays of equal length)."""
+    start_date: datetime
+    temp_avg: np.ndarray         # °C
+    temp_min: np.ndarray         # °C
+    temp_max: np.ndarray         # °C
+    solar_radiation: np.ndarray  # MJ/m²/day
+    rel_humidity: np.ndarray     # %
+    wind_speed: np.ndarray       # m/s
+    rainfall: np.ndarray         # mm
+    location: str = "USGA"
+    dates: Optional[Sequence[datetime]] = None  # Explicit dates (default: consecutive days from start_date)
+
+    def __len__(self) -> int:
+        return len(self.temp_avg)
+
+    def __getitem__(self, index):
+        if isinstance(index, slice):
+            start, stop, step = index.indices(len(self))
+            if step != 1:
+                raise ValueError("WeatherSeries slices must be contiguous")
+            return WeatherSeries(
+                start_date=self.date(start) if start < len(self) else self.start_date,
+                location=self.location,
+                dates=self.dates[start:stop] if self.dates is not None else None,
+                **{name: getattr(self, name)[start:stop] for name in WEATHER_COLUMNS}
+            )
+        n = len(self)
+        if index < 0:
+            index += n
+        if not 0 <= index < n:
+            raise IndexError("weather series index out of range")
+        return WeatherData(date=self.date(index),
+                           **{name: float(getattr(self, name)[index]) for name in WEATHER_COLUMNS})
+
+    def __iter__(self):
+        for i in range(len(self)):
+            yield self[i]
+
+    def date(self, index: int) -> datetime:
+        if self.dates is not None:
+            return self.dates[index]
+        return self.start_date + timedelta(days=index)
+
+    def columns(self) -> Dict[str, np.ndarray]:
+        return {name: getattr(self, name) for name in WEATHER_COLUMNS}
+
+    def with_temperature_offset(self, offset: float) -> 'WeatherSeries':
+        """Copy with all temperature columns shifted by `offset` °C (other columns shared)."""
+        columns = self.columns()
+        for name in ('temp_avg', 'temp_min', 'temp_max'):
+            columns[name] = columns[name] + offset
+        return WeatherSeries(start_date=self.start_date, location=self.location,
+                             dates=self.dates, **columns)
+
+    def to_weather_data(self) -> List[WeatherData]:
+        """Materialize every day (for code that needs a plain list)."""
+        return list(self)
+
+    @classmethod
+    def from_weather_data(cls, weather_data: Sequence[WeatherData], location: str = "USGA") -> 'WeatherSeries':
+        """Column view of a list of WeatherData (one pass, no per-day objects retained)."""
+        if isinstance(weather_data, WeatherSeries):
+            return weather_data
+        weather_data = list(weather_data)
+        if not weather_data:
+            raise ValueError("Weather series needs at least one day")
+        columns = {name: np.fromiter((getattr(w, name) for w in weather_data), dtype=float,
+                                     count=len(weather_data))
+                   for name in WEATHER_COLUMNS}
+        return cls(start_date=weather_data[0].date, location=location,
+                   dates=[w.date for w in weather_data], **columns)
+
+
+@dataclass
+class WeatherBlock:
+    """Scenario × day weather block (each column has shape (n_scenarios, days))."""
+    start_date: datetime
+    temp_avg: np.ndarray
+    temp_min: np.ndarray
+    temp_max: np.ndarray
+    solar_radiation: np.ndarray
+    rel_humidity: np.ndarray
+    wind_speed: np.ndarray
+    rainfall: np.ndarray
+    location: str = "USGA"
+
+    @property
+    def n_scenarios(self) -> int:
+        return self.temp_avg.shape[0]
+
+    @property
+    def days(self) -> int:
+        return self.temp_avg.shape[1]
+
+    def __len__(self) -> int:
+        return self.n_scenarios
+
+    def scenario(self, index: int) -> WeatherSeries:
+        """Weather of one scenario (row views, no copy)."""
+        return WeatherSeries(start_date=self.start_date, location=self.location,
+                             **{name: getattr(self, name)[index] for name in WEATHER_COLUMNS})
+
+    def __getitem__(self, index: int) -> WeatherSeries:
+        return self.scenario(index)
+
+
+def as_weather_series(weather_data) -> WeatherSeries:
+    """WeatherSeries for any supported weather input (returned as-is when already columnar)."""
+    if isinstance(weather_data, WeatherSeries):
+        return weather_data
+    return WeatherSeries.from_weather_data(weather_data)
@@ -0,0 +1,215 @@
+"""
+Memory-Mapped Weather Sources
+Historical weather read lazily from a binary column file (or Parquet) instead
+of a materialized List[WeatherData].
+
+Binary layout (.cwx):
+    8 bytes   magic b"CROPWX01"
+    4 bytes   little-endian uint32 header length
+    N bytes   UTF-8 JSON header {"site", "start_date", "columns", "n_days", "dtype"}
+    padding   to a 64-byte boundary
+    data      one contiguous little-endian float64 array per column (n_days each)
+
+MemmapWeatherSource is a WeatherSeries whose columns are views of a read-only
+memory map, so the simulator touches only the pages of the days it reads and
+concurrent runs on one machine share a single page-cached copy. Sources pickle
+by path and day window, so batch workers reopen the mapping rather than
+receiving a copy of the data.
+"""
+
+import json
+import struct
+from datetime import datetime, timedelta
+from pathlib import Path
+from typing import Any, Dict, Optional, Sequence, Tuple
+
+import numpy as np
+
+try:
+    import pyarrow as pa
+    import pyarrow.parquet as pq
+    PYARROW_AVAILABLE = True
+except ImportError:
+    pa = None
+    pq = None
+    PYARROW_AVAILABLE = False
+
+from .weather_series import WEATHER_COLUMNS, WeatherSeries, as_weather_series
+
+MAGIC = b"CROPWX01"
+ALIGNMENT = 64
+REQUIRED_COLUMNS = ('temp_avg', 'rel_humidity', 'solar_radiation')
+
+# Open mappings per process, shared by every source on the same file version
+# (keyed by resolved path, mtime and size, so a rewritten file is re-mapped)
+_MAPPED_FILES: Dict[Tuple[str, int, int], Tuple[Dict[str, Any], Dict[str, np.ndarray]]] = {}
+
+
+def _forget_mapped(resolved: str):
+    """Drop the mappings of every version of a file from the process cache."""
+    for key in [key for key in _MAPPED_FILES if key[0] == resolved]:
+        del _MAPPED_FILES[key]
+
+
+def write_weather_file(path: str, weather_data, site: Optional[str] = None) -> Path:
+    """
+    Write weather (WeatherSeries or List[WeatherData]) to a weather file.
+
+    Days are assumed consecutive from the first date. A .parquet path writes
+    Parquet with the header fields as schema metadata (requires pyarrow);
+    anything else writes the binary layout.
+    """
+    series = as_weather_series(weather_data)
+    path = Path(path)
+    path.parent.mkdir(parents=True, exist_ok=True)
+    header = {
+        'site': site or series.location,
+        'start_date': series.date(0).isoformat(),
+        'columns': list(WEATHER_COLUMNS),
+        'n_days': len(series),
+        'dtype': '<f8'
+    }
+
+    if path.suffix.lower() == '.parquet':
+        if not PYARROW_AVAILABLE:
+            raise ImportError("Writing Parquet weather files requires pyarrow")
+        table = pa.table({name: np.asarray(getattr(series, name), dtype=float) for name in WEATHER_COLUMNS})
+        metadata = {key.encode(): str(value).encode() for key, value in header.items() if key != 'columns'}
+        pq.write_table(table.replace_schema_metadata(metadata), str(path))
+        _forget_mapped(str(path.resolve()))
+        return path
+
+    header_bytes = json.dumps(header).encode('utf-8')
+    prefix = len(MAGIC) + 4 + len(header_bytes)
+    padding = (-prefix) % ALIGNMENT
+    with open(path, 'wb') as f:
+        f.write(MAGIC)
+        f.write(struct.pack('<I', len(header_bytes)))
+        f.write(header_bytes)
+        f.write(b'\0' * padding)
+        for name in WEATHER_COLUMNS:
+            f.write(np.ascontiguousarray(getattr(series, name), dtype='<f8').tobytes())
+    _forget_mapped(str(path.resolve()))
+    return path
+
+
+def _open_binary(path: Path) -> Tuple[Dict[str, Any], Dict[str, np.ndarray]]:
+    with open(path, 'rb') as f:
+        if f.read(len(MAGIC)) != MAGIC:
+            raise ValueError(f"{path} is not a CROPGRO weather file")
+        (header_length,) = struct.unpack('<I', f.read(4))
+        header = json.loads(f.read(header_length).decode('utf-8'))
+    prefix = len(MAGIC) + 4 + header_length
+    offset = prefix + (-prefix) % ALIGNMENT
+    columns = header['columns']
+    n_days = int(header['n_days'])
+    data = np.memmap(path, dtype=header.get('dtype', '<f8'), mode='r',
+                     offset=offset, shape=(len(columns), n_days))
+    return header, {name: data[i] for i, name in enumerate(columns)}
+
+
+def _open_parquet(path: Path) -> Tuple[Dict[str, Any], Dict[str, np.ndarray]]:
+    if not PYARROW_AVAILABLE:
+        raise ImportError("Reading Parquet weather files requires pyarrow")
+    table = pq.read_table(str(path), memory_map=True)
+    metadata = {key.decode(): value.decode() for key, value in (table.schema.metadata or {}).items()}
+    header = {
+        'site': metadata.get('site', path.stem),
+        'start_date': metadata.get('start_date', datetime(2024, 1, 1).isoformat()),
+        'columns': table.column_names,
+        'n_days': table.num_rows
+    }
+    # Single-chunk float columns without nulls convert without copying
+    columns = {name: table.column(name).to_numpy() for name in table.column_names}
+    return header, columns
+
+
+def open_weather_file(path: str) -> Tuple[Dict[str, Any], Dict[str, np.ndarray]]:
+    """Header and column arrays of a weather file (mapped once per process and file version)."""
+    path = Path(path)
+    resolved = path.resolve()
+    info = resolved.stat()
+    key = (str(resolved), info.st_mtime_ns, info.st_size)
+    mapped = _MAPPED_FILES.get(key)
+    if mapped is None:
+        mapped = _open_parquet(path) if path.suffix.lower() == '.parquet' else _open_binary(path)
+        missing = [name for name in REQUIRED_COLUMNS if name not in mapped[1]]
+        if missing:
+            raise ValueError(f"Weather file {path} is missing columns {missing}")
+        # Sources already open on an older version keep their own arrays
+        _forget_mapped(key[0])
+        _MAPPED_FILES[key] = mapped
+    return mapped
+
+
+class MemmapWeatherSource(WeatherSeries):
+    """
+    Lazily paged weather series backed by a weather file.
+
+    Args:
+        path: .cwx binary or .parquet weather file
+        start: First day of the window (index into the file)
+        stop: End of the window (exclusive; default: end of file)
+    """
+
+    def __init__(self, path: str, start: int = 0, stop: Optional[int] = None):
+        header, columns = open_weather_file(path)
+        n_days = int(header['n_days'])
+        stop = n_days if stop is None else min(stop, n_days)
+        if not 0 <= start < stop:
+            raise ValueError(f"Empty weather window [{start}, {stop}) in {path}")
+
+        self.path = str(path)
+        self.site = header.get('site', Path(path).stem)
+        self.window = (start, stop)
+        file_start = datetime.fromisoformat(header['start_date'])
+
+        def window(name: str, fallback: Optional[str] = None) -> np.ndarray:
+            if name in columns:
+                return columns[name][start:stop]
+            if fallback is not None:
+                return columns[fallback][start:stop]
+            return np.zeros(stop - start)
+
+        super().__init__(
+            start_date=file_start + timedelta(days=start),
+            temp_avg=window('temp_avg'),
+            temp_min=window('temp_min', 'temp_avg'),
+            temp_max=window('temp_max', 'temp_avg'),
+            solar_radiation=window('solar_radiation'),
+            rel_humidity=window('rel_humidity'),
+            wind_speed=window('wind_speed'),
+            rainfall=window('rainfall'),
+            location=self.site
+        )
+
+    def __getitem__(self, index):
+        if isinstance(index, slice):
+            start, stop, step = index.indices(len(self))
+            if step != 1:
+                raise ValueError("Weather slices must be contiguous")
+            return MemmapWeatherSource(self.path, self.window[0] + start, self.window[0] + stop)
+        return super().__getitem__(index)
+
+    def between(self, start_date: datetime, days: int) -> 'MemmapWeatherSource':
+        """Window of `days` days beginning at start_date."""
+        offset = (start_date.date() - self.start_date.date()).days
+        if offset < 0 or offset >= len(self):
+            raise ValueError(f"{start_date.date()} is outside the weather record of {self.site}")
+        return self[offset:offset + days]
+
+    def __reduce__(self):
+        # Pickle by reference: workers remap the file instead of copying its data
+        return (MemmapWeatherSource, (self.path, self.window[0], self.window[1]))
+
+    def __repr__(self) -> str:
+        return f"MemmapWeatherSource({self.path!r}, site={self.site!r}, days={len(self)})"
+
+
+def open_weather_sources(paths: Sequence[str]) -> Dict[str, MemmapWeatherSource]:
+    """Sources for several site files, keyed by site."""
+    sources = {}
+    for path in paths:
+        source = MemmapWeatherSource(path)
+        sources[source.site] = source
+    return sources
@@ -0,0 +1,579 @@
+"""
+CROPGRO Digital Twin - Incremental Simulation Fed by Live Rack Sensors
+
+Runs the simulator alongside real NFT/DWC racks. Instead of a closed batch
+loop over a weather list, each rack has a warm simulator that is advanced
+one sensor observation at a time (pH, EC, air temperature, RH, CO2, PAR and
+optionally solution temperature).
+
+The crop model integrates with a daily time step, so observations are
+aggregated into the current day (O(1) per tick: running sums, no model
+work). When the first observation of a new day arrives, the finished day is
+run through _simulate_daily_step once with its aggregated conditions, and
+the change of the plant state is returned as a delta. Measured pH and EC
+replace the modelled solution state; solution changes are reported by the
+rack instead of being scheduled weekly.
+
+Key concepts implemented:
+1. advance(observation) -> TwinDelta incremental step API
+2. Daily aggregation of sensor ticks (means, light-period PAR and CO2,
+   photoperiod from the fraction of lit ticks)
+3. Measured EC mapped onto the nutrient profile of the solution
+4. Pool of warm simulators keyed by rack, reused via reset() when a rack
+   is retired (no per-tick or per-rack model construction)
+5. asyncio ingestion front end batching observations across racks
+
+Research basis:
+- Jans-Singh et al. (2020) Digital twin of an urban-integrated hydroponic farm
+- Kocian et al. (2020) Dynamic Bayesian network for greenhouse crop monitoring
+"""
+
+import time
+import asyncio
+import logging
+from collections import defaultdict
+from dataclasses import dataclass, field
+from datetime import datetime
+from typing import Any, Callable, Dict, Iterable, List, Optional, Tuple, Union
+
+from .cropgro_hydroponic_simulator import CROPGROHydroponicSimulator
+from .models.genetic_parameters import get_shared_lettuce_genetic_system
+from .data.hydroponic_system import DailyResults, DefaultConfigurations, HydroSystemConfig
+
+logger = logging.getLogger(__name__)
+
+SECONDS_PER_DAY = 86400.0
+
+# Daily solar radiation (MJ/m²/day) to photoperiod PPFD, as in the simulator's light environment
+SOLAR_TO_PPFD = 45.0
+
+# PAR above which a tick counts as lit (μmol/m²/s)
+LIGHT_THRESHOLD_PAR = 10.0
+
+# Conditions assumed until a sensor has reported
+DEFAULT_CONDITIONS = {
+    'temperature': 22.0,       # °C
+    'humidity': 65.0,          # %
+    'solar_radiation': 15.0,   # MJ/m²/day
+    'daylength': 16.0,         # h
+    'co2_light': 400.0,        # μmol/mol
+    'co2_dark': 400.0,         # μmol/mol
+}
+
+# Fresh solution of a reported solution change (mg/L)
+FRESH_SOLUTION = {'N-NO3': 200.0, 'P-PO4': 50.0, 'K': 300.0, 'Ca': 150.0, 'Mg': 50.0}
+
+# Plant state variables reported in deltas
+STATE_FIELDS = ('total_biomass', 'leaf_biomass', 'stem_biomass', 'root_biomass',
+                'lai', 'canopy_height_cm', 'v_stage', 'accumulated_gdd', 'tank_volume')
+
+
+def _seconds(timestamp: Union[float, datetime]) -> float:
+    return timestamp.timestamp() if isinstance(timestamp, datetime) else float(timestamp)
+
+
+@dataclass
+class SensorObservation:
+    """One sensor tick of a rack (missing readings are None)."""
+    rack_id: str
+    timestamp: Union[float, datetime]           # Epoch seconds or datetime
+    ph: Optional[float] = None
+    ec: Optional[float] = None                  # dS/m
+    temperature: Optional[float] = None         # Air temperature (°C)
+    humidity: Optional[float] = None            # Relative humidity (%)
+    co2: Optional[float] = None                 # μmol/mol
+    par: Optional[float] = None                 # PPFD at canopy top (μmol/m²/s)
+    solution_temperature: Optional[float] = None  # °C
+    solution_change: bool = False               # Tank refilled with fresh solution
+
+    @classmethod
+    def from_dict(cls, record: Dict[str, Any]) -> 'SensorObservation':
+        """Observation from a decoded JSON record (unknown keys are ignored)."""
+        names = cls.__dataclass_fields__
+        return cls(**{key: value for key, value in record.items() if key in names})
+
+
+class DayAggregate:
+    """Running per-day aggregates of sensor ticks."""
+
+    SUMMED = ('ph', 'ec', 'temperature', 'humidity', 'solution_temperature')
+
+    def __init__(self):
+        self.clear()
+
+    def clear(self):
+        self.ticks = 0
+        self.sums = dict.fromkeys(self.SUMMED, 0.0)
+        self.counts = dict.fromkeys(self.SUMMED, 0)
+        self.par_ticks = 0
+        self.lit_ticks = 0
+        self.lit_par = 0.0
+        self.co2_light = [0.0, 0]
+        self.co2_dark = [0.0, 0]
+
+    def add(self, observation: SensorObservation):
+        self.ticks += 1
+        for name in self.SUMMED:
+            value = getattr(observation, name)
+            if value is not None:
+                self.sums[name] += value
+                self.counts[name] += 1
+        lit = None
+        if observation.par is not None:
+            self.par_ticks += 1
+            lit = observation.par > LIGHT_THRESHOLD_PAR
+            if lit:
+                self.lit_ticks += 1
+                self.lit_par += observation.par
+        if observation.co2 is not None:
+            bucket = self.co2_dark if lit is False else self.co2_light
+            bucket[0] += observation.co2
+            bucket[1] += 1
+
+    def mean(self, name: str) -> Optional[float]:
+        count = self.counts[name]
+        return self.sums[name] / count if count else None
+
+    def conditions(self, previous: Dict[str, float]) -> Dict[str, float]:
+        """Daily model inputs; variables no sensor reported keep the previous day's value."""
+        conditions = dict(previous)
+        for name, key in (('temperature', 'temperature'), ('humidity', 'humidity')):
+            value = self.mean(name)
+            if value is not None:
+                conditions[key] = value
+        if self.par_ticks:
+            conditions['daylength'] = 24.0 * self.lit_ticks / self.par_ticks
+            # Mean photoperiod PPFD back to the simulator's daily radiation scale
+            conditions['solar_radiation'] = (self.lit_par / self.lit_ticks / SOLAR_TO_PPFD
+                                             if self.lit_ticks else 0.0)
+        if self.co2_light[1]:
+            conditions['co2_light'] = self.co2_light[0] / self.co2_light[1]
+        if self.co2_dark[1]:
+            conditions['co2_dark'] = self.co2_dark[0] / self.co2_dark[1]
+        return conditions
+
+    def summary(self) -> Dict[str, float]:
+        summary = {name: self.mean(name) for name in self.SUMMED if self.counts[name]}
+        summary['ticks'] = self.ticks
+        return summary
+
+
+@dataclass
+class TwinDelta:
+    """Result of one advance(): the day the observation fell on and what changed."""
+    rack_id: str
+    day: int
+    days_completed: int = 0                                   # Daily steps run by this observation
+    changes: Dict[str, float] = field(default_factory=dict)   # Plant state change over those days
+    growth_stage: Optional[str] = None                        # Stage after the last completed day
+    result: Optional[DailyResults] = None                     # Last completed day
+    observed: Dict[str, float] = field(default_factory=dict)  # Running means of the current day
+
+    @property
+    def stepped(self) -> bool:
+        return self.days_completed > 0
+
+
+def plant_state(simulator: CROPGROHydroponicSimulator, tank_volume: float) -> Dict[str, float]:
+    """Plant state variables of STATE_FIELDS read from a simulator."""
+    pools = simulator.biomass_pools
+    return {
+        'total_biomass': sum(pool.dry_mass for pool in pools),
+        'leaf_biomass': pools[0].dry_mass,
+        'stem_biomass': pools[1].dry_mass,
+        'root_biomass': pools[2].dry_mass,
+        'lai': simulator.current_lai,
+        'canopy_height_cm': simulator.canopy_height * 100,
+        'v_stage': simulator.leaf_model.current_v_stage,
+        'accumulated_gdd': simulator.accumulated_gdd,
+        'tank_volume': tank_volume,
+    }
+
+
+class DigitalTwin:
+    """
+    Warm simulator of one rack, advanced by sensor observations.
+
+    Args:
+        rack_id: Rack identifier
+        simulator: Simulator in its freshly constructed (or reset) state
+        system_config: Rack system; defaults to the NFT lettuce system
+        start_time: Start of day 1 (default: the first observation)
+        nutrient_params: Nutrient parameters (default solution profile)
+    """
+
+    def __init__(self, rack_id: str, simulator: CROPGROHydroponicSimulator,
+                 system_config: Optional[HydroSystemConfig] = None,
+                 start_time: Optional[Union[float, datetime]] = None,
+                 nutrient_params: Optional[Dict[str, Any]] = None):
+        self.rack_id = rack_id
+        self.simulator = simulator
+        self.system_config = system_config or DefaultConfigurations.get_nft_lettuce_system()
+        self.nutrient_params = nutrient_params or DefaultConfigurations.get_default_nutrients()
+        self.start_time = _seconds(start_time) if start_time is not None else None
+
+        simulator.configure_system(self.system_config)
+        simulator.results_store = None
+        self.concentrations = {nutrient_id: params.initial_conc
+                               for nutrient_id, params in self.nutrient_params.items()}
+        self.ph = 6.0
+        self.tank_volume = self.system_config.tank_volume
+        self.day = 1
+        self.conditions = dict(DEFAULT_CONDITIONS)
+        self.aggregate = DayAggregate()
+        self.last_result: Optional[DailyResults] = None
+        self.step_seconds = 0.0
+
+    def day_of(self, timestamp: float) -> int:
+        return int((timestamp - self.start_time) // SECONDS_PER_DAY) + 1
+
+    def advance(self, observation: SensorObservation) -> TwinDelta:
+        """
+        Apply one observation.
+
+        Observations within the current day only update its aggregates.
+        The first observation of a later day completes every day in between
+        (days without observations repeat the last conditions) before it is
+        added to the new day. Observations older than the current day are
+        added to the current day.
+        """
+        timestamp = _seconds(observation.timestamp)
+        if self.start_time is None:
+            self.start_time = timestamp
+        day = self.day_of(timestamp)
+
+        delta = TwinDelta(self.rack_id, day=max(day, self.day))
+        if day > self.day:
+            before = plant_state(self.simulator, self.tank_volume)
+            delta.days_completed = day - self.day
+            while self.day < day:
+                self._complete_day()
+            after = plant_state(self.simulator, self.tank_volume)
+            delta.changes = {name: after[name] - before[name] for name in STATE_FIELDS}
+            delta.result = self.last_result
+            delta.growth_stage = getattr(self.last_result, 'growth_stage', None)
+
+        if observation.solution_change:
+            self._replace_solution()
+        self.aggregate.add(observation)
+        delta.observed = self.aggregate.summary()
+        return delta
+
+    def _replace_solution(self):
+        for nutrient_id, params in self.nutrient_params.items():
+            self.concentrations[nutrient_id] = FRESH_SOLUTION.get(
+                nutrient_id, getattr(params, 'recharge_conc', params.initial_conc))
+        self.ph = 6.0
+        self.tank_volume = self.system_config.tank_volume
+
+    def _measured_solution(self):
+        """Measured pH and EC replace the modelled solution state."""
+        aggregate = self.aggregate
+        ph = aggregate.mean('ph')
+        if ph is not None:
+            self.ph = ph
+        ec = aggregate.mean('ec')
+        if ec is not None:
+            modelled = self.simulator._calculate_ec(self.concentrations)
+            if modelled > 0.0:
+                scale = ec / modelled
+                for nutrient_id in self.concentrations:
+                    self.concentrations[nutrient_id] *= scale
+
+    def _complete_day(self):
+        """Run the current day with its aggregated conditions and start the next one."""
+        start = time.perf_counter()
+        simulator = self.simulator
+        conditions = self.aggregate.conditions(self.conditions)
+        self._measured_solution()
+
+        setpoints = simulator.environmental_control.setpoints
+        setpoints.target_co2 = conditions['co2_light']
+        setpoints.ambient_co2 = conditions['co2_dark']
+        solution_temperature = self.aggregate.mean('solution_temperature')
+        simulator.rzt_setpoint = solution_temperature
+
+        simulator.simulation_day = self.day
+        result = simulator._simulate_daily_step(
+            day=self.day,
+            temperature=conditions['temperature'],
+            humidity=conditions['humidity'],
+            solar_radiation=conditions['solar_radiation'],
+            daylength=conditions['daylength'],
+            nutrient_concentrations=self.concentrations,
+            ph=self.ph,
+            previous_tank_volume=self.tank_volume,
+            plant_density=simulator.plant_density
+        )
+        simulator._last_humidity = conditions['humidity']
+        simulator._last_solar = conditions['solar_radiation']
+        self.ph = simulator._update_solution(result, self.concentrations, self.ph, self.system_config.n_plants)
+        self.tank_volume = result.tank_volume
+
+        self.conditions = conditions
+        self.last_result = result
+        self.aggregate.clear()
+        self.day += 1
+        self.step_seconds += time.perf_counter() - start
+
+
+class DigitalTwinPool:
+    """
+    Warm twins of many racks.
+
+    Simulators are cloned from the process-wide prototype of their cultivar
+    and system type; a retired rack's simulator is reset and kept for the
+    next rack of the same kind.
+    """
+
+    def __init__(self):
+        self.twins: Dict[str, DigitalTwin] = {}
+        self._keys: Dict[str, Tuple[str, str]] = {}
+        self._idle: Dict[Tuple[str, str], List[CROPGROHydroponicSimulator]] = defaultdict(list)
+        self.observations = 0
+        self.days_completed = 0
+
+    def __len__(self) -> int:
+        return len(self.twins)
+
+    def __contains__(self, rack_id: str) -> bool:
+        return rack_id in self.twins
+
+    def register(self, rack_id: str, cultivar_id: str = 'HYDRO_001',
+                 system_config: Optional[HydroSystemConfig] = None,
+                 start_time: Optional[Union[float, datetime]] = None) -> DigitalTwin:
+        """Start tracking a rack (replaces an existing twin of the same id)."""
+        if rack_id in self.twins:
+            self.retire(rack_id)
+        system_config = system_config or DefaultConfigurations.get_nft_lettuce_system()
+        key = (cultivar_id, system_config.system_type)
+        idle = self._idle[key]
+        if idle:
+            simulator = idle.pop().reset()
+        else:
+            simulator = CROPGROHydroponicSimulator.from_prototype(
+                cultivar_id=cultivar_id,
+                system_type=system_config.system_type,
+                genetic_system=get_shared_lettuce_genetic_system()
+            )
+        twin = DigitalTwin(rack_id, simulator, system_config, start_time)
+        self.twins[rack_id] = twin
+        self._keys[rack_id] = key
+        return twin
+
+    def retire(self, rack_id: str) -> DigitalTwin:
+        """Stop tracking a rack; its simulator goes back to the pool."""
+        twin = self.twins.pop(rack_id)
+        self._idle[self._keys.pop(rack_id)].append(twin.simulator)
+        return twin
+
+    def advance(self, observation: SensorObservation) -> TwinDelta:
+        """Apply one observation, registering unknown racks with the default cultivar and system."""
+        twin = self.twins.get(observation.rack_id)
+        if twin is None:
+            twin = self.register(observation.rack_id)
+        delta = twin.advance(observation)
+        self.observations += 1
+        self.days_completed += delta.days_completed
+        return delta
+
+    def advance_batch(self, observations: Iterable[SensorObservation]) -> List[TwinDelta]:
+        """Apply a batch of observations (in timestamp order per rack); deltas in input order."""
+        observations = list(observations)
+        order = sorted(range(len(observations)),
+                       key=lambda i: (observations[i].rack_id, _seconds(observations[i].timestamp)))
+        deltas: List[Optional[TwinDelta]] = [None] * len(observations)
+        for i in order:
+            deltas[i] = self.advance(observations[i])
+        return deltas
+
+    def stats(self) -> Dict[str, Any]:
+        step_seconds = sum(twin.step_seconds for twin in self.twins.values())
+        plants = sum(twin.system_config.n_plants for twin in self.twins.values())
+        return {
+            'racks': len(self.twins),
+            'plants': plants,
+            'observations': self.observations,
+            'days_completed': self.days_completed,
+            'idle_simulators': sum(len(idle) for idle in self._idle.values()),
+            'step_seconds': step_seconds,
+        }
+
+
+class AsyncTwinIngestor:
+    """
+    asyncio front end of a twin pool.
+
+    Observations submitted from any number of producers are queued and
+    applied in batches: a batch closes when it holds max_batch observations
+    or max_delay seconds after its first one. Batches are applied in a
+    worker thread (one at a time, so the simulators are never shared
+    between threads) to keep the event loop responsive during daily steps.
+
+    Args:
+        pool: Twins to advance
+        max_batch: Largest number of observations per batch
+        max_delay: Longest wait for a batch to fill (s)
+        on_delta: Optional callback for every delta (called on the event loop)
+    """
+
+    def __init__(self, pool: Optional[DigitalTwinPool] = None, max_batch: int = 1024,
+                 max_delay: float = 0.05, on_delta: Optional[Callable[[TwinDelta], None]] = None):
+        self.pool = pool if pool is not None else DigitalTwinPool()
+        self.max_batch = max_batch
+        self.max_delay = max_delay
+        self.on_delta = on_delta
+        self.batches = 0
+        self._queue: asyncio.Queue = asyncio.Queue()
+        self._task: Optional[asyncio.Task] = None
+
+    async def submit(self, observation: SensorObservation) -> TwinDelta:
+        """Queue an observation and wait for its delta."""
+        future = asyncio.get_running_loop().create_future()
+        await self._queue.put((observation, future))
+        return await future
+
+    def submit_nowait(self, observation: SensorObservation) -> 'asyncio.Future':
+        """Queue an observation without waiting; the returned future resolves to its delta."""
+        future = asyncio.get_running_loop().create_future()
+        self._queue.put_nowait((observation, future))
+        return future
+
+    async def ingest(self, stream) -> int:
+        """Queue every observation of an async iterable; returns the number queued."""
+        count = 0
+        async for observation in stream:
+            self.submit_nowait(observation)
+            count += 1
+        return count
+
+    def start(self) -> 'AsyncTwinIngestor':
+        if self._task is None:
+            self._task = asyncio.get_running_loop().create_task(self.run())
+        return self
+
+    async def stop(self):
+        """Apply what is queued, then stop the batching task."""
+        if self._task is None:
+            return
+        await self._queue.join()
+        self._task.cancel()
+        try:
+            await self._task
+        except asyncio.CancelledError:
+            pass
+        self._task = None
+
+    async def _next_batch(self) -> List[Tuple[SensorObservation, 'asyncio.Future']]:
+        loop = asyncio.get_running_loop()
+        batch = [await self._queue.get()]
+        deadline = loop.time() + self.max_delay
+        while len(batch) < self.max_batch:
+            if not self._queue.empty():
+                batch.append(self._queue.get_nowait())
+                continue
+            remaining = deadline - loop.time()
+            if remaining <= 0:
+                break
+            try:
+                batch.append(await asyncio.wait_for(self._queue.get(), remaining))
+            except asyncio.TimeoutError:
+                break
+        return batch
+
+    async def run(self):
+        """Batching loop (started by start())."""
+        loop = asyncio.get_running_loop()
+        while True:
+            batch = await self._next_batch()
+            try:
+                deltas = await loop.run_in_executor(
+                    None, self.pool.advance_batch, [observation for observation, _ in batch])
+            except Exception as error:
+                logger.error(f"Twin batch of {len(batch)} observations failed: {error}")
+                for _, future in batch:
+                    if not future.done():
+                        future.set_exception(error)
+            else:
+                for (_, future), delta in zip(batch, deltas):
+                    if self.on_delta is not None:
+                        self.on_delta(delta)
+                    if not future.done():
+                        future.set_result(delta)
+            finally:
+                self.batches += 1
+                for _ in batch:
+                    self._queue.task_done()
+
+
+def create_lettuce_twin_pool(racks: Iterable[str], cultivar_id: str = 'HYDRO_001',
+                             system_config: Optional[HydroSystemConfig] = None,
+                             start_time: Optional[Union[float, datetime]] = None) -> DigitalTwinPool:
+    """Create twin pool with one warm twin per rack."""
+    pool = DigitalTwinPool()
+    for rack_id in racks:
+        pool.register(rack_id, cultivar_id, system_config, start_time)
+    return pool
+
+
+def demonstrate_digital_twin():
+    """Demonstrate a twin pool fed by synthetic 10-minute sensor ticks."""
+    import math
+    import random
+
+    print("=" * 80)
+    print("DIGITAL TWIN DEMONSTRATION")
+    print("=" * 80)
+
+    n_racks, days, tick_seconds = 8, 14, 600.0
+    start = datetime(2024, 1, 1).timestamp()
+    racks = [f"RACK{i + 1:02d}" for i in range(n_racks)]
+    pool = create_lettuce_twin_pool(racks, start_time=start)
+    rng = random.Random(1)
+
+    async def sensors():
+        ticks = int(days * SECONDS_PER_DAY / tick_seconds) + 1
+        for tick in range(ticks):
+            timestamp = start + tick * tick_seconds
+            hour = (timestamp - start) % SECONDS_PER_DAY / 3600.0
+            lit = hour < 16.0
+            for i, rack_id in enumerate(racks):
+                yield SensorObservation(
+                    rack_id=rack_id,
+                    timestamp=timestamp,
+                    ph=6.0 + rng.gauss(0.0, 0.05),
+                    ec=1.8 - 0.01 * i + rng.gauss(0.0, 0.02),
+                    temperature=22.0 + 3.0 * math.sin(math.pi * hour / 16.0 if lit else 0.0) + 0.3 * i,
+                    humidity=65.0 + rng.gauss(0.0, 2.0),
+                    co2=(800.0 if lit else 420.0) + rng.gauss(0.0, 15.0),
+                    par=250.0 + 10.0 * i if lit else 0.0,
+                    solution_change=(tick > 0 and tick % int(7 * SECONDS_PER_DAY / tick_seconds) == 0)
+                )
+
+    async def main():
+        ingestor = AsyncTwinIngestor(pool).start()
+        wall = time.perf_counter()
+        queued = await ingestor.ingest(sensors())
+        await ingestor.stop()
+        return queued, ingestor.batches, time.perf_counter() - wall
+
+    queued, batches, wall = asyncio.run(main())
+    stats = pool.stats()
+
+    print(f"{'Rack':<8} {'Day':>4} {'Stage':<10} {'Biomass (g)':>12} {'LAI':>6} {'EC':>6} {'pH':>5}")
+    print("-" * 80)
+    for rack_id in racks:
+        twin = pool.twins[rack_id]
+        result = twin.last_result
+        print(f"{rack_id:<8} {twin.day:>4} {result.growth_stage:<10} {result.total_biomass:>12.2f} "
+              f"{result.lai:>6.2f} {result.ec:>6.2f} {result.ph:>5.2f}")
+
+    print(f"\nObservations: {queued} in {batches} batches, daily steps: {stats['days_completed']}")
+    print(f"Wall time: {wall:.2f} s ({wall / queued * 1e6:.1f} μs per observation), "
+          f"daily steps {stats['step_seconds'] / max(1, stats['days_completed']) * 1e3:.2f} ms each "
+          f"({stats['step_seconds'] / max(1, stats['days_completed'] * stats['plants'] / n_racks) * 1e3:.3f} "
+          f"ms per plant-day)")
+
+
+if __name__ == "__main__":
+    demonstrate_digital_twin()
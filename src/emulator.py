@@ -0,0 +1,715 @@
+"""
+CROPGRO Emulator - Surrogate Model of the Simulator for Instant What-If Queries
+
+Answers queries like "fresh weight at harvest for EC 1.8 dS/m, RZT 22 °C,
+a 16 h photoperiod and cultivar HYDRO_002" in well under a millisecond from
+a regressor trained on simulator runs, instead of a full season run.
+
+Pipeline:
+1. Design of experiments: a Latin hypercube over the continuous controls
+   (fresh solution EC, root zone temperature setpoint, photoperiod), with
+   the cultivars stratified over the rows
+2. Dataset: every design point becomes a ScenarioSpec (solution strength,
+   constant setpoint schedule, fixed photoperiod) simulated by the parallel
+   batch runner
+3. Training: a bootstrap ensemble of small tanh MLPs on the unit-scaled
+   controls and one-hot cultivar, validated on a held-out split
+4. Serving: predictions with a standard deviation (spread of the ensemble
+   members plus the out-of-bag residual error); queries outside the training
+   envelope, or too uncertain, fall back to the full simulator
+
+Key concepts implemented:
+1. Latin hypercube design with stratified categorical factor
+2. Bootstrap MLP ensemble (NumPy, Adam) with out-of-bag noise estimate
+3. Held-out validation: R², RMSE and 95% interval coverage per output
+4. Training envelope check with simulator fallback and LRU cache
+5. Model and dataset stores tied to the configuration hash
+
+Research basis:
+- McKay, Beckman & Conover (1979) A comparison of three methods for selecting
+  values of input variables in the analysis of output from a computer code
+- Lakshminarayanan, Pritzel & Blundell (2017) Simple and scalable predictive
+  uncertainty estimation using deep ensembles
+- Kingma & Ba (2015) Adam: A method for stochastic optimization
+- Razavi, Tolson & Burn (2012) Review of surrogate modeling in water resources
+"""
+
+import os
+import json
+import time
+import hashlib
+import logging
+from collections import OrderedDict
+from dataclasses import dataclass, replace
+from pathlib import Path
+from typing import Any, Dict, List, Mapping, Optional, Sequence, Tuple, Union, TYPE_CHECKING
+
+import numpy as np
+
+from .batch_runner import ScenarioSpec, run_batch, run_scenario
+from .cropgro_hydroponic_simulator import EC_COEFFICIENTS, EC_DEFAULT_COEFFICIENT, WEEKLY_RESET_CONCENTRATIONS
+from .models.environmental_control import EnvironmentalSetpoints, SetpointSchedule
+from .models.genetic_parameters import get_shared_lettuce_genetic_system
+from .sensitivity import SENSITIVITY_OUTPUTS, sample_outputs
+from .utils.config_loader import get_config_snapshot
+
+if TYPE_CHECKING:
+    from .utils.config_loader import ConfigSnapshot
+
+logger = logging.getLogger(__name__)
+
+EMULATOR_OUTPUTS = SENSITIVITY_OUTPUTS
+
+# Continuous query controls and their default training ranges
+FEATURE_NAMES = ('ec', 'rzt', 'photoperiod')
+DEFAULT_FEATURE_BOUNDS = {
+    'ec': (0.9, 2.6),           # dS/m of the fresh solution
+    'rzt': (16.0, 28.0),        # °C root zone temperature setpoint
+    'photoperiod': (12.0, 20.0),  # h of sole-source lighting
+}
+
+STORE_FORMAT = 1
+
+
+def fresh_solution_ec(strength: float = 1.0) -> float:
+    """EC (dS/m) of the weekly replacement solution at a concentration multiplier."""
+    return strength * sum(EC_COEFFICIENTS.get(nid, EC_DEFAULT_COEFFICIENT) * conc
+                          for nid, conc in WEEKLY_RESET_CONCENTRATIONS.items())
+
+
+def latin_hypercube(n: int, dimensions: int, seed: int = 0) -> np.ndarray:
+    """(n, dimensions) Latin hypercube in the unit cube: one point per stratum and axis."""
+    rng = np.random.default_rng(seed)
+    strata = np.stack([rng.permutation(n) for _ in range(dimensions)], axis=1)
+    return (strata + rng.random((n, dimensions))) / n
+
+
+@dataclass(frozen=True)
+class EmulatorQuery:
+    """One what-if question: growing conditions and cultivar."""
+    ec: float            # dS/m of the fresh solution
+    rzt: float           # °C root zone temperature setpoint
+    photoperiod: float   # h
+    cultivar_id: str = 'HYDRO_001'
+
+    @classmethod
+    def from_dict(cls, data: Mapping[str, Any]) -> 'EmulatorQuery':
+        return cls(ec=float(data['ec']), rzt=float(data['rzt']), photoperiod=float(data['photoperiod']),
+                   cultivar_id=str(data.get('cultivar_id', 'HYDRO_001')))
+
+    def features(self) -> Tuple[float, ...]:
+        return tuple(getattr(self, name) for name in FEATURE_NAMES)
+
+
+@dataclass
+class EmulatorPrediction:
+    """Answer to one query."""
+    query: EmulatorQuery
+    outputs: Dict[str, float]
+    std: Dict[str, float]         # Predictive standard deviation (0 for simulator answers)
+    source: str                   # 'emulator', 'simulator' or 'cache'
+    in_envelope: bool
+    reason: Optional[str] = None  # Why the simulator was used
+    elapsed_ms: float = 0.0
+
+    def to_dict(self) -> Dict[str, Any]:
+        return {
+            'query': vars(self.query),
+            'outputs': self.outputs,
+            'std': self.std,
+            'source': self.source,
+            'in_envelope': self.in_envelope,
+            'reason': self.reason,
+            'elapsed_ms': self.elapsed_ms,
+        }
+
+
+class EmulatorDesign:
+    """
+    Query space of an emulator and its mapping to simulator scenarios.
+
+    Args:
+        bounds: Training range (lower, upper) of each continuous feature
+        cultivars: Cultivars the emulator answers for
+        base_scenario: Scenario every query is a variant of (system,
+            weather, horizon, target maturity)
+        target_vpd: VPD setpoint of the constant setpoint schedule (kPa)
+        target_co2: CO2 setpoint during the photoperiod (μmol/mol)
+    """
+
+    def __init__(self, bounds: Optional[Mapping[str, Sequence[float]]] = None,
+                 cultivars: Sequence[str] = ('HYDRO_001',),
+                 base_scenario: Optional[ScenarioSpec] = None,
+                 target_vpd: Optional[float] = None,
+                 target_co2: Optional[float] = None):
+        bounds = {**DEFAULT_FEATURE_BOUNDS, **(bounds or {})}
+        unknown = set(bounds) - set(FEATURE_NAMES)
+        if unknown:
+            raise ValueError(f"Unknown emulator features: {sorted(unknown)} (use {FEATURE_NAMES})")
+        self.bounds = {name: (float(bounds[name][0]), float(bounds[name][1])) for name in FEATURE_NAMES}
+        for name, (lower, upper) in self.bounds.items():
+            if not upper > lower:
+                raise ValueError(f"Emulator feature {name}: upper bound must exceed lower bound")
+        self.cultivars = tuple(cultivars)
+        if not self.cultivars:
+            raise ValueError("Emulator design needs at least one cultivar")
+        self.base_scenario = base_scenario or ScenarioSpec()
+        defaults = EnvironmentalSetpoints()
+        self.target_vpd = defaults.target_vpd if target_vpd is None else float(target_vpd)
+        self.target_co2 = defaults.target_co2 if target_co2 is None else float(target_co2)
+        self._lower = np.array([self.bounds[name][0] for name in FEATURE_NAMES])
+        self._span = np.array([self.bounds[name][1] - self.bounds[name][0] for name in FEATURE_NAMES])
+        self._cultivar_index = {cultivar_id: i for i, cultivar_id in enumerate(self.cultivars)}
+
+    @property
+    def n_inputs(self) -> int:
+        return len(FEATURE_NAMES) + len(self.cultivars)
+
+    def sample(self, n_samples: int, seed: int = 0) -> List[EmulatorQuery]:
+        """Latin hypercube queries; cultivars take turns over a shuffled row order."""
+        unit = latin_hypercube(n_samples, len(FEATURE_NAMES), seed)
+        values = self._lower + unit * self._span
+        cultivars = np.resize(np.arange(len(self.cultivars)), n_samples)
+        np.random.default_rng(seed + 1).shuffle(cultivars)
+        return [EmulatorQuery(*map(float, row), cultivar_id=self.cultivars[c])
+                for row, c in zip(values, cultivars)]
+
+    def encode(self, queries: Sequence[EmulatorQuery]) -> np.ndarray:
+        """Model inputs (queries, features + cultivars): unit-scaled controls and one-hot cultivar."""
+        x = np.zeros((len(queries), self.n_inputs))
+        if not queries:
+            return x
+        x[:, :len(FEATURE_NAMES)] = (np.array([q.features() for q in queries]) - self._lower) / self._span
+        for i, query in enumerate(queries):
+            x[i, len(FEATURE_NAMES) + self._cultivar_index[query.cultivar_id]] = 1.0
+        return x
+
+    def scenario(self, query: EmulatorQuery) -> ScenarioSpec:
+        """Simulator scenario answering a query."""
+        return replace(
+            self.base_scenario,
+            cultivar_id=query.cultivar_id,
+            photoperiod_hours=query.photoperiod,
+            solution_strength=query.ec / fresh_solution_ec(),
+            setpoint_schedule=SetpointSchedule((1,), (self.target_vpd,), (self.target_co2,), (query.rzt,)),
+            label=None
+        )
+
+    def describe(self) -> Dict[str, Any]:
+        """JSON-serializable constructor arguments (base_scenario as ScenarioSpec fields)."""
+        base = self.base_scenario
+        return {
+            'bounds': self.bounds,
+            'cultivars': self.cultivars,
+            'base_scenario': {'system_type': base.system_type, 'weather_seed': base.weather_seed,
+                              'weather_file': base.weather_file, 'max_days': base.max_days,
+                              'target_maturity': base.target_maturity, 'timestep': base.timestep,
+                              'temperature_offset': base.temperature_offset,
+                              'config_overrides': base.config_overrides},
+            'target_vpd': self.target_vpd,
+            'target_co2': self.target_co2,
+        }
+
+    @classmethod
+    def from_description(cls, description: Mapping[str, Any]) -> 'EmulatorDesign':
+        base = dict(description['base_scenario'])
+        base['config_overrides'] = tuple(tuple(item) for item in base['config_overrides'])
+        return cls(bounds=description['bounds'], cultivars=description['cultivars'],
+                   base_scenario=ScenarioSpec(**base),
+                   target_vpd=description['target_vpd'], target_co2=description['target_co2'])
+
+    def fingerprint(self) -> str:
+        spec = {'format': STORE_FORMAT, 'design': self.describe(), 'config': get_config_snapshot().source_hash}
+        return hashlib.sha256(json.dumps(spec, default=str).encode('utf-8')).hexdigest()
+
+
+@dataclass
+class TrainingEnvelope:
+    """Range of the training data: the emulator answers only inside it."""
+    lower: Dict[str, float]
+    upper: Dict[str, float]
+    cultivars: Tuple[str, ...]
+
+    @classmethod
+    def from_queries(cls, queries: Sequence[EmulatorQuery]) -> 'TrainingEnvelope':
+        values = np.array([q.features() for q in queries])
+        return cls(lower={name: float(values[:, i].min()) for i, name in enumerate(FEATURE_NAMES)},
+                   upper={name: float(values[:, i].max()) for i, name in enumerate(FEATURE_NAMES)},
+                   cultivars=tuple(sorted({q.cultivar_id for q in queries})))
+
+    def violation(self, query: EmulatorQuery) -> Optional[str]:
+        """Why a query lies outside the envelope (None inside)."""
+        if query.cultivar_id not in self.cultivars:
+            return f"cultivar {query.cultivar_id} not in the training data"
+        for name, value in zip(FEATURE_NAMES, query.features()):
+            if not self.lower[name] <= value <= self.upper[name]:
+                return f"{name}={value:g} outside the trained range [{self.lower[name]:g}, {self.upper[name]:g}]"
+        return None
+
+
+@dataclass
+class EmulatorDataset:
+    """Simulated outputs of design queries (NaN rows: failed runs)."""
+    queries: List[EmulatorQuery]
+    outputs: np.ndarray            # (queries, outputs)
+    maturity_reached: np.ndarray   # (queries,)
+    output_names: Tuple[str, ...] = EMULATOR_OUTPUTS
+
+    @property
+    def valid(self) -> np.ndarray:
+        return ~np.isnan(self.outputs).any(axis=1)
+
+    def save(self, path: Union[str, Path], fingerprint: str):
+        """Write to an .npz store (atomically replaced)."""
+        path = Path(path)
+        path.parent.mkdir(parents=True, exist_ok=True)
+        tmp_path = path.with_name(path.name + '.tmp.npz')
+        values = np.array([q.features() for q in self.queries])
+        np.savez(tmp_path, fingerprint=np.array(fingerprint), features=values,
+                 cultivars=np.array([q.cultivar_id for q in self.queries]),
+                 outputs=self.outputs, maturity_reached=self.maturity_reached,
+                 output_names=np.array(self.output_names))
+        os.replace(tmp_path, path)
+
+    @classmethod
+    def load(cls, path: Union[str, Path], fingerprint: str) -> 'EmulatorDataset':
+        with np.load(path, allow_pickle=False) as store:
+            if str(store['fingerprint']) != fingerprint:
+                raise ValueError(f"Emulator dataset {path} belongs to a different design or config")
+            queries = [EmulatorQuery(*map(float, row), cultivar_id=str(c))
+                       for row, c in zip(store['features'], store['cultivars'])]
+            return cls(queries, store['outputs'].copy(), store['maturity_reached'].copy(),
+                       tuple(str(name) for name in store['output_names']))
+
+
+def build_emulator_dataset(design: EmulatorDesign, queries: Sequence[EmulatorQuery],
+                           max_workers: Optional[int] = None,
+                           config_path: Optional[str] = None) -> EmulatorDataset:
+    """Simulate every query with the parallel batch runner."""
+    queries = list(queries)
+    outputs = np.full((len(queries), len(EMULATOR_OUTPUTS)), np.nan)
+    reached = np.zeros(len(queries), dtype=bool)
+    start = time.perf_counter()
+    specs = [design.scenario(query) for query in queries]
+    for result in run_batch(specs, max_workers=max_workers, config_path=config_path):
+        if not result.ok:
+            logger.warning(f"Emulator design point {result.index} failed: {result.error}")
+            continue
+        values, reached[result.index] = sample_outputs(result.summary_stats, result.metadata)
+        outputs[result.index] = [values[name] for name in EMULATOR_OUTPUTS]
+    dataset = EmulatorDataset(queries, outputs, reached)
+    logger.info(f"Emulator dataset: {int(dataset.valid.sum())}/{len(queries)} runs in "
+                f"{time.perf_counter() - start:.1f} s")
+    return dataset
+
+
+class MLPEnsemble:
+    """
+    Bootstrap ensemble of small fully connected tanh networks (NumPy).
+
+    Each member is trained with full-batch Adam on a bootstrap resample of
+    the rows; the rows a member never saw give the out-of-bag residual
+    error, which is added to the spread of the members in predict().
+
+    Args:
+        hidden: Hidden layer widths
+        n_members: Ensemble members
+        epochs: Adam steps per member
+        learning_rate: Adam step size
+        weight_decay: L2 penalty on the weights
+        seed: Initialization and bootstrap seed
+    """
+
+    def __init__(self, hidden: Sequence[int] = (32, 32), n_members: int = 5, epochs: int = 1500,
+                 learning_rate: float = 0.01, weight_decay: float = 1e-4, seed: int = 0):
+        self.hidden = tuple(hidden)
+        self.n_members = n_members
+        self.epochs = epochs
+        self.learning_rate = learning_rate
+        self.weight_decay = weight_decay
+        self.seed = seed
+        self.members: List[List[np.ndarray]] = []
+        self.y_mean = np.zeros(0)
+        self.y_scale = np.ones(0)
+        self.residual_std = np.zeros(0)  # Out-of-bag RMSE, standardized units
+
+    @staticmethod
+    def _forward(params: List[np.ndarray], x: np.ndarray) -> Tuple[np.ndarray, List[np.ndarray]]:
+        activations = [x]
+        for k in range(0, len(params) - 2, 2):
+            activations.append(np.tanh(activations[-1] @ params[k] + params[k + 1]))
+        return activations[-1] @ params[-2] + params[-1], activations
+
+    def _train(self, x: np.ndarray, z: np.ndarray, rng: np.random.Generator) -> List[np.ndarray]:
+        sizes = (x.shape[1],) + self.hidden + (z.shape[1],)
+        params: List[np.ndarray] = []
+        for fan_in, fan_out in zip(sizes[:-1], sizes[1:]):
+            params.append(rng.normal(0.0, np.sqrt(1.0 / fan_in), (fan_in, fan_out)))
+            params.append(np.zeros(fan_out))
+        m1 = [np.zeros_like(p) for p in params]
+        m2 = [np.zeros_like(p) for p in params]
+        beta1, beta2, eps = 0.9, 0.999, 1e-8
+        n = len(x)
+        for step in range(1, self.epochs + 1):
+            out, activations = self._forward(params, x)
+            delta = (out - z) / n
+            grads = [None] * len(params)
+            for k in range(len(params) - 2, -1, -2):
+                grads[k] = activations[k // 2].T @ delta + self.weight_decay * params[k]
+                grads[k + 1] = delta.sum(axis=0)
+                if k:
+                    delta = (delta @ params[k].T) * (1.0 - activations[k // 2] ** 2)
+            lr = self.learning_rate * np.sqrt(1.0 - beta2 ** step) / (1.0 - beta1 ** step)
+            for i, g in enumerate(grads):
+                m1[i] = beta1 * m1[i] + (1.0 - beta1) * g
+                m2[i] = beta2 * m2[i] + (1.0 - beta2) * g * g
+                params[i] -= lr * m1[i] / (np.sqrt(m2[i]) + eps)
+        return params
+
+    def fit(self, x: np.ndarray, y: np.ndarray) -> 'MLPEnsemble':
+        x = np.asarray(x, dtype=float)
+        y = np.asarray(y, dtype=float)
+        self.y_mean = y.mean(axis=0)
+        self.y_scale = np.where(y.std(axis=0) > 0, y.std(axis=0), 1.0)
+        z = (y - self.y_mean) / self.y_scale
+
+        rng = np.random.default_rng(self.seed)
+        n = len(x)
+        oob_sum = np.zeros_like(z)
+        oob_count = np.zeros(n)
+        self.members = []
+        for _ in range(self.n_members):
+            rows = rng.integers(0, n, n)
+            params = self._train(x[rows], z[rows], rng)
+            self.members.append(params)
+            unseen = np.ones(n, dtype=bool)
+            unseen[rows] = False
+            if unseen.any():
+                oob_sum[unseen] += self._forward(params, x[unseen])[0]
+                oob_count[unseen] += 1
+        seen = oob_count > 0
+        if seen.any():
+            residual = z[seen] - oob_sum[seen] / oob_count[seen, None]
+            self.residual_std = np.sqrt(np.mean(residual ** 2, axis=0))
+        else:
+            self.residual_std = np.zeros(z.shape[1])
+        return self
+
+    def predict(self, x: np.ndarray) -> Tuple[np.ndarray, np.ndarray]:
+        """Mean and predictive standard deviation (rows, outputs)."""
+        z = np.stack([self._forward(params, x)[0] for params in self.members])
+        std = np.sqrt(z.var(axis=0) + self.residual_std ** 2)
+        return z.mean(axis=0) * self.y_scale + self.y_mean, std * self.y_scale
+
+    def to_arrays(self) -> Dict[str, np.ndarray]:
+        arrays = {'hidden': np.array(self.hidden), 'y_mean': self.y_mean, 'y_scale': self.y_scale,
+                  'residual_std': self.residual_std}
+        for m, params in enumerate(self.members):
+            for i, p in enumerate(params):
+                arrays[f'member{m}_{i}'] = p
+        return arrays
+
+    @classmethod
+    def from_arrays(cls, arrays: Mapping[str, np.ndarray]) -> 'MLPEnsemble':
+        model = cls(hidden=tuple(int(h) for h in arrays['hidden']))
+        model.y_mean = np.asarray(arrays['y_mean'])
+        model.y_scale = np.asarray(arrays['y_scale'])
+        model.residual_std = np.asarray(arrays['residual_std'])
+        n_params = 2 * (len(model.hidden) + 1)
+        m = 0
+        while f'member{m}_0' in arrays:
+            model.members.append([np.asarray(arrays[f'member{m}_{i}']) for i in range(n_params)])
+            m += 1
+        model.n_members = m
+        return model
+
+
+def validation_metrics(y: np.ndarray, mean: np.ndarray, std: np.ndarray,
+                       output_names: Sequence[str]) -> Dict[str, Dict[str, float]]:
+    """Per-output R², RMSE and coverage of the 95% prediction interval."""
+    metrics = {}
+    for j, name in enumerate(output_names):
+        residual = y[:, j] - mean[:, j]
+        total = np.sum((y[:, j] - y[:, j].mean()) ** 2)
+        metrics[name] = {
+            'r2': float(1.0 - np.sum(residual ** 2) / total) if total > 0 else float('nan'),
+            'rmse': float(np.sqrt(np.mean(residual ** 2))),
+            'coverage_95': float(np.mean(np.abs(residual) <= 1.96 * std[:, j])),
+        }
+    return metrics
+
+
+class EmulatorService:
+    """
+    Serving API of a trained emulator with simulator fallback.
+
+    Args:
+        design: Query space and scenario mapping the model was trained for
+        model: Trained regressor
+        envelope: Range of the training data
+        validation: Held-out metrics recorded at training time
+        max_relative_std: Also fall back when a prediction's standard
+            deviation exceeds this fraction of its value (any output)
+        fallback: Run the simulator for queries the emulator cannot answer
+            (otherwise they are answered with in_envelope=False)
+        cache_size: Simulator answers kept (LRU)
+        max_workers: Batch runner workers for fallbacks of predict_many
+    """
+
+    def __init__(self, design: EmulatorDesign, model: MLPEnsemble, envelope: TrainingEnvelope,
+                 validation: Optional[Dict[str, Dict[str, float]]] = None,
+                 max_relative_std: Optional[float] = None,
+                 fallback: bool = True,
+                 cache_size: int = 256,
+                 max_workers: Optional[int] = None):
+        self.design = design
+        self.model = model
+        self.envelope = envelope
+        self.validation = validation or {}
+        self.max_relative_std = max_relative_std
+        self.fallback = fallback
+        self.cache_size = cache_size
+        self.max_workers = max_workers
+        self._simulated: 'OrderedDict[EmulatorQuery, Dict[str, float]]' = OrderedDict()
+        self.counts = {'emulator': 0, 'simulator': 0, 'cache': 0}
+
+    @classmethod
+    def train(cls, design: EmulatorDesign, dataset: EmulatorDataset, holdout_fraction: float = 0.2,
+              seed: int = 0, model_options: Optional[Dict[str, Any]] = None,
+              **service_options) -> 'EmulatorService':
+        """Validate on a held-out split, then fit the served model on all valid runs."""
+        valid = np.flatnonzero(dataset.valid)
+        if len(valid) < 4:
+            raise ValueError(f"Emulator needs at least 4 successful runs, got {len(valid)}")
+        queries = [dataset.queries[i] for i in valid]
+        x = design.encode(queries)
+        y = dataset.outputs[valid]
+        model_options = dict(model_options or {})
+        model_options.setdefault('seed', seed)
+
+        validation = {}
+        n_holdout = int(round(holdout_fraction * len(valid)))
+        if n_holdout >= 2:
+            order = np.random.default_rng(seed).permutation(len(valid))
+            test, train = order[:n_holdout], order[n_holdout:]
+            mean, std = MLPEnsemble(**model_options).fit(x[train], y[train]).predict(x[test])
+            validation = validation_metrics(y[test], mean, std, dataset.output_names)
+            logger.info("Emulator validation: " + ", ".join(
+                f"{name} R²={m['r2']:.3f}" for name, m in validation.items()))
+
+        model = MLPEnsemble(**model_options).fit(x, y)
+        return cls(design, model, TrainingEnvelope.from_queries(queries), validation, **service_options)
+
+    # ------------------------------------------------------------------
+    # Queries
+    # ------------------------------------------------------------------
+
+    def _check(self, query: EmulatorQuery, mean: np.ndarray, std: np.ndarray) -> Optional[str]:
+        """Reason the emulator answer is not served (None: serve it)."""
+        reason = self.envelope.violation(query)
+        if reason is None and self.max_relative_std is not None:
+            relative = std / np.maximum(np.abs(mean), 1e-9)
+            worst = int(np.argmax(relative))
+            if relative[worst] > self.max_relative_std:
+                reason = (f"{EMULATOR_OUTPUTS[worst]} uncertainty {relative[worst]:.0%} "
+                          f"above {self.max_relative_std:.0%}")
+        return reason
+
+    def _emulated(self, query, mean, std, reason, elapsed_ms) -> EmulatorPrediction:
+        self.counts['emulator'] += 1
+        return EmulatorPrediction(
+            query=query,
+            outputs={name: float(v) for name, v in zip(EMULATOR_OUTPUTS, mean)},
+            std={name: float(v) for name, v in zip(EMULATOR_OUTPUTS, std)},
+            source='emulator',
+            in_envelope=reason is None,
+            reason=reason,
+            elapsed_ms=elapsed_ms
+        )
+
+    def _simulated_prediction(self, query: EmulatorQuery, outputs: Dict[str, float], source: str,
+                              reason: Optional[str], elapsed_ms: float) -> EmulatorPrediction:
+        self.counts[source] += 1
+        return EmulatorPrediction(query, outputs, {name: 0.0 for name in outputs}, source,
+                                  self.envelope.violation(query) is None, reason, elapsed_ms)
+
+    def _remember(self, query: EmulatorQuery, outputs: Dict[str, float]):
+        self._simulated[query] = outputs
+        if len(self._simulated) > self.cache_size:
+            self._simulated.popitem(last=False)
+
+    def predict(self, query: Union[EmulatorQuery, Mapping[str, Any]]) -> EmulatorPrediction:
+        """Answer one query (emulator, or simulator outside the envelope)."""
+        return self.predict_many([query])[0]
+
+    def predict_many(self, queries: Sequence[Union[EmulatorQuery, Mapping[str, Any]]]) -> List[EmulatorPrediction]:
+        """Answer queries with one model evaluation; fallbacks run as one simulator batch."""
+        start = time.perf_counter()
+        queries = [q if isinstance(q, EmulatorQuery) else EmulatorQuery.from_dict(q) for q in queries]
+        known = [q.cultivar_id in self.design.cultivars for q in queries]
+        rows = [i for i, ok in enumerate(known) if ok]
+        mean = np.zeros((len(queries), len(EMULATOR_OUTPUTS)))
+        std = np.zeros_like(mean)
+        if rows:
+            mean[rows], std[rows] = self.model.predict(self.design.encode([queries[i] for i in rows]))
+        elapsed_ms = (time.perf_counter() - start) * 1000.0
+
+        predictions: List[Optional[EmulatorPrediction]] = [None] * len(queries)
+        pending: Dict[int, str] = {}
+        for i, query in enumerate(queries):
+            reason = self._check(query, mean[i], std[i])
+            if reason is None or (not self.fallback and known[i]):
+                # Without fallback, out-of-envelope answers are extrapolations flagged by in_envelope
+                predictions[i] = self._emulated(query, mean[i], std[i], reason, elapsed_ms)
+            elif not self.fallback:
+                raise ValueError(f"Emulator cannot answer {query}: {reason}")
+            elif query in self._simulated:
+                self._simulated.move_to_end(query)
+                predictions[i] = self._simulated_prediction(query, self._simulated[query], 'cache',
+                                                            reason, elapsed_ms)
+            else:
+                pending[i] = reason
+        if pending:
+            self._simulate(queries, pending, predictions)
+        return predictions
+
+    def _simulate(self, queries: List[EmulatorQuery], pending: Dict[int, str],
+                  predictions: List[Optional[EmulatorPrediction]]):
+        start = time.perf_counter()
+        indices = list(pending)
+        logger.info(f"Emulator fallback: simulating {len(indices)} queries ({pending[indices[0]]})")
+        specs = [self.design.scenario(queries[i]) for i in indices]
+        if len(specs) == 1:
+            results = [run_scenario(specs[0])]
+        else:
+            results = sorted(run_batch(specs, max_workers=self.max_workers), key=lambda r: r.index)
+        elapsed_ms = (time.perf_counter() - start) * 1000.0
+        for i, result in zip(indices, results):
+            if not result.ok:
+                raise RuntimeError(f"Simulator fallback failed for {queries[i]}: {result.error}")
+            values, _ = sample_outputs(result.summary_stats, result.metadata)
+            outputs = {name: values[name] for name in EMULATOR_OUTPUTS}
+            self._remember(queries[i], outputs)
+            predictions[i] = self._simulated_prediction(queries[i], outputs, 'simulator',
+                                                        pending[i], elapsed_ms)
+
+    # ------------------------------------------------------------------
+    # Store
+    # ------------------------------------------------------------------
+
+    def save(self, path: Union[str, Path]):
+        """Write the trained emulator to an .npz file (atomically replaced)."""
+        path = Path(path)
+        path.parent.mkdir(parents=True, exist_ok=True)
+        tmp_path = path.with_name(path.name + '.tmp.npz')
+        meta = {'design': self.design.describe(), 'envelope': vars(self.envelope), 'validation': self.validation}
+        np.savez(tmp_path, fingerprint=np.array(self.design.fingerprint()),
+                 meta=np.array(json.dumps(meta)), **self.model.to_arrays())
+        os.replace(tmp_path, path)
+
+    @classmethod
+    def load(cls, path: Union[str, Path], **service_options) -> 'EmulatorService':
+        """Load a saved emulator; it must have been trained for the active configuration."""
+        with np.load(path, allow_pickle=False) as store:
+            arrays = {name: store[name] for name in store.files}
+        meta = json.loads(str(arrays['meta']))
+        design = EmulatorDesign.from_description(meta['design'])
+        if str(arrays['fingerprint']) != design.fingerprint():
+            raise ValueError(f"Emulator {path} was trained for a different configuration")
+        envelope = meta['envelope']
+        return cls(design, MLPEnsemble.from_arrays(arrays),
+                   TrainingEnvelope(envelope['lower'], envelope['upper'], tuple(envelope['cultivars'])),
+                   meta['validation'], **service_options)
+
+
+def create_lettuce_emulator_design(config: Optional['ConfigSnapshot'] = None, **options) -> EmulatorDesign:
+    """
+    Emulator design configured from the JSON config (environment.EMULATOR:
+    BOUNDS, CULTIVARS, SYSTEM, MAX_DAYS, WEATHER_SEED, TARGET_VPD, TARGET_CO2).
+    """
+    config = config or get_config_snapshot()
+    emulator_config = dict(config.environment.get('EMULATOR', {}))
+    options.setdefault('bounds', emulator_config.get('BOUNDS'))
+    if 'cultivars' not in options:
+        options['cultivars'] = tuple(emulator_config.get('CULTIVARS') or
+                                     get_shared_lettuce_genetic_system()[0].cultivars)
+    if 'base_scenario' not in options:
+        options['base_scenario'] = ScenarioSpec(system_type=emulator_config.get('SYSTEM', 'NFT'),
+                                                max_days=emulator_config.get('MAX_DAYS', 60),
+                                                weather_seed=emulator_config.get('WEATHER_SEED', 0))
+    options.setdefault('target_vpd', emulator_config.get('TARGET_VPD'))
+    options.setdefault('target_co2', emulator_config.get('TARGET_CO2'))
+    return EmulatorDesign(**options)
+
+
+def create_lettuce_emulator(design: Optional[EmulatorDesign] = None,
+                            n_samples: Optional[int] = None,
+                            seed: Optional[int] = None,
+                            dataset_path: Optional[Union[str, Path]] = None,
+                            max_workers: Optional[int] = None,
+                            config_path: Optional[str] = None,
+                            config: Optional['ConfigSnapshot'] = None,
+                            model_options: Optional[Dict[str, Any]] = None,
+                            **service_options) -> EmulatorService:
+    """
+    Run the full pipeline: design, dataset (reused from dataset_path when it
+    matches), training and validation (environment.EMULATOR: SAMPLES, SEED,
+    HIDDEN, MEMBERS, EPOCHS, MAX_RELATIVE_STD; see also
+    create_lettuce_emulator_design).
+    """
+    config = config or get_config_snapshot()
+    emulator_config = dict(config.environment.get('EMULATOR', {}))
+    design = design or create_lettuce_emulator_design(config)
+    n_samples = n_samples or emulator_config.get('SAMPLES', 200)
+    seed = emulator_config.get('SEED', 0) if seed is None else seed
+    model_options = dict(model_options or {})
+    model_options.setdefault('hidden', tuple(emulator_config.get('HIDDEN', (32, 32))))
+    model_options.setdefault('n_members', emulator_config.get('MEMBERS', 5))
+    model_options.setdefault('epochs', emulator_config.get('EPOCHS', 1500))
+    service_options.setdefault('max_relative_std', emulator_config.get('MAX_RELATIVE_STD'))
+    service_options.setdefault('max_workers', max_workers)
+
+    fingerprint = hashlib.sha256(f"{design.fingerprint()}:{n_samples}:{seed}".encode('utf-8')).hexdigest()
+    if dataset_path is not None and Path(dataset_path).exists():
+        dataset = EmulatorDataset.load(dataset_path, fingerprint)
+        logger.info(f"Emulator dataset loaded from {dataset_path}: {len(dataset.queries)} runs")
+    else:
+        dataset = build_emulator_dataset(design, design.sample(n_samples, seed), max_workers, config_path)
+        if dataset_path is not None:
+            dataset.save(dataset_path, fingerprint)
+    return EmulatorService.train(design, dataset, seed=seed, model_options=model_options, **service_options)
+
+
+def demonstrate_emulator():
+    """Train a small emulator and answer queries inside and outside its envelope."""
+    print("=" * 80)
+    print("SIMULATOR EMULATOR DEMONSTRATION")
+    print("=" * 80)
+
+    design = create_lettuce_emulator_design(cultivars=('HYDRO_001', 'HYDRO_002'),
+                                            base_scenario=ScenarioSpec(max_days=40))
+    start = time.perf_counter()
+    service = create_lettuce_emulator(design, n_samples=48, model_options={'epochs': 800})
+    print(f"\nTrained on 48 runs in {time.perf_counter() - start:.1f} s")
+    print(f"\n{'Output':<28} {'R²':>7} {'RMSE':>9} {'95% cov':>8}")
+    print("-" * 80)
+    for name, m in service.validation.items():
+        print(f"{name:<28} {m['r2']:>7.3f} {m['rmse']:>9.3f} {m['coverage_95']:>8.0%}")
+
+    queries = [
+        EmulatorQuery(ec=1.8, rzt=22.0, photoperiod=16.0, cultivar_id='HYDRO_001'),
+        EmulatorQuery(ec=1.2, rzt=18.0, photoperiod=14.0, cultivar_id='HYDRO_002'),
+        EmulatorQuery(ec=3.2, rzt=22.0, photoperiod=16.0, cultivar_id='HYDRO_001'),  # Outside: falls back
+    ]
+    print(f"\n{'EC':>5} {'RZT':>5} {'PP':>5} {'Cultivar':<10} {'FW (g)':>9} {'± (g)':>7} {'Source':>10} {'ms':>8}")
+    print("-" * 80)
+    for query in queries:
+        p = service.predict(query)
+        print(f"{query.ec:>5.1f} {query.rzt:>5.1f} {query.photoperiod:>5.1f} {query.cultivar_id:<10} "
+              f"{p.outputs['fresh_weight_g']:>9.2f} {p.std['fresh_weight_g']:>7.2f} {p.source:>10} "
+              f"{p.elapsed_ms:>8.2f}")
+    return service
+
+
+if __name__ == "__main__":
+    demonstrate_emulator()
@@ -0,0 +1,1807 @@
+"""
+CROPGRO Ensemble Engine - Batched Multi-Scenario Simulation
+
+Steps many independent CROPGRO hydroponic simulations forward together. The
+state of every member (biomass pools, leaf cohorts, phenological thermal time,
+nitrogen pools, root cohorts, solution chemistry, tank volume, controller and
+acclimation memories) is held as contiguous NumPy arrays whose leading axis is
+the ensemble member, so one daily step is a fixed sequence of array operations
+instead of one Python object graph per scenario.
+
+The daily process chain and every formula mirror
+CROPGROHydroponicSimulator._simulate_daily_step, and each member is returned as
+the same SimulationResults/DailyResults structure produced by run_simulation.
+Root cohorts are the one stochastic process: every member steps its own
+RootArchitectureModel on the host, seeded like run_simulation from the
+member's random_seed, so a seeded member reproduces the seeded single run
+(ensemble_parity measures the remaining floating-point difference).
+
+Key concepts implemented:
+1. Struct-of-arrays plant state with the member index as leading axis
+2. Lock-step daily integration of environment, phenology, stress, carbon,
+   nitrogen, leaf, canopy, root and water processes for all members
+3. Maturity masking - members reaching HM/PM keep their slot, are frozen and
+   stop recording, while the remaining members continue
+4. Fixed-size ring histories for temperature-stress memory and respiration
+   acclimation
+5. Per-member seeded root cohort stores (the single-run root architecture
+   model and random stream), with uptake kinetics batched over members
+6. Optional per-member scalar diagnostics for the integrated stress,
+   senescence and nutrient mobility models
+7. Pluggable array backend (NumPy, CuPy, JAX): state stays on the device for
+   the whole run and only the requested output columns are copied back to
+   the host, at the end or once per output chunk of days
+
+Research basis:
+- Boote et al. (1998) CROPGRO model structure and daily process ordering
+- Jones et al. (2003) DSSAT cropping system model (batch/ensemble execution)
+- Wallach et al. (2014) Working with Dynamic Crop Models (ensemble analysis)
+- Van Rossum et al. (2011) NumPy array programming for scientific computing
+"""
+
+import math
+import logging
+from copy import deepcopy
+from dataclasses import dataclass
+from datetime import datetime, timedelta
+from typing import Any, Dict, List, Optional, Sequence, Union
+
+import numpy as np
+
+from .cropgro_hydroponic_simulator import (
+    CROPGROHydroponicSimulator, SimulationParameters,
+    EC_COEFFICIENTS, EC_DEFAULT_COEFFICIENT, ROOT_RNG_STREAM, WEEKLY_RESET_CONCENTRATIONS
+)
+from .models.genetic_parameters import GeneticTrait
+from .models.phenology_model import LettuceGrowthStage
+from .models.leaf_development import LeafStage
+from .models.root_system_model import (
+    create_enhanced_root_uptake_model, HydroponicSystemType, RootArchitectureModel
+)
+from .models.senescence_model import create_lettuce_senescence_model
+from .models.uptake_kernel import IonUptakeKernel
+from .models.nutrient_models import create_lettuce_nutrient_mobility_model
+from .models.stress_models import create_lettuce_integrated_stress_model
+from .data.hydroponic_system import HydroInputData, SimulationResults, DailyResults
+from .data.weather_series import as_weather_series
+from .utils.array_backend import ArrayBackend, get_array_backend
+from .utils.diurnal_profiles import seasonal_daylength_table
+
+logger = logging.getLogger(__name__)
+
+
+ORGANS = ('leaves', 'stems', 'roots')
+ROOT_TYPES = ('fine', 'medium', 'coarse')
+STRESS_KEYS = ('temperature', 'water', 'light', 'nitrogen', 'salinity', 'ph', 'oxygen')
+
+# Solution notation -> root uptake notation (same mapping as the single-run path)
+ROOT_NUTRIENT_MAP = {'N-NO3': 'NO3', 'P-PO4': 'PO4', 'K': 'K', 'Ca': 'Ca', 'Mg': 'Mg'}
+
+SYSTEM_TYPE_MAP = {
+    'NFT': HydroponicSystemType.NFT,
+    'DWC': HydroponicSystemType.DWC,
+    'AEROPONICS': HydroponicSystemType.AEROPONICS
+}
+
+MODELS_USED = [
+    'genetic_parameters', 'phenology', 'respiration', 'senescence',
+    'canopy_architecture', 'nitrogen_balance', 'nutrient_mobility',
+    'integrated_stress', 'temperature_stress', 'root_architecture',
+    'environmental_control'
+]
+
+# Leaf cohort stage codes
+LEAF_EMPTY, LEAF_EMERGING, LEAF_EXPANDING, LEAF_MATURE, LEAF_SENESCING = 0, 1, 2, 3, 4
+_LEAF_STAGE_CODES = {
+    LeafStage.PRIMORDIAL: LEAF_EMERGING,
+    LeafStage.EMERGING: LEAF_EMERGING,
+    LeafStage.EXPANDING: LEAF_EXPANDING,
+    LeafStage.MATURE: LEAF_MATURE,
+    LeafStage.SENESCING: LEAF_SENESCING
+}
+
+# DailyResults constructor fields; with these, nutrient_concentrations and
+# growth_stage, always copied back (results and summaries need them)
+RECORD_CONSTRUCTOR_FIELDS = (
+    'eto_ref', 'etc_prime', 'transpiration', 'water_uptake_total', 'tank_volume',
+    'temp_avg', 'solar_radiation', 'vpd', 'water_use_efficiency', 'ph', 'ec', 'rzt',
+    'rzt_growth_factor', 'rzt_nutrient_factor', 'co2_concentration', 'vpd_actual',
+    'env_photosynthesis_factor', 'env_transpiration_factor'
+)
+REQUIRED_RECORD_COLUMNS = RECORD_CONSTRUCTOR_FIELDS + ('nutrient_concentrations', 'growth_stage')
+
+# Final state read back for the summary statistics
+FINAL_STATE_ARRAYS = ('days_completed', 'maturity_reached', 'lai', 'canopy_height', 'pool_mass')
+
+# Temperature stress type codes
+TEMP_OPTIMAL, TEMP_HEAT, TEMP_COLD, TEMP_FROST = 0, 1, 2, 3
+
+# Daily columns compared by ensemble_parity
+PARITY_COLUMNS = ('total_biomass', 'leaf_biomass', 'lai', 'root_surface_area', 'fine_root_length',
+                  'root_cohorts', 'transpiration', 'tank_volume', 'ec', 'N-NO3_uptake_rate')
+
+# RootArchitectureModel metrics kept per member (columns of EnsembleState.root_metrics)
+ROOT_METRICS = ('root_length_density', 'total_root_surface_area', 'total_root_volume',
+                'fine_root_length', 'medium_root_length', 'coarse_root_length', 'average_root_activity')
+
+
+@dataclass
+class EnsembleMember:
+    """One scenario of an ensemble run."""
+    input_data: HydroInputData
+    cultivar_id: str = 'HYDRO_001'
+    label: Optional[str] = None
+    # Seed of the root cohort draws (default: that of run_simulation for input_data.random_seed)
+    root_seed: Optional[Sequence[int]] = None
+
+
+class EnsembleState:
+    """
+    Struct-of-arrays state container for all ensemble members.
+
+    Every state variable is an array whose first axis is the member index.
+    Updates are written through commit() so that members which are no longer
+    active (matured) keep their frozen values. State is built on the host and
+    moved to the array backend once (to_device); from then on it is only
+    read back through host().
+    """
+
+    def __init__(self, n_members: int, backend: Optional[ArrayBackend] = None):
+        self.n_members = n_members
+        self.backend = backend or get_array_backend('numpy')
+        self.active = np.ones(n_members, dtype=bool)
+        self.days_completed = np.zeros(n_members, dtype=int)
+        self.maturity_reached = np.zeros(n_members, dtype=bool)
+
+    def commit(self, name: str, value: Any):
+        """Write value into state array `name` for active members only."""
+        current = getattr(self, name)
+        mask = self.active.reshape((-1,) + (1,) * (current.ndim - 1))
+        setattr(self, name, self.backend.where_set(current, value, mask))
+
+    def to_device(self):
+        """Move every state array to the backend (a no-op for NumPy)."""
+        for name, value in list(vars(self).items()):
+            if isinstance(value, np.ndarray):
+                setattr(self, name, self.backend.asarray(value))
+
+    def host(self, name: str) -> np.ndarray:
+        """NumPy copy of state array `name`."""
+        return self.backend.to_host(getattr(self, name))
+
+
+def member_root_seed(member: EnsembleMember) -> Optional[Sequence[int]]:
+    """Seed of a member's root cohort stream (run_simulation's for its random_seed; None: fresh entropy)."""
+    if member.root_seed is not None:
+        return member.root_seed
+    seed = member.input_data.random_seed
+    return None if seed is None else (seed, ROOT_RNG_STREAM)
+
+
+class EnsembleSimulator:
+    """
+    Batched CROPGRO simulator running many scenarios in lock-step.
+
+    Model parameters are taken from a prototype CROPGROHydroponicSimulator,
+    so the ensemble uses exactly the configuration of the single-run path.
+    Members may differ in cultivar, hydroponic system, tank volume, plant
+    count, growing area, nutrient recipe and weather series.
+
+    Args:
+        simulation_params: Simulation parameters of the prototype
+        backend: Array backend name or instance ('numpy', 'cupy', 'jax';
+            default: environment.ARRAY_BACKEND of the configuration)
+    """
+
+    def __init__(self, simulation_params: Optional[SimulationParameters] = None,
+                 backend: Union[str, ArrayBackend, None] = None):
+        self.simulation_params = simulation_params
+        self.backend = get_array_backend(backend)
+        self.xp = self.backend.xp
+        self.prototype = CROPGROHydroponicSimulator(simulation_params=simulation_params)
+        self.params = self.prototype.params
+        self._load_shared_parameters()
+        self._cultivar_cache: Dict[str, Dict[str, Any]] = {}
+
+    # ------------------------------------------------------------------
+    # Parameter tables
+    # ------------------------------------------------------------------
+
+    def _load_shared_parameters(self):
+        """Extract model parameters shared by all members from the prototype."""
+        proto = self.prototype
+
+        # Phenology stage table
+        phen = proto.phenology_model
+        self.stages = list(LettuceGrowthStage)
+        stage_index = {stage: i for i, stage in enumerate(self.stages)}
+        self.stage_values = [stage.value for stage in self.stages]
+        self.stage_next = np.array([stage_index[phen.get_next_stage(s, False)] for s in self.stages])
+        self.stage_requirement = np.array([
+            phen.get_thermal_requirement(s, phen.get_next_stage(s, False)) for s in self.stages
+        ], dtype=float)
+        self.stage_is_vegetative = np.array([
+            s.value.startswith('V') or s == LettuceGrowthStage.EMERGENCE for s in self.stages
+        ])
+        self.stage_is_reproductive = np.array([s in (
+            LettuceGrowthStage.BOLTING_INITIATION, LettuceGrowthStage.FLOWERING,
+            LettuceGrowthStage.ANTHESIS, LettuceGrowthStage.SEED_DEVELOPMENT,
+            LettuceGrowthStage.PHYSIOLOGICAL_MATURITY
+        ) for s in self.stages])
+        self.stage_starts_v = np.array([s.value.startswith('V') for s in self.stages])
+        self.stage_long_day = np.array([s in (
+            LettuceGrowthStage.BOLTING_INITIATION, LettuceGrowthStage.FLOWERING
+        ) for s in self.stages])
+        self.stage_index = stage_index
+        # Indexed by the (device) stage state every day
+        for name in ('stage_next', 'stage_requirement', 'stage_is_vegetative', 'stage_is_reproductive',
+                     'stage_starts_v', 'stage_long_day'):
+            setattr(self, name, self.backend.asarray(getattr(self, name)))
+
+        # Leaf cohort slots: initial cohorts plus every leaf that can still appear
+        lp = proto.leaf_model.params
+        n_initial = int(lp.initial_leaf_number)
+        n_new = max(0, int(math.ceil(lp.max_leaf_number - lp.initial_leaf_number)))
+        self.n_leaf_slots = max(n_initial, n_new + 1, 1)
+
+        # Genetics weight for the default trait modulation
+        self.overall_stress_weight = proto.config_snapshot.genetics.get('OVERALL_STRESS_WEIGHT', 0.1)
+
+    def _cultivar_constants(self, cultivar_id: str) -> Dict[str, Any]:
+        """Resolve a cultivar and the stress-independent parts of its performance."""
+        if cultivar_id in self._cultivar_cache:
+            return self._cultivar_cache[cultivar_id]
+
+        proto = self.prototype
+        resolved_id = cultivar_id
+        profile = proto.genetic_db.get_cultivar(cultivar_id)
+        if not profile:
+            logger.warning(f"Cultivar {cultivar_id} not found, using default")
+            resolved_id = 'HYDRO_001'
+            profile = proto.genetic_db.get_cultivar(resolved_id)
+
+        # These trait expressions do not depend on the stress keys passed by the
+        # simulator, so they are evaluated once per cultivar.
+        ge = proto.ge_model
+        coeffs = profile.genetic_coefficients
+        constants = {
+            'cultivar_id': resolved_id,
+            'profile': profile,
+            'cultivar_name': profile.cultivar_name,
+            'yield_potential': profile.yield_potential,
+            'photosynthetic_capacity': coeffs.PHOTOSYNTHETIC_CAPACITY,
+            'nitrate_efficiency': coeffs.NITRATE_EFFICIENCY,
+            'ec_tolerance': coeffs.EC_TOLERANCE,
+            'root_activity': coeffs.ROOT_ACTIVITY,
+            'leaf_size': profile.trait_values.get(GeneticTrait.LEAF_SIZE, 0.5),
+            'chlorophyll': ge.calculate_phenotype_expression(resolved_id, {}, GeneticTrait.CHLOROPHYLL_CONTENT),
+            'nitrate_accumulation': ge.calculate_phenotype_expression(resolved_id, {}, GeneticTrait.NITRATE_ACCUMULATION),
+            'root_development': ge.calculate_phenotype_expression(resolved_id, {}, GeneticTrait.ROOT_DEVELOPMENT),
+            'adaptation_index': profile.calculate_adaptation_index({}, proto.config_snapshot.genetics)
+        }
+        self._cultivar_cache[cultivar_id] = constants
+        return constants
+
+    # ------------------------------------------------------------------
+    # State initialization
+    # ------------------------------------------------------------------
+
+    def _initialize_state(self, members: Sequence[EnsembleMember], max_days: int) -> EnsembleState:
+        proto = self.prototype
+        n = len(members)
+        st = EnsembleState(n, self.backend)
+        st.members = list(members)
+
+        # --- Cultivar vectors ---
+        st.cultivars = [self._cultivar_constants(m.cultivar_id) for m in members]
+
+        def cv(key):
+            return np.array([c[key] for c in st.cultivars], dtype=float)
+
+        st.photosynthetic_capacity = cv('photosynthetic_capacity')
+        st.nitrate_efficiency = cv('nitrate_efficiency')
+        st.ec_tolerance = cv('ec_tolerance')
+        st.yield_potential = cv('yield_potential')
+        st.root_activity_coeff = cv('root_activity')
+        st.leaf_size_trait = cv('leaf_size')
+        st.chlorophyll_trait = cv('chlorophyll')
+        st.nitrate_trait = cv('nitrate_accumulation')
+        st.root_trait = cv('root_development')
+        st.adaptation_index = cv('adaptation_index')
+
+        # --- System configuration ---
+        configs = [m.input_data.system_config for m in members]
+        st.n_plants = np.array([c.n_plants for c in configs], dtype=float)
+        st.plants_for_uptake = np.maximum(1.0, st.n_plants)
+        st.system_area = np.maximum(0.1, np.array([c.system_area for c in configs], dtype=float))
+        st.tank_volume = np.array([c.tank_volume for c in configs], dtype=float)
+        st.ph = np.full(n, 6.0)
+        # Solution chemistry set by the caller each day (spatial NFT mode): no
+        # weekly replacement and no per-member depletion or pH drift
+        st.external_solution = False
+        # Root zone oxygen factor and an optional imposed solution temperature
+        st.oxygen_factor = np.full(n, 0.95)
+        st.solution_temperature_override: Optional[np.ndarray] = None
+        # Photoperiod is a scalar of the lock-step day: fixed lighting must be shared
+        photoperiods = {m.input_data.photoperiod_hours for m in members}
+        if len(photoperiods) > 1:
+            raise ValueError(f"Ensemble members must share one photoperiod, got {sorted(photoperiods, key=str)}")
+        st.photoperiod = photoperiods.pop()
+        # Same day -> photoperiod table as run_simulation (indexed by day - 1)
+        st.daylength = (seasonal_daylength_table(max_days) if st.photoperiod is None
+                        else np.full(max_days, float(st.photoperiod)))
+
+        # --- Weather matrices (cycled per member) ---
+        series = [as_weather_series(m.input_data.weather_data) for m in members]
+        lengths = [len(w) for w in series]
+        if min(lengths) == 0:
+            raise ValueError("Every ensemble member needs at least one day of weather data")
+        w_max = max(lengths)
+        st.weather_length = np.array(lengths)
+        st.weather_temp = np.zeros((n, w_max))
+        st.weather_rh = np.zeros((n, w_max))
+        st.weather_solar = np.zeros((n, w_max))
+        for i, w in enumerate(series):
+            st.weather_temp[i, :lengths[i]] = w.temp_avg
+            st.weather_rh[i, :lengths[i]] = w.rel_humidity
+            st.weather_solar[i, :lengths[i]] = w.solar_radiation
+
+        # --- Nutrient matrix over the union of nutrient ids ---
+        nutrient_ids: List[str] = []
+        for m in members:
+            for nid in m.input_data.nutrient_params:
+                if nid not in nutrient_ids:
+                    nutrient_ids.append(nid)
+        st.nutrient_ids = nutrient_ids
+        k = len(nutrient_ids)
+        st.member_nutrients = [list(m.input_data.nutrient_params.keys()) for m in members]
+        st.nutrient_present = np.zeros((n, k), dtype=bool)
+        st.concentrations = np.zeros((n, k))
+        st.recharge_concentrations = np.zeros((n, k))
+        for i, m in enumerate(members):
+            strength = m.input_data.solution_strength
+            for nid, p in m.input_data.nutrient_params.items():
+                col = nutrient_ids.index(nid)
+                st.nutrient_present[i, col] = True
+                st.concentrations[i, col] = p.initial_conc * strength
+                if nid in WEEKLY_RESET_CONCENTRATIONS:
+                    st.recharge_concentrations[i, col] = WEEKLY_RESET_CONCENTRATIONS[nid] * strength
+                else:
+                    st.recharge_concentrations[i, col] = strength * (
+                        p.recharge_conc if hasattr(p, 'recharge_conc') else p.initial_conc)
+        st.ec_coefficients = np.array(
+            [EC_COEFFICIENTS.get(nid, EC_DEFAULT_COEFFICIENT) for nid in nutrient_ids])
+        st.no3_column = nutrient_ids.index('N-NO3') if 'N-NO3' in nutrient_ids else -1
+        # Columns feeding the root uptake model, in root notation order
+        st.root_columns = {root_key: (nutrient_ids.index(csv_key) if csv_key in nutrient_ids else -1)
+                           for csv_key, root_key in ROOT_NUTRIENT_MAP.items()}
+
+        # --- Environmental control memories ---
+        st.humidity_integral = np.zeros(n)
+        st.humidity_previous = np.zeros(n)
+        st.co2_integral = np.zeros(n)
+        st.co2_previous = np.zeros(n)
+
+        # --- Phenology ---
+        ds = proto.phenology_model.developmental_state
+        st.stage = np.full(n, self.stage_index[ds.current_stage], dtype=int)
+        st.thermal_accumulated = np.full(n, ds.thermal_time_accumulated)
+        st.thermal_required = np.full(n, ds.thermal_time_required)
+        st.thermal_total = np.full(n, ds.total_thermal_time)
+        st.stage_progress = np.full(n, ds.stage_progress)
+
+        # --- Temperature stress memories ---
+        ts = proto.temperature_stress.params
+        st.heat_acclimation = np.zeros(n)
+        st.cold_acclimation = np.zeros(n)
+        st.heat_damage = np.zeros(n)
+        st.cold_damage = np.zeros(n)
+        st.frost_damage = np.zeros(n)
+        st.stress_memory = np.zeros((n, max(1, int(ts.stress_memory_duration))))
+        st.stress_memory_count = np.zeros(n, dtype=int)
+
+        # --- Solution temperature ---
+        st.solution_temperature = np.full(n, np.nan)
+
+        # --- Respiration acclimation ---
+        rp = proto.respiration_model.params
+        st.respiration_reference = np.full(n, float(proto.respiration_model.acclimated_reference_temp))
+        st.respiration_history = np.zeros((n, max(1, int(rp.acclimation_memory))))
+        st.respiration_history_count = np.zeros(n, dtype=int)
+
+        # --- Biomass pools (leaves, stems, roots) ---
+        pools = proto.biomass_pools
+        st.pool_mass = np.tile([p.dry_mass for p in pools], (n, 1)).astype(float)
+        st.pool_age = np.tile([p.age_days for p in pools], (n, 1)).astype(float)
+        st.pool_nitrogen = np.tile([p.nitrogen_content for p in pools], (n, 1)).astype(float)
+
+        # --- Nitrogen balance organs (cultivar-scaled initial concentrations) ---
+        initial_conc = np.stack([0.045 * st.nitrate_efficiency,
+                                 np.full(n, 0.020),
+                                 0.028 * st.nitrate_efficiency], axis=1)
+        st.n_mass = st.pool_mass.copy()
+        st.n_total = st.n_mass * initial_conc
+        st.n_conc = np.where(st.n_mass > 0, st.n_total / np.where(st.n_mass > 0, st.n_mass, 1.0), initial_conc)
+        st.n_pools = st.n_total[:, :, None] * np.array([0.4, 0.35, 0.20, 0.05])[None, None, :]
+
+        # --- Leaf cohorts ---
+        leaf = proto.leaf_model
+        s = self.n_leaf_slots
+        st.leaf_area = np.zeros((n, s))
+        st.leaf_max_area = np.zeros((n, s))
+        st.leaf_stage = np.zeros((n, s), dtype=int)
+        st.leaf_tt = np.zeros((n, s))
+        st.leaf_senescence = np.zeros((n, s))
+        for cohort_id, cohort in leaf.leaf_cohorts.items():
+            slot = cohort_id - 1
+            st.leaf_area[:, slot] = cohort.current_area
+            st.leaf_max_area[:, slot] = cohort.max_potential_area
+            st.leaf_stage[:, slot] = _LEAF_STAGE_CODES[cohort.stage]
+            st.leaf_tt[:, slot] = cohort.thermal_time_since_appearance
+            st.leaf_senescence[:, slot] = cohort.senescence_rate
+        st.v_stage = np.full(n, float(leaf.current_v_stage))
+        st.leaf_cumulative_tt = np.full(n, float(leaf.cumulative_thermal_time))
+        st.leaf_next_id = np.full(n, int(leaf.next_cohort_id), dtype=int)
+
+        st.lai = np.full(n, float(proto.current_lai))
+        st.canopy_height = np.full(n, float(proto.canopy_height))
+
+        # --- Root system (per member system layout) ---
+        self._initialize_roots(st, configs, max_days)
+
+        # --- Optional scalar diagnostic models ---
+        st.diagnostic_models = None
+
+        st.to_device()
+        return st
+
+    def _initialize_roots(self, st: EnsembleState, configs, max_days: int):
+        n = st.n_members
+        st.root_mean_diameter = np.zeros((n, 3))
+        st.root_effectiveness = np.zeros((n, 3))
+        st.root_q10 = np.zeros(n)
+        st.root_optimal_temperature = np.zeros(n)
+        st.root_flow_factor = np.zeros(n)
+        root_ions = tuple(ROOT_NUTRIENT_MAP.values())
+        root_vmax = np.zeros((n, len(root_ions)))
+        root_km = np.zeros((n, len(root_ions)))
+        st.root_fine_turnover_rate = np.zeros(n)
+
+        # Cohorts of every member live in its own seeded architecture model
+        # (host objects, stepped by _roots); their metrics are mirrored here
+        st.root_architectures: List[RootArchitectureModel] = []
+        st.root_metrics = np.zeros((n, len(ROOT_METRICS)))
+        st.root_cohort_count = np.zeros(n, dtype=int)
+
+        uptake_models = {}
+        for i, config in enumerate(configs):
+            system_enum = SYSTEM_TYPE_MAP.get(config.system_type, HydroponicSystemType.NFT)
+            # Members of the same system layout share one (read-only) parameter model
+            model_key = (system_enum, config.tank_volume)
+            uptake_model = uptake_models.get(model_key)
+            if uptake_model is None:
+                uptake_model = create_enhanced_root_uptake_model(system_enum, config.tank_volume)
+                uptake_models[model_key] = uptake_model
+            ap = uptake_model.root_architecture.params
+            up = uptake_model.uptake_params
+            st.root_architectures.append(RootArchitectureModel(ap, rng=member_root_seed(st.members[i])))
+
+            st.root_fine_turnover_rate[i] = getattr(ap, 'fine_turnover_rate', 0.02)
+            st.root_mean_diameter[i] = [ap.fine_diameter_mean, ap.medium_diameter_mean, ap.coarse_diameter_mean]
+            st.root_effectiveness[i] = [up.fine_root_effectiveness, up.medium_root_effectiveness,
+                                        up.coarse_root_effectiveness]
+            st.root_q10[i] = up.q10_factor
+            st.root_optimal_temperature[i] = up.optimal_temperature
+            st.root_flow_factor[i] = uptake_model.calculate_flow_factor(1.5)
+            for j, key in enumerate(root_ions):
+                root_vmax[i, j] = up.base_uptake_rates.get(key, 0.0)
+                root_km[i, j] = up.michaelis_constants.get(key, 50.0) if up.michaelis_constants else np.nan
+
+        # Per-member kinetics as one (members, ions) kernel
+        st.root_kernel = IonUptakeKernel(root_ions, root_vmax, root_km).on(self.backend)
+        columns = np.array([st.root_columns[key] for key in root_ions])
+        st.root_kernel_columns = np.maximum(columns, 0)
+        st.root_kernel_present = st.nutrient_present[:, st.root_kernel_columns] & (columns >= 0)
+
+    def _initialize_diagnostics(self, st: EnsembleState):
+        """Create per-member scalar models for diagnostic-only outputs."""
+        models = []
+        nitrate_efficiency = st.host('nitrate_efficiency')
+        pool_mass = st.host('pool_mass')
+        for i in range(st.n_members):
+            mobility = create_lettuce_nutrient_mobility_model()
+            ne = nitrate_efficiency[i]
+            initial_nutrients = {
+                'nitrogen': 0.15 * ne,
+                'phosphorus': 0.020,
+                'potassium': 0.12,
+                'calcium': 0.08,
+                'magnesium': 0.025,
+                'sulfur': 0.018
+            }
+            mobility.initialize_organ_pools('leaves', initial_nutrients, pool_mass[i, 0])
+            mobility.initialize_organ_pools('stems',
+                {k: v * 0.35 for k, v in initial_nutrients.items()}, pool_mass[i, 1])
+            mobility.initialize_organ_pools('roots',
+                {k: v * 0.80 for k, v in initial_nutrients.items()}, pool_mass[i, 2])
+            models.append({
+                'senescence': create_lettuce_senescence_model(),
+                'mobility': mobility
+            })
+        st.diagnostic_models = models
+
+        # Integrated stress of all members as one batched state on the compiled kernel
+        kernel = create_lettuce_integrated_stress_model().kernel
+        st.stress_kernel = kernel
+        st.stress_memory = kernel.initial_memory(st.n_members)
+        st.stress_columns, known = kernel.columns_of(STRESS_KEYS)
+        st.stress_level_columns = np.nonzero(known)[0]
+
+    # ------------------------------------------------------------------
+    # Main loop
+    # ------------------------------------------------------------------
+
+    def run(self, members: Sequence[EnsembleMember],
+            max_days: int = 365,
+            target_maturity: str = "harvest",
+            scalar_diagnostics: bool = False,
+            output_columns: Optional[Sequence[str]] = None,
+            output_chunk_days: Optional[int] = None) -> List[SimulationResults]:
+        """
+        Run all members until each reaches the target maturity or max_days.
+
+        Args:
+            members: Scenarios to simulate
+            max_days: Maximum simulated days per member
+            target_maturity: 'harvest' (HM), 'physiological' (PM) or any other
+                value for whichever comes first
+            scalar_diagnostics: Also step the integrated stress, senescence and
+                nutrient mobility models per member (diagnostic outputs only)
+            output_columns: Daily record columns to return in addition to
+                REQUIRED_RECORD_COLUMNS (default: all); the others are never
+                copied back from the array backend
+            output_chunk_days: Copy the recorded columns to the host every this
+                many days instead of once at the end (bounds device memory)
+
+        Returns:
+            One SimulationResults per member, in input order
+        """
+        members = list(members)
+        if not members:
+            return []
+
+        target_table = self._target_table(target_maturity)
+
+        logger.info(f"Starting CROPGRO ensemble simulation: {len(members)} members, "
+                    f"target maturity {target_maturity}, maximum {max_days} days")
+
+        st = self._initialize_state(members, max_days)
+        if scalar_diagnostics:
+            self._initialize_diagnostics(st)
+
+        keep = None if output_columns is None else set(REQUIRED_RECORD_COLUMNS) | set(output_columns)
+        pending: List[Dict[str, Any]] = []
+        columns: Dict[str, List[np.ndarray]] = {}
+        diagnostics: List[Optional[Dict[int, Dict[str, Any]]]] = []
+        day = 1
+        while day <= max_days and bool(st.active.any()):
+            record = self._step(st, day)
+            diagnostics.append(record.pop('_diagnostics'))
+            pending.append(record if keep is None else {key: record[key] for key in record if key in keep})
+            self._close_day(st, day, target_table)
+            if output_chunk_days and len(pending) >= output_chunk_days:
+                self._flush_records(pending, columns)
+                pending = []
+
+            if day % 10 == 0:
+                logger.info(f"Day {day}: {int(st.active.sum())}/{st.n_members} members active")
+            day += 1
+        self._flush_records(pending, columns)
+
+        results = self._build_results(st, {key: np.concatenate(chunks) for key, chunks in columns.items()},
+                                      diagnostics)
+        logger.info(f"Ensemble completed: {int(st.maturity_reached.sum())}/{st.n_members} members reached maturity")
+        return results
+
+    def _target_table(self, target_maturity: str) -> np.ndarray:
+        """Stage index -> whether the stage ends a member's run."""
+        if target_maturity == "harvest":
+            target_stages = {"HM"}
+        elif target_maturity == "physiological":
+            target_stages = {"PM"}
+        else:
+            target_stages = {"HM", "PM"}
+        return self.backend.asarray([value in target_stages for value in self.stage_values])
+
+    def _close_day(self, st: EnsembleState, day: int, target_table: np.ndarray):
+        """Count the day for active members and freeze those that reached maturity."""
+        st.days_completed = self.xp.where(st.active, day, st.days_completed)
+        matured = st.active & target_table[st.stage]
+        st.maturity_reached = st.maturity_reached | matured
+        st.active = st.active & ~matured
+
+    # ------------------------------------------------------------------
+    # Daily step
+    # ------------------------------------------------------------------
+
+    def _step(self, st: EnsembleState, day: int) -> Dict[str, Any]:
+        with self.backend.errstate():
+            return self._step_arrays(st, day)
+
+    def _step_arrays(self, st: EnsembleState, day: int) -> Dict[str, Any]:
+        xp = self.xp
+        proto = self.prototype
+        params = self.params
+        n = st.n_members
+        rows = xp.arange(n)
+        rec: Dict[str, Any] = {}
+
+        # === WEATHER ===
+        widx = (day - 1) % st.weather_length
+        T = st.weather_temp[rows, widx]
+        RH = st.weather_rh[rows, widx]
+        S = st.weather_solar[rows, widx]
+        daylength = float(st.daylength[day - 1])
+
+        # Weekly solution replacement at the beginning of the day
+        if day % 7 == 1 and day > 1 and not st.external_solution:
+            st.commit('concentrations', xp.where(st.nutrient_present, st.recharge_concentrations,
+                                                 st.concentrations))
+            st.commit('ph', xp.full(n, 6.0))
+
+        conc = st.concentrations
+        ph = st.ph.copy()
+        previous_tank = st.tank_volume.copy()
+        rec['nutrient_concentrations'] = conc.copy()
+        rec['ph'] = ph
+
+        # === STEP 1: ENVIRONMENT ===
+        env = self._environment(st, T, RH, S, day)
+
+        # === STEP 2: PHENOLOGY ===
+        pheno = self._phenology(st, T, daylength)
+        is_veg = self.stage_is_vegetative[st.stage]
+        is_repro = self.stage_is_reproductive[st.stage]
+
+        # === STEP 3: STRESS ===
+        stress = self._stress(st, T, S, env['vpd'], conc, ph, previous_tank)
+        perf = self._cultivar_performance(st, stress)
+
+        # === STEP 4: PHOTOSYNTHESIS ===
+        photo = self._photosynthesis(env, T, daylength, st.lai)
+        canopy_photosynthesis = photo['gross'] * stress['overall'] * st.photosynthetic_capacity
+
+        # === STEP 5: RESPIRATION ===
+        resp = self._respiration(st, T)
+
+        # === STEP 6: GROWTH ===
+        c_bm = params.carbon_to_biomass_ratio
+        rg = max(0.0, params.growth_respiration_fraction)
+        net_carbon = xp.maximum(0.0, canopy_photosynthesis - resp['maintenance'])
+        available_growth = xp.maximum(0.0, net_carbon / (c_bm * (1.0 + rg)))
+        veg_frac = xp.array([params.vegetative_leaf_allocation, params.vegetative_stem_allocation,
+                             params.vegetative_root_allocation])
+        rep_frac = xp.array([params.reproductive_leaf_allocation, params.reproductive_stem_allocation,
+                             params.reproductive_root_allocation])
+        fractions = xp.where(is_veg[:, None], veg_frac[None, :], rep_frac[None, :])
+        rzt_growth, rzt_nutrient = self._rzt_factors(stress['solution_temperature'], T)
+        growth = available_growth[:, None] * fractions * rzt_growth[:, None]
+        total_growth = growth.sum(axis=1)
+        growth_respiration = total_growth * c_bm * rg
+        total_respiration = resp['maintenance'] + growth_respiration
+        net_assimilation = canopy_photosynthesis - total_respiration
+
+        # === STEP 7: NUTRIENT UPTAKE (root system) ===
+        roots = self._roots(st, day, stress, conc)
+
+        # === STEP 8: INTERNAL NITROGEN ALLOCATION ===
+        nitrogen = self._nitrogen(st, roots['NO3'] / 1000.0, growth, is_veg, stress['levels'])
+
+        # Diagnostics that need pre-growth pools
+        diagnostics = None
+        if st.diagnostic_models is not None:
+            diagnostics = self._scalar_diagnostics(st, growth, stress, is_veg, is_repro, T)
+
+        # === STEP 9: UPDATE STATE ===
+        st.commit('pool_age', st.pool_age + 1.0)
+        st.commit('pool_mass', st.pool_mass + growth)
+        st.commit('pool_nitrogen', st.n_conc * 100.0)
+
+        leaf = self._leaf_development(st, T, stress)
+
+        sla = getattr(proto.leaf_model.params, 'specific_leaf_area', 250.0)
+        biomass_area = st.pool_mass[:, 0] * sla / 10000.0
+        one_plant_area = xp.maximum(leaf['total_area'], biomass_area)
+        new_lai = xp.minimum(8.0, xp.maximum(0.0, one_plant_area * st.n_plants / xp.maximum(1e-6, st.system_area)))
+        st.commit('lai', new_lai)
+
+        height = st.canopy_height + xp.where(is_veg, 0.004 * stress['overall'] * perf['yield_index'], 0.0)
+        st.commit('canopy_height', xp.minimum(0.25, height))
+
+        canopy = self._canopy(st.lai, st.canopy_height, env['ppfd'], day)
+
+        # === WATER ===
+        water = self._water(T, RH, S, env['vpd'], canopy['light_interception'], st.lai)
+        system_water_use = water['uptake'] * st.system_area
+        st.commit('tank_volume', xp.maximum(0.0, previous_tank - system_water_use))
+
+        total_biomass = st.pool_mass.sum(axis=1)
+
+        # Nitrogen uptake reported from the root model with the minimal fallback
+        no3_available = roots['solution_NO3'] > 1.0
+        nitrogen_uptake_mg = xp.where(
+            (roots['NO3'] == 0.0) & (total_biomass > 0.1) & no3_available,
+            params.minimal_nitrogen_uptake, roots['NO3'])
+        no3_uptake_rate = nitrogen_uptake_mg * (62.0 / 14.0)
+
+        # === SOLUTION DEPLETION AND pH DRIFT (for the next day) ===
+        if not st.external_solution:
+            zero = xp.zeros(n)
+            per_plant = xp.stack([
+                no3_uptake_rate if col == st.no3_column else
+                roots[ROOT_NUTRIENT_MAP[nid]] if nid in ROOT_NUTRIENT_MAP else zero
+                for col, nid in enumerate(st.nutrient_ids)
+            ], axis=1)
+            volume_m3 = xp.maximum(0.001, st.tank_volume / 1000.0)
+            reduction = per_plant * st.plants_for_uptake[:, None] / volume_m3[:, None]
+            depleted = xp.where(per_plant > 0.0, xp.maximum(0.0, conc - reduction), conc)
+            st.commit('concentrations', xp.where(st.nutrient_present, depleted, st.concentrations))
+
+            no3_total = no3_uptake_rate * st.plants_for_uptake
+            new_ph = xp.clip(ph - xp.minimum(0.03, no3_total / 20000.0) - 0.005, 5.5, 6.5)
+            st.commit('ph', new_ph)
+
+        # === DAILY RECORD ===
+        rec.update({
+            'eto_ref': water['eto'],
+            'etc_prime': water['etc'],
+            'transpiration': water['transpiration'],
+            'water_uptake_total': system_water_use,
+            'tank_volume': st.tank_volume.copy(),
+            'temp_avg': T,
+            'solar_radiation': S,
+            'vpd': water['vpd'],
+            'water_use_efficiency': total_growth / xp.maximum(1e-6, water['transpiration'] * st.system_area),
+            'ec': stress['ec'],
+            'rzt': stress['solution_temperature'],
+            'rzt_growth_factor': rzt_growth,
+            'rzt_nutrient_factor': rzt_nutrient,
+            'co2_concentration': env['co2'],
+            'vpd_actual': env['vpd'],
+            'env_photosynthesis_factor': env['photosynthesis_factor'],
+            'env_transpiration_factor': env['transpiration_factor'],
+
+            # 1. Phenology
+            'growth_stage': st.stage.copy(),
+            'accumulated_gdd': st.thermal_total.copy(),
+            'thermal_time_daily': pheno['thermal_time'],
+            'development_rate': pheno['development_rate'],
+            'is_vegetative': is_veg,
+            'is_reproductive': is_repro,
+
+            # 2. Biomass
+            'total_biomass': total_biomass,
+            'leaf_biomass': st.pool_mass[:, 0].copy(),
+            'stem_biomass': st.pool_mass[:, 1].copy(),
+            'root_biomass': st.pool_mass[:, 2].copy(),
+            'daily_growth_rate': total_growth,
+            'leaf_growth_rate': growth[:, 0],
+            'stem_growth_rate': growth[:, 1],
+            'root_growth_rate': growth[:, 2],
+
+            # 3. Canopy architecture
+            'lai': st.lai.copy(),
+            'canopy_height_cm': st.canopy_height * 100,
+            'light_interception': canopy['light_interception'],
+            'canopy_photosynthesis': canopy['canopy_photosynthesis'],
+            'total_absorbed_ppfd': canopy['total_absorbed_ppfd'],
+            'sunlit_lai': canopy['sunlit_lai'],
+            'shaded_lai': canopy['shaded_lai'],
+            'v_stage': st.v_stage.copy(),
+            'leaf_number': leaf['active_count'],
+            'leaf_area_m2': one_plant_area,
+            'average_leaf_area_cm2': one_plant_area / xp.maximum(1, leaf['active_count']) * 1.0e4,
+            'canopy_layers': canopy['layers'],
+            'ppfd_top': canopy['ppfd_top'],
+            'ppfd_bottom': canopy['ppfd_bottom'],
+            'light_extinction': canopy['extinction'],
+
+            # 4. Physiological processes
+            'photosynthesis_rate': canopy_photosynthesis,
+            'respiration_rate': total_respiration,
+            'maintenance_respiration': resp['maintenance'],
+            'growth_respiration': growth_respiration,
+            'net_assimilation': net_assimilation,
+            'vcmax_25': photo['vcmax_25'],
+            'jmax_25': photo['jmax_25'],
+            'quantum_efficiency': photo['alpha'],
+            'rubisco_limited': photo['rubisco_limited'],
+            'light_limited': photo['light_limited'],
+            'co2_compensation': photo['gamma_star'],
+            'intercellular_co2': env['co2'],
+            'maintenance_resp_leaves': resp['tissue'][:, 0],
+            'maintenance_resp_stems': resp['tissue'][:, 1],
+            'maintenance_resp_roots': resp['tissue'][:, 2],
+            'growth_resp_leaves': xp.zeros(n),
+            'growth_resp_stems': xp.zeros(n),
+            'growth_resp_roots': xp.zeros(n),
+            'temperature_acclimation': resp['temperature_factor'],
+            'age_factor': resp['age_factor'],
+
+            # 5. Nitrogen dynamics
+            'nitrogen_uptake_mg': nitrogen_uptake_mg,
+            'nitrogen_demand_mg': xp.full(n, 50.0),
+            'nitrogen_stress_factor': 1.0 - nitrogen['stress_level'],
+            'leaf_nitrogen_conc': xp.full(n, 4.5),
+            'root_nitrogen_conc': xp.full(n, 2.8),
+            'n_pool_structural': st.n_pools[:, 0, 0].copy(),
+            'n_pool_metabolic': st.n_pools[:, 0, 1].copy(),
+            'n_pool_storage': st.n_pools[:, 0, 2].copy(),
+            'n_pool_transport': st.n_pools[:, 0, 3].copy(),
+            'n_remobilization': nitrogen['remobilized'] * 1000,
+            'n_critical_conc': xp.where(
+                total_biomass > 0,
+                (nitrogen_uptake_mg / 1000.0) / xp.where(total_biomass > 0, total_biomass, 1.0) * 1.2,
+                0.045),
+
+            # 6. Stress responses
+            'temperature_stress_level': stress['levels'][:, 0],
+            'temperature_stress_photosynthesis': stress['temperature_photosynthesis'],
+            'temperature_stress_growth': stress['temperature_growth'],
+            'water_stress': stress['levels'][:, 1],
+            'nutrient_stress': stress['levels'][:, 3],
+            'salinity_stress': stress['salinity_factor'],
+
+            # 8. Root architecture
+            'root_length_density': roots['length_density'],
+            'root_surface_area': roots['surface_area'],
+            'root_volume': roots['volume'],
+            'root_activity_factor': st.root_activity_coeff,
+            'fine_root_length': roots['fine_length'],
+            'coarse_root_length': roots['coarse_length'],
+            'root_cohorts': roots['cohorts'],
+            'root_turnover_rate': st.root_fine_turnover_rate,
+            'root_activity_young': roots['activity'],
+            'root_activity_old': xp.maximum(0.0, roots['activity'] - 0.2),
+            'root_surface_active': roots['surface_area'] * roots['activity'],
+            'P-PO4_uptake_rate': roots['PO4'],
+            'K_uptake_rate': roots['K'],
+            'Ca_uptake_rate': roots['Ca'],
+            'Mg_uptake_rate': roots['Mg'],
+            'N-NO3_uptake_rate': no3_uptake_rate,
+
+            # 9. Genetic parameters
+            'cultivar_adaptation_index': perf['adaptation_index'],
+            'cultivar_yield_potential': st.yield_potential,
+            'genetic_photosynthesis_capacity': st.photosynthetic_capacity,
+            'genetic_nitrate_efficiency': st.nitrate_efficiency,
+            'genetic_ec_tolerance': st.ec_tolerance,
+
+            # 10. Environmental control
+            'controlled_temperature': T,
+            'controlled_humidity': RH,
+            'controlled_co2': env['co2'],
+            'vpd_target': xp.full(n, 0.8),
+            'environmental_cost': env['cost'],
+        })
+        rec['_diagnostics'] = diagnostics
+        return rec
+
+    # ------------------------------------------------------------------
+    # Process kernels
+    # ------------------------------------------------------------------
+
+    def _environment(self, st: EnsembleState, T, RH, S, day: int) -> Dict[str, np.ndarray]:
+        """Environmental control (VPD, humidity and CO2 PID) for all members."""
+        xp = self.xp
+        ec = self.prototype.environmental_control
+        sp, eq, pid = ec.setpoints, ec.equipment, ec.pid_params
+
+        light_on = S > 5.0
+        es = 0.6108 * xp.exp(17.27 * T / (T + 237.3))
+        vpd = xp.maximum(0.0, es - es * (RH / 100.0))
+
+        # VPD stress factors
+        low = sp.target_vpd - sp.vpd_tolerance
+        high = sp.target_vpd + sp.vpd_tolerance
+        deficit = low - vpd
+        excess = vpd - high
+        transp = xp.where(vpd < low, xp.maximum(0.4, 1.0 - deficit * 0.8),
+                          xp.where(vpd > high, xp.maximum(0.3, 1.0 - excess * 1.2), 1.0))
+        photo = xp.where(vpd < low, xp.maximum(0.6, 1.0 - deficit * 0.5),
+                         xp.where(vpd > high, xp.maximum(0.4, 1.0 - excess * 0.8), 1.0))
+
+        # CO2 enhancement relative to 400 ppm for the measured 400 ppm input
+        co2_in = 400.0
+        temp_factor = xp.clip(1.0 + (T - 20.0) * 0.02, 0.5, 1.5)
+        light_factor = S / (S + 200.0)
+        vmax = 2.0 * temp_factor * light_factor
+        km = 800.0 * (1.0 - temp_factor * 0.2)
+        baseline = vmax * 400.0 / (km + 400.0)
+        co2_factor = xp.where(baseline > 0, (vmax * co2_in / (km + co2_in)) / xp.where(baseline > 0, baseline, 1.0), 1.0)
+
+        # Humidity PID
+        optimal_rh = xp.clip((es - sp.target_vpd) / es * 100.0, 30.0, 95.0)
+        h_error = optimal_rh - RH
+        h_integral = st.humidity_integral + h_error
+        h_derivative = h_error - st.humidity_previous
+        h_out = pid['humidity']['kp'] * h_error + pid['humidity']['ki'] * h_integral + pid['humidity']['kd'] * h_derivative
+        h_energy = xp.where(h_out > 5.0, xp.minimum(100.0, h_out) * 0.005,
+                            xp.where(h_out < -5.0, xp.minimum(100.0, xp.abs(h_out)) * 0.012, 0.1))
+        st.commit('humidity_integral', h_integral)
+        st.commit('humidity_previous', h_error)
+
+        # CO2 PID
+        target_co2 = xp.where(light_on, sp.target_co2, sp.ambient_co2)
+        c_error = target_co2 - co2_in
+        c_integral = st.co2_integral + c_error
+        c_derivative = c_error - st.co2_previous
+        c_out = pid['co2']['kp'] * c_error + pid['co2']['ki'] * c_integral + pid['co2']['kd'] * c_derivative
+        inject = (c_error > sp.co2_tolerance) & light_on
+        ventilate = ~inject & (c_error < -sp.co2_tolerance)
+        injection_rate = xp.minimum(eq.co2_injection_rate, xp.maximum(0.0, c_out * 0.5))
+        co2_cost = xp.where(inject, injection_rate * 0.001 * 60 * 0.002, 0.0)
+        c_energy = xp.where(inject, 0.05,
+                            xp.where(ventilate, xp.minimum(2.0, xp.abs(c_error) / 100.0) * 0.1, 0.02))
+        st.commit('co2_integral', c_integral)
+        st.commit('co2_previous', c_error)
+
+        return {
+            'ppfd': S * 45.0,
+            'light_on': light_on,
+            'vpd': vpd,
+            'co2': xp.where(light_on, sp.target_co2, sp.ambient_co2).astype(float),
+            'photosynthesis_factor': photo * co2_factor,
+            'transpiration_factor': transp,
+            'cost': (h_energy + c_energy) * eq.electricity_cost + co2_cost
+        }
+
+    def _phenology(self, st: EnsembleState, T, daylength: float) -> Dict[str, np.ndarray]:
+        xp = self.xp
+        p = self.prototype.phenology_model.params
+        tb, t1, t2, tmax = (p.base_temperature, p.optimal_temperature_min,
+                            p.optimal_temperature_max, p.maximum_temperature)
+        scale = p.thermal_time_scale
+        tt = xp.where((T <= tb) | (T >= tmax), 0.0,
+                      xp.where(T <= t1, scale * (T - tb) * (T - tb) / (t1 - tb),
+                               xp.where(T <= t2, scale * (T - tb),
+                                        scale * (tmax - T) / (tmax - t2) * (T - tb))))
+
+        if not p.photoperiod_sensitive:
+            photoperiod = xp.ones(st.n_members)
+        else:
+            if daylength > p.critical_photoperiod:
+                long_day = min(1.5, 1.0 + (daylength - p.critical_photoperiod) * p.photoperiod_slope)
+            else:
+                long_day = 0.8
+            photoperiod = xp.where(self.stage_starts_v[st.stage], 1.0,
+                                   xp.where(self.stage_long_day[st.stage], long_day, 1.0))
+
+        # The simulator calls phenology before stress is known (water 0, temperature 1)
+        water_factor = p.stress_acceleration_factor if 0.0 < p.drought_threshold else 1.0
+        stress_factor = max(water_factor, 1.0)
+
+        development = tt * photoperiod * stress_factor
+        accumulated = st.thermal_accumulated + development
+        st.commit('thermal_total', st.thermal_total + development)
+        progress = xp.where(st.thermal_required > 0, accumulated / st.thermal_required, st.stage_progress)
+
+        next_stage = self.stage_next[st.stage]
+        transition = (progress >= 1.0) & (next_stage != st.stage)
+        st.commit('stage', xp.where(transition, next_stage, st.stage))
+        st.commit('thermal_accumulated', xp.where(transition, 0.0, accumulated))
+        st.commit('thermal_required', xp.where(transition, self.stage_requirement[next_stage], st.thermal_required))
+        st.commit('stage_progress', xp.where(transition, 0.0, progress))
+
+        return {'thermal_time': tt, 'development_rate': development}
+
+    def _temperature_stress(self, st: EnsembleState, T) -> Dict[str, np.ndarray]:
+        """Air temperature stress with acclimation, memory and damage."""
+        xp = self.xp
+        p = self.prototype.temperature_stress.params
+        t_min, t_max = p.optimal_temp_min, p.optimal_temp_max
+
+        optimal = (T >= t_min) & (T <= t_max)
+        stype = xp.where(optimal, TEMP_OPTIMAL,
+                         xp.where(T < p.frost_threshold, TEMP_FROST,
+                                  xp.where(T < t_min, TEMP_COLD, TEMP_HEAT)))
+        heat = stype == TEMP_HEAT
+        cold = (stype == TEMP_COLD) | (stype == TEMP_FROST)
+
+        # Base stress level
+        heat_base = xp.where(
+            T <= p.heat_threshold_mild,
+            0.3 * ((T - t_max) / (p.heat_threshold_mild - t_max)),
+            xp.where(T <= p.heat_threshold_severe,
+                     0.3 + 0.4 * ((T - p.heat_threshold_mild) / (p.heat_threshold_severe - p.heat_threshold_mild)),
+                     0.7 + 0.3 * xp.minimum(1.0, (T - p.heat_threshold_severe) /
+                                            (p.heat_lethal_temperature - p.heat_threshold_severe))))
+        cold_base = xp.where(
+            T >= p.cold_threshold_mild,
+            0.2 * ((t_min - T) / (t_min - p.cold_threshold_mild)),
+            xp.where(T >= p.cold_threshold_severe,
+                     0.2 + 0.3 * ((p.cold_threshold_mild - T) / (p.cold_threshold_mild - p.cold_threshold_severe)),
+                     xp.where(T >= p.frost_threshold,
+                              0.5 + 0.3 * ((p.cold_threshold_severe - T) /
+                                           (p.cold_threshold_severe - p.frost_threshold)),
+                              0.8 + 0.2 * xp.minimum(1.0, xp.abs(T - p.frost_threshold) / 5.0))))
+        base = xp.where(optimal, 0.0, xp.where(T > t_max, heat_base, cold_base))
+
+        # Acclimation
+        decay = 1.0 - p.acclimation_decay_rate
+        heat_target = xp.minimum(1.0, (T - t_max) / (p.heat_threshold_severe - t_max))
+        cold_target = xp.minimum(1.0, (t_min - T) / (t_min - p.cold_threshold_severe))
+        heat_acc = xp.where(heat, st.heat_acclimation + p.acclimation_rate * (heat_target - st.heat_acclimation),
+                            st.heat_acclimation * decay)
+        cold_acc = xp.where(cold, st.cold_acclimation + p.acclimation_rate * (cold_target - st.cold_acclimation),
+                            st.cold_acclimation * decay)
+        heat_acc = xp.clip(heat_acc, 0.0, 1.0)
+        cold_acc = xp.clip(cold_acc, 0.0, 1.0)
+        st.commit('heat_acclimation', heat_acc)
+        st.commit('cold_acclimation', cold_acc)
+
+        adjusted = xp.where(heat, base * (1.0 - heat_acc * 0.4),
+                            xp.where(cold, base * (1.0 - cold_acc * 0.5), base))
+
+        # Memory: recency-weighted mean of the stored final stress levels
+        m = st.stress_memory.shape[1]
+        count = st.stress_memory_count
+        rank = xp.arange(m)[None, :] - (m - count)[:, None] + 1
+        weights = xp.where(rank >= 1, rank, 0).astype(float)
+        weight_sum = weights.sum(axis=1)
+        memory = xp.where(weight_sum > 0,
+                          (weights * st.stress_memory).sum(axis=1) / xp.where(weight_sum > 0, weight_sum, 1.0)
+                          * p.memory_effect_strength, 0.0)
+        final = xp.minimum(1.0, adjusted + memory)
+
+        # Process factors by stress type
+        def factor(heat_sens, cold_sens):
+            return xp.where(heat, xp.maximum(0.0, 1.0 - final * heat_sens),
+                            xp.where(cold, xp.maximum(0.0, 1.0 - final * cold_sens), 1.0))
+
+        f_photo = factor(p.photosynthesis_heat_sensitivity, p.photosynthesis_cold_sensitivity)
+        f_resp = factor(p.respiration_heat_sensitivity, p.respiration_cold_sensitivity)
+        f_growth = factor(p.growth_heat_sensitivity, p.growth_cold_sensitivity)
+        f_dev = factor(p.development_heat_sensitivity, p.development_cold_sensitivity)
+        f_overall = f_photo * 0.35 + f_growth * 0.35 + f_dev * 0.20 + f_resp * 0.10
+
+        damage = xp.maximum(xp.maximum(st.heat_damage, st.cold_damage), st.frost_damage)
+        damage_factor = xp.where(damage > 0, 1.0 - damage * 0.5, 1.0)
+        f_photo = f_photo * damage_factor
+        f_growth = f_growth * damage_factor
+        f_overall = f_overall * damage_factor
+
+        # Damage accumulation and recovery
+        heat_damaging = heat & (final > p.heat_damage_threshold)
+        recovering = ~heat_damaging & ~cold
+        heat_d = xp.where(heat_damaging,
+                          xp.minimum(1.0, st.heat_damage + (final - p.heat_damage_threshold) * 0.01),
+                          xp.where(recovering, xp.maximum(0.0, st.heat_damage - p.recovery_rate_heat),
+                                   st.heat_damage))
+        frost_d = xp.where(cold & (stype == TEMP_FROST),
+                           xp.minimum(1.0, st.frost_damage + p.frost_damage_rate / 24.0),
+                           xp.where(recovering, xp.maximum(0.0, st.frost_damage - p.recovery_rate_cold * 0.5),
+                                    st.frost_damage))
+        cold_d = xp.where(cold & (final > p.cold_damage_threshold),
+                          xp.minimum(1.0, st.cold_damage + (final - p.cold_damage_threshold) * 0.008),
+                          xp.where(recovering, xp.maximum(0.0, st.cold_damage - p.recovery_rate_cold),
+                                   st.cold_damage))
+        # Recovery only acts on positive damage, which the floor at zero reproduces
+        st.commit('heat_damage', heat_d)
+        st.commit('cold_damage', cold_d)
+        st.commit('frost_damage', frost_d)
+
+        # Append the final stress level to the memory window
+        shifted = xp.concatenate([st.stress_memory[:, 1:], final[:, None]], axis=1)
+        st.commit('stress_memory', shifted)
+        st.commit('stress_memory_count', xp.minimum(m, count + 1))
+
+        return {'overall': f_overall, 'photosynthesis': f_photo, 'growth': f_growth}
+
+    def _stress(self, st: EnsembleState, T, S, vpd, conc, ph, previous_tank) -> Dict[str, Any]:
+        """Unified stress factors (single source of truth of the simulator)."""
+        xp = self.xp
+        params = self.params
+        n = st.n_members
+
+        ec = xp.clip((conc * st.ec_coefficients[None, :] * st.nutrient_present).sum(axis=1), 0.05, 5.0)
+
+        # Solution temperature with thermal mass lag
+        thermal_mass = xp.clip(previous_tank / 1000.0, 0.1, 1.0)
+        prev_ts = xp.where(xp.isnan(st.solution_temperature), T, st.solution_temperature)
+        ts = prev_ts + (T + S * 0.15 - prev_ts) * (0.3 / thermal_mass)
+        ts = xp.clip(ts, 10.0, 35.0)
+        if st.solution_temperature_override is not None:
+            ts = xp.asarray(st.solution_temperature_override)
+        st.commit('solution_temperature', ts)
+
+        temp_stress = self._temperature_stress(st, T)
+        air_factor = temp_stress['overall']
+
+        root_dev = xp.abs(ts - params.optimal_root_temp)
+        root_factor = xp.where(root_dev > params.root_temp_tolerance,
+                               xp.maximum(0.0, 1.0 - (root_dev - params.root_temp_tolerance) * params.root_temp_stress_factor),
+                               1.0)
+        combined = xp.minimum(air_factor, root_factor)
+
+        vpd_dev = xp.abs(vpd - 0.8)
+        water_level = xp.where(vpd_dev <= 0.5, 0.0, xp.minimum(0.3, (vpd_dev - 0.5) * 0.2))
+        water = xp.maximum(0.0, 1.0 - water_level)
+
+        light = xp.minimum(1.0, xp.maximum(0.0, S / 12.0))
+
+        no3 = conc[:, st.no3_column] if st.no3_column >= 0 else xp.zeros(n)
+        if st.no3_column >= 0:
+            no3 = xp.where(st.nutrient_present[:, st.no3_column], no3, 0.0)
+        n_level = xp.where(no3 < 20.0, 0.8,
+                           xp.where(no3 < 100.0, 0.8 * (100.0 - no3) / 80.0,
+                                    xp.where(no3 <= 400.0, 0.0, xp.minimum(0.3, (no3 - 400.0) / 1000.0))))
+        nitrogen = xp.maximum(0.0, 1.0 - n_level)
+
+        salinity = xp.where(ec > 1.8, xp.maximum(0.0, 1.0 - (ec - 1.8) / 2.0), 1.0)
+        ph_dev = xp.minimum(xp.abs(ph - 5.5), xp.abs(ph - 6.5))
+        ph_factor = xp.where((ph >= 5.5) & (ph <= 6.5), 1.0, xp.maximum(0.0, 1.0 - ph_dev * 0.2))
+        oxygen = st.oxygen_factor
+
+        overall = combined * water * light * nitrogen * salinity * ph_factor * oxygen
+        factors = xp.stack([combined, water, light, nitrogen, salinity, ph_factor, oxygen], axis=1)
+
+        return {
+            'temperature_factor': combined,
+            'air_temp_factor': air_factor,
+            'root_temp_factor': root_factor,
+            'water_factor': water,
+            'light_factor': light,
+            'nitrogen_factor': nitrogen,
+            'salinity_factor': salinity,
+            'ph_factor': ph_factor,
+            'oxygen_factor': oxygen,
+            'overall': overall,
+            'levels': 1.0 - factors,
+            'water_level': water_level,
+            'nitrogen_level': n_level,
+            'ec': ec,
+            'solution_temperature': ts,
+            'temperature_photosynthesis': temp_stress['photosynthesis'],
+            'temperature_growth': temp_stress['growth']
+        }
+
+    def _cultivar_performance(self, st: EnsembleState, stress: Dict[str, Any]) -> Dict[str, np.ndarray]:
+        """Yield index of GenotypeEnvironmentModel.predict_cultivar_performance."""
+        xp = self.xp
+        numeric = xp.stack([
+            stress['temperature_factor'], stress['air_temp_factor'], stress['root_temp_factor'],
+            stress['water_factor'], stress['light_factor'], stress['nitrogen_factor'],
+            stress['salinity_factor'], stress['ph_factor'], stress['oxygen_factor'], stress['overall'],
+            stress['ec'], stress['solution_temperature'], stress['water_level'], stress['nitrogen_level']
+        ], axis=1)
+        overall_stress = xp.abs(numeric).mean(axis=1)
+        leaf_size = xp.clip(st.leaf_size_trait * (1.0 - overall_stress * self.overall_stress_weight), 0.0, 1.0)
+        yield_index = (leaf_size * 0.3 + st.chlorophyll_trait * 0.2 + (1.0 - st.nitrate_trait) * 0.2 +
+                       st.root_trait * 0.15 + st.yield_potential * 0.15)
+        return {'yield_index': yield_index, 'adaptation_index': st.adaptation_index}
+
+    def _photosynthesis(self, env, T, daylength: float, lai) -> Dict[str, Any]:
+        xp = self.xp
+        model = self.prototype.photosynthesis_model
+        p = model.params
+        co2 = env['co2']
+        par = env['ppfd']
+        temp_k = T + 273.15
+        vcmax = p.vcmax_25 * xp.exp(p.eav * (temp_k - 298.15) / (298.15 * p.r * temp_k))
+        jmax = p.jmax_25 * xp.exp(p.eaj * (temp_k - 298.15) / (298.15 * p.r * temp_k))
+        i2 = p.alpha * par
+        j = (i2 + jmax - xp.sqrt((i2 + jmax) ** 2 - 4 * p.theta * i2 * jmax)) / (2 * p.theta)
+
+        # Daily assimilation for all members in one call
+        gross = model.calculate_daily_assimilation_array(par, co2, T, lai, daylength)
+
+        # Diagnostic rates reported by the simulator (ci = ambient, fixed O2 term)
+        ci_diag = co2
+        ac_diag = vcmax * (ci_diag - p.gamma_star) / (ci_diag + p.kc * (1 + 210000 / p.ko))
+        aj_diag = j * (ci_diag - p.gamma_star) / (4 * (ci_diag + 2 * p.gamma_star))
+
+        n = len(T)
+        return {
+            'gross': gross,
+            'rubisco_limited': ac_diag,
+            'light_limited': aj_diag,
+            'gamma_star': xp.full(n, p.gamma_star),
+            'vcmax_25': xp.full(n, p.vcmax_25),
+            'jmax_25': xp.full(n, p.jmax_25),
+            'alpha': xp.full(n, p.alpha)
+        }
+
+    def _respiration(self, st: EnsembleState, T) -> Dict[str, np.ndarray]:
+        xp = self.xp
+        p = self.prototype.respiration_model.params
+
+        # Thermal acclimation of the reference temperature
+        m = st.respiration_history.shape[1]
+        history = xp.concatenate([st.respiration_history[:, 1:], T[:, None]], axis=1)
+        count = xp.minimum(m, st.respiration_history_count + 1)
+        valid = xp.arange(m)[None, :] >= (m - count)[:, None]
+        mean_temp = xp.where(valid, history, 0.0).sum(axis=1) / xp.maximum(1, count)
+        reference = xp.where(count >= 3,
+                             xp.clip(st.respiration_reference + (mean_temp - st.respiration_reference) * p.acclimation_rate,
+                                     15.0, 35.0),
+                             st.respiration_reference)
+        st.commit('respiration_history', history)
+        st.commit('respiration_history_count', count)
+        st.commit('respiration_reference', reference)
+
+        temp_factor = p.q10_factor ** ((T - st.respiration_reference) / 10.0)
+        temp_factor = xp.where(T > 40.0, temp_factor * xp.exp(-0.1 * (T - 40.0)), temp_factor)
+        temp_factor = xp.maximum(0.1, temp_factor)
+
+        age_factor = xp.minimum(1.0 + p.age_effect_coefficient * st.pool_age, p.max_age_effect)
+        n_factor = self.backend.set(
+            xp.ones_like(st.pool_mass), (slice(None), 0),
+            xp.clip(1.0 + p.n_effect_slope * (st.pool_nitrogen[:, 0] / p.reference_leaf_n - 1.0), 0.5, 2.0))
+        tissue = xp.array([p.tissue_factors.get(name, 1.0) for name in ORGANS])
+
+        tissue_resp = (p.maintenance_base_rate * st.pool_mass * temp_factor[:, None] *
+                       age_factor * n_factor * tissue[None, :])
+        mass = st.pool_mass.sum(axis=1)
+        safe_mass = xp.where(mass > 0, mass, 1.0)
+        return {
+            'maintenance': tissue_resp.sum(axis=1),
+            'tissue': tissue_resp,
+            'temperature_factor': xp.where(mass > 0, temp_factor * mass / safe_mass, 0.0),
+            'age_factor': xp.where(mass > 0, (age_factor * st.pool_mass).sum(axis=1) / safe_mass, 0.0)
+        }
+
+    def _rzt_factors(self, rzt, air_temperature):
+        xp = self.xp
+        p = self.prototype.rzt_model.params
+        optimal = xp.clip(air_temperature + p.optimal_rzt_offset, p.min_effective_rzt, p.max_effective_rzt)
+        growth = xp.where(rzt <= optimal,
+                          xp.where(rzt >= p.min_effective_rzt,
+                                   p.base_growth_factor + (optimal - rzt) * p.linear_growth_slope, 0.2),
+                          p.base_growth_factor - (rzt - optimal) * p.rapid_decline_slope)
+        nutrient = xp.where(rzt <= optimal, 1.0 + (optimal - rzt) * 0.06, 1.0 - (rzt - optimal) * 0.12)
+        return xp.clip(growth, 0.2, 1.5), xp.clip(nutrient, 0.3, 1.4)
+
+    def _roots(self, st: EnsembleState, day: int, stress: Dict[str, Any], conc) -> Dict[str, np.ndarray]:
+        """Seeded root architecture of every active member and batched Michaelis-Menten uptake."""
+        xp = self.xp
+        n = st.n_members
+        backend = self.backend
+
+        # Cohort aging, survival draws and new cohorts: each member's own model
+        # and random stream, exactly as RootArchitectureModel.daily_update in run_simulation
+        host = {key: np.broadcast_to(backend.to_host(stress[key]), (n,))
+                for key in ('nitrogen_factor', 'water_factor', 'temperature_factor', 'solution_temperature')}
+        metrics = backend.to_host(st.root_metrics).copy()
+        cohorts = backend.to_host(st.root_cohort_count).copy()
+        for i in np.flatnonzero(backend.to_host(st.active)):
+            architecture = st.root_architectures[i]
+            response = architecture.daily_update(
+                {'temperature': float(host['solution_temperature'][i]), 'flow_rate': 1.5, 'oxygen_level': 8.0},
+                {'nitrogen_stress': float(host['nitrogen_factor'][i]),
+                 'water_stress': float(host['water_factor'][i]),
+                 'temperature_stress': float(host['temperature_factor'][i])})
+            metrics[i] = [response[key] for key in ROOT_METRICS]
+            cohorts[i] = sum(zone.n_cohorts for zone in architecture.root_zones)
+        st.root_metrics = backend.asarray(metrics)
+        st.root_cohort_count = backend.asarray(cohorts)
+
+        m = st.root_metrics
+        length = m[:, 3:6]
+        surface = m[:, 1]
+        activity = m[:, 6]
+
+        # Uptake (EnhancedRootUptakeModel.calculate_nutrient_uptake, same operation order)
+        area = length * math.pi * (st.root_mean_diameter / 10.0) * st.root_effectiveness
+        effective_area = area[:, 0] + area[:, 1] + area[:, 2]
+        effective_area = xp.where(effective_area < 1e-6, surface * 0.7, effective_area)
+        temp_factor = xp.clip(st.root_q10 ** ((stress['solution_temperature'] - st.root_optimal_temperature) / 10.0),
+                              0.1, 4.0)
+        capacity = effective_area * temp_factor * st.root_flow_factor * activity
+
+        result = {
+            'length_density': m[:, 0],
+            'surface_area': surface,
+            'volume': m[:, 2],
+            'fine_length': length[:, 0],
+            'coarse_length': length[:, 2],
+            'cohorts': st.root_cohort_count,
+            'activity': activity
+        }
+        kernel = st.root_kernel
+        present = st.root_kernel_present
+        c = xp.where(present, conc[:, st.root_kernel_columns], 0.0)
+        rates = xp.where(present, kernel.rates(c, capacity), 0.0)
+        for j, root_key in enumerate(kernel.ions):
+            result[root_key] = rates[:, j]
+            result[f'solution_{root_key}'] = c[:, j]
+        return result
+
+    def _nitrogen(self, st: EnsembleState, n_input, growth, is_veg, stress_levels) -> Dict[str, np.ndarray]:
+        """Internal nitrogen remobilization and allocation (NitrogenBalanceModel)."""
+        xp = self.xp
+        p = self.prototype.nitrogen_model.params
+        pools = st.n_pools.copy()
+        total_n = st.n_total.copy()
+        mass = st.n_mass.copy()
+
+        efficiency = xp.array([p.remobilization_efficiency.get(o, 0.0) for o in ORGANS])
+        has_efficiency = xp.array([o in p.remobilization_efficiency for o in ORGANS])
+
+        # Stress-induced remobilization
+        overall_stress = 1.0 - stress_levels.min(axis=1)
+        stressed = (overall_stress > 0.3)[:, None] & has_efficiency[None, :]
+        storage_remob = pools[:, :, 2] * p.remobilization_rates['storage']
+        metabolic_remob = pools[:, :, 1] * p.remobilization_rates['metabolic'] * overall_stress[:, None]
+        transport_remob = pools[:, :, 3] * p.remobilization_rates['transport']
+        stress_remob = xp.where(stressed, (storage_remob + metabolic_remob + transport_remob) * efficiency, 0.0)
+        withdrawn = xp.stack([xp.zeros_like(storage_remob), metabolic_remob * overall_stress[:, None],
+                              storage_remob, transport_remob], axis=2)
+        pools = pools - xp.where(stressed[:, :, None], withdrawn, 0.0)
+
+        # Senescence-induced remobilization
+        senescence = xp.array([0.002, 0.001, 0.0005])
+        senescence_remob = xp.where(has_efficiency[None, :], total_n * senescence * efficiency * 0.5, 0.0)
+        remobilized = stress_remob.sum(axis=1) + senescence_remob.sum(axis=1)
+        available = n_input + remobilized
+
+        # Demand for new growth
+        optimal = xp.array([p.critical_n_concentrations[o]['optimal'] if o in p.critical_n_concentrations else 0.0
+                            for o in ORGANS])
+        has_critical = xp.array([o in p.critical_n_concentrations for o in ORGANS])
+        target = xp.tile(optimal, (st.n_members, 1))
+        target = self.backend.set(target, (slice(None), 0), xp.where(is_veg, target[:, 0] * 1.1, target[:, 0]))
+        demand = xp.where((growth > 0) & has_critical[None, :], growth * target, 0.0)
+        total_demand = demand.sum(axis=1)
+
+        # Allocation with stage priorities
+        coeffs = p.allocation_coefficients
+        veg_prio = coeffs['vegetative']
+        rep_prio = coeffs.get('reproductive', veg_prio)
+        def priority_row(prio, default):
+            return xp.array([prio.get(o, default) for o in ORGANS])
+        excess_prio = xp.where(is_veg[:, None], priority_row(veg_prio, 0.0)[None, :],
+                               priority_row(rep_prio, 0.0)[None, :])
+        weight_prio = xp.where(is_veg[:, None], priority_row(veg_prio, 0.25)[None, :],
+                               priority_row(rep_prio, 0.25)[None, :])
+        sufficient = available >= total_demand
+        excess = available - total_demand
+        weighted_demand = (demand * weight_prio).sum(axis=1)
+        proportional = xp.where(weighted_demand[:, None] > 0,
+                                available[:, None] * (demand * weight_prio) /
+                                xp.where(weighted_demand > 0, weighted_demand, 1.0)[:, None], 0.0)
+        allocated = xp.where(sufficient[:, None], demand + excess[:, None] * excess_prio, proportional)
+        allocated = xp.where((total_demand > 0)[:, None], allocated, 0.0)
+
+        # Organ updates
+        mass = xp.where(growth > 0, mass + growth, mass)
+        total_n = total_n + allocated
+        conc = xp.where(mass > 0, total_n / xp.where(mass > 0, mass, 1.0), st.n_conc)
+        pool_sum = pools.sum(axis=2)
+        rescale = (total_n > 0) & (pool_sum > 0)
+        scale = xp.where(rescale, total_n / xp.where(pool_sum > 0, pool_sum, 1.0), 1.0)
+        pools = pools * scale[:, :, None]
+
+        st.commit('n_pools', pools)
+        st.commit('n_total', total_n)
+        st.commit('n_mass', mass)
+        st.commit('n_conc', conc)
+
+        # Plant nitrogen stress level
+        critical = xp.array([p.critical_n_concentrations[o]['critical'] if o in p.critical_n_concentrations else 0.0
+                             for o in ORGANS])
+        organ_stress = xp.where(st.n_conc >= optimal, 0.0,
+                                xp.where(st.n_conc >= critical,
+                                         1.0 - (st.n_conc - critical) / (optimal - critical), 0.9))
+        weights = np.where([o in p.critical_n_concentrations for o in ORGANS], [0.5, 0.1, 0.3], 0.0)
+        total_weight = float(weights.sum())
+        stress_level = ((organ_stress * xp.asarray(weights)).sum(axis=1) / total_weight) if total_weight > 0 \
+            else xp.zeros(st.n_members)
+
+        return {'remobilized': remobilized, 'stress_level': xp.clip(stress_level, 0.0, 1.0)}
+
+    def _leaf_development(self, st: EnsembleState, T, stress) -> Dict[str, np.ndarray]:
+        """Leaf appearance and cohort expansion (LeafDevelopmentModel)."""
+        xp = self.xp
+        p = self.prototype.leaf_model.params
+        tt = xp.where((T <= p.min_temp) | (T >= p.max_temp), 0.0,
+                      xp.where(T <= p.opt_temp_min, (T - p.min_temp) / (p.opt_temp_min - p.min_temp) * (p.opt_temp_min - p.min_temp),
+                               xp.where(T <= p.opt_temp_max, T - p.min_temp,
+                                        (p.max_temp - T) / (p.max_temp - p.opt_temp_max) * (T - p.min_temp))))
+
+        water = stress['water_factor']
+        nitrogen = stress['nitrogen_factor']
+        water_f = xp.where(water < p.water_stress_threshold, xp.maximum(0.2, water / p.water_stress_threshold), 1.0)
+        nitrogen_f = xp.where(nitrogen < p.nitrogen_stress_threshold,
+                              xp.maximum(0.3, nitrogen / p.nitrogen_stress_threshold), 1.0)
+        temp_f = xp.maximum(0.1, 1.0 - (1.0 - stress['temperature_factor']) * p.temperature_stress_sensitivity)
+        appearance = water_f * temp_f
+        expansion = water_f * nitrogen_f * temp_f
+
+        # V-stage progression and new cohorts
+        cumulative = st.leaf_cumulative_tt + tt * appearance
+        threshold = xp.where(st.v_stage > 15, p.base_phyllochron * 1.3, p.base_phyllochron)
+        new_leaf = (cumulative >= threshold) & (st.v_stage < p.max_leaf_number) & st.active
+        v = st.v_stage
+        position = xp.where(v <= 5, 0.4 + (v - 1) * 0.15,
+                            xp.where(v <= 15, 1.0, xp.maximum(0.6, 1.0 - (v - 15) * 0.04)))
+        # New cohort slot of each member as a mask (no data-dependent indexing on the device)
+        new_slot = new_leaf[:, None] & (xp.arange(self.n_leaf_slots)[None, :] == (st.leaf_next_id - 1)[:, None])
+        st.leaf_area = self.backend.where_set(st.leaf_area, 0.001, new_slot)
+        st.leaf_max_area = self.backend.where_set(st.leaf_max_area,
+                                                (p.max_individual_leaf_area * position)[:, None], new_slot)
+        st.leaf_stage = self.backend.where_set(st.leaf_stage, LEAF_EMERGING, new_slot)
+        st.leaf_tt = self.backend.where_set(st.leaf_tt, 0.0, new_slot)
+        st.leaf_senescence = self.backend.where_set(st.leaf_senescence, 0.0, new_slot)
+        st.commit('leaf_next_id', xp.where(new_leaf, st.leaf_next_id + 1, st.leaf_next_id))
+        st.commit('v_stage', xp.where(new_leaf, v + 1.0, v))
+        st.commit('leaf_cumulative_tt', xp.where(new_leaf, 0.0, cumulative))
+
+        # Cohort area dynamics (each cohort follows the branch of its current stage)
+        exists = st.leaf_stage != LEAF_EMPTY
+        stage = st.leaf_stage
+        area = st.leaf_area
+        max_area = st.leaf_max_area
+        leaf_tt = xp.where(exists, st.leaf_tt + tt[:, None], st.leaf_tt)
+
+        emerging = stage == LEAF_EMERGING
+        expanding = stage == LEAF_EXPANDING
+        mature = stage == LEAF_MATURE
+        senescing = stage == LEAF_SENESCING
+
+        safe_max = xp.where(max_area > 0, max_area, 1.0)
+        expanded = xp.minimum(max_area, area + max_area * (p.leaf_area_expansion_rate * expansion[:, None]) *
+                              (1.0 - (area / safe_max) ** 2))
+        age = leaf_tt / 600.0
+        stress_senescence = ((1.0 - expansion) * 0.1)[:, None]
+        start_senescence = mature & ((age > 1.0) | (stress_senescence > 0.08))
+
+        new_area = xp.where(expanding, expanded,
+                            xp.where(senescing, xp.maximum(0.0, area - area * st.leaf_senescence), area))
+        new_stage = xp.where(emerging & (leaf_tt > 5.0), LEAF_EXPANDING,
+                             xp.where(expanding & (new_area >= 0.95 * max_area), LEAF_MATURE,
+                                      xp.where(start_senescence, LEAF_SENESCING, stage)))
+        new_rate = xp.where(start_senescence, xp.maximum(0.01, age * 0.005 + stress_senescence),
+                            st.leaf_senescence)
+        st.commit('leaf_tt', leaf_tt)
+        st.commit('leaf_area', new_area)
+        st.commit('leaf_stage', new_stage)
+        st.commit('leaf_senescence', new_rate)
+
+        total_area = xp.where(exists, st.leaf_area, 0.0).sum(axis=1)
+        active_count = (exists & (st.leaf_area > 0.001)).sum(axis=1)
+        return {'total_area': total_area, 'active_count': active_count}
+
+    def _canopy(self, lai, height, ppfd, day: int) -> Dict[str, np.ndarray]:
+        """Layered Beer's-law light distribution (CanopyArchitectureModel)."""
+        xp = self.xp
+        p = self.prototype.canopy_model.params
+        n_layers = p.number_of_layers
+        i = xp.arange(n_layers)
+        relative_height = (2 * n_layers - 2 * i - 1) / (2.0 * n_layers)
+        fraction = xp.where(relative_height > 0.8, 0.8,
+                            xp.where(relative_height > 0.5, 1.2,
+                                     xp.where(relative_height > 0.2, 0.9, 0.6)))
+        has_canopy = (lai > 0) & (height > 0)
+        layer_lai = xp.where(has_canopy[:, None], fraction[None, :] / n_layers * lai[:, None], 0.0)
+        lai_above = xp.cumsum(layer_lai, axis=1) - layer_lai
+
+        zenith = math.radians(30.0 + 20.0 * np.sin(day * 2 * np.pi / 365))
+        x = {'spherical': 1.0, 'planophile': 2.0 / math.pi, 'erectophile': 2.0,
+             'plagiophile': 1.33}.get(p.leaf_angle_distribution, 1.0)
+        k_beam = x / math.cos(zenith) if abs(math.cos(zenith)) > 0.001 else 10.0
+        k_diffuse = x * p.diffuse_extinction_coeff
+        k_beam *= p.clumping_index
+        k_diffuse *= p.clumping_index
+
+        beam = (ppfd * 0.6)[:, None] * xp.exp(-k_beam * lai_above)
+        diffuse = (ppfd * 0.4)[:, None] * xp.exp(-k_diffuse * lai_above)
+        if p.sunlit_fraction_method == "campbell":
+            safe_lai = xp.where(layer_lai > 0, layer_lai, 1.0)
+            sunlit = xp.where(layer_lai > 0, (1.0 - xp.exp(-k_beam * layer_lai)) / (k_beam * safe_lai), 0.0)
+        else:
+            sunlit = xp.exp(-k_beam * lai_above)
+        average = sunlit * (beam + diffuse) + (1.0 - sunlit) * (diffuse * 0.2)
+        absorbed = (beam * (1.0 - xp.exp(-k_beam * layer_lai)) +
+                    diffuse * (1.0 - xp.exp(-k_diffuse * layer_lai))) * p.leaf_absorptance
+
+        interception = xp.where(ppfd > 0, absorbed.sum(axis=1) / xp.where(ppfd > 0, ppfd, 1.0), 0.0)
+        plant_area = p.canopy_width * p.canopy_width
+        available_area = p.row_spacing * p.plant_spacing
+        coverage = min(1.0, plant_area / available_area) if available_area > 0 else 1.0
+        row_factor = 0.8 + 0.2 * coverage if coverage < 1.0 else 1.0
+
+        sunlit_lai = (sunlit * layer_lai).sum(axis=1)
+        total_absorbed = (average * layer_lai).sum(axis=1)
+        n = len(lai)
+        return {
+            'light_interception': interception * row_factor,
+            'extinction': xp.full(n, k_beam * 0.6 + k_diffuse * 0.4),
+            'sunlit_lai': sunlit_lai,
+            'shaded_lai': lai - sunlit_lai,
+            'total_absorbed_ppfd': total_absorbed,
+            'canopy_photosynthesis': total_absorbed * 0.05,
+            'layers': xp.full(n, n_layers),
+            'ppfd_top': average[:, 0],
+            'ppfd_bottom': average[:, -1]
+        }
+
+    def _water(self, T, RH, S, actual_vpd, light_interception, lai) -> Dict[str, np.ndarray]:
+        """Reference ET, crop ET, transpiration and water uptake per m²."""
+        xp = self.xp
+        es = 0.6108 * xp.exp(17.27 * T / (T + 237.3))
+        vpd = xp.maximum(0.0, es - es * RH / 100.0)
+        delta = 4098 * es / ((T + 237.3) ** 2)
+        gamma, u2 = 0.665, 2.0
+        radiation_term = 0.408 * delta * (S * 0.8)
+        aerodynamic_term = gamma * 900 / (T + 273) * u2 * vpd
+        eto = xp.clip((radiation_term + aerodynamic_term) / (delta + gamma * (1 + 0.34 * u2)), 0.5, 8.0)
+        etc = eto * (0.7 + 0.4 * light_interception)
+        transpiration = etc * xp.minimum(1.5, 0.8 + actual_vpd / 2.0) * light_interception
+        uptake = transpiration + lai * self.params.metabolic_water_per_lai
+        return {'eto': eto, 'etc': etc, 'vpd': vpd, 'transpiration': transpiration, 'uptake': uptake}
+
+    def _scalar_diagnostics(self, st: EnsembleState, growth, stress, is_veg, is_repro, T) -> Dict[int, Dict[str, Any]]:
+        """Step the diagnostic-only scalar models for each active member."""
+        # The scalar models run on the host: copy the inputs once per day
+        to_host = self.backend.to_host
+        growth, levels_array, T = to_host(growth), to_host(stress['levels']), to_host(T)
+        is_veg, is_repro = to_host(is_veg), to_host(is_repro)
+        pool_age, pool_mass, pool_nitrogen = st.host('pool_age'), st.host('pool_mass'), st.host('pool_nitrogen')
+        active = np.nonzero(st.host('active'))[0]
+
+        # Integrated stress: one batched update of the active members (NaN rows stay unchanged)
+        kernel, memory = st.stress_kernel, st.stress_memory
+        stress_levels = np.full((st.n_members, len(kernel.stress_types)), np.nan)
+        stress_levels[np.ix_(active, st.stress_columns)] = levels_array[np.ix_(active, st.stress_level_columns)]
+        kernel.update(memory, stress_levels)
+        overall = kernel.evaluate(memory).overall_stress_factor.tolist()
+        interaction = (memory.chronic_stress * memory.acute_stress).tolist()
+        acclimation, damage = memory.acclimation_level.tolist(), memory.damage_level.tolist()
+
+        out = {}
+        for i in active:
+            models = st.diagnostic_models[i]
+            levels = {key: float(levels_array[i, j]) for j, key in enumerate(STRESS_KEYS)}
+            stage = 'vegetative' if is_veg[i] else 'reproductive'
+
+            organ_demands = {}
+            for j, organ in enumerate(ORGANS):
+                g = float(growth[i, j])
+                organ_demands[organ] = {
+                    'nitrogen': g * 0.045,
+                    'phosphorus': g * 0.008,
+                    'potassium': g * 0.035,
+                    'calcium': g * 0.015,
+                    'magnesium': g * 0.006
+                }
+            mobility = models['mobility'].daily_update(
+                organ_demands=organ_demands,
+                stress_factors=levels,
+                senescence_rates={'leaves': 0.002, 'stems': 0.001, 'roots': 0.0005},
+                growth_stage=stage,
+                water_fluxes={'leaves': 0.25, 'stems': 0.15, 'roots': 0.35},
+                assimilate_fluxes={'leaves': 0.12, 'stems': 0.08, 'roots': 0.05},
+                temperature=float(T[i])
+            )
+
+            cohort_data = {}
+            for j, organ in enumerate(ORGANS):
+                cohort_data[j] = {
+                    'age_gdd': float(pool_age[i, j]) * 12.0,
+                    'area': float(pool_mass[i, j]) * 0.18,
+                    'biomass': float(pool_mass[i, j]),
+                    'canopy_position': 0.8 if organ == 'leaves' else 0.5,
+                    'nutrient_content': {
+                        'nitrogen': float(pool_nitrogen[i, j]) / 100.0,
+                        'phosphorus': 0.010,
+                        'potassium': 0.028
+                    }
+                }
+            environmental_stress = {key: levels[key] for key in ('water', 'nitrogen', 'temperature', 'light')}
+            senescence = models['senescence'].daily_update(
+                cohort_data, environmental_stress, {'is_reproductive': bool(is_repro[i])}
+            )
+
+            redistribution = getattr(mobility, 'total_redistribution', {})
+            out[int(i)] = {
+                'integrated_stress_factor': overall[i],
+                'stress_interactions': {f'{k}_interaction': value
+                                        for k, value in zip(kernel.stress_types, interaction[i])},
+                'acclimation_levels': dict(zip(kernel.stress_types, acclimation[i])),
+                'cumulative_damage': dict(zip(kernel.stress_types, damage[i])),
+                'senescence_rate': getattr(senescence, 'total_senescence_rate', 0.0),
+                'leaf_senescence_rate': getattr(senescence, 'leaf_senescence_rate', 0.0),
+                'nitrogen_remobilization': redistribution.get('nitrogen', 0.0) * 1000,
+                'phosphorus_remobilization': redistribution.get('phosphorus', 0.0) * 1000,
+                'potassium_remobilization': redistribution.get('potassium', 0.0) * 1000
+            }
+        return out
+
+    # ------------------------------------------------------------------
+    # Results
+    # ------------------------------------------------------------------
+
+    def _flush_records(self, records: List[Dict[str, Any]], columns: Dict[str, List[np.ndarray]]):
+        """Copy a chunk of daily records to the host: one (days, members, ...) transfer per column."""
+        if not records:
+            return
+        xp = self.xp
+        for key in records[0]:
+            stacked = xp.stack([xp.asarray(record[key]) for record in records])
+            columns.setdefault(key, []).append(self.backend.to_host(stacked))
+
+    def _build_results(self, st: EnsembleState, columns: Dict[str, np.ndarray],
+                       diagnostics: List[Optional[Dict[int, Dict[str, Any]]]]) -> List[SimulationResults]:
+        """Materialize per-member DailyResults and SimulationResults from host (days, members) columns."""
+        start = datetime.now()
+        skip = set(RECORD_CONSTRUCTOR_FIELDS) | {'nutrient_concentrations', 'growth_stage'}
+        final = {name: st.host(name) for name in FINAL_STATE_ARRAYS}
+
+        # Convert each column to per-member Python lists once
+        member_lists = {key: np.swapaxes(value, 0, 1).tolist() for key, value in columns.items()}
+        extra = [key for key in member_lists if key not in skip]
+
+        nutrient_columns = {nid: col for col, nid in enumerate(st.nutrient_ids)}
+        results = []
+        for i, member in enumerate(st.members):
+            n_days = int(final['days_completed'][i])
+            member_columns = [(nid, nutrient_columns[nid]) for nid in st.member_nutrients[i]]
+            values = {key: column[i] for key, column in member_lists.items()}
+            daily_results = []
+            for d in range(n_days):
+                row = values['nutrient_concentrations'][d]
+                result = DailyResults(
+                    day=d + 1,
+                    date=start + timedelta(days=d),
+                    nutrient_concentrations={nid: row[col] for nid, col in member_columns},
+                    **{key: values[key][d] for key in RECORD_CONSTRUCTOR_FIELDS}
+                )
+                result.growth_stage = self.stage_values[values['growth_stage'][d]]
+                for key in extra:
+                    setattr(result, key, values[key][d])
+                if diagnostics[d] is not None and i in diagnostics[d]:
+                    for key, value in diagnostics[d][i].items():
+                        setattr(result, key, value)
+                daily_results.append(result)
+
+            results.append(self._member_results(st, i, member, daily_results, start, final))
+        return results
+
+    def _member_results(self, st: EnsembleState, i: int, member: EnsembleMember,
+                        daily_results: List[DailyResults], start: datetime,
+                        final: Dict[str, np.ndarray]) -> SimulationResults:
+        cultivar = st.cultivars[i]
+        n_days = len(daily_results)
+        summary_stats = {}
+        if daily_results:
+            summary_stats = {
+                'final_temperature_C': daily_results[-1].temp_avg,
+                'final_vpd_kPa': daily_results[-1].vpd,
+                'final_ec_dS_m': daily_results[-1].ec,
+                'average_water_use_efficiency': np.mean([r.water_use_efficiency for r in daily_results]),
+                'total_transpiration_mm': sum([r.transpiration for r in daily_results]),
+                'total_water_consumption_L': sum([r.water_uptake_total for r in daily_results]),
+                'average_co2_umol_mol': np.mean([r.co2_concentration for r in daily_results]),
+                'average_photosynthesis_factor': np.mean([r.env_photosynthesis_factor for r in daily_results]),
+                'average_transpiration_factor': np.mean([r.env_transpiration_factor for r in daily_results]),
+                'current_lai': float(final['lai'][i]),
+                'current_canopy_height_cm': float(final['canopy_height'][i]) * 100,
+                'total_biomass_g': float(final['pool_mass'][i].sum()),
+                'leaf_biomass_g': float(final['pool_mass'][i, 0]),
+                'stem_biomass_g': float(final['pool_mass'][i, 1]),
+                'root_biomass_g': float(final['pool_mass'][i, 2]),
+                'cultivar_used': cultivar['cultivar_name'],
+                'simulation_type': 'CROPGRO_Advanced',
+                'total_days': n_days
+            }
+
+        results = SimulationResults(
+            system_id=f"CROPGRO_{cultivar['cultivar_id']}",
+            crop_id="LETTUCE_ADVANCED",
+            location_id="HYDROPONIC_LAB",
+            start_date=start,
+            end_date=start + timedelta(days=n_days),
+            total_days=n_days,
+            daily_results=daily_results,
+            summary_stats=summary_stats
+        )
+        results.metadata = {
+            'cultivar_id': cultivar['cultivar_id'],
+            'cultivar_name': cultivar['cultivar_name'],
+            'simulation_type': 'CROPGRO_Advanced',
+            'models_used': list(MODELS_USED),
+            'total_days': n_days,
+            'final_growth_stage': 'advanced_growth_modeling',
+            'ensemble_index': i,
+            'ensemble_label': member.label,
+            'maturity_reached': bool(final['maturity_reached'][i])
+        }
+        return results
+
+
+def ensemble_parity(input_data: HydroInputData, cultivar_id: str = 'HYDRO_001', max_days: int = 60,
+                    target_maturity: str = "harvest", columns: Sequence[str] = PARITY_COLUMNS,
+                    simulation_params: Optional[SimulationParameters] = None) -> Dict[str, float]:
+    """
+    Largest relative difference per daily column between a one-member ensemble
+    and run_simulation of the same seeded input, plus the difference in
+    simulated days ('total_days').
+
+    input_data.random_seed must be set so that both draw the same root
+    cohorts; with it, every deviation should be at floating-point noise.
+    """
+    if input_data.random_seed is None:
+        raise ValueError("ensemble_parity needs input_data.random_seed (root cohort draws)")
+    simulator = CROPGROHydroponicSimulator(cultivar_id=cultivar_id,
+                                           system_type=input_data.system_config.system_type,
+                                           simulation_params=simulation_params)
+    single = simulator.run_simulation(deepcopy(input_data), max_days=max_days, target_maturity=target_maturity)
+    ensemble = EnsembleSimulator(simulation_params=simulation_params, backend='numpy')
+    member = ensemble.run([EnsembleMember(deepcopy(input_data), cultivar_id)], max_days=max_days,
+                          target_maturity=target_maturity)[0]
+
+    days = min(len(single.daily_results), len(member.daily_results))
+    deviations = {'total_days': float(abs(single.total_days - member.total_days))}
+    for name in columns:
+        expected = np.array([float(getattr(r, name)) for r in single.daily_results[:days]])
+        actual = np.array([float(getattr(r, name)) for r in member.daily_results[:days]])
+        deviations[name] = (float(np.max(np.abs(actual - expected) / np.maximum(1e-9, np.abs(expected))))
+                            if days else 0.0)
+    return deviations
+
+
+def create_lettuce_ensemble_simulator(simulation_params: Optional[SimulationParameters] = None,
+                                      backend: Union[str, ArrayBackend, None] = None) -> EnsembleSimulator:
+    """Create an ensemble simulator configured like the single-run lettuce simulator."""
+    return EnsembleSimulator(simulation_params=simulation_params, backend=backend)
+
+
+def demonstrate_ensemble_engine():
+    """Demonstrate a small multi-scenario ensemble run."""
+    from .data.hydroponic_system import DefaultConfigurations
+    from .utils.weather_generator import WeatherGenerator
+
+    print("CROPGRO Ensemble Engine Demonstration")
+    print("=" * 80)
+
+    weather = WeatherGenerator().generate_weather_series(datetime.now(), 60)
+    members = []
+    for system_type, tank_volume in [('NFT', 1500.0), ('DWC', 1000.0), ('AEROPONICS', 800.0)]:
+        for cultivar_id in ['HYDRO_001']:
+            config = DefaultConfigurations.get_nft_lettuce_system()
+            config.system_type = system_type
+            config.tank_volume = tank_volume
+            input_data = HydroInputData(
+                system_config=config,
+                crop_params=DefaultConfigurations.get_lettuce_parameters(),
+                weather_data=weather,
+                nutrient_params=DefaultConfigurations.get_default_nutrients(),
+                simulation_days=60
+            )
+            members.append(EnsembleMember(input_data, cultivar_id, label=f"{system_type}_{tank_volume:.0f}"))
+
+    ensemble = create_lettuce_ensemble_simulator()
+    results = ensemble.run(members, max_days=60)
+
+    print(f"\n{'Member':<18} {'Days':>5} {'Stage':>6} {'Biomass (g)':>12} {'LAI':>6} {'Water (L)':>10}")
+    print("-" * 80)
+    for res in results:
+        final = res.daily_results[-1]
+        print(f"{res.metadata['ensemble_label']:<18} {res.total_days:>5} {final.growth_stage:>6} "
+              f"{res.summary_stats['total_biomass_g']:>12.2f} {res.summary_stats['current_lai']:>6.2f} "
+              f"{res.summary_stats['total_water_consumption_L']:>10.2f}")
+
+    # Parity with the single-run simulator for a seeded member
+    parity_input = deepcopy(members[0].input_data)
+    parity_input.random_seed = 42
+    deviations = ensemble_parity(parity_input, max_days=30)
+    print("\nParity with run_simulation (seed 42, 30 days), largest relative difference:")
+    for name, deviation in deviations.items():
+        print(f"  {name:<22} {deviation:.2e}")
+
+    return results
+
+
+if __name__ == "__main__":
+    demonstrate_ensemble_engine()
@@ -5,6 +5,7 @@ from .root_system_model import (
     RootType,
     HydroponicSystemType,
     RootCohort,
+    RootCohortStore,
     RootZoneLayer,
     RootArchitectureParameters,
     RootArchitectureModel,
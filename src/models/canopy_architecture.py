@@ -15,14 +15,24 @@ Research basis:
 - Norman & Campbell (1989) - Canopy structure
 - Goudriaan & van Laar (1994) - Modelling potential crop growth processes
 - Spitters et al. (1986) - Separating direct and diffuse radiation components
+
+Light integration modes (CanopyArchitectureParameters.light_integration):
+- "layered": reference path, Beer's law evaluated layer by layer
+- "analytic": the fixed layered LAI profile integrated in closed form with
+  array operations, memoized on a quantized (LAI, zenith angle, leaf angle
+  distribution, beam/diffuse fraction) key shared by all models in the process
 """
 
 import numpy as np
-from typing import Dict, Tuple, Optional, Any, List
+from collections import OrderedDict
+from typing import Dict, Tuple, Optional, Any, List, TYPE_CHECKING
 from dataclasses import dataclass
 from enum import Enum
 import math
 
+if TYPE_CHECKING:
+    from ..utils.config_loader import ConfigSnapshot
+
 
 class LeafAngleDistribution(Enum):
     """Leaf angle distribution types."""
@@ -34,6 +44,21 @@ class LeafAngleDistribution(Enum):
     UNIFORM = "uniform"           # Uniform distribution
 
 
+# Extinction factor x per leaf angle distribution (others default to spherical)
+LEAF_ANGLE_FACTORS = {
+    "spherical": 1.0,
+    "planophile": 2.0 / math.pi,
+    "erectophile": 2.0,
+    "plagiophile": 1.33
+}
+
+# Quantization of the analytic light cache key
+LAI_STEP = 1e-3                  # m²/m²
+ZENITH_STEP = 0.01               # degrees
+FRACTION_STEP = 1e-3             # beam / diffuse fraction
+LIGHT_CACHE_SIZE = 4096
+
+
 @dataclass
 class CanopyArchitectureParameters:
     """Parameters for canopy architecture model."""
@@ -70,6 +95,7 @@ class CanopyArchitectureParameters:
     # Photosynthesis scaling
     sunlit_fraction_method: str = "campbell"  # Method for calculating sunlit fraction (model constant)
     clumping_index: float = 0.9              # Leaf clumping index (0-1) (model constant)
+    light_integration: str = "layered"       # "layered" (reference) or "analytic" (cached closed form)
     
     def __post_init__(self):
         """Load parameters from JSON config if not provided."""
@@ -112,6 +138,7 @@ class CanopyArchitectureParameters:
             neighbor_shading_distance=config_dict.get('neighbor_shading_distance', 0.5),
             sunlit_fraction_method=config_dict.get('sunlit_fraction_method', 'campbell'),
             clumping_index=config_dict.get('clumping_index', 0.9),
+            light_integration=config_dict.get('light_integration', 'layered'),
         )
 
 
@@ -142,6 +169,97 @@ class LightEnvironment:
     solar_azimuth_angle: float = 180.0       # degrees solar azimuth angle
 
 
+@dataclass(frozen=True, eq=False)
+class LightProfile:
+    """
+    Closed-form light profile per unit of incident PPFD.
+
+    Per-layer arrays (read-only, shared through the cache) are relative to
+    ppfd_above_canopy = 1; multiply PPFD values by the incident PPFD.
+    """
+    k_beam: float
+    k_diffuse: float
+    layer_lai: np.ndarray                    # LAI of each layer
+    lai_above: np.ndarray                    # Cumulative LAI above each layer
+    fraction_sunlit: np.ndarray
+    ppfd_sunlit: np.ndarray                  # Relative PPFD on sunlit leaves
+    ppfd_shaded: np.ndarray                  # Relative PPFD on shaded leaves
+    ppfd_average: np.ndarray                 # Relative average PPFD
+    light_interception: float                # Absorbed fraction of incident PPFD
+    sunlit_lai: float
+    absorbed_per_ppfd: float                 # Σ ppfd_average × layer LAI per unit incident PPFD
+
+
+def layer_lai_weights(n_layers: int) -> np.ndarray:
+    """Fraction of total LAI in each layer (top first) of the lettuce LAI profile."""
+    i = np.arange(n_layers)
+    relative_height = (2 * n_layers - 2 * i - 1) / (2.0 * n_layers)
+    fraction = np.select([relative_height > 0.8, relative_height > 0.5, relative_height > 0.2],
+                         [0.8, 1.2, 0.9], 0.6)
+    return fraction / n_layers
+
+
+def integrate_light_profile(params: CanopyArchitectureParameters, total_lai: float,
+                            k_beam: float, k_diffuse: float,
+                            beam_fraction: float, diffuse_fraction: float) -> LightProfile:
+    """
+    Beer's law over the layered LAI profile, for the whole profile at once.
+
+    Absorption telescopes across layers (each layer absorbs the difference of
+    the transmissions at its top and bottom), so the intercepted fraction is
+    the closed form 1 - exp(-k L) of the profile's total LAI per component.
+    """
+    layer_lai = layer_lai_weights(params.number_of_layers) * total_lai
+    cumulative = np.cumsum(layer_lai)
+    lai_above = cumulative - layer_lai
+    profile_lai = float(cumulative[-1]) if len(cumulative) else 0.0
+
+    beam = beam_fraction * np.exp(-k_beam * lai_above)
+    diffuse = diffuse_fraction * np.exp(-k_diffuse * lai_above)
+    if params.sunlit_fraction_method == "campbell":
+        safe_lai = np.where(layer_lai > 0, layer_lai, 1.0)
+        sunlit = np.where(layer_lai > 0, -np.expm1(-k_beam * layer_lai) / (k_beam * safe_lai), 0.0)
+    else:
+        sunlit = np.exp(-k_beam * lai_above)
+    ppfd_sunlit = beam + diffuse
+    ppfd_shaded = diffuse * 0.2  # Shaded leaves get scattered light
+    ppfd_average = sunlit * ppfd_sunlit + (1.0 - sunlit) * ppfd_shaded
+
+    interception = params.leaf_absorptance * (beam_fraction * -math.expm1(-k_beam * profile_lai) +
+                                              diffuse_fraction * -math.expm1(-k_diffuse * profile_lai))
+    arrays = (layer_lai, lai_above, sunlit, ppfd_sunlit, ppfd_shaded, ppfd_average)
+    for array in arrays:
+        array.setflags(write=False)
+    return LightProfile(
+        k_beam=k_beam,
+        k_diffuse=k_diffuse,
+        layer_lai=layer_lai,
+        lai_above=lai_above,
+        fraction_sunlit=sunlit,
+        ppfd_sunlit=ppfd_sunlit,
+        ppfd_shaded=ppfd_shaded,
+        ppfd_average=ppfd_average,
+        light_interception=interception,
+        sunlit_lai=float(np.dot(sunlit, layer_lai)),
+        absorbed_per_ppfd=float(np.dot(ppfd_average, layer_lai))
+    )
+
+
+# Analytic light profiles by (parameter signature, quantized canopy state), least recently used first
+_light_profile_cache: 'OrderedDict[tuple, LightProfile]' = OrderedDict()
+_light_cache_stats = {'hits': 0, 'misses': 0}
+
+
+def light_cache_info() -> Dict[str, int]:
+    """Hits, misses and size of the analytic light cache."""
+    return {**_light_cache_stats, 'size': len(_light_profile_cache)}
+
+
+def clear_light_cache():
+    _light_profile_cache.clear()
+    _light_cache_stats.update(hits=0, misses=0)
+
+
 @dataclass
 class CanopyArchitectureResponse:
     """Daily canopy architecture calculation results."""
@@ -200,21 +318,9 @@ class CanopyArchitectureModel:
         # Convert to radians
         zenith_rad = math.radians(solar_zenith_angle)
         
-        # Leaf angle distribution factors
-        if leaf_angle_distribution == "spherical":
-            # Spherical leaf angle distribution (random)
-            x = 1.0  # Factor for spherical distribution
-        elif leaf_angle_distribution == "planophile":
-            # Horizontal leaves
-            x = 2.0 / math.pi
-        elif leaf_angle_distribution == "erectophile":
-            # Vertical leaves  
-            x = 2.0
-        elif leaf_angle_distribution == "plagiophile":
-            # 45-degree leaves
-            x = 1.33
-        else:
-            x = 1.0  # Default to spherical
+        # Leaf angle distribution factor (spherical = random, planophile = horizontal,
+        # erectophile = vertical, plagiophile = 45-degree leaves)
+        x = LEAF_ANGLE_FACTORS.get(leaf_angle_distribution, 1.0)
         
         # Calculate extinction coefficient for direct beam
         if abs(math.cos(zenith_rad)) > 0.001:
@@ -360,6 +466,62 @@ class CanopyArchitectureModel:
         
         return light_interception_fraction, avg_k
     
+    def calculate_light_profile(self, light_env: LightEnvironment, total_lai: float) -> LightProfile:
+        """
+        Analytic light profile for a canopy state (memoized).
+        
+        Inputs are quantized to LAI_STEP, ZENITH_STEP and FRACTION_STEP and the
+        profile is computed from the quantized values, so a cached result is
+        exactly what a fresh calculation of the same key would return.
+        
+        Args:
+            light_env: Light environment conditions (PPFD does not enter the key)
+            total_lai: Total leaf area index (0 when there is no canopy height)
+            
+        Returns:
+            LightProfile per unit of incident PPFD
+        """
+        p = self.params
+        key = (
+            p.number_of_layers, p.leaf_angle_distribution, p.diffuse_extinction_coeff, p.clumping_index,
+            p.leaf_absorptance, p.sunlit_fraction_method,
+            round(max(0.0, total_lai) / LAI_STEP),
+            round(light_env.solar_zenith_angle / ZENITH_STEP),
+            round(light_env.direct_beam_fraction / FRACTION_STEP),
+            round(light_env.diffuse_fraction / FRACTION_STEP)
+        )
+        profile = _light_profile_cache.get(key)
+        if profile is not None:
+            _light_profile_cache.move_to_end(key)
+            _light_cache_stats['hits'] += 1
+            return profile
+
+        _light_cache_stats['misses'] += 1
+        lai_q, zenith_q, beam_q, diffuse_q = key[-4:]
+        k_beam, k_diffuse = self.calculate_extinction_coefficient(zenith_q * ZENITH_STEP, p.leaf_angle_distribution)
+        profile = integrate_light_profile(p, lai_q * LAI_STEP, k_beam, k_diffuse,
+                                          beam_q * FRACTION_STEP, diffuse_q * FRACTION_STEP)
+        _light_profile_cache[key] = profile
+        if len(_light_profile_cache) > LIGHT_CACHE_SIZE:
+            _light_profile_cache.popitem(last=False)
+        return profile
+
+    def _apply_light_profile(self, profile: LightProfile, ppfd: float, canopy_height: float):
+        """Write an analytic profile (scaled to the incident PPFD) into the canopy layers."""
+        n_layers = len(self.canopy_layers)
+        thickness = canopy_height / n_layers if canopy_height > 0 else 0.0
+        density = profile.layer_lai / thickness if thickness > 0 else np.zeros(n_layers)
+        columns = zip(profile.lai_above.tolist(), density.tolist(), profile.fraction_sunlit.tolist(),
+                      (profile.ppfd_sunlit * ppfd).tolist(), (profile.ppfd_shaded * ppfd).tolist(),
+                      (profile.ppfd_average * ppfd).tolist())
+        for i, (layer, values) in enumerate(zip(self.canopy_layers, columns)):
+            (layer.cumulative_lai_above, layer.leaf_area_density, layer.fraction_sunlit,
+             layer.ppfd_sunlit, layer.ppfd_shaded, layer.ppfd_average) = values
+            layer.fraction_shaded = 1.0 - layer.fraction_sunlit
+            if thickness > 0:
+                layer.height_top = canopy_height - i * thickness
+                layer.height_bottom = canopy_height - (i + 1) * thickness
+
     def calculate_row_effects(self, row_spacing: float, plant_spacing: float,
                             canopy_width: float) -> float:
         """
@@ -426,13 +588,23 @@ class CanopyArchitectureModel:
         Returns:
             Canopy architecture response
         """
-        # Distribute leaf area through layers
-        self.distribute_leaf_area(total_lai, canopy_height)
-        
-        # Calculate light distribution
-        light_interception, avg_extinction = self.calculate_light_distribution(
-            light_env, total_lai
-        )
+        if self.params.light_integration == "analytic":
+            # Closed-form profile; the layer partition is fixed, so only LAI scales it
+            has_canopy = total_lai > 0 and canopy_height > 0
+            profile = self.calculate_light_profile(light_env, total_lai if has_canopy else 0.0)
+            self._apply_light_profile(profile, light_env.ppfd_above_canopy, canopy_height)
+            light_interception = profile.light_interception if light_env.ppfd_above_canopy > 0 else 0.0
+            avg_extinction = (profile.k_beam * light_env.direct_beam_fraction +
+                              profile.k_diffuse * light_env.diffuse_fraction)
+        else:
+            profile = None
+            # Distribute leaf area through layers
+            self.distribute_leaf_area(total_lai, canopy_height)
+            
+            # Calculate light distribution
+            light_interception, avg_extinction = self.calculate_light_distribution(
+                light_env, total_lai
+            )
         
         # Calculate temperature profile
         self.calculate_temperature_profile(air_temperature, total_lai)
@@ -451,17 +623,21 @@ class CanopyArchitectureModel:
         # Apply row effects to light interception
         effective_light_interception = light_interception * row_factor
         
-        # Calculate sunlit and shaded LAI
-        sunlit_lai = sum(layer.fraction_sunlit * 
-                        layer.leaf_area_density * (layer.height_top - layer.height_bottom)
-                        for layer in self.canopy_layers)
+        if profile is not None:
+            sunlit_lai = profile.sunlit_lai
+            total_absorbed = profile.absorbed_per_ppfd * light_env.ppfd_above_canopy
+        else:
+            # Calculate sunlit LAI
+            sunlit_lai = sum(layer.fraction_sunlit * 
+                            layer.leaf_area_density * (layer.height_top - layer.height_bottom)
+                            for layer in self.canopy_layers)
+            
+            # Calculate total absorbed PPFD
+            total_absorbed = sum(layer.ppfd_average * 
+                               layer.leaf_area_density * (layer.height_top - layer.height_bottom)
+                               for layer in self.canopy_layers)
         shaded_lai = total_lai - sunlit_lai
         
-        # Calculate total absorbed PPFD
-        total_absorbed = sum(layer.ppfd_average * 
-                           layer.leaf_area_density * (layer.height_top - layer.height_bottom)
-                           for layer in self.canopy_layers)
-        
         # Placeholder for canopy photosynthesis (would integrate with photosynthesis model)
         canopy_photosynthesis = total_absorbed * 0.05  # Rough conversion factor
         
@@ -477,11 +653,10 @@ class CanopyArchitectureModel:
             canopy_photosynthesis=canopy_photosynthesis
         )
     
-def create_lettuce_canopy_model() -> CanopyArchitectureModel:
+def create_lettuce_canopy_model(config: Optional['ConfigSnapshot'] = None) -> CanopyArchitectureModel:
     """Create canopy architecture model with lettuce-specific parameters from JSON config."""
-    from ..utils.config_loader import get_config_loader
-    config_loader = get_config_loader()
-    canopy_config = config_loader.get_canopy_architecture_parameters()
+    from ..utils.config_loader import get_config_snapshot
+    canopy_config = (config or get_config_snapshot()).canopy.to_dict()
     parameters = CanopyArchitectureParameters.from_config(canopy_config)
     return CanopyArchitectureModel(parameters)
 
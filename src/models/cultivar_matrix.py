@@ -0,0 +1,455 @@
+"""
+Cultivar Trait Matrix - Vectorized G×E Screening
+
+Column view of a cultivar catalog (cultivar × trait) for screening tens of
+thousands of profiles against many environments at once.
+
+The scoring functions reproduce CultivarProfile.calculate_adaptation_index,
+GenotypeEnvironmentModel.calculate_phenotype_expression and
+predict_cultivar_performance term by term, but over a cultivar × environment
+grid: trait columns broadcast against the environment factor columns, so one
+environment set costs a few array expressions instead of one Python call per
+cultivar, trait and environment. Top-N selection uses a partial sort
+(argpartition), and screen_cultivars scores catalogs in chunks of rows, in
+parallel threads (NumPy releases the GIL in the array kernels, and threads
+share the matrix without copying it), merging the per-chunk top-N
+candidates.
+"""
+
+import time
+import logging
+from concurrent.futures import ThreadPoolExecutor
+from dataclasses import dataclass
+from typing import Any, Dict, Iterable, List, Mapping, Optional, Sequence, Tuple, TYPE_CHECKING
+
+import numpy as np
+
+from .genetic_parameters import GeneticTrait
+
+if TYPE_CHECKING:
+    from .genetic_parameters import CultivarProfile, GeneticParameterDatabase
+    from ..utils.config_loader import ConfigSection
+
+logger = logging.getLogger(__name__)
+
+TRAITS: Tuple[GeneticTrait, ...] = tuple(GeneticTrait)
+TRAIT_INDEX: Dict[GeneticTrait, int] = {trait: i for i, trait in enumerate(TRAITS)}
+DEFAULT_TRAIT_VALUE = 0.5
+
+# Environment factors read by the G×E formulas, with the value used when absent
+ENVIRONMENT_DEFAULTS: Dict[str, float] = {
+    'temperature_stress': 0.0,   # > 0 heat, < 0 cold
+    'salinity_stress': 0.0,
+    'light_stress': 0.0,
+    'nutrient_stress': 0.0,
+    'water_stress': 0.0,
+    'nitrogen_excess': 0.0,
+    'light_intensity': 1.0,
+    'nitrogen_status': 1.0,
+}
+
+PERFORMANCE_METRICS = ('yield_index', 'quality_index', 'stress_tolerance', 'time_to_harvest',
+                       'bolting_resistance', 'adaptation_index')
+
+
+class CultivarTraitMatrix:
+    """
+    Trait matrix of a cultivar catalog.
+
+    Attributes:
+        cultivar_ids: Row labels
+        traits: (cultivars × len(GeneticTrait)) trait values, columns in GeneticTrait order
+        adaptation_score, yield_potential, commercial_rating, nitrate_efficiency:
+            Per-cultivar columns
+    """
+
+    def __init__(self, cultivar_ids: Sequence[str], traits: np.ndarray,
+                 adaptation_score: np.ndarray, yield_potential: np.ndarray,
+                 commercial_rating: np.ndarray, nitrate_efficiency: np.ndarray):
+        self.cultivar_ids: List[str] = list(cultivar_ids)
+        n = len(self.cultivar_ids)
+        self.traits = np.asarray(traits, dtype=float).reshape(n, len(TRAITS))
+        self.adaptation_score = np.asarray(adaptation_score, dtype=float).reshape(n)
+        self.yield_potential = np.asarray(yield_potential, dtype=float).reshape(n)
+        self.commercial_rating = np.asarray(commercial_rating, dtype=float).reshape(n)
+        self.nitrate_efficiency = np.asarray(nitrate_efficiency, dtype=float).reshape(n)
+        self._rows: Optional[Dict[str, int]] = None
+
+    def __len__(self) -> int:
+        return len(self.cultivar_ids)
+
+    @classmethod
+    def from_profiles(cls, profiles: Iterable['CultivarProfile']) -> 'CultivarTraitMatrix':
+        profiles = list(profiles)
+        traits = np.full((len(profiles), len(TRAITS)), DEFAULT_TRAIT_VALUE)
+        for row, profile in enumerate(profiles):
+            for trait, value in profile.trait_values.items():
+                traits[row, TRAIT_INDEX[trait]] = value
+        return cls(
+            cultivar_ids=[p.cultivar_id for p in profiles],
+            traits=traits,
+            adaptation_score=[p.adaptation_score for p in profiles],
+            yield_potential=[p.yield_potential for p in profiles],
+            commercial_rating=[p.commercial_rating for p in profiles],
+            nitrate_efficiency=[p.genetic_coefficients.NITRATE_EFFICIENCY for p in profiles]
+        )
+
+    @classmethod
+    def from_database(cls, genetic_db: 'GeneticParameterDatabase') -> 'CultivarTraitMatrix':
+        return cls.from_profiles(genetic_db.cultivars.values())
+
+    @classmethod
+    def from_columns(cls, cultivar_ids: Sequence[str], columns: Mapping[str, Sequence[float]]) -> 'CultivarTraitMatrix':
+        """
+        Matrix of an imported catalog given as columns.
+
+        Trait columns are keyed by GeneticTrait value (e.g. "heat_tolerance");
+        missing traits default to 0.5, and adaptation_score, yield_potential,
+        commercial_rating and nitrate_efficiency to the CultivarProfile /
+        GeneticCoefficients defaults.
+        """
+        n = len(cultivar_ids)
+        traits = np.full((n, len(TRAITS)), DEFAULT_TRAIT_VALUE)
+        for trait in TRAITS:
+            if trait.value in columns:
+                traits[:, TRAIT_INDEX[trait]] = np.asarray(columns[trait.value], dtype=float)
+
+        def column(name: str, default: float) -> np.ndarray:
+            return np.asarray(columns[name], dtype=float) if name in columns else np.full(n, default)
+
+        return cls(cultivar_ids, traits,
+                   adaptation_score=column('adaptation_score', 1.0),
+                   yield_potential=column('yield_potential', 1.0),
+                   commercial_rating=column('commercial_rating', 1.0),
+                   nitrate_efficiency=column('nitrate_efficiency', 0.85))
+
+    def trait(self, trait: GeneticTrait) -> np.ndarray:
+        return self.traits[:, TRAIT_INDEX[trait]]
+
+    def row_of(self, cultivar_id: str) -> int:
+        if self._rows is None:
+            self._rows = {cultivar_id: row for row, cultivar_id in enumerate(self.cultivar_ids)}
+        return self._rows[cultivar_id]
+
+    def take(self, rows) -> 'CultivarTraitMatrix':
+        """Sub-matrix of the given rows (a slice gives views, no copy)."""
+        ids = self.cultivar_ids[rows] if isinstance(rows, slice) else [self.cultivar_ids[i] for i in rows]
+        return CultivarTraitMatrix(ids, self.traits[rows], self.adaptation_score[rows],
+                                   self.yield_potential[rows], self.commercial_rating[rows],
+                                   self.nitrate_efficiency[rows])
+
+    def __repr__(self) -> str:
+        return f"CultivarTraitMatrix({len(self)} cultivars × {len(TRAITS)} traits)"
+
+
+class EnvironmentMatrix:
+    """
+    Environment factor matrix (environment × factor).
+
+    Absent factors take the defaults of the scalar formulas. Which factors
+    each environment actually specified is kept as well, since the default
+    phenotype modulation averages the stress over the given factors only.
+    """
+
+    def __init__(self, environments: Sequence[Mapping[str, Any]]):
+        self.environments: List[Mapping[str, Any]] = list(environments)
+        names = list(ENVIRONMENT_DEFAULTS)
+        for environment in self.environments:
+            names.extend(name for name in environment if name not in names and
+                         isinstance(environment[name], (int, float)))
+        self.factor_names: Tuple[str, ...] = tuple(names)
+        n = len(self.environments)
+        self.values = np.empty((n, len(names)))
+        self.given = np.zeros((n, len(names)), dtype=bool)
+        for row, environment in enumerate(self.environments):
+            for col, name in enumerate(names):
+                value = environment.get(name)
+                if isinstance(value, (int, float)):
+                    self.values[row, col] = value
+                    self.given[row, col] = True
+                else:
+                    self.values[row, col] = ENVIRONMENT_DEFAULTS.get(name, 0.0)
+
+    def __len__(self) -> int:
+        return len(self.environments)
+
+    def factor(self, name: str) -> np.ndarray:
+        return self.values[:, self.factor_names.index(name)]
+
+    def mean_abs_factor(self) -> np.ndarray:
+        """Mean |value| of the factors each environment gave (NaN when it gave none)."""
+        count = self.given.sum(axis=1)
+        total = np.where(self.given, np.abs(self.values), 0.0).sum(axis=1)
+        with np.errstate(invalid='ignore', divide='ignore'):
+            return total / count
+
+
+def as_environment_matrix(environments) -> EnvironmentMatrix:
+    if isinstance(environments, EnvironmentMatrix):
+        return environments
+    if isinstance(environments, Mapping):
+        environments = [environments]
+    return EnvironmentMatrix(environments)
+
+
+# =========================
+# Vectorized G×E scoring (cultivar × environment)
+# =========================
+
+def adaptation_index_matrix(matrix: CultivarTraitMatrix, environments,
+                            genetics: 'ConfigSection') -> np.ndarray:
+    """CultivarProfile.calculate_adaptation_index for every cultivar × environment."""
+    env = as_environment_matrix(environments)
+    temp_stress = env.factor('temperature_stress')[None, :]
+    heat_tolerance = matrix.trait(GeneticTrait.HEAT_TOLERANCE)[:, None]
+    cold_tolerance = matrix.trait(GeneticTrait.COLD_TOLERANCE)[:, None]
+
+    stress_adjustments = np.where(
+        temp_stress > 0,
+        temp_stress * (1.0 - heat_tolerance) * genetics.get('HEAT_STRESS_WEIGHT', 0.3),
+        np.abs(temp_stress) * (1.0 - cold_tolerance) * genetics.get('COLD_STRESS_WEIGHT', 0.25)
+    )
+    salinity_tolerance = matrix.trait(GeneticTrait.SALINITY_TOLERANCE)[:, None]
+    stress_adjustments = stress_adjustments + (env.factor('salinity_stress')[None, :] * (1.0 - salinity_tolerance)
+                                               * genetics.get('SALINITY_STRESS_WEIGHT', 0.2))
+    stress_adjustments = stress_adjustments + env.factor('light_stress')[None, :] * genetics.get('LIGHT_STRESS_WEIGHT', 0.15)
+    stress_adjustments = stress_adjustments + (env.factor('nutrient_stress')[None, :]
+                                               * (1.0 - matrix.nitrate_efficiency[:, None])
+                                               * genetics.get('NUTRIENT_STRESS_WEIGHT', 0.25))
+
+    return np.clip(matrix.adaptation_score[:, None] - stress_adjustments, 0.1, 1.0)
+
+
+def overall_score_matrix(matrix: CultivarTraitMatrix, environments, genetics: 'ConfigSection') -> np.ndarray:
+    """Score of GeneticParameterDatabase.get_best_cultivars_for_conditions (cultivar × environment)."""
+    adaptation = adaptation_index_matrix(matrix, environments, genetics)
+    return (adaptation * genetics.get('ADAPTATION_SCORE_WEIGHT', 0.6)
+            + matrix.yield_potential[:, None] * genetics.get('YIELD_POTENTIAL_BREEDING_WEIGHT', 0.25)
+            + matrix.commercial_rating[:, None] * genetics.get('COMMERCIAL_RATING_WEIGHT', 0.15))
+
+
+def phenotype_expression_matrix(matrix: CultivarTraitMatrix, environments,
+                                temperature_stress_weight: float = 0.5,
+                                nitrogen_excess_weight: float = 0.3,
+                                stress_response_weight: float = 0.2,
+                                overall_stress_weight: float = 0.1) -> np.ndarray:
+    """
+    GenotypeEnvironmentModel.calculate_phenotype_expression of every trait.
+
+    Returns:
+        (cultivars × environments × traits) expressed values (0-1)
+    """
+    env = as_environment_matrix(environments)
+    base = matrix.traits[:, None, :]
+    overall_stress = env.mean_abs_factor()
+    expression = base * (1.0 - overall_stress * overall_stress_weight)[None, :, None]
+
+    temp_stress = env.factor('temperature_stress')[None, :]
+    heat = TRAIT_INDEX[GeneticTrait.HEAT_TOLERANCE]
+    cold = TRAIT_INDEX[GeneticTrait.COLD_TOLERANCE]
+    expression[:, :, heat] = np.where(temp_stress > 0,
+                                      base[:, :, heat] * (1.0 - temp_stress * temperature_stress_weight),
+                                      base[:, :, heat])
+    expression[:, :, cold] = np.where(temp_stress < 0,
+                                      base[:, :, cold] * (1.0 + temp_stress * temperature_stress_weight),
+                                      base[:, :, cold])
+
+    chlorophyll = TRAIT_INDEX[GeneticTrait.CHLOROPHYLL_CONTENT]
+    expression[:, :, chlorophyll] = (base[:, :, chlorophyll] * env.factor('light_intensity')[None, :]
+                                     * env.factor('nitrogen_status')[None, :])
+
+    nitrate = TRAIT_INDEX[GeneticTrait.NITRATE_ACCUMULATION]
+    expression[:, :, nitrate] = base[:, :, nitrate] + env.factor('nitrogen_excess')[None, :] * nitrogen_excess_weight
+
+    root = TRAIT_INDEX[GeneticTrait.ROOT_DEVELOPMENT]
+    stress_response = np.maximum(env.factor('water_stress'), env.factor('nutrient_stress')) * stress_response_weight
+    expression[:, :, root] = base[:, :, root] + stress_response[None, :]
+
+    # NaN (environment without numeric factors) clips to 1.0 like min(1.0, nan)
+    return np.clip(np.nan_to_num(expression, nan=1.0), 0.0, 1.0)
+
+
+def performance_matrix(matrix: CultivarTraitMatrix, environments, genetics: 'ConfigSection',
+                       **expression_weights) -> Dict[str, np.ndarray]:
+    """GenotypeEnvironmentModel.predict_cultivar_performance metrics (each cultivar × environment)."""
+    env = as_environment_matrix(environments)
+    expression = phenotype_expression_matrix(matrix, env, **expression_weights)
+
+    def expressed(trait: GeneticTrait) -> np.ndarray:
+        return expression[:, :, TRAIT_INDEX[trait]]
+
+    nitrate = expressed(GeneticTrait.NITRATE_ACCUMULATION)
+    chlorophyll = expressed(GeneticTrait.CHLOROPHYLL_CONTENT)
+    return {
+        'yield_index': (expressed(GeneticTrait.LEAF_SIZE) * 0.3 + chlorophyll * 0.2 + (1.0 - nitrate) * 0.2
+                        + expressed(GeneticTrait.ROOT_DEVELOPMENT) * 0.15 + matrix.yield_potential[:, None] * 0.15),
+        'quality_index': (expressed(GeneticTrait.VITAMIN_C_CONTENT) * 0.3
+                          + expressed(GeneticTrait.CAROTENOID_CONTENT) * 0.25
+                          + (1.0 - nitrate) * 0.25 + chlorophyll * 0.2),
+        'stress_tolerance': (expressed(GeneticTrait.HEAT_TOLERANCE) * 0.3
+                             + expressed(GeneticTrait.COLD_TOLERANCE) * 0.25
+                             + expressed(GeneticTrait.SALINITY_TOLERANCE) * 0.25
+                             + expressed(GeneticTrait.DISEASE_RESISTANCE) * 0.2),
+        'time_to_harvest': 90 - expressed(GeneticTrait.DAYS_TO_HARVEST) * 30,
+        'bolting_resistance': expressed(GeneticTrait.BOLTING_TOLERANCE),
+        'adaptation_index': adaptation_index_matrix(matrix, env, genetics),
+    }
+
+
+# =========================
+# Top-N selection and chunked screening
+# =========================
+
+def top_n_rows(scores: np.ndarray, n: int, rows: Optional[np.ndarray] = None) -> np.ndarray:
+    """
+    Positions of the n highest scores, best first, by partial sort.
+
+    Ties keep the order of `rows` (default: position), as a stable
+    descending sort of the full list would.
+    """
+    scores = np.asarray(scores, dtype=float)
+    rows = np.arange(len(scores)) if rows is None else np.asarray(rows)
+    n = min(n, len(scores))
+    if n <= 0:
+        return np.empty(0, dtype=np.int64)
+    if n < len(scores):
+        threshold = np.partition(scores, len(scores) - n)[len(scores) - n]
+        above = np.flatnonzero(scores > threshold)
+        tied = np.flatnonzero(scores == threshold)
+        tied = tied[np.argsort(rows[tied], kind='stable')][:n - len(above)]
+        candidates = np.concatenate([above, tied])
+    else:
+        candidates = np.arange(len(scores))
+    return candidates[np.lexsort((rows[candidates], -scores[candidates]))]
+
+
+@dataclass
+class ScreeningResult:
+    """Top-N cultivars of every environment."""
+    metric: str
+    cultivar_ids: List[List[str]]        # Per environment, best first
+    scores: np.ndarray                   # (environments × n)
+    rows: np.ndarray                     # (environments × n) matrix rows
+    n_cultivars: int = 0
+    chunks: int = 0
+    elapsed_seconds: float = 0.0
+
+    def best_for(self, environment: int) -> List[Tuple[str, float]]:
+        return list(zip(self.cultivar_ids[environment], self.scores[environment].tolist()))
+
+
+def _chunk_scores(matrix: CultivarTraitMatrix, env: EnvironmentMatrix, metric: str,
+                  genetics: 'ConfigSection', expression_weights: Dict[str, float]) -> np.ndarray:
+    if metric == 'overall':
+        return overall_score_matrix(matrix, env, genetics)
+    if metric == 'adaptation_index':
+        return adaptation_index_matrix(matrix, env, genetics)
+    return performance_matrix(matrix, env, genetics, **expression_weights)[metric]
+
+
+def _screen_chunk(matrix: CultivarTraitMatrix, start: int, stop: int, env: EnvironmentMatrix,
+                  metric: str, top_n: int, genetics: 'ConfigSection',
+                  expression_weights: Dict[str, float]) -> Tuple[np.ndarray, np.ndarray]:
+    """Top-N rows and scores of one chunk of cultivars, per environment."""
+    scores = _chunk_scores(matrix.take(slice(start, stop)), env, metric, genetics, expression_weights)
+    k = min(top_n, stop - start)
+    rows = np.empty((len(env), k), dtype=np.int64)
+    best = np.empty((len(env), k))
+    for e in range(len(env)):
+        selected = top_n_rows(scores[:, e], k)
+        rows[e] = selected + start
+        best[e] = scores[selected, e]
+    return rows, best
+
+
+def screen_cultivars(matrix: CultivarTraitMatrix, environments, genetics: 'ConfigSection',
+                     top_n: int = 10, metric: str = 'overall', chunk_size: int = 4096,
+                     max_workers: Optional[int] = None,
+                     expression_weights: Optional[Dict[str, float]] = None) -> ScreeningResult:
+    """
+    Top-N cultivars of a catalog for each environment.
+
+    Args:
+        matrix: Cultivar catalog
+        environments: Environment factor dicts (or an EnvironmentMatrix)
+        genetics: Genetics config section (G×E weights)
+        top_n: Cultivars kept per environment
+        metric: 'overall' (database selection score) or one of PERFORMANCE_METRICS
+            (higher is better, time_to_harvest included as predicted)
+        chunk_size: Cultivars scored per array pass (bounds the
+            cultivar × environment × trait working set)
+        max_workers: Threads scoring chunks in parallel (None or 1: serial)
+        expression_weights: Phenotype expression weights (see phenotype_expression_matrix)
+    """
+    if metric != 'overall' and metric not in PERFORMANCE_METRICS:
+        raise ValueError(f"Unknown screening metric '{metric}'")
+    start_time = time.perf_counter()
+    env = as_environment_matrix(environments)
+    expression_weights = expression_weights or {}
+    chunk_size = max(1, chunk_size)
+    bounds = [(start, min(start + chunk_size, len(matrix))) for start in range(0, len(matrix), chunk_size)]
+
+    def run(bound):
+        return _screen_chunk(matrix, bound[0], bound[1], env, metric, top_n, genetics, expression_weights)
+
+    if max_workers and max_workers > 1 and len(bounds) > 1:
+        with ThreadPoolExecutor(max_workers=max_workers) as pool:
+            parts = list(pool.map(run, bounds))
+    else:
+        parts = [run(bound) for bound in bounds]
+
+    # Merge the per-chunk candidates (row order breaks ties, like a stable sort)
+    k = min(top_n, len(matrix))
+    rows = np.empty((len(env), k), dtype=np.int64)
+    scores = np.empty((len(env), k))
+    if parts:
+        candidate_rows = np.concatenate([part[0] for part in parts], axis=1)
+        candidate_scores = np.concatenate([part[1] for part in parts], axis=1)
+        for e in range(len(env)):
+            selected = top_n_rows(candidate_scores[e], k, candidate_rows[e])
+            rows[e] = candidate_rows[e, selected]
+            scores[e] = candidate_scores[e, selected]
+
+    elapsed = time.perf_counter() - start_time
+    logger.debug(f"Screened {len(matrix)} cultivars × {len(env)} environments in {elapsed:.3f}s")
+    return ScreeningResult(
+        metric=metric,
+        cultivar_ids=[[matrix.cultivar_ids[row] for row in env_rows] for env_rows in rows.tolist()],
+        scores=scores,
+        rows=rows,
+        n_cultivars=len(matrix),
+        chunks=len(bounds),
+        elapsed_seconds=elapsed
+    )
+
+
+def demonstrate_cultivar_screening(n_cultivars: int = 20000, n_environments: int = 50):
+    """Demonstrate screening a synthetic catalog against random environments."""
+    from .genetic_parameters import create_lettuce_genetic_system
+
+    print("=" * 80)
+    print("CULTIVAR TRAIT MATRIX SCREENING DEMONSTRATION")
+    print("=" * 80)
+
+    genetic_db, ge_model, _ = create_lettuce_genetic_system()
+    rng = np.random.default_rng(7)
+    columns = {trait.value: rng.uniform(0.2, 1.0, n_cultivars) for trait in TRAITS}
+    columns['adaptation_score'] = rng.uniform(0.8, 1.0, n_cultivars)
+    columns['yield_potential'] = rng.uniform(0.8, 1.2, n_cultivars)
+    catalog = CultivarTraitMatrix.from_columns([f"TRIAL_{i:05d}" for i in range(n_cultivars)], columns)
+    environments = [{'temperature_stress': float(t), 'salinity_stress': float(s), 'light_intensity': float(l)}
+                    for t, s, l in zip(rng.uniform(-0.5, 0.5, n_environments),
+                                       rng.uniform(0.0, 0.4, n_environments),
+                                       rng.uniform(0.6, 1.4, n_environments))]
+
+    for metric in ('overall', 'yield_index'):
+        result = ge_model.screen_cultivars(environments, top_n=5, metric=metric, matrix=catalog, max_workers=4)
+        print(f"\n{metric}: {result.n_cultivars} cultivars × {len(environments)} environments "
+              f"in {result.chunks} chunks, {result.elapsed_seconds:.2f} s")
+        for e in range(3):
+            best = ", ".join(f"{cid} ({score:.3f})" for cid, score in result.best_for(e)[:3])
+            print(f"  Environment {e}: {best}")
+
+
+if __name__ == "__main__":
+    demonstrate_cultivar_screening()
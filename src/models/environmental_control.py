@@ -9,6 +9,7 @@ Based on recent research (2021-2024):
 """
 
 import numpy as np
+from bisect import bisect_right
 from typing import Dict, Tuple, Optional, List
 from dataclasses import dataclass
 from enum import Enum
@@ -65,6 +66,53 @@ class EnvironmentalSetpoints:
         )
 
 
+@dataclass(frozen=True)
+class SetpointSchedule:
+    """
+    Piecewise-constant daily VPD, CO2 and root zone temperature setpoints.
+    
+    Phase i applies from day phase_starts[i] until the next phase starts; the
+    first phase starts on day 1. Schedules are hashable, so evaluated
+    schedules and shared phase prefixes can be cached.
+    """
+    phase_starts: Tuple[int, ...]
+    target_vpd: Tuple[float, ...]      # kPa
+    target_co2: Tuple[float, ...]      # μmol/mol during the photoperiod
+    target_rzt: Tuple[float, ...]      # °C solution temperature
+    
+    def __post_init__(self):
+        n = len(self.phase_starts)
+        if not n or self.phase_starts[0] != 1:
+            raise ValueError("The first setpoint phase must start on day 1")
+        if any(b <= a for a, b in zip(self.phase_starts, self.phase_starts[1:])):
+            raise ValueError(f"Setpoint phase starts must increase: {self.phase_starts}")
+        if not len(self.target_vpd) == len(self.target_co2) == len(self.target_rzt) == n:
+            raise ValueError("Every setpoint phase needs a VPD, CO2 and RZT target")
+    
+    @property
+    def n_phases(self) -> int:
+        return len(self.phase_starts)
+    
+    def phase_of(self, day: int) -> int:
+        return max(0, bisect_right(self.phase_starts, day) - 1)
+    
+    def setpoints_for_day(self, day: int) -> Tuple[float, float, float]:
+        """(VPD, CO2, RZT) targets of a simulation day."""
+        phase = self.phase_of(day)
+        return self.target_vpd[phase], self.target_co2[phase], self.target_rzt[phase]
+    
+    def daily_arrays(self, days: int) -> Tuple[np.ndarray, np.ndarray, np.ndarray]:
+        """VPD, CO2 and RZT targets of days 1..days."""
+        phase = np.searchsorted(self.phase_starts, np.arange(1, days + 1), side='right') - 1
+        return (np.asarray(self.target_vpd)[phase], np.asarray(self.target_co2)[phase],
+                np.asarray(self.target_rzt)[phase])
+    
+    def prefix(self, n_phases: int) -> Tuple:
+        """Key of the first n phases (equal for schedules that agree up to phase n)."""
+        return (self.phase_starts[:n_phases + 1],) + tuple(
+            zip(self.target_vpd[:n_phases], self.target_co2[:n_phases], self.target_rzt[:n_phases]))
+
+
 @dataclass
 class ControlEquipment:
     """Equipment specifications for environmental control."""
@@ -217,6 +265,11 @@ class EnvironmentalControlSystem:
         else:
             return 1.0
     
+    def calculate_controlled_humidity(self, temperature: float, target_vpd: float) -> float:
+        """Humidity the controller holds for a VPD target, within the humidity limits."""
+        rh = self.calculate_optimal_humidity(temperature, target_vpd)
+        return max(self.setpoints.min_humidity, min(self.setpoints.max_humidity, rh))
+    
     def calculate_vpd_stress_factor(self, current_vpd: float) -> Tuple[float, float, str]:
         """
         Calculate plant stress factor based on VPD.
@@ -530,6 +583,94 @@ class EnvironmentalControlSystem:
             }
         }
     
+    def calculate_hourly_control(self, temperatures: np.ndarray, humidities: np.ndarray,
+                                 co2: np.ndarray, light_intensities: np.ndarray,
+                                 light_on: np.ndarray) -> Dict[str, any]:
+        """
+        Vectorized PID control over a sequence of sub-daily steps.
+
+        Evaluates calculate_comprehensive_control (PID strategy) for every step
+        in one pass: the PID integral is a cumulative sum of the errors and the
+        derivative a first difference, continuing from and updating the
+        controller state exactly as consecutive scalar calls would.
+
+        Args:
+            temperatures, humidities, co2, light_intensities: Per-step arrays
+            light_on: Per-step boolean light schedule
+
+        Returns:
+            Dictionary of per-step arrays (VPD, plant factors, optimal humidity,
+            energy and cost)
+        """
+        temp = np.asarray(temperatures, dtype=float)
+        rh = np.asarray(humidities, dtype=float)
+        co2 = np.broadcast_to(np.asarray(co2, dtype=float), temp.shape)
+        light = np.broadcast_to(np.asarray(light_intensities, dtype=float), temp.shape)
+        light_on = np.broadcast_to(np.asarray(light_on, dtype=bool), temp.shape)
+        sp = self.setpoints
+
+        es = 0.6108 * np.exp(17.27 * temp / (temp + 237.3))
+        vpd = np.maximum(0.0, es - es * (rh / 100.0))
+        optimal_rh = np.clip((es - sp.target_vpd) / es * 100.0, 30.0, 95.0)
+
+        # VPD stress factors
+        low = sp.target_vpd - sp.vpd_tolerance
+        high = sp.target_vpd + sp.vpd_tolerance
+        transp_factor = np.where(vpd < low, np.maximum(0.4, 1.0 - (low - vpd) * 0.8),
+                                 np.where(vpd > high, np.maximum(0.3, 1.0 - (vpd - high) * 1.2), 1.0))
+        photo_factor = np.where(vpd < low, np.maximum(0.6, 1.0 - (low - vpd) * 0.5),
+                                np.where(vpd > high, np.maximum(0.4, 1.0 - (vpd - high) * 0.8), 1.0))
+
+        # CO2 enhancement (Michaelis-Menten relative to 400 ppm)
+        temp_factor = np.clip(1.0 + (temp - 20.0) * 0.02, 0.5, 1.5)
+        light_factor = light / (light + 200.0)
+        vmax = 2.0 * temp_factor * light_factor
+        km = 800.0 * (1.0 - temp_factor * 0.2)
+        baseline = vmax * 400.0 / (km + 400.0)
+        with np.errstate(divide='ignore', invalid='ignore'):
+            co2_factor = np.where(baseline > 0, (vmax * co2 / (km + co2)) / baseline, 1.0)
+
+        def pid_sequence(name: str, error: np.ndarray) -> np.ndarray:
+            params = self.pid_params[name]
+            integral = self.integral_errors[name] + np.cumsum(error)
+            previous = np.concatenate([[self.previous_errors[name]], error[:-1]])
+            derivative = error - previous
+            if error.size:
+                self.integral_errors[name] = float(integral[-1])
+                self.previous_errors[name] = float(error[-1])
+            return params['kp'] * error + params['ki'] * integral + params['kd'] * derivative
+
+        # Humidity PID
+        humidity_output = pid_sequence('humidity', optimal_rh - rh)
+        humidity_energy = np.where(humidity_output > 5.0, np.minimum(100.0, humidity_output) * 0.005,
+                                   np.where(humidity_output < -5.0,
+                                            np.minimum(100.0, np.abs(humidity_output)) * 0.012, 0.1))
+
+        # CO2 PID (enrichment only during the photoperiod)
+        co2_error = np.where(light_on, sp.target_co2, sp.ambient_co2) - co2
+        co2_output = pid_sequence('co2', co2_error)
+        inject = (co2_error > sp.co2_tolerance) & light_on
+        ventilate = ~inject & (co2_error < -sp.co2_tolerance)
+        injection_rate = np.where(inject, np.minimum(self.equipment.co2_injection_rate,
+                                                     np.maximum(0.0, co2_output * 0.5)), 0.0)
+        co2_cost = injection_rate * 0.001 * 60 * 0.002
+        co2_energy = np.where(inject, 0.05,
+                              np.where(ventilate, np.minimum(2.0, np.abs(co2_error) / 100.0) * 0.1, 0.02))
+
+        total_energy = humidity_energy + co2_energy
+        return {
+            'vpd_kPa': vpd,
+            'optimal_humidity': optimal_rh,
+            'vpd_transpiration_factor': transp_factor,
+            'vpd_photosynthesis_factor': photo_factor,
+            'co2_photosynthesis_factor': co2_factor,
+            'combined_photosynthesis_factor': photo_factor * co2_factor,
+            'co2_injection_rate': injection_rate,
+            'total_energy_kWh': total_energy,
+            'co2_cost': co2_cost,
+            'total_operating_cost': total_energy * self.equipment.electricity_cost + co2_cost
+        }
+
     def _determine_priority_action(self, current_vpd: float, current_co2: float, light_on: bool) -> str:
         """Determine the highest priority control action."""
         vpd_error = abs(current_vpd - self.setpoints.target_vpd)
@@ -12,11 +12,14 @@ Based on DSSAT CROPGRO framework adapted for Lactuca sativa cultivars.
 
 import math
 from dataclasses import dataclass, field
-from typing import Dict, List, Tuple, Optional, Any
+from typing import Dict, List, Tuple, Optional, Any, Sequence, TYPE_CHECKING
 from enum import Enum
 import numpy as np
 # Import centralized JSON config via config_loader
-from ..utils.config_loader import get_config_loader
+from ..utils.config_loader import ConfigSection, ConfigSnapshot, get_config_snapshot
+
+if TYPE_CHECKING:
+    from .cultivar_matrix import CultivarTraitMatrix, ScreeningResult
 
 
 class LettuceType(Enum):
@@ -114,8 +117,15 @@ class CultivarProfile:
     pedigree: List[str] = field(default_factory=list)
     breeding_notes: str = ""
     
-    def calculate_adaptation_index(self, environment_factors: Dict[str, float]) -> float:
-        """Calculate G×E adaptation index for specific environment"""
+    def calculate_adaptation_index(self, environment_factors: Dict[str, float],
+                                   genetics: Optional[ConfigSection] = None) -> float:
+        """Calculate G×E adaptation index for specific environment
+        
+        Args:
+            environment_factors: Environmental stress factors
+            genetics: Genetics config section (default: current config snapshot)
+        """
+        genetics_cfg = genetics if genetics is not None else get_config_snapshot().genetics
         base_adaptation = self.adaptation_score
         
         # Environmental stress adjustments
@@ -127,18 +137,15 @@ class CultivarProfile:
         cold_tolerance = self.trait_values.get(GeneticTrait.COLD_TOLERANCE, 0.5)
         
         if temp_stress > 0:  # Heat stress
-            genetics_cfg = get_config_loader().get_genetics_parameters()
             weight = genetics_cfg.get('HEAT_STRESS_WEIGHT', 0.3)
             stress_adjustments += temp_stress * (1.0 - heat_tolerance) * weight
         else:  # Cold stress
-            genetics_cfg = get_config_loader().get_genetics_parameters()
             weight = genetics_cfg.get('COLD_STRESS_WEIGHT', 0.25)
             stress_adjustments += abs(temp_stress) * (1.0 - cold_tolerance) * weight
         
         # Salinity stress
         salinity_stress = environment_factors.get('salinity_stress', 0.0)
         salinity_tolerance = self.trait_values.get(GeneticTrait.SALINITY_TOLERANCE, 0.5)
-        genetics_cfg = get_config_loader().get_genetics_parameters()
         stress_adjustments += salinity_stress * (1.0 - salinity_tolerance) * genetics_cfg.get('SALINITY_STRESS_WEIGHT', 0.2)
         
         # Light stress
@@ -158,8 +165,12 @@ class CultivarProfile:
 class GeneticParameterDatabase:
     """Database of lettuce cultivar genetic parameters"""
     
-    def __init__(self):
+    def __init__(self, config: Optional[ConfigSnapshot] = None):
+        self.config = config or get_config_snapshot()
+        self.genetics = self.config.genetics
         self.cultivars: Dict[str, CultivarProfile] = {}
+        # Trait matrix of the cultivars (rebuilt after add_cultivar)
+        self._trait_matrix: Optional['CultivarTraitMatrix'] = None
         self.initialize_cultivar_database()
     
     def initialize_cultivar_database(self):
@@ -350,6 +361,14 @@ class GeneticParameterDatabase:
     def add_cultivar(self, cultivar: CultivarProfile):
         """Add a cultivar to the database"""
         self.cultivars[cultivar.cultivar_id] = cultivar
+        self._trait_matrix = None
+    
+    def trait_matrix(self) -> 'CultivarTraitMatrix':
+        """Cultivar × trait matrix of the database, in insertion order."""
+        from .cultivar_matrix import CultivarTraitMatrix
+        if self._trait_matrix is None or len(self._trait_matrix) != len(self.cultivars):
+            self._trait_matrix = CultivarTraitMatrix.from_database(self)
+        return self._trait_matrix
     
     def get_cultivar(self, cultivar_id: str) -> Optional[CultivarProfile]:
         """Get cultivar by ID"""
@@ -359,21 +378,10 @@ class GeneticParameterDatabase:
                                         environment_factors: Dict[str, float],
                                         top_n: int = 3) -> List[Tuple[str, float]]:
         """Get best adapted cultivars for specific environmental conditions"""
-        cultivar_scores = []
-        
-        for cultivar_id, cultivar in self.cultivars.items():
-            adaptation_score = cultivar.calculate_adaptation_index(environment_factors)
-            genetics_cfg = get_config_loader().get_genetics_parameters()
-            overall_score = (
-                adaptation_score * genetics_cfg.get('ADAPTATION_SCORE_WEIGHT', 0.6)
-                + cultivar.yield_potential * genetics_cfg.get('YIELD_POTENTIAL_BREEDING_WEIGHT', 0.25)
-                + cultivar.commercial_rating * genetics_cfg.get('COMMERCIAL_RATING_WEIGHT', 0.15)
-            )
-            cultivar_scores.append((cultivar_id, overall_score))
-        
-        # Sort by score and return top N
-        cultivar_scores.sort(key=lambda x: x[1], reverse=True)
-        return cultivar_scores[:top_n]
+        from .cultivar_matrix import overall_score_matrix, top_n_rows
+        matrix = self.trait_matrix()
+        scores = overall_score_matrix(matrix, [environment_factors], self.genetics)[:, 0]
+        return [(matrix.cultivar_ids[row], float(scores[row])) for row in top_n_rows(scores, top_n)]
 
 
 class GenotypeEnvironmentModel:
@@ -382,8 +390,14 @@ class GenotypeEnvironmentModel:
     Models how genetic traits interact with environmental conditions
     """
     
-    def __init__(self, genetic_db: GeneticParameterDatabase):
+    def __init__(self, genetic_db: GeneticParameterDatabase, config: Optional[ConfigSnapshot] = None):
         self.genetic_db = genetic_db
+        genetics = config.genetics if config is not None else genetic_db.genetics
+        self.genetics = genetics
+        self.temperature_stress_weight = genetics.get('TEMPERATURE_STRESS_WEIGHT', 0.5)
+        self.nitrogen_excess_weight = genetics.get('NITROGEN_EXCESS_WEIGHT', 0.3)
+        self.stress_response_weight = genetics.get('STRESS_RESPONSE_WEIGHT', 0.2)
+        self.overall_stress_weight = genetics.get('OVERALL_STRESS_WEIGHT', 0.1)
         
     def calculate_phenotype_expression(self, 
                                      cultivar_id: str,
@@ -410,16 +424,14 @@ class GenotypeEnvironmentModel:
         if trait == GeneticTrait.HEAT_TOLERANCE:
             temp_stress = environment_factors.get('temperature_stress', 0.0)
             if temp_stress > 0:  # Heat stress present
-                weight = get_config_loader().get_genetics_parameters().get('TEMPERATURE_STRESS_WEIGHT', 0.5)
-                expression = base_trait_value * (1.0 - temp_stress * weight)
+                expression = base_trait_value * (1.0 - temp_stress * self.temperature_stress_weight)
             else:
                 expression = base_trait_value
         
         elif trait == GeneticTrait.COLD_TOLERANCE:
             temp_stress = environment_factors.get('temperature_stress', 0.0)
             if temp_stress < 0:  # Cold stress present
-                weight = get_config_loader().get_genetics_parameters().get('TEMPERATURE_STRESS_WEIGHT', 0.5)
-                expression = base_trait_value * (1.0 + temp_stress * weight)  # temp_stress is negative
+                expression = base_trait_value * (1.0 + temp_stress * self.temperature_stress_weight)  # temp_stress is negative
             else:
                 expression = base_trait_value
                 
@@ -432,19 +444,19 @@ class GenotypeEnvironmentModel:
         elif trait == GeneticTrait.NITRATE_ACCUMULATION:
             nitrogen_excess = environment_factors.get('nitrogen_excess', 0.0)
             # Higher nitrogen leads to more nitrate accumulation
-            expression = base_trait_value + nitrogen_excess * get_config_loader().get_genetics_parameters().get('NITROGEN_EXCESS_WEIGHT', 0.3)
+            expression = base_trait_value + nitrogen_excess * self.nitrogen_excess_weight
             
         elif trait == GeneticTrait.ROOT_DEVELOPMENT:
             water_stress = environment_factors.get('water_stress', 0.0)
             nutrient_stress = environment_factors.get('nutrient_stress', 0.0)
             # Root development increases under stress
-            stress_response = max(water_stress, nutrient_stress) * get_config_loader().get_genetics_parameters().get('STRESS_RESPONSE_WEIGHT', 0.2)
+            stress_response = max(water_stress, nutrient_stress) * self.stress_response_weight
             expression = base_trait_value + stress_response
             
         else:
             # Default environmental modulation
             overall_stress = np.mean([abs(v) for v in environment_factors.values() if isinstance(v, (int, float))])
-            expression = base_trait_value * (1.0 - overall_stress * get_config_loader().get_genetics_parameters().get('OVERALL_STRESS_WEIGHT', 0.1))
+            expression = base_trait_value * (1.0 - overall_stress * self.overall_stress_weight)
         
         return max(0.0, min(1.0, expression))
     
@@ -494,9 +506,54 @@ class GenotypeEnvironmentModel:
         
         performance_metrics['bolting_resistance'] = trait_expressions[GeneticTrait.BOLTING_TOLERANCE]
         
-        performance_metrics['adaptation_index'] = cultivar.calculate_adaptation_index(environment_factors)
+        performance_metrics['adaptation_index'] = cultivar.calculate_adaptation_index(environment_factors, self.genetics)
         
         return performance_metrics
+    
+    def _expression_weights(self) -> Dict[str, float]:
+        return {
+            'temperature_stress_weight': self.temperature_stress_weight,
+            'nitrogen_excess_weight': self.nitrogen_excess_weight,
+            'stress_response_weight': self.stress_response_weight,
+            'overall_stress_weight': self.overall_stress_weight
+        }
+    
+    def predict_performance_matrix(self, environments: Sequence[Dict[str, float]],
+                                   matrix: Optional['CultivarTraitMatrix'] = None) -> Dict[str, np.ndarray]:
+        """
+        predict_cultivar_performance for every cultivar × environment at once.
+        
+        Args:
+            environments: Environment factor dicts
+            matrix: Cultivar catalog (default: the database's trait matrix)
+            
+        Returns:
+            Metric name -> (cultivars × environments) array
+        """
+        from .cultivar_matrix import performance_matrix
+        matrix = matrix if matrix is not None else self.genetic_db.trait_matrix()
+        return performance_matrix(matrix, environments, self.genetics, **self._expression_weights())
+    
+    def screen_cultivars(self, environments: Sequence[Dict[str, float]], top_n: int = 10,
+                         metric: str = 'overall', matrix: Optional['CultivarTraitMatrix'] = None,
+                         chunk_size: int = 4096, max_workers: Optional[int] = None) -> 'ScreeningResult':
+        """
+        Top-N cultivars of a catalog for each environment.
+        
+        Args:
+            environments: Environment factor dicts
+            top_n: Cultivars kept per environment
+            metric: 'overall' (get_best_cultivars_for_conditions score) or a
+                predict_cultivar_performance metric
+            matrix: Cultivar catalog (default: the database's trait matrix)
+            chunk_size: Cultivars scored per array pass
+            max_workers: Threads scoring chunks in parallel (default: serial)
+        """
+        from .cultivar_matrix import screen_cultivars
+        matrix = matrix if matrix is not None else self.genetic_db.trait_matrix()
+        return screen_cultivars(matrix, environments, self.genetics, top_n=top_n, metric=metric,
+                                chunk_size=chunk_size, max_workers=max_workers,
+                                expression_weights=self._expression_weights())
 
 
 class BreedingAssistant:
@@ -618,24 +675,40 @@ class BreedingAssistant:
             )
         
         # Add overall performance metrics
-        performance['predicted_yield_index'] = hybrid_profile.yield_potential * hybrid_profile.calculate_adaptation_index(environment_factors)
+        genetics = self.genetic_db.genetics
+        performance['predicted_yield_index'] = hybrid_profile.yield_potential * hybrid_profile.calculate_adaptation_index(environment_factors, genetics)
         performance['heterosis_advantage'] = performance['predicted_yield_index'] - max(
-            parent1.yield_potential * parent1.calculate_adaptation_index(environment_factors),
-            parent2.yield_potential * parent2.calculate_adaptation_index(environment_factors)
+            parent1.yield_potential * parent1.calculate_adaptation_index(environment_factors, genetics),
+            parent2.yield_potential * parent2.calculate_adaptation_index(environment_factors, genetics)
         )
         
         return performance
 
 
-def create_lettuce_genetic_system() -> Tuple[GeneticParameterDatabase, GenotypeEnvironmentModel, BreedingAssistant]:
+def create_lettuce_genetic_system(config: Optional[ConfigSnapshot] = None) -> Tuple[GeneticParameterDatabase, GenotypeEnvironmentModel, BreedingAssistant]:
     """Create complete genetic parameter system for lettuce"""
-    genetic_db = GeneticParameterDatabase()
-    ge_model = GenotypeEnvironmentModel(genetic_db)
+    genetic_db = GeneticParameterDatabase(config)
+    ge_model = GenotypeEnvironmentModel(genetic_db, config)
     breeding_assistant = BreedingAssistant(genetic_db, ge_model)
     
     return genetic_db, ge_model, breeding_assistant
 
 
+_shared_genetic_system: Optional[Tuple[GeneticParameterDatabase, GenotypeEnvironmentModel, BreedingAssistant]] = None
+
+
+def get_shared_lettuce_genetic_system() -> Tuple[GeneticParameterDatabase, GenotypeEnvironmentModel, BreedingAssistant]:
+    """Process-wide genetic system, built once and shared read-only.
+
+    Loaded before worker processes are forked, the cultivar tables are
+    inherited by every worker instead of being rebuilt per simulation.
+    """
+    global _shared_genetic_system
+    if _shared_genetic_system is None:
+        _shared_genetic_system = create_lettuce_genetic_system()
+    return _shared_genetic_system
+
+
 if __name__ == "__main__":
     # Demonstration of genetic parameter system
     print("Advanced Genetic Parameters System - Lettuce Cultivar Modeling")
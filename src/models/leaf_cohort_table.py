@@ -0,0 +1,145 @@
+"""
+Shared Leaf Cohort Table
+One structure-of-arrays table of leaf cohorts, updated in place by both the
+leaf development model (appearance, expansion, area loss) and the senescence
+model (damage, senescence stage, nutrient remobilization).
+
+Row i of every column is the same cohort, in order of appearance. Stages are
+stored as small integer codes (index into LeafStage / SenescenceStage as
+ordered by the owning models), active senescence triggers as a bit mask, and
+nutrients as (cohort × nutrient) matrices, so a daily update is a handful of
+array expressions regardless of the number of leaves.
+"""
+
+from typing import Dict, Sequence, Tuple
+
+import numpy as np
+
+DEFAULT_NUTRIENTS: Tuple[str, ...] = ('nitrogen', 'phosphorus', 'potassium')
+
+
+class LeafCohortTable:
+    """Column arrays of leaf cohorts (the first `n` rows are live)."""
+
+    # Float columns
+    COLUMNS = (
+        'appearance_day',           # V-stage at appearance
+        'age_gdd',                  # Thermal time since appearance (°C-day)
+        'area',                     # Current leaf area (m²)
+        'max_area',                 # Maximum potential area (m²)
+        'area_loss_rate',           # Daily fractional area loss while senescing
+        'biomass',                  # Leaf dry mass (g)
+        'canopy_position',          # 0 = bottom, 1 = top
+        'senescence_damage',        # Cumulative senescence damage (0-1)
+        'daily_senescence_rate',    # Current daily senescence rate
+    )
+    # Integer / boolean columns and their dtypes
+    CODE_COLUMNS = {
+        'cohort_id': np.int64,
+        'leaf_stage': np.int8,          # Leaf development stage code
+        'senescence_stage': np.int8,    # Senescence stage code
+        'senescence_types': np.int16,   # Bit mask of active senescence triggers
+        'recoverable': np.bool_,
+        'nutrients_initialized': np.bool_,
+    }
+
+    def __init__(self, nutrients: Sequence[str] = DEFAULT_NUTRIENTS, capacity: int = 32):
+        self.n = 0
+        self.nutrients: Tuple[str, ...] = tuple(nutrients)
+        for name in self.COLUMNS:
+            setattr(self, name, np.zeros(capacity))
+        for name, dtype in self.CODE_COLUMNS.items():
+            setattr(self, name, np.zeros(capacity, dtype=dtype))
+        # g nutrient / g biomass, and the part still available for remobilization
+        self.nutrient_content = np.zeros((capacity, len(self.nutrients)))
+        self.remobilizable = np.zeros((capacity, len(self.nutrients)))
+
+    def __len__(self) -> int:
+        return self.n
+
+    @property
+    def capacity(self) -> int:
+        return len(self.area)
+
+    def _columns(self):
+        return self.COLUMNS + tuple(self.CODE_COLUMNS) + ('nutrient_content', 'remobilizable')
+
+    def _reserve(self, size: int):
+        if size <= self.capacity:
+            return
+        new_capacity = max(size, 2 * self.capacity)
+        for name in self._columns():
+            column = getattr(self, name)
+            grown = np.zeros((new_capacity,) + column.shape[1:], dtype=column.dtype)
+            grown[:self.n] = column[:self.n]
+            setattr(self, name, grown)
+
+    def ensure_nutrients(self, names: Sequence[str]):
+        """Add nutrient columns that are not tracked yet."""
+        missing = [name for name in names if name not in self.nutrients]
+        if not missing:
+            return
+        self.nutrients += tuple(missing)
+        pad = ((0, 0), (0, len(missing)))
+        self.nutrient_content = np.pad(self.nutrient_content, pad)
+        self.remobilizable = np.pad(self.remobilizable, pad)
+
+    def nutrient_index(self, name: str) -> int:
+        return self.nutrients.index(name)
+
+    def append(self, cohort_id: int, leaf_stage: int, area: float = 0.0, max_area: float = 0.0,
+               appearance_day: float = 0.0, age_gdd: float = 0.0) -> int:
+        """Add one cohort and return its row."""
+        self._reserve(self.n + 1)
+        row = self.n
+        for name in self._columns():
+            getattr(self, name)[row] = 0
+        self.cohort_id[row] = cohort_id
+        self.leaf_stage[row] = leaf_stage
+        self.area[row] = area
+        self.max_area[row] = max_area
+        self.appearance_day[row] = appearance_day
+        self.age_gdd[row] = age_gdd
+        self.canopy_position[row] = 0.5
+        self.recoverable[row] = True
+        self.n += 1
+        return row
+
+    def rows_of(self, cohort_ids: Sequence[int]) -> np.ndarray:
+        """Rows of the given cohort ids (-1 for ids that are not in the table)."""
+        wanted = np.asarray(cohort_ids, dtype=np.int64)
+        if self.n == 0:
+            return np.full(len(wanted), -1, dtype=np.int64)
+        ids = self.cohort_id[:self.n]
+        order = np.argsort(ids, kind='stable')
+        position = np.minimum(np.searchsorted(ids, wanted, sorter=order), self.n - 1)
+        rows = order[position]
+        return np.where(ids[rows] == wanted, rows, -1)
+
+    def copy(self) -> 'LeafCohortTable':
+        """Independent copy of the live rows."""
+        table = LeafCohortTable.__new__(LeafCohortTable)
+        table.n = self.n
+        table.nutrients = self.nutrients
+        for name in self._columns():
+            setattr(table, name, getattr(self, name)[:self.n].copy())
+        return table
+
+    def row(self, index: int) -> Dict[str, float]:
+        """Columns of one row as a dict (for inspection)."""
+        record = {name: getattr(self, name)[index].item() for name in self.COLUMNS + tuple(self.CODE_COLUMNS)}
+        record['nutrient_content'] = dict(zip(self.nutrients, self.nutrient_content[index].tolist()))
+        record['remobilizable'] = dict(zip(self.nutrients, self.remobilizable[index].tolist()))
+        return record
+
+    def __repr__(self) -> str:
+        return f"LeafCohortTable({self.n} cohorts, nutrients={list(self.nutrients)})"
+
+
+def assign_canopy_positions(table: LeafCohortTable):
+    """Rank cohorts by appearance: oldest leaf at the bottom (0), newest on top (1)."""
+    n = table.n
+    if n == 1:
+        table.canopy_position[0] = 0.5
+    elif n > 1:
+        table.canopy_position[:n] = np.arange(n) / (n - 1)
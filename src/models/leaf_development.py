@@ -9,6 +9,9 @@ Key concepts implemented:
 4. Water and nutrient stress effects on leaf development
 5. Individual leaf area expansion
 6. Total leaf area index (LAI) calculation
+
+Cohorts live in a LeafCohortTable shared with the senescence model; the daily
+area update is vectorized over its columns.
 """
 
 import numpy as np
@@ -16,6 +19,9 @@ from typing import Dict, Tuple, Optional
 from dataclasses import dataclass
 from enum import Enum
 
+from .leaf_cohort_table import LeafCohortTable, assign_canopy_positions
+from ..utils.response_tables import DEFAULT_TABLE_RANGE, ResponseTable, TableRange, response_table
+
 
 class LeafStage(Enum):
     """Leaf development stages."""
@@ -26,6 +32,14 @@ class LeafStage(Enum):
     SENESCING = "senescing"   # Beginning senescence
 
 
+# Stage codes of LeafCohortTable.leaf_stage (index into LEAF_STAGES)
+LEAF_STAGES: Tuple[LeafStage, ...] = tuple(LeafStage)
+LEAF_EMERGING = LEAF_STAGES.index(LeafStage.EMERGING)
+LEAF_EXPANDING = LEAF_STAGES.index(LeafStage.EXPANDING)
+LEAF_MATURE = LEAF_STAGES.index(LeafStage.MATURE)
+LEAF_SENESCING = LEAF_STAGES.index(LeafStage.SENESCING)
+
+
 @dataclass
 class LeafParameters:
     """Parameters for leaf development model."""
@@ -93,10 +107,12 @@ class LeafDevelopmentModel:
     
     def __init__(self, parameters: Optional[LeafParameters] = None):
         self.params = parameters or LeafParameters()
-        self.leaf_cohorts: Dict[int, LeafCohort] = {}
+        self.cohorts = LeafCohortTable()
         self.current_v_stage: float = self.params.initial_leaf_number
         self.cumulative_thermal_time: float = 0.0
         self.next_cohort_id: int = 1
+        # Thermal time curve (None: exact formula)
+        self._thermal_time_table: Optional[ResponseTable] = None
         
         # Initialize with initial leaves
         for i in range(int(self.params.initial_leaf_number)):
@@ -105,21 +121,51 @@ class LeafDevelopmentModel:
     def _create_initial_leaf_cohort(self, cohort_id: int):
         """Create initial leaf cohorts (cotyledons + first leaves)."""
         initial_area = self.params.max_individual_leaf_area * 0.3  # 30% of max
-        cohort = LeafCohort(
+        self.cohorts.append(
             cohort_id=cohort_id,
+            leaf_stage=LEAF_EXPANDING,
+            area=initial_area,
+            max_area=self.params.max_individual_leaf_area,
             appearance_day=0.0,
-            current_area=initial_area,
-            max_potential_area=self.params.max_individual_leaf_area,
-            stage=LeafStage.EXPANDING,
-            thermal_time_since_appearance=20.0  # Some initial thermal time
+            age_gdd=20.0  # Some initial thermal time
         )
-        self.leaf_cohorts[cohort_id] = cohort
+
+    @property
+    def leaf_cohorts(self) -> Dict[int, LeafCohort]:
+        """Cohorts as LeafCohort objects keyed by id (materialized on access)."""
+        table = self.cohorts
+        return {
+            int(table.cohort_id[i]): LeafCohort(
+                cohort_id=int(table.cohort_id[i]),
+                appearance_day=float(table.appearance_day[i]),
+                current_area=float(table.area[i]),
+                max_potential_area=float(table.max_area[i]),
+                stage=LEAF_STAGES[table.leaf_stage[i]],
+                thermal_time_since_appearance=float(table.age_gdd[i]),
+                senescence_rate=float(table.area_loss_rate[i])
+            )
+            for i in range(table.n)
+        }
     
+    def use_response_tables(self, table_range: Optional[TableRange] = DEFAULT_TABLE_RANGE):
+        """Evaluate thermal time from a shared table (None restores the exact formula)."""
+        if table_range is None:
+            self._thermal_time_table = None
+            return
+        p = self.params
+        key = (p.min_temp, p.opt_temp_min, p.opt_temp_max, p.max_temp)
+        self._thermal_time_table = response_table('leaf.thermal_time', key, self._thermal_time_exact, table_range)
+
     def calculate_thermal_time(self, temperature: float) -> float:
         """
         Calculate daily thermal time using cardinal temperature approach.
         Based on DSSAT CROPGRO temperature response function.
         """
+        if self._thermal_time_table is not None:
+            return self._thermal_time_table(temperature)
+        return self._thermal_time_exact(temperature)
+
+    def _thermal_time_exact(self, temperature: float) -> float:
         T = temperature
         Tmin = self.params.min_temp
         Topt1 = self.params.opt_temp_min  
@@ -205,15 +251,13 @@ class LeafDevelopmentModel:
         position_factor = self._calculate_leaf_position_factor(self.current_v_stage)
         max_area = self.params.max_individual_leaf_area * position_factor
         
-        cohort = LeafCohort(
+        self.cohorts.append(
             cohort_id=self.next_cohort_id,
-            appearance_day=self.current_v_stage,
-            current_area=0.001,  # Very small initial area
-            max_potential_area=max_area,
-            stage=LeafStage.EMERGING
+            leaf_stage=LEAF_EMERGING,
+            area=0.001,  # Very small initial area
+            max_area=max_area,
+            appearance_day=self.current_v_stage
         )
-        
-        self.leaf_cohorts[self.next_cohort_id] = cohort
         self.next_cohort_id += 1
     
     def _calculate_leaf_position_factor(self, v_stage: float) -> float:
@@ -231,58 +275,52 @@ class LeafDevelopmentModel:
         """Update individual leaf areas for all cohorts."""
         
         expansion_factor = stress_factors['combined_expansion_factor']
-        total_area = 0.0
-        active_leaves = 0
-        senesced_area = 0.0
-        
-        for cohort in self.leaf_cohorts.values():
-            # Update thermal time for this cohort
-            cohort.thermal_time_since_appearance += daily_thermal_time
-            
-            # Calculate area expansion for this cohort
-            if cohort.stage == LeafStage.EMERGING:
-                # Transition to expanding after some thermal time
-                if cohort.thermal_time_since_appearance > 5.0:
-                    cohort.stage = LeafStage.EXPANDING
-            
-            elif cohort.stage == LeafStage.EXPANDING:
-                # Calculate daily area increase
-                relative_expansion_rate = self.params.leaf_area_expansion_rate * expansion_factor
-                
-                # Slower expansion as leaf approaches max size
-                size_factor = 1.0 - (cohort.current_area / cohort.max_potential_area) ** 2
-                daily_increase = (cohort.max_potential_area * relative_expansion_rate * 
-                                size_factor)
-                
-                cohort.current_area = min(
-                    cohort.max_potential_area,
-                    cohort.current_area + daily_increase
-                )
-                
-                # Transition to mature when 95% of max area reached
-                if cohort.current_area >= 0.95 * cohort.max_potential_area:
-                    cohort.stage = LeafStage.MATURE
-            
-            elif cohort.stage == LeafStage.MATURE:
-                # Check for senescence initiation (old leaves or stress)
-                # Lettuce leaves should last 6-8 weeks (600-800 thermal time units)
-                age_factor = cohort.thermal_time_since_appearance / 600.0  # More realistic lifespan
-                stress_senescence = (1.0 - expansion_factor) * 0.1
-                
-                # Only start senescence if leaf is truly old (>600 TT) or under severe stress (>0.08)
-                if age_factor > 1.0 or stress_senescence > 0.08:
-                    cohort.stage = LeafStage.SENESCING
-                    cohort.senescence_rate = max(0.01, age_factor * 0.005 + stress_senescence)
-            
-            elif cohort.stage == LeafStage.SENESCING:
-                # Reduce leaf area due to senescence
-                area_loss = cohort.current_area * cohort.senescence_rate
-                cohort.current_area = max(0.0, cohort.current_area - area_loss)
-                senesced_area += area_loss
-            
-            total_area += cohort.current_area
-            if cohort.current_area > 0.001:  # Count as active leaf
-                active_leaves += 1
+        table = self.cohorts
+        n = table.n
+        stage = table.leaf_stage[:n]
+        area = table.area[:n]
+        max_area = table.max_area[:n]
+        loss_rate = table.area_loss_rate[:n]
+
+        # Update thermal time of every cohort
+        age_gdd = table.age_gdd[:n]
+        age_gdd += daily_thermal_time
+
+        # Each cohort follows the branch of the stage it started the day in
+        emerging = stage == LEAF_EMERGING
+        expanding = stage == LEAF_EXPANDING
+        mature = stage == LEAF_MATURE
+        senescing = stage == LEAF_SENESCING
+
+        # Expanding: slower expansion as leaf approaches max size
+        relative_expansion_rate = self.params.leaf_area_expansion_rate * expansion_factor
+        size_factor = 1.0 - (area[expanding] / max_area[expanding]) ** 2
+        area[expanding] = np.minimum(max_area[expanding],
+                                     area[expanding] + max_area[expanding] * relative_expansion_rate * size_factor)
+
+        # Mature: senescence starts for truly old leaves (>600 TT) or under severe stress (>0.08)
+        # Lettuce leaves should last 6-8 weeks (600-800 thermal time units)
+        age_factor = age_gdd / 600.0
+        stress_senescence = (1.0 - expansion_factor) * 0.1
+        start_senescence = mature & ((age_factor > 1.0) | (stress_senescence > 0.08))
+        loss_rate[start_senescence] = np.maximum(0.01, age_factor[start_senescence] * 0.005 + stress_senescence)
+
+        # Senescing: reduce leaf area
+        area_loss = area[senescing] * loss_rate[senescing]
+        area[senescing] = np.maximum(0.0, area[senescing] - area_loss)
+        senesced_area = float(area_loss.sum())
+
+        # Stage transitions
+        stage[emerging & (age_gdd > 5.0)] = LEAF_EXPANDING
+        stage[expanding & (area >= 0.95 * max_area)] = LEAF_MATURE
+        stage[start_senescence] = LEAF_SENESCING
+
+        # Leaf dry mass and canopy rank for the senescence model
+        table.biomass[:n] = area * 1e4 / self.params.specific_leaf_area
+        assign_canopy_positions(table)
+
+        total_area = float(area.sum())
+        active_leaves = int(np.count_nonzero(area > 0.001))  # Count as active leaf
         
         # Calculate LAI (assuming 1 m² growing area per plant for base calculation)
         lai = total_area  # Will be scaled by plant density in main simulation
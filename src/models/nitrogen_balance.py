@@ -18,11 +18,16 @@ Research basis:
 """
 
 import numpy as np
-from typing import Dict, Tuple, Optional, Any, List
+from typing import Dict, Tuple, Optional, Any, List, TYPE_CHECKING
 from dataclasses import dataclass
 from enum import Enum
 import math
 
+from .uptake_kernel import IonUptakeKernel
+
+if TYPE_CHECKING:
+    from ..utils.config_loader import ConfigSnapshot
+
 
 class NitrogenForm(Enum):
     """Forms of nitrogen available for uptake."""
@@ -277,6 +282,11 @@ class PlantNitrogenBalanceModel:
         self.nitrogen_history: List[Dict[str, float]] = []
         self.total_cumulative_uptake: float = 0.0
         self.total_cumulative_remobilization: float = 0.0
+    
+    @property
+    def uptake_kernel(self) -> IonUptakeKernel:
+        """Shared uptake kernel of the current N-form kinetics."""
+        return IonUptakeKernel.from_nitrogen_params(self.params)
         
     def initialize_organ(self, organ_name: str, initial_dry_mass: float,
                         initial_n_concentration: float):
@@ -311,9 +321,6 @@ class PlantNitrogenBalanceModel:
         Returns:
             Nitrogen uptake response
         """
-        total_uptake = 0.0
-        uptake_by_form = {}
-        uptake_rate_by_form = {}
         limiting_factors = []
         
         # Environmental factor effects
@@ -329,44 +336,25 @@ class PlantNitrogenBalanceModel:
         if env_factor < 0.8:
             limiting_factors.append('environmental_stress')
         
-        # Calculate uptake for each nitrogen form
-        for n_form_str, concentration in solution_concentrations.items():
-            if n_form_str in self.params.uptake_kinetics:
-                kinetics = self.params.uptake_kinetics[n_form_str]
-                
-                # Michaelis-Menten kinetics with environmental effects
-                vmax = kinetics['vmax']
-                km = kinetics['km']
-                min_conc = kinetics['min_conc']
-                
-                if concentration >= min_conc:
-                    # Basic Michaelis-Menten
-                    uptake_rate = (vmax * concentration) / (km + concentration)
-                    
-                    # Apply environmental effects
-                    uptake_rate *= env_factor
-                    
-                    # Apply root mass and exploration factor
-                    actual_uptake = (uptake_rate * root_mass * 
-                                   self.params.root_zone_exploration)
-                    
-                    # Check for competitive inhibition between NH4 and NO3
-                    if n_form_str == 'NO3' and 'NH4' in solution_concentrations:
-                        nh4_conc = solution_concentrations['NH4']
-                        ki = kinetics['inhibition_ki']
-                        inhibition_factor = ki / (ki + nh4_conc)
-                        actual_uptake *= inhibition_factor
-                    
-                    uptake_by_form[n_form_str] = actual_uptake
-                    uptake_rate_by_form[n_form_str] = uptake_rate
-                    total_uptake += actual_uptake
-                    
-                    if concentration < km:
-                        limiting_factors.append(f'{n_form_str}_concentration')
-                else:
-                    uptake_by_form[n_form_str] = 0.0
-                    uptake_rate_by_form[n_form_str] = 0.0
-                    limiting_factors.append(f'{n_form_str}_below_minimum')
+        # Michaelis-Menten kinetics of every N form in one kernel call; the
+        # actual uptake scales by root mass and exploration, and NO3 is
+        # competitively inhibited by NH4
+        kernel = self.uptake_kernel
+        concentrations, present = kernel.gather(solution_concentrations)
+        rates = kernel.rates(concentrations, env_factor, inhibit=False)
+        uptake = rates * kernel.inhibition(concentrations) * (root_mass * self.params.root_zone_exploration)
+        total_uptake = float(uptake[present].sum())
+        uptake_by_form = kernel.by_ion(uptake, present)
+        uptake_rate_by_form = kernel.by_ion(rates, present)
+        
+        for n_form_str, concentration, km, min_conc in zip(kernel.ions, concentrations.tolist(),
+                                                           kernel.km.tolist(), kernel.min_conc.tolist()):
+            if n_form_str not in solution_concentrations:
+                continue
+            if concentration < min_conc:
+                limiting_factors.append(f'{n_form_str}_below_minimum')
+            elif concentration < km:
+                limiting_factors.append(f'{n_form_str}_concentration')
         
         # Calculate root activity and efficiency
         if root_mass > 0:
@@ -789,12 +777,11 @@ class PlantNitrogenBalanceModel:
         return summary
 
 
-def create_lettuce_nitrogen_balance_model() -> PlantNitrogenBalanceModel:
+def create_lettuce_nitrogen_balance_model(config: Optional['ConfigSnapshot'] = None) -> PlantNitrogenBalanceModel:
     """Create nitrogen balance model with lettuce-specific parameters."""
     try:
-        from ..utils.config_loader import get_config_loader
-        config_loader = get_config_loader()
-        nitrogen_config = config_loader.get_nitrogen_balance_parameters()
+        from ..utils.config_loader import get_config_snapshot
+        nitrogen_config = (config or get_config_snapshot()).nutrients.to_dict()
         parameters = NitrogenBalanceParameters.from_config(nitrogen_config)
         return PlantNitrogenBalanceModel(parameters)
     except ImportError:
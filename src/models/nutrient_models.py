@@ -15,9 +15,12 @@ from __future__ import annotations
 import numpy as np
 from dataclasses import dataclass
 from enum import Enum
-from typing import Any, Dict, List, Optional, Tuple
+from typing import Any, Dict, List, Optional, Tuple, TYPE_CHECKING
 import math
 
+if TYPE_CHECKING:
+    from ..utils.config_loader import ConfigSnapshot
+
 # =========================
 # Nutrient Concentration Submodel
 # =========================
@@ -304,6 +307,51 @@ class NutrientTransportFlux:
     efficiency: float
 
 
+@dataclass
+class TransportFluxTensor:
+    """
+    Dense transport fluxes of one day, indexed (source organ, sink organ, nutrient).
+
+    Entries below the 0.001 reporting threshold are zero; `active` marks the
+    fluxes that the detailed list would contain.
+    """
+    source_organs: List[str]
+    sink_organs: List[str]
+    nutrients: List[str]
+    flux: np.ndarray              # (n_source, n_sink, n_nutrient) flux rates
+    active: np.ndarray            # Same shape, True where a flux is reported
+    mechanisms: List[str]         # Transport mechanism per nutrient
+    efficiency: np.ndarray        # Supply/demand transport efficiency per nutrient
+    _flux_list: Optional[List[NutrientTransportFlux]] = None
+
+    @property
+    def n_fluxes(self) -> int:
+        return int(self.active.sum())
+
+    def redistribution_by_nutrient(self) -> Dict[str, float]:
+        """Total flux per nutrient (only nutrients with at least one flux)."""
+        totals = self.flux.sum(axis=(0, 1))
+        has_flux = self.active.any(axis=(0, 1))
+        return {n: float(totals[j]) for j, n in enumerate(self.nutrients) if has_flux[j]}
+
+    def to_flux_list(self) -> List[NutrientTransportFlux]:
+        """Materialize the detailed flux objects (nutrient, source, sink order)."""
+        if self._flux_list is None:
+            fluxes = []
+            for j, i, k in zip(*np.nonzero(self.active.transpose(2, 0, 1))):
+                fluxes.append(NutrientTransportFlux(
+                    source_organ=self.source_organs[i],
+                    sink_organ=self.sink_organs[k],
+                    nutrient=self.nutrients[j],
+                    transport_mechanism=self.mechanisms[j],
+                    flux_rate=float(self.flux[i, k, j]),
+                    driving_force="demand",
+                    efficiency=float(self.efficiency[j]),
+                ))
+            self._flux_list = fluxes
+        return self._flux_list
+
+
 @dataclass
 class OrganNutrientPools:
     organ_name: str
@@ -325,7 +373,7 @@ class OrganNutrientPools:
 
 @dataclass
 class NutrientMobilityResponse:
-    transport_fluxes: List[NutrientTransportFlux]
+    flux_tensor: TransportFluxTensor
     organ_pools: Dict[str, Dict[str, OrganNutrientPools]]
     total_redistribution: Dict[str, float]
     transport_limitations: List[str]
@@ -333,6 +381,11 @@ class NutrientMobilityResponse:
     source_supplies: Dict[str, Dict[str, float]]
     mobility_efficiency: Dict[str, float]
 
+    @property
+    def transport_fluxes(self) -> List[NutrientTransportFlux]:
+        """Detailed flux objects (materialized on first access)."""
+        return self.flux_tensor.to_flux_list()
+
 
 class NutrientMobilityModel:
     def __init__(self, parameters: Optional[NutrientMobilityParameters] = None):
@@ -425,72 +478,81 @@ class NutrientMobilityModel:
         return supplies
 
     def calculate_transport_fluxes(self, sink_demands: Dict[str, Dict[str, float]], source_supplies: Dict[str, Dict[str, float]], transport_capacities: Dict[str, Dict[str, float]], temperature: float) -> List[NutrientTransportFlux]:
-        fluxes: List[NutrientTransportFlux] = []
+        return self.calculate_transport_flux_tensor(sink_demands, source_supplies, transport_capacities, temperature).to_flux_list()
+
+    def calculate_transport_flux_tensor(self, sink_demands: Dict[str, Dict[str, float]], source_supplies: Dict[str, Dict[str, float]], transport_capacities: Dict[str, Dict[str, float]], temperature: float) -> TransportFluxTensor:
+        """All source → sink fluxes as one (source, sink, nutrient) array computation."""
+        nutrients = list(self.params.mobility_classifications)
+        sources = list(source_supplies)
+        sinks = list(sink_demands)
+        supply = np.array([[source_supplies[o].get(n, 0.0) for n in nutrients] for o in sources]).reshape(len(sources), len(nutrients))
+        demand = np.array([[sink_demands[o].get(n, 0.0) for n in nutrients] for o in sinks]).reshape(len(sinks), len(nutrients))
+
         # Apply Q10 temperature response to transport kinetics (rates), not to capacity
         temp_factor = self.params.temperature_q10 ** ((temperature - 25.0) / 10.0)
         temp_factor = max(0.5, min(2.0, temp_factor))
-        for nutrient in self.params.mobility_classifications:
-            mobility_info = self.params.mobility_classifications[nutrient]
-            transport_type = mobility_info["transport"]
-            xylem_rate = self.params.xylem_transport_rates.get(nutrient, 0.1) * temp_factor
-            phloem_rate = self.params.phloem_transport_rates.get(nutrient, 0.1) * temp_factor
-            total_demand = sum(d.get(nutrient, 0.0) for d in sink_demands.values())
-            total_supply = sum(s.get(nutrient, 0.0) for s in source_supplies.values())
-            if total_demand > 0 and total_supply > 0:
-                supply_demand_ratio = total_supply / total_demand
-                transport_eff = min(1.0, supply_demand_ratio)
-                for source_organ, supplies in source_supplies.items():
-                    if supplies.get(nutrient, 0.0) > 0:
-                        src_supply = supplies[nutrient]
-                        for sink_organ, demands in sink_demands.items():
-                            if demands.get(nutrient, 0.0) > 0 and source_organ != sink_organ:
-                                sink_demand = demands[nutrient]
-                                if transport_type == TransportMechanism.XYLEM_ONLY.value:
-                                    if source_organ == "roots":
-                                        max_flux = src_supply * xylem_rate
-                                        cap = transport_capacities.get(source_organ, {}).get("xylem", 1.0)
-                                        flux_rate = min(max_flux, sink_demand, cap)
-                                        mechanism = "xylem"
-                                    else:
-                                        flux_rate = 0.0
-                                        mechanism = "none"
-                                elif transport_type == TransportMechanism.BIDIRECTIONAL.value:
-                                    xylem_flux = src_supply * xylem_rate * 0.6
-                                    phloem_flux = src_supply * phloem_rate * 0.4
-                                    xcap = transport_capacities.get(source_organ, {}).get("xylem", 1.0)
-                                    pcap = transport_capacities.get(source_organ, {}).get("phloem", 1.0)
-                                    flux_rate = min(xylem_flux + phloem_flux, sink_demand, xcap + pcap)
-                                    mechanism = "bidirectional"
-                                elif transport_type == TransportMechanism.COMPLEX.value:
-                                    base_flux = src_supply * min(xylem_rate, phloem_rate)
-                                    total_cap = transport_capacities.get(source_organ, {}).get("xylem", 0.5) + transport_capacities.get(source_organ, {}).get("phloem", 0.5)
-                                    flux_rate = min(base_flux, sink_demand, total_cap)
-                                    mechanism = "complex"
-                                else:
-                                    flux_rate = 0.0
-                                    mechanism = "none"
-                                flux_rate *= transport_eff
-                                if flux_rate > 0.001:
-                                    fluxes.append(
-                                        NutrientTransportFlux(
-                                            source_organ=source_organ,
-                                            sink_organ=sink_organ,
-                                            nutrient=nutrient,
-                                            transport_mechanism=mechanism,
-                                            flux_rate=flux_rate,
-                                            driving_force="demand",
-                                            efficiency=transport_eff,
-                                        )
-                                    )
-        return fluxes
-
-    def update_organ_pools(self, transport_fluxes: List[NutrientTransportFlux]):
-        net_fluxes: Dict[str, Dict[str, float]] = {}
-        for flux in transport_fluxes:
-            net_fluxes.setdefault(flux.source_organ, {}).setdefault(flux.nutrient, 0.0)
-            net_fluxes.setdefault(flux.sink_organ, {}).setdefault(flux.nutrient, 0.0)
-            net_fluxes[flux.source_organ][flux.nutrient] -= flux.flux_rate
-            net_fluxes[flux.sink_organ][flux.nutrient] += flux.flux_rate
+        xylem_rate = np.array([self.params.xylem_transport_rates.get(n, 0.1) for n in nutrients]) * temp_factor
+        phloem_rate = np.array([self.params.phloem_transport_rates.get(n, 0.1) for n in nutrients]) * temp_factor
+        transport_types = [self.params.mobility_classifications[n]["transport"] for n in nutrients]
+
+        total_demand = demand.sum(axis=0)
+        total_supply = supply.sum(axis=0)
+        valid = (total_demand > 0) & (total_supply > 0)
+        transport_eff = np.where(valid, np.minimum(1.0, total_supply / np.where(valid, total_demand, 1.0)), 0.0)
+
+        def capacity(kind: str, default: float) -> np.ndarray:
+            return np.array([transport_capacities.get(o, {}).get(kind, default) for o in sources])[:, None]
+
+        src = supply[:, None, :]    # (source, 1, nutrient)
+        dem = demand[None, :, :]    # (1, sink, nutrient)
+        pairs = (src > 0) & (dem > 0) & valid[None, None, :]
+        pairs &= (np.array(sources, dtype=object)[:, None] != np.array(sinks, dtype=object)[None, :])[:, :, None]
+
+        flux = np.zeros((len(sources), len(sinks), len(nutrients)))
+        mechanisms = []
+        for j, transport_type in enumerate(transport_types):
+            if transport_type == TransportMechanism.XYLEM_ONLY.value:
+                is_root = np.array([o == "roots" for o in sources])[:, None]
+                rate = np.minimum(np.minimum(src[:, :, j] * xylem_rate[j], dem[:, :, j]), capacity("xylem", 1.0))
+                flux[:, :, j] = np.where(is_root, rate, 0.0)
+                mechanisms.append("xylem")
+            elif transport_type == TransportMechanism.BIDIRECTIONAL.value:
+                potential = src[:, :, j] * xylem_rate[j] * 0.6 + src[:, :, j] * phloem_rate[j] * 0.4
+                cap = capacity("xylem", 1.0) + capacity("phloem", 1.0)
+                flux[:, :, j] = np.minimum(np.minimum(potential, dem[:, :, j]), cap)
+                mechanisms.append("bidirectional")
+            elif transport_type == TransportMechanism.COMPLEX.value:
+                potential = src[:, :, j] * min(xylem_rate[j], phloem_rate[j])
+                cap = capacity("xylem", 0.5) + capacity("phloem", 0.5)
+                flux[:, :, j] = np.minimum(np.minimum(potential, dem[:, :, j]), cap)
+                mechanisms.append("complex")
+            else:
+                mechanisms.append("none")
+
+        flux *= transport_eff[None, None, :]
+        active = pairs & (flux > 0.001)
+        flux = np.where(active, flux, 0.0)
+        return TransportFluxTensor(
+            source_organs=sources,
+            sink_organs=sinks,
+            nutrients=nutrients,
+            flux=flux,
+            active=active,
+            mechanisms=mechanisms,
+            efficiency=transport_eff,
+        )
+
+    def update_organ_pools(self, transport_fluxes):
+        """Apply net fluxes to the pools (accepts a TransportFluxTensor or a flux list)."""
+        if isinstance(transport_fluxes, TransportFluxTensor):
+            net_fluxes = self._net_fluxes_from_tensor(transport_fluxes)
+        else:
+            net_fluxes = {}
+            for flux in transport_fluxes:
+                net_fluxes.setdefault(flux.source_organ, {}).setdefault(flux.nutrient, 0.0)
+                net_fluxes.setdefault(flux.sink_organ, {}).setdefault(flux.nutrient, 0.0)
+                net_fluxes[flux.source_organ][flux.nutrient] -= flux.flux_rate
+                net_fluxes[flux.sink_organ][flux.nutrient] += flux.flux_rate
         for organ_name, nutrient_fluxes in net_fluxes.items():
             if organ_name in self.organ_pools:
                 for nutrient, net_flux in nutrient_fluxes.items():
@@ -525,6 +587,24 @@ class NutrientMobilityModel:
                         if nutrient in self.cumulative_redistribution:
                             self.cumulative_redistribution[nutrient] += net_flux
 
+    @staticmethod
+    def _net_fluxes_from_tensor(tensor: TransportFluxTensor) -> Dict[str, Dict[str, float]]:
+        """Net flux per (organ, nutrient) for every pair touched by an active flux."""
+        outflow = tensor.flux.sum(axis=1)            # (source, nutrient)
+        inflow = tensor.flux.sum(axis=0)             # (sink, nutrient)
+        exporting = tensor.active.any(axis=1)
+        importing = tensor.active.any(axis=0)
+        net_fluxes: Dict[str, Dict[str, float]] = {}
+        for i, organ in enumerate(tensor.source_organs):
+            for j in np.flatnonzero(exporting[i]):
+                organ_net = net_fluxes.setdefault(organ, {})
+                organ_net[tensor.nutrients[j]] = organ_net.get(tensor.nutrients[j], 0.0) - float(outflow[i, j])
+        for k, organ in enumerate(tensor.sink_organs):
+            for j in np.flatnonzero(importing[k]):
+                organ_net = net_fluxes.setdefault(organ, {})
+                organ_net[tensor.nutrients[j]] = organ_net.get(tensor.nutrients[j], 0.0) + float(inflow[k, j])
+        return net_fluxes
+
     def calculate_mobility_efficiency(self, nutrient: str) -> float:
         if nutrient not in self.params.mobility_classifications:
             return 0.5
@@ -557,11 +637,9 @@ class NutrientMobilityModel:
             water_flux = water_fluxes.get(organ, 0.1)
             assimilate_flux = assimilate_fluxes.get(organ, 0.05)
             transport_capacities[organ] = self.calculate_transport_capacity(organ, "sink", water_flux, assimilate_flux, temperature)
-        transport_fluxes = self.calculate_transport_fluxes(sink_demands, source_supplies, transport_capacities, temperature)
-        self.update_organ_pools(transport_fluxes)
-        total_redistribution: Dict[str, float] = {}
-        for flux in transport_fluxes:
-            total_redistribution[flux.nutrient] = total_redistribution.get(flux.nutrient, 0.0) + flux.flux_rate
+        flux_tensor = self.calculate_transport_flux_tensor(sink_demands, source_supplies, transport_capacities, temperature)
+        self.update_organ_pools(flux_tensor)
+        total_redistribution = flux_tensor.redistribution_by_nutrient()
         limitations: List[str] = []
         for nutrient in self.params.mobility_classifications:
             total_demand = sum(d.get(nutrient, 0.0) for d in sink_demands.values())
@@ -571,11 +649,11 @@ class NutrientMobilityModel:
         mobility_efficiency: Dict[str, float] = {n: self.calculate_mobility_efficiency(n) for n in self.params.mobility_classifications}
         self.transport_history.append({
             "total_redistribution": sum(total_redistribution.values()),
-            "transport_fluxes": len(transport_fluxes),
+            "transport_fluxes": flux_tensor.n_fluxes,
             "limitations": len(limitations),
         })
         return NutrientMobilityResponse(
-            transport_fluxes=transport_fluxes,
+            flux_tensor=flux_tensor,
             organ_pools=self.organ_pools.copy(),
             total_redistribution=total_redistribution,
             transport_limitations=limitations,
@@ -603,12 +681,11 @@ class NutrientMobilityModel:
         }
 
 
-def create_lettuce_nutrient_mobility_model() -> NutrientMobilityModel:
+def create_lettuce_nutrient_mobility_model(config: Optional['ConfigSnapshot'] = None) -> NutrientMobilityModel:
     """Create nutrient mobility model with lettuce-specific parameters."""
     try:
-        from ..utils.config_loader import get_config_loader
-        config_loader = get_config_loader()
-        mobility_config = config_loader.get_nutrient_mobility_parameters()
+        from ..utils.config_loader import get_config_snapshot
+        mobility_config = (config or get_config_snapshot()).nutrients.to_dict()
         parameters = NutrientMobilityParameters.from_config(mobility_config)
         return NutrientMobilityModel(parameters)
     except Exception:
@@ -18,11 +18,16 @@ Research basis:
 """
 
 import numpy as np
-from typing import Dict, Tuple, Optional, Any, List
+from typing import Dict, Tuple, Optional, Any, List, TYPE_CHECKING
 from dataclasses import dataclass
 from enum import Enum
 import math
 
+from ..utils.response_tables import DEFAULT_TABLE_RANGE, ResponseTable, TableRange, response_table
+
+if TYPE_CHECKING:
+    from ..utils.config_loader import ConfigSnapshot
+
 
 class LettuceGrowthStage(Enum):
     """Comprehensive lettuce growth stages following CROPGRO approach."""
@@ -223,6 +228,19 @@ class ComprehensivePhenologyModel:
         )
         self.photoperiod_history: List[float] = []
         self.temperature_history: List[float] = []
+        # Thermal time curve (None: exact formula)
+        self._thermal_time_table: Optional[ResponseTable] = None
+
+    def use_response_tables(self, table_range: Optional[TableRange] = DEFAULT_TABLE_RANGE):
+        """Evaluate thermal time from a shared table (None restores the exact formula)."""
+        if table_range is None:
+            self._thermal_time_table = None
+            return
+        p = self.params
+        key = (p.base_temperature, p.optimal_temperature_min, p.optimal_temperature_max,
+               p.maximum_temperature, p.thermal_time_scale)
+        self._thermal_time_table = response_table('phenology.thermal_time', key,
+                                                  self._thermal_time_exact, table_range)
         
     def calculate_thermal_time(self, temperature: float) -> float:
         """
@@ -234,6 +252,11 @@ class ComprehensivePhenologyModel:
         Returns:
             Daily thermal time (Growing Degree Days)
         """
+        if self._thermal_time_table is not None:
+            return self._thermal_time_table(temperature)
+        return self._thermal_time_exact(temperature)
+
+    def _thermal_time_exact(self, temperature: float) -> float:
         T = temperature
         Tbase = self.params.base_temperature
         Topt1 = self.params.optimal_temperature_min
@@ -592,11 +615,11 @@ class ComprehensivePhenologyModel:
         return properties
 
 
-def create_lettuce_phenology_model(initial_stage: LettuceGrowthStage = LettuceGrowthStage.GERMINATION) -> ComprehensivePhenologyModel:
+def create_lettuce_phenology_model(initial_stage: LettuceGrowthStage = LettuceGrowthStage.GERMINATION,
+                                   config: Optional['ConfigSnapshot'] = None) -> ComprehensivePhenologyModel:
     """Create phenology model with lettuce-specific parameters from JSON config."""
-    from ..utils.config_loader import get_config_loader
-    loader = get_config_loader()
-    cfg = loader.get_phenology_parameters()
+    from ..utils.config_loader import get_config_snapshot
+    cfg = (config or get_config_snapshot()).phenology.to_dict()
     parameters = PhenologyParameters.from_config(cfg)
     return ComprehensivePhenologyModel(parameters, initial_stage)
 
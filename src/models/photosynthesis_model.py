@@ -1,12 +1,28 @@
 """
 Photosynthesis Model (Simplified Farquhar-type)
 Calculates daily carbon assimilation based on light, CO2, and temperature.
+
+The array API (calculate_daily_assimilation_array) evaluates the same kernel
+for whole arrays of conditions at once, e.g. all members of an ensemble or all
+sub-daily steps. When Numba is installed a compiled element-wise kernel is
+used; otherwise the NumPy broadcast version runs. After use_response_tables()
+both the scalar and the array API read Vcmax and Jmax from the same tables.
 """
 
 import numpy as np
+from functools import partial
 from typing import Optional, Dict, Any
 from dataclasses import dataclass
 
+from ..utils.response_tables import DEFAULT_TABLE_RANGE, ResponseTable, TableRange, response_table
+
+try:
+    from numba import njit
+    NUMBA_AVAILABLE = True
+except ImportError:  # Optional accelerator
+    njit = None
+    NUMBA_AVAILABLE = False
+
 
 @dataclass
 class PhotosynthesisParameters:
@@ -114,11 +130,38 @@ class PhotosynthesisModel:
             self.params = PhotosynthesisParameters.from_dict(p_cfg)
         else:
             self.params = parameters
+        # Arrhenius factor tables by activation energy (None: exact formula)
+        self._arrhenius_tables: Optional[Dict[float, ResponseTable]] = None
+        self._table_range: TableRange = DEFAULT_TABLE_RANGE
+
+    def use_response_tables(self, table_range: Optional[TableRange] = DEFAULT_TABLE_RANGE):
+        """Evaluate Arrhenius responses from shared tables (None restores the exact formula)."""
+        if table_range is None:
+            self._arrhenius_tables = None
+            return
+        self._table_range = table_range
+        self._arrhenius_tables = {}
+        for ea in (self.params.eav, self.params.eaj, self.params.ear):
+            self._arrhenius_table(ea)
+
+    def _arrhenius_table(self, ea: float) -> ResponseTable:
+        table = self._arrhenius_tables.get(ea)
+        if table is None:
+            table = response_table('photosynthesis.arrhenius', (float(ea), float(self.params.r)),
+                                   partial(self._arrhenius_factor, ea), self._table_range)
+            self._arrhenius_tables[ea] = table
+        return table
+
+    def _arrhenius_factor(self, ea: float, temp_c: float) -> float:
+        """Arrhenius factor relative to 25 °C."""
+        temp_k = temp_c + 273.15
+        return np.exp(ea * (temp_k - 298.15) / (298.15 * self.params.r * temp_k))
 
     def _arrhenius_temp_response(self, rate_25: float, ea: float, temp_c: float) -> float:
         """Calculate temperature response using Arrhenius equation."""
-        temp_k = temp_c + 273.15
-        return rate_25 * np.exp(ea * (temp_k - 298.15) / (298.15 * self.params.r * temp_k))
+        if self._arrhenius_tables is not None:
+            return rate_25 * self._arrhenius_table(ea)(temp_c)
+        return rate_25 * self._arrhenius_factor(ea, temp_c)
 
     def calculate_daily_assimilation(self, par_umol_m2_s: float, co2_ppm: float, temp_c: float, lai: float, photoperiod_hours: float = 16.0) -> float:
         """Calculate daily carbon assimilation (g C/m2/day).
@@ -160,6 +203,144 @@ class PhotosynthesisModel:
 
         return max(0.0, total_g_c_m2_day)
 
+    def calculate_daily_assimilation_array(self, par_umol_m2_s, co2_ppm, temp_c, lai,
+                                           photoperiod_hours=16.0,
+                                           use_compiled: Optional[bool] = None,
+                                           xp=None) -> np.ndarray:
+        """Vectorized calculate_daily_assimilation (g C/m2/day).
+
+        All inputs are broadcast against each other, so any mix of scalars and
+        equally shaped arrays is accepted. Results match the scalar method
+        element by element, with or without response tables.
+
+        Args:
+            use_compiled: Force (True) or disable (False) the Numba kernel.
+                None uses it when Numba is available. The compiled kernel
+                evaluates the exact Arrhenius formula, so it is not used
+                while response tables are enabled.
+            xp: Array namespace of the inputs (CuPy, jax.numpy); results stay
+                in it. The Numba kernel applies to NumPy inputs only.
+        """
+        xp = np if xp is None else xp
+        inputs = xp.broadcast_arrays(*(xp.asarray(x, dtype=xp.float64) for x in
+                                       (par_umol_m2_s, co2_ppm, temp_c, lai, photoperiod_hours)))
+        if self._arrhenius_tables is not None:
+            par, co2, temp, leaf_area, photoperiod = inputs
+            p = self.params
+            vcmax = p.vcmax_25 * self._arrhenius_table_array(p.eav, temp, xp)
+            jmax = p.jmax_25 * self._arrhenius_table_array(p.eaj, temp, xp)
+            return _farquhar_rate_kernel(par, co2, vcmax, jmax, leaf_area, photoperiod,
+                                         *self._kernel_constants()[5:], xp=xp)
+        if xp is not np:
+            return _farquhar_daily_kernel(*inputs, *self._kernel_constants(), xp=xp)
+
+        par, co2, temp, leaf_area, photoperiod = inputs
+        if use_compiled is None:
+            use_compiled = NUMBA_AVAILABLE
+        if use_compiled and not NUMBA_AVAILABLE:
+            raise RuntimeError("Compiled photosynthesis kernel requested but numba is not installed")
+
+        kernel = _get_compiled_kernel() if use_compiled else _farquhar_daily_kernel
+        result = kernel(par.ravel(), co2.ravel(), temp.ravel(), leaf_area.ravel(), photoperiod.ravel(),
+                        *self._kernel_constants())
+        return np.asarray(result).reshape(par.shape)
+
+    def _arrhenius_table_array(self, ea: float, temp_c, xp):
+        """Arrhenius factors of an array of temperatures from the shared table."""
+        table = self._arrhenius_table(ea)
+        if xp is np:
+            return table(temp_c)
+        # Same lookup in the inputs' namespace: interpolate inside the table, exact outside
+        temp_k = temp_c + 273.15
+        exact = xp.exp(ea * (temp_k - 298.15) / (298.15 * self.params.r * temp_k))
+        inside = (temp_c >= table.t_min) & (temp_c <= table.t_max)
+        return xp.where(inside, xp.interp(temp_c, xp.asarray(table.grid), xp.asarray(table.values)), exact)
+
+    def _kernel_constants(self):
+        """Scalar parameters in the argument order of the assimilation kernels."""
+        p = self.params
+        return (float(p.vcmax_25), float(p.jmax_25), float(p.eav), float(p.eaj), float(p.r),
+                float(p.kc), float(p.ko), float(p.o2_mmol_mol) * 1000.0, float(p.gamma_star),
+                float(p.alpha), float(p.theta), float(p.ci_fraction))
+
+    def check_array_parity(self, n_samples: int = 1000, seed: int = 0,
+                           use_compiled: Optional[bool] = None) -> float:
+        """Maximum absolute difference between the array and scalar paths.
+
+        Conditions are sampled across the ranges seen in hydroponic lettuce
+        production (PAR 0-2000, CO2 200-1500 ppm, 5-40 C, LAI 0-8, 0-24 h).
+        """
+        rng = np.random.default_rng(seed)
+        par = rng.uniform(0.0, 2000.0, n_samples)
+        co2 = rng.uniform(200.0, 1500.0, n_samples)
+        temp = rng.uniform(5.0, 40.0, n_samples)
+        leaf_area = rng.uniform(0.0, 8.0, n_samples)
+        photoperiod = rng.uniform(0.0, 24.0, n_samples)
+
+        vector = self.calculate_daily_assimilation_array(par, co2, temp, leaf_area, photoperiod,
+                                                         use_compiled=use_compiled)
+        scalar = np.array([
+            self.calculate_daily_assimilation(par[i], co2[i], temp[i], leaf_area[i], photoperiod[i])
+            for i in range(n_samples)
+        ])
+        return float(np.max(np.abs(vector - scalar))) if n_samples else 0.0
+
+
+def _farquhar_daily_kernel(par, co2, temp_c, lai, photoperiod,
+                           vcmax_25, jmax_25, eav, eaj, r, kc, ko, o2_umol_mol,
+                           gamma_star, alpha, theta, ci_fraction, xp=np):
+    """Array kernel of PhotosynthesisModel.calculate_daily_assimilation (any NumPy-like xp)."""
+    temp_k = temp_c + 273.15
+    vcmax = vcmax_25 * xp.exp(eav * (temp_k - 298.15) / (298.15 * r * temp_k))
+    jmax = jmax_25 * xp.exp(eaj * (temp_k - 298.15) / (298.15 * r * temp_k))
+    return _farquhar_rate_kernel(par, co2, vcmax, jmax, lai, photoperiod, kc, ko, o2_umol_mol,
+                                 gamma_star, alpha, theta, ci_fraction, xp=xp)
+
+
+def _farquhar_rate_kernel(par, co2, vcmax, jmax, lai, photoperiod, kc, ko, o2_umol_mol,
+                          gamma_star, alpha, theta, ci_fraction, xp=np):
+    """Assimilation from temperature-adjusted Vcmax and Jmax (exact or tabulated)."""
+    ci = co2 * ci_fraction
+    ac = vcmax * (ci - gamma_star) / (ci + kc * (1 + o2_umol_mol / ko))
+    i2 = alpha * par
+    j = (i2 + jmax - xp.sqrt((i2 + jmax)**2 - 4 * theta * i2 * jmax)) / (2 * theta)
+    aj = j * (ci - gamma_star) / (4 * (ci + 2 * gamma_star))
+
+    gross_day_umol = xp.maximum(0.0, xp.minimum(ac, aj)) * xp.maximum(0.0, photoperiod) * 3600.0
+    g_c_m2_day = xp.maximum(0.0, gross_day_umol) * 1.201e-5
+    return xp.maximum(0.0, g_c_m2_day * lai)
+
+
+def _farquhar_daily_loop(par, co2, temp_c, lai, photoperiod,
+                         vcmax_25, jmax_25, eav, eaj, r, kc, ko, o2_umol_mol,
+                         gamma_star, alpha, theta, ci_fraction):
+    """Element-wise kernel compiled with Numba (same arithmetic as above)."""
+    n = par.shape[0]
+    out = np.empty(n)
+    for k in range(n):
+        ci = co2[k] * ci_fraction
+        temp_k = temp_c[k] + 273.15
+        vcmax = vcmax_25 * np.exp(eav * (temp_k - 298.15) / (298.15 * r * temp_k))
+        jmax = jmax_25 * np.exp(eaj * (temp_k - 298.15) / (298.15 * r * temp_k))
+        ac = vcmax * (ci - gamma_star) / (ci + kc * (1 + o2_umol_mol / ko))
+        i2 = alpha * par[k]
+        j = (i2 + jmax - np.sqrt((i2 + jmax)**2 - 4 * theta * i2 * jmax)) / (2 * theta)
+        aj = j * (ci - gamma_star) / (4 * (ci + 2 * gamma_star))
+        gross = max(0.0, min(ac, aj)) * max(0.0, photoperiod[k]) * 3600.0
+        out[k] = max(0.0, max(0.0, gross) * 1.201e-5 * lai[k])
+    return out
+
+
+_COMPILED_KERNEL = None
+
+
+def _get_compiled_kernel():
+    """Compile the element-wise kernel on first use."""
+    global _COMPILED_KERNEL
+    if _COMPILED_KERNEL is None:
+        _COMPILED_KERNEL = njit(_farquhar_daily_loop)
+    return _COMPILED_KERNEL
+
 
 
 def demonstrate_photosynthesis_model():
@@ -189,6 +370,17 @@ def demonstrate_photosynthesis_model():
         assimilation = model.calculate_daily_assimilation(par, co2_ppm, temp_c, lai)
         print(f"{par:<7.0f} {lai:<5.1f} {assimilation:<18.2f}")
 
+    # Array API: all scenarios in one call, checked against the scalar path
+    pars = np.array([s[0] for s in scenarios])
+    lais = np.array([s[1] for s in scenarios])
+    batch = model.calculate_daily_assimilation_array(pars, co2_ppm, temp_c, lais)
+    print(f"\nArray API ({'numba' if NUMBA_AVAILABLE else 'numpy'}): "
+          + ", ".join(f"{a:.2f}" for a in batch))
+    print(f"Array/scalar parity (max abs diff, 1000 samples): {model.check_array_parity():.2e}")
+    model.use_response_tables()
+    print(f"Array/scalar parity with response tables: {model.check_array_parity():.2e}")
+    model.use_response_tables(None)
+
 
 if __name__ == "__main__":
     demonstrate_photosynthesis_model()
@@ -17,10 +17,15 @@ Research basis:
 """
 
 import numpy as np
-from typing import Dict, Tuple, Optional, Any, List
+from typing import Dict, Tuple, Optional, Any, List, TYPE_CHECKING
 from dataclasses import dataclass
 from enum import Enum
 
+from ..utils.response_tables import DEFAULT_TABLE_RANGE, ResponseTable, TableRange, response_table
+
+if TYPE_CHECKING:
+    from ..utils.config_loader import ConfigSnapshot
+
 
 class TissueType(Enum):
     """Plant tissue types with different respiration characteristics."""
@@ -149,7 +154,22 @@ class EnhancedRespirationModel:
         self.params = parameters or RespirationParameters()
         self.temperature_history: List[float] = []
         self.acclimated_reference_temp: float = self.params.reference_temperature
-        
+        # Q10 curve over temperature - reference (None: exact formula)
+        self._q10_table: Optional[ResponseTable] = None
+
+    def use_response_tables(self, table_range: Optional[TableRange] = DEFAULT_TABLE_RANGE):
+        """Evaluate the Q10 response from a shared table (None restores the exact formula)."""
+        if table_range is None:
+            self._q10_table = None
+            return
+        # Differences to any reference inside the temperature range
+        span = table_range.t_max - table_range.t_min
+        self._q10_table = response_table('respiration.q10', (float(self.params.q10_factor),),
+                                         self._q10_response, TableRange(-span, span, table_range.step))
+
+    def _q10_response(self, temp_diff: float) -> float:
+        return self.params.q10_factor ** (temp_diff / 10.0)
+
     def calculate_temperature_factor(self, temperature: float, acclimated_temp: float = None) -> float:
         """
         Calculate temperature effect on respiration using Q10 response.
@@ -165,7 +185,10 @@ class EnhancedRespirationModel:
         temp_diff = temperature - reference_temp
         
         # Q10 temperature response
-        factor = self.params.q10_factor ** (temp_diff / 10.0)
+        if self._q10_table is not None:
+            factor = self._q10_table(temp_diff)
+        else:
+            factor = self._q10_response(temp_diff)
         
         # Prevent excessive respiration at very high temperatures
         if temperature > 40.0:
@@ -392,11 +415,10 @@ class EnhancedRespirationModel:
             nitrogen_factor=combined_factors['nitrogen_factor']
         )
 
-def create_lettuce_respiration_model() -> EnhancedRespirationModel:
+def create_lettuce_respiration_model(config: Optional['ConfigSnapshot'] = None) -> EnhancedRespirationModel:
     """Create respiration model with lettuce-specific parameters from JSON config."""
-    from ..utils.config_loader import get_config_loader
-    config_loader = get_config_loader()
-    respiration_config = config_loader.get_respiration_parameters()
+    from ..utils.config_loader import get_config_snapshot
+    respiration_config = (config or get_config_snapshot()).physiology.to_dict()
     parameters = RespirationParameters.from_config(respiration_config)
     return EnhancedRespirationModel(parameters)
 
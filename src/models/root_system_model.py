@@ -2,7 +2,7 @@
 Unified Root System Model
 
 Combines:
-- Enhanced Root Architecture Model (spatial, cohorts)
+- Enhanced Root Architecture Model (spatial, cohorts stored column-wise per zone)
 - Hydroponic Root Dynamics utilities
 - Root Architecture Integration (Enhanced nutrient uptake)
 
@@ -17,10 +17,12 @@ from __future__ import annotations
 import math
 from dataclasses import dataclass, field
 from enum import Enum
-from typing import Dict, List, Tuple, Optional
+from typing import Dict, List, Optional, Sequence, Tuple, Union
 
 import numpy as np
 
+from .uptake_kernel import IonUptakeKernel, flow_factor, oxygen_factor, ph_factor, q10_factor, zone_uptake_matrix
+
 
 # =========================
 # Root Architecture (from root_architecture.py)
@@ -96,12 +98,164 @@ class RootCohort:
         return self.surface_area * self.activity_factor * base_uptake_rate
 
 
+# Root type codes of RootCohortStore (index into RootType)
+ROOT_TYPES: Tuple[RootType, ...] = (RootType.FINE, RootType.MEDIUM, RootType.COARSE)
+ROOT_TYPE_CODES: Dict[RootType, int] = {root_type: code for code, root_type in enumerate(ROOT_TYPES)}
+# Activity decay per type (same constants as RootCohort.calculate_activity_factor)
+ROOT_HALF_LIFE_DAYS = np.array([45.0, 90.0, 180.0])
+ROOT_MIN_ACTIVITY = np.array([0.20, 0.25, 0.30])
+
+
+def root_activity_factor(age_days: np.ndarray, type_codes: np.ndarray) -> np.ndarray:
+    """Vectorized RootCohort.calculate_activity_factor over cohort columns."""
+    decay = 0.5 ** (age_days / ROOT_HALF_LIFE_DAYS[type_codes])
+    return np.maximum(ROOT_MIN_ACTIVITY[type_codes], np.where(age_days <= 7.0, 1.0, decay))
+
+
+class RootCohortStore:
+    """
+    Structure-of-arrays storage of the root cohorts of one zone.
+
+    Every cohort attribute is a NumPy column whose first `n` entries are live.
+    Columns grow by doubling, dead cohorts are dropped in one bulk compaction,
+    and zone totals (length, surface area, biomass, volume, length per root
+    type, activity) are kept as running sums, so aggregating a zone no longer
+    walks its cohorts.
+    """
+
+    COLUMNS = ('age_days', 'length', 'diameter', 'biomass', 'surface_area', 'activity_factor')
+
+    def __init__(self, zone_depth: float = 0.0, capacity: int = 32):
+        self.zone_depth = zone_depth        # cm from root collar (shared by the zone's cohorts)
+        self.n = 0
+        for name in self.COLUMNS:
+            setattr(self, name, np.zeros(capacity))
+        self.type_code = np.zeros(capacity, dtype=np.int8)
+        self._reset_totals()
+
+    def _reset_totals(self):
+        self.total_length = 0.0
+        self.total_surface_area = 0.0
+        self.total_biomass = 0.0
+        self.total_volume = 0.0
+        self.total_activity = 0.0
+        self.length_by_type = np.zeros(len(ROOT_TYPES))
+
+    def __len__(self) -> int:
+        return self.n
+
+    @property
+    def capacity(self) -> int:
+        return len(self.length)
+
+    def _reserve(self, size: int):
+        if size <= self.capacity:
+            return
+        new_capacity = max(size, 2 * self.capacity)
+        for name in self.COLUMNS + ('type_code',):
+            column = getattr(self, name)
+            grown = np.zeros(new_capacity, dtype=column.dtype)
+            grown[:self.n] = column[:self.n]
+            setattr(self, name, grown)
+
+    @staticmethod
+    def _volume(length: np.ndarray, diameter: np.ndarray) -> np.ndarray:
+        return np.pi * (diameter / 20.0) ** 2 * length  # cm³ (diameter mm -> radius cm)
+
+    def append(self, length: np.ndarray, diameter: np.ndarray, type_code: np.ndarray,
+               biomass: np.ndarray, age_days: Optional[np.ndarray] = None):
+        """Add cohorts (one entry per array element)."""
+        length = np.asarray(length, dtype=float)
+        k = len(length)
+        if k == 0:
+            return
+        diameter = np.asarray(diameter, dtype=float)
+        type_code = np.asarray(type_code, dtype=np.int8)
+        age = np.zeros(k) if age_days is None else np.asarray(age_days, dtype=float)
+        area = np.pi * (diameter / 10.0) * length
+        activity = root_activity_factor(age, type_code)
+
+        self._reserve(self.n + k)
+        window = slice(self.n, self.n + k)
+        self.age_days[window] = age
+        self.length[window] = length
+        self.diameter[window] = diameter
+        self.biomass[window] = biomass
+        self.surface_area[window] = area
+        self.activity_factor[window] = activity
+        self.type_code[window] = type_code
+        self.n += k
+
+        self.total_length += float(length.sum())
+        self.total_surface_area += float(area.sum())
+        self.total_biomass += float(np.sum(biomass))
+        self.total_volume += float(self._volume(length, diameter).sum())
+        self.total_activity += float(activity.sum())
+        self.length_by_type += np.bincount(type_code, weights=length, minlength=len(ROOT_TYPES))
+
+    def age(self, days: float = 1.0):
+        """Age every cohort and recompute its activity factor."""
+        n = self.n
+        self.age_days[:n] += days
+        self.activity_factor[:n] = root_activity_factor(self.age_days[:n], self.type_code[:n])
+        self.total_activity = float(self.activity_factor[:n].sum())
+
+    def compact(self, keep: np.ndarray):
+        """Drop the cohorts where `keep` is False in one bulk move."""
+        n = self.n
+        if keep.all():
+            return
+        dead = ~keep
+        remaining = int(keep.sum())
+        if remaining == 0:
+            self.n = 0
+            self._reset_totals()
+            return
+
+        length = self.length[:n][dead]
+        diameter = self.diameter[:n][dead]
+        self.total_length -= float(length.sum())
+        self.total_surface_area -= float(self.surface_area[:n][dead].sum())
+        self.total_biomass -= float(self.biomass[:n][dead].sum())
+        self.total_volume -= float(self._volume(length, diameter).sum())
+        self.total_activity -= float(self.activity_factor[:n][dead].sum())
+        self.length_by_type -= np.bincount(self.type_code[:n][dead], weights=length, minlength=len(ROOT_TYPES))
+
+        for name in self.COLUMNS + ('type_code',):
+            column = getattr(self, name)
+            column[:remaining] = column[:n][keep]
+        self.n = remaining
+
+    def uptake_capacity(self, uptake_rate: float) -> float:
+        """Summed RootCohort.calculate_uptake_capacity (mg/day)."""
+        n = self.n
+        return float(np.dot(self.surface_area[:n], self.activity_factor[:n])) * uptake_rate
+
+    def to_cohorts(self) -> List[RootCohort]:
+        """Materialize the live cohorts as RootCohort objects."""
+        return [
+            RootCohort(age_days=float(self.age_days[i]), length=float(self.length[i]),
+                       diameter=float(self.diameter[i]), root_type=ROOT_TYPES[self.type_code[i]],
+                       zone_depth=self.zone_depth, biomass=float(self.biomass[i]))
+            for i in range(self.n)
+        ]
+
+    def replace_cohorts(self, cohorts: List[RootCohort]):
+        """Reload the store from RootCohort objects."""
+        self.n = 0
+        self._reset_totals()
+        if cohorts:
+            self.append(length=[c.length for c in cohorts], diameter=[c.diameter for c in cohorts],
+                        type_code=[ROOT_TYPE_CODES[c.root_type] for c in cohorts],
+                        biomass=np.array([c.biomass for c in cohorts]),
+                        age_days=[c.age_days for c in cohorts])
+
+
 @dataclass
 class RootZoneLayer:
     """Represents a spatial layer in the root zone"""
     depth_range: Tuple[float, float]    # cm from surface
     volume: float                       # cm³
-    root_cohorts: List[RootCohort] = field(default_factory=list)
 
     # Environmental conditions
     temperature: float = 20.0           # °C
@@ -109,50 +263,52 @@ class RootZoneLayer:
     oxygen_level: float = 8.0          # mg/L
     nutrient_concentrations: Dict[str, float] = field(default_factory=dict)
 
+    # Cohorts of this layer, stored column-wise
+    cohorts: RootCohortStore = field(init=False, repr=False)
+
+    def __post_init__(self):
+        self.cohorts = RootCohortStore(zone_depth=sum(self.depth_range) / 2)
+
+    @property
+    def root_cohorts(self) -> List[RootCohort]:
+        """Cohorts as RootCohort objects (materialized on access)."""
+        return self.cohorts.to_cohorts()
+
+    @root_cohorts.setter
+    def root_cohorts(self, cohorts: List[RootCohort]):
+        self.cohorts.replace_cohorts(cohorts)
+
+    @property
+    def n_cohorts(self) -> int:
+        return self.cohorts.n
+
     def calculate_root_length_density(self) -> float:
         """Calculate root length density (cm/cm³)"""
-        total_length = sum(cohort.length for cohort in self.root_cohorts)
-        return total_length / max(1.0, self.volume)
+        return self.cohorts.total_length / max(1.0, self.volume)
 
     def calculate_root_surface_area_density(self) -> float:
         """Calculate root surface area density (cm²/cm³)"""
-        total_area = sum(cohort.surface_area for cohort in self.root_cohorts)
-        return total_area / max(1.0, self.volume)
+        return self.cohorts.total_surface_area / max(1.0, self.volume)
 
     def calculate_total_uptake_capacity(self, nutrient: str, base_rate: float) -> float:
         """Calculate total nutrient uptake capacity for this layer"""
-        total_capacity = 0.0
-        for cohort in self.root_cohorts:
-            adjusted_rate = self.adjust_uptake_rate(base_rate)
-            total_capacity += cohort.calculate_uptake_capacity(adjusted_rate)
-        return total_capacity
+        return self.cohorts.uptake_capacity(self.adjust_uptake_rate(base_rate))
 
     def adjust_uptake_rate(self, base_rate: float) -> float:
         """Adjust uptake rate based on environmental conditions"""
         # Temperature effect (Q10 ≈ 1.6 typical for root uptake)
-        temp_factor = 1.6 ** ((self.temperature - 20.0) / 10.0)
-        temp_factor = max(0.5, min(2.5, temp_factor))
+        temp_factor = q10_factor(self.temperature, 20.0, 1.6, 0.5, 2.5)
 
         # Flow rate effect (optimal around 1-2 L/min)
-        if self.flow_rate < 0.5:
-            flow_factor = 0.5
-        elif self.flow_rate > 4.0:
-            flow_factor = 0.7
-        else:
-            flow_factor = min(1.0, self.flow_rate / 1.5)
+        flow = flow_factor(self.flow_rate, 1.5, 4.0, starved=0.5, stressed=0.7, intercept=0.0)
 
         # Oxygen effect
-        oxygen_factor = min(1.0, self.oxygen_level / 6.0)
-        
-        # pH effect - optimal range 5.5-6.5 for nutrient uptake
-        current_ph = getattr(self, 'ph', 6.0)
-        if 5.5 <= current_ph <= 6.5:
-            ph_factor = 1.0
-        else:
-            ph_deviation = min(abs(current_ph - 5.5), abs(current_ph - 6.5))
-            ph_factor = max(0.3, 1.0 - ph_deviation * 0.15)  # Less severe than growth effects
+        oxygen = oxygen_factor(self.oxygen_level)
+
+        # pH effect - optimal range 5.5-6.5 for nutrient uptake (less severe than growth effects)
+        ph = ph_factor(getattr(self, 'ph', 6.0))
 
-        return base_rate * temp_factor * flow_factor * oxygen_factor * ph_factor
+        return base_rate * temp_factor * flow * oxygen * ph
 
 
 @dataclass
@@ -234,13 +390,19 @@ class RootArchitectureParameters:
 class RootArchitectureModel:
     """Enhanced root architecture model for hydroponic systems"""
 
-    def __init__(self, parameters: RootArchitectureParameters):
+    def __init__(self, parameters: RootArchitectureParameters,
+                 rng: Union[int, Sequence[int], np.random.Generator, None] = None):
         self.params = parameters
         self.root_zones: List[RootZoneLayer] = []
         self.total_age_days = 0.0
         self.cumulative_root_growth = 0.0
+        self.seed(rng)
         self.initialize_root_zones()
 
+    def seed(self, rng: Union[int, Sequence[int], np.random.Generator, None] = None):
+        """Random stream of the cohort survival and diameter draws (a Generator, a seed or None: fresh entropy)."""
+        self.rng = rng if isinstance(rng, np.random.Generator) else np.random.default_rng(rng)
+
     def initialize_root_zones(self):
         """Initialize root zone layers based on system type"""
         if self.params.system_type == HydroponicSystemType.NFT:
@@ -296,23 +458,19 @@ class RootArchitectureModel:
 
     def update_root_aging(self):
         """Age roots and remove those that have died"""
+        survival_prob = 1.0 - np.array([
+            self.params.fine_turnover_rate,
+            self.params.medium_turnover_rate,
+            self.params.coarse_turnover_rate
+        ])
         for zone in self.root_zones:
-            surviving_cohorts = []
-            for cohort in zone.root_cohorts:
-                cohort.age_days += 1.0
-                cohort.activity_factor = cohort.calculate_activity_factor()
-
-                if cohort.root_type == RootType.FINE:
-                    survival_prob = 1.0 - self.params.fine_turnover_rate
-                elif cohort.root_type == RootType.MEDIUM:
-                    survival_prob = 1.0 - self.params.medium_turnover_rate
-                else:
-                    survival_prob = 1.0 - self.params.coarse_turnover_rate
-
-                if np.random.random() < survival_prob:
-                    surviving_cohorts.append(cohort)
-
-            zone.root_cohorts = surviving_cohorts
+            store = zone.cohorts
+            if store.n == 0:
+                continue
+            store.age(1.0)
+            # One draw per cohort in storage order (same stream as per-cohort draws)
+            survives = self.rng.random(store.n) < survival_prob[store.type_code[:store.n]]
+            store.compact(survives)
 
     def generate_new_roots(self, growth_factors: Dict[str, float]) -> float:
         """Generate new root cohorts based on growth conditions"""
@@ -328,6 +486,16 @@ class RootArchitectureModel:
         length_mult = multipliers.get('root_length_multiplier', 1.0)
         branching_mult = multipliers.get('branching_multiplier', 1.0)
 
+        # Per root type (FINE, MEDIUM, COARSE)
+        fractions = np.array([self.params.fine_root_fraction, self.params.medium_root_fraction,
+                              self.params.coarse_root_fraction])
+        diameter_means = np.array([self.params.fine_diameter_mean, self.params.medium_diameter_mean,
+                                   self.params.coarse_diameter_mean])
+        diameter_stds = np.array([self.params.fine_diameter_std, self.params.medium_diameter_std,
+                                  self.params.coarse_diameter_std])
+        diameter_minimums = np.array([0.05, 0.15, 0.8])
+        type_codes = np.arange(len(ROOT_TYPES), dtype=np.int8)
+
         total_new_growth = 0.0
 
         for i, zone in enumerate(self.root_zones):
@@ -335,71 +503,29 @@ class RootArchitectureModel:
             zone_growth = effective_growth * zone_growth_fraction * length_mult
 
             if zone_growth > 0.01:
-                for root_type in RootType:
-                    if root_type == RootType.FINE:
-                        fraction = self.params.fine_root_fraction
-                        diameter = max(0.05, np.random.normal(
-                            self.params.fine_diameter_mean, self.params.fine_diameter_std))
-                    elif root_type == RootType.MEDIUM:
-                        fraction = self.params.medium_root_fraction
-                        diameter = max(0.15, np.random.normal(
-                            self.params.medium_diameter_mean, self.params.medium_diameter_std))
-                    else:
-                        fraction = self.params.coarse_root_fraction
-                        diameter = max(0.8, np.random.normal(
-                            self.params.coarse_diameter_mean, self.params.coarse_diameter_std))
-
-                    cohort_length = zone_growth * fraction * branching_mult
-                    if cohort_length > 0.1:
-                        diameter_cm = diameter / 10.0
-                        volume = math.pi * (diameter_cm/2)**2 * cohort_length
-                        biomass = volume * 0.3
-
-                        new_cohort = RootCohort(
-                            age_days=0.0,
-                            length=cohort_length,
-                            diameter=diameter,
-                            root_type=root_type,
-                            zone_depth=sum(zone.depth_range) / 2,
-                            biomass=biomass
-                        )
-                        zone.root_cohorts.append(new_cohort)
-                        total_new_growth += cohort_length
+                # One diameter draw per root type, in type order
+                diameters = np.maximum(diameter_minimums, self.rng.normal(diameter_means, diameter_stds))
+                lengths = zone_growth * fractions * branching_mult
+                born = lengths > 0.1
+                if born.any():
+                    lengths, diameters = lengths[born], diameters[born]
+                    biomass = np.pi * (diameters / 20.0) ** 2 * lengths * 0.3
+                    zone.cohorts.append(lengths, diameters, type_codes[born], biomass)
+                    total_new_growth += float(lengths.sum())
 
         return total_new_growth
 
     def calculate_architecture_metrics(self) -> Dict[str, float]:
-        total_length = 0.0
-        total_surface_area = 0.0
-        total_biomass = 0.0
-        total_volume = 0.0
-
-        fine_length = 0.0
-        medium_length = 0.0
-        coarse_length = 0.0
-
-        weighted_activity = 0.0
-        total_cohorts = 0
-
-        for zone in self.root_zones:
-            for cohort in zone.root_cohorts:
-                total_length += cohort.length
-                total_surface_area += cohort.surface_area
-                total_biomass += cohort.biomass
-
-                diameter_cm = cohort.diameter / 10.0
-                cohort_volume = math.pi * (diameter_cm/2)**2 * cohort.length
-                total_volume += cohort_volume
-
-                if cohort.root_type == RootType.FINE:
-                    fine_length += cohort.length
-                elif cohort.root_type == RootType.MEDIUM:
-                    medium_length += cohort.length
-                else:
-                    coarse_length += cohort.length
-
-                weighted_activity += cohort.activity_factor
-                total_cohorts += 1
+        # Sums of the zones' running totals
+        stores = [zone.cohorts for zone in self.root_zones]
+        total_length = sum(store.total_length for store in stores)
+        total_surface_area = sum(store.total_surface_area for store in stores)
+        total_biomass = sum(store.total_biomass for store in stores)
+        total_volume = sum(store.total_volume for store in stores)
+        fine_length, medium_length, coarse_length = (
+            float(length) for length in sum(store.length_by_type for store in stores))
+        weighted_activity = sum(store.total_activity for store in stores)
+        total_cohorts = sum(store.n for store in stores)
 
         total_zone_volume = sum(zone.volume for zone in self.root_zones)
         root_length_density = total_length / max(1.0, total_zone_volume)
@@ -429,16 +555,14 @@ class RootArchitectureModel:
         distribution = {}
         for i, zone in enumerate(self.root_zones):
             zone_name = f"zone_{i+1}_depth_{zone.depth_range[0]}-{zone.depth_range[1]}cm"
-            total_length = sum(cohort.length for cohort in zone.root_cohorts)
-            total_area = sum(cohort.surface_area for cohort in zone.root_cohorts)
-            total_biomass = sum(cohort.biomass for cohort in zone.root_cohorts)
+            store = zone.cohorts
             distribution[zone_name] = {
-                'root_length': total_length,
-                'root_surface_area': total_area,
-                'root_biomass': total_biomass,
+                'root_length': store.total_length,
+                'root_surface_area': store.total_surface_area,
+                'root_biomass': store.total_biomass,
                 'root_length_density': zone.calculate_root_length_density(),
                 'root_surface_area_density': zone.calculate_root_surface_area_density(),
-                'num_cohorts': len(zone.root_cohorts)
+                'num_cohorts': store.n
             }
         return distribution
 
@@ -637,9 +761,18 @@ class RootUptakeParameters:
     michaelis_constants: Dict[str, float] = None
 
 
+def _at_least(minimum: float, value):
+    """max(minimum, value) for scalars, elementwise for arrays."""
+    return np.maximum(minimum, value) if np.ndim(value) else max(minimum, value)
+
+
 class EnhancedRootUptakeModel:
     """
-    Enhanced nutrient uptake model using detailed root architecture
+    Enhanced nutrient uptake model using detailed root architecture.
+
+    calculate_nutrient_uptake also accepts arrays (one entry per plant
+    position) for the architecture metrics, temperature and concentrations
+    and then returns arrays of uptake rates.
     """
 
     def __init__(self, system_type: HydroponicSystemType = HydroponicSystemType.NFT, 
@@ -695,36 +828,38 @@ class EnhancedRootUptakeModel:
         flow_rate = environmental_conditions.get('flow_rate', 1.5)
 
         temp_factor = self.calculate_temperature_factor(temperature)
-        flow_factor = self.calculate_flow_factor(flow_rate)
-
-        uptake_rates: Dict[str, float] = {}
-        for nutrient, concentration in solution_concentrations.items():
-            if nutrient in self.uptake_params.base_uptake_rates:
-                base_rate = self.uptake_params.base_uptake_rates[nutrient]
-                if self.uptake_params.michaelis_constants:
-                    km = self.uptake_params.michaelis_constants.get(nutrient, 50.0)
-                    conc_factor = concentration / (concentration + km)
-                else:
-                    conc_factor = 1.0
-
-                effective_surface_area = self.calculate_effective_surface_area(architecture_metrics)
-                uptake_rate = (
-                    effective_surface_area * base_rate * conc_factor * temp_factor * flow_factor * avg_activity
-                )
-                uptake_rates[f'{nutrient}_uptake_rate'] = uptake_rate
-
-        total_uptake = sum(uptake_rates.values())
+        flow = self.calculate_flow_factor(flow_rate)
+        effective_surface_area = self.calculate_effective_surface_area(architecture_metrics)
+
+        # All ions in one kernel call; the site capacity carries every broadcast factor
+        kernel = self.uptake_kernel
+        concentrations, present = kernel.gather(solution_concentrations)
+        rates = kernel.rates(concentrations, effective_surface_area * temp_factor * flow * avg_activity)
+        uptake_rates = {f'{nutrient}_uptake_rate': rate for nutrient, rate in kernel.by_ion(rates, present).items()}
+
+        total_uptake = rates[..., present].sum(axis=-1)
+        if np.ndim(total_uptake) == 0:
+            total_uptake = float(total_uptake)
         return {
             **uptake_rates,
             'total_nutrient_uptake': total_uptake,
-            'uptake_per_surface_area': total_uptake / max(1.0, total_surface_area),
+            'uptake_per_surface_area': total_uptake / _at_least(1.0, total_surface_area),
             'uptake_temperature_factor': temp_factor,
-            'uptake_flow_factor': flow_factor,
-            'effective_root_surface_area': self.calculate_effective_surface_area(architecture_metrics),
+            'uptake_flow_factor': flow,
+            'effective_root_surface_area': effective_surface_area,
             'total_uptake_g_per_day': total_uptake / 1000.0,
             'nitrogen_uptake_g_per_day': uptake_rates.get('NO3_uptake_rate', 0.0) / 1000.0,
         }
 
+    @property
+    def uptake_kernel(self) -> IonUptakeKernel:
+        """Shared ion uptake kernel of the current uptake parameters."""
+        return IonUptakeKernel.from_root_uptake_params(self.uptake_params)
+
+    def calculate_zone_uptake(self, solution_concentrations: Optional[Dict[str, float]] = None) -> np.ndarray:
+        """(zones, ions) uptake capacity of every root zone for every ion (ions: uptake_kernel.ions)."""
+        return zone_uptake_matrix(self.uptake_kernel, self.root_architecture.root_zones, solution_concentrations)
+
     def calculate_effective_surface_area(self, architecture_metrics: Dict[str, float]) -> float:
         # Get the actual surface areas by root type from the root architecture
         # The root architecture already properly calculates surface area from cohorts
@@ -750,6 +885,9 @@ class EnhancedRootUptakeModel:
         )
         
         # Fallback: if architecture-based calculation fails, use total surface area as proxy
+        if np.ndim(effective_area):
+            total_surface = architecture_metrics.get('total_root_surface_area', 0)
+            return np.where(effective_area < 1e-6, total_surface * 0.7, effective_area)
         if effective_area < 1e-6:
             total_surface = architecture_metrics.get('total_root_surface_area', 0)
             effective_area = total_surface * 0.7  # Assume 70% effectiveness
@@ -757,29 +895,24 @@ class EnhancedRootUptakeModel:
         return effective_area
 
     def calculate_temperature_factor(self, temperature: float) -> float:
-        temp_diff = temperature - self.uptake_params.optimal_temperature
-        factor = self.uptake_params.q10_factor ** (temp_diff / 10.0)
-        return max(0.1, min(4.0, factor))
+        return q10_factor(temperature, self.uptake_params.optimal_temperature, self.uptake_params.q10_factor)
 
     def calculate_flow_factor(self, flow_rate: float) -> float:
-        optimal_flow = self.uptake_params.optimal_flow_rate
-        if flow_rate < 0.5:
-            return 0.4
-        elif flow_rate > self.uptake_params.flow_stress_threshold:
-            return 0.6
-        else:
-            normalized_flow = flow_rate / optimal_flow
-            return min(1.0, 0.5 + 0.5 * normalized_flow)
+        return flow_factor(flow_rate, self.uptake_params.optimal_flow_rate,
+                           self.uptake_params.flow_stress_threshold)
 
     def get_spatial_uptake_distribution(self) -> Dict[str, Dict[str, float]]:
         root_distribution = self.root_architecture.get_root_distribution()
         spatial_uptake: Dict[str, Dict[str, float]] = {}
-        for zone_name, zone_data in root_distribution.items():
-            zone_surface_area = zone_data['root_surface_area']
-            zone_uptake: Dict[str, float] = {}
-            for nutrient, base_rate in self.uptake_params.base_uptake_rates.items():
-                zone_uptake[f'{nutrient}_capacity'] = zone_surface_area * base_rate
-            zone_uptake['total_surface_area'] = zone_surface_area
+        kernel = self.uptake_kernel
+        zone_names = list(root_distribution)
+        surface = np.array([root_distribution[name]['root_surface_area'] for name in zone_names])
+        capacities = np.outer(surface, kernel.vmax)
+        for zone_name, zone_capacity in zip(zone_names, capacities.tolist()):
+            zone_uptake: Dict[str, float] = {
+                f'{nutrient}_capacity': capacity for nutrient, capacity in zip(kernel.ions, zone_capacity)
+            }
+            zone_uptake['total_surface_area'] = root_distribution[zone_name]['root_surface_area']
             zone_uptake['total_capacity'] = sum(
                 v for k, v in zone_uptake.items() if k.endswith('_capacity')
             )
@@ -15,9 +15,22 @@ Key findings:
 """
 
 import numpy as np
+from functools import partial
 from typing import Dict, Tuple, Optional
 from dataclasses import dataclass
 
+from ..utils.response_tables import DEFAULT_TABLE_RANGE, ResponseTable, TableRange, response_table
+
+# Per-factor response to RZT - optimal RZT:
+# (slope per °C below optimum, slope per °C above optimum, min factor, max factor).
+# The growth factor takes its slopes from RZTParameters.
+RZT_FACTOR_SHAPES: Dict[str, Tuple[float, float, float, float]] = {
+    'nutrient_uptake': (0.06, 0.12, 0.3, 1.4),    # Slightly less sensitive, more sensitive to excess
+    'water_uptake': (0.04, 0.08, 0.4, 1.3),       # Less sensitive than growth
+    'photosynthesis': (0.03, 0.05, 0.5, 1.2),     # Moderate sensitivity
+    'root_metabolism': (0.1, 0.18, 0.3, 1.6),     # Highly sensitive
+}
+
 
 @dataclass
 class RZTParameters:
@@ -55,6 +68,45 @@ class RootZoneTemperatureModel:
     
     def __init__(self, parameters: Optional[RZTParameters] = None):
         self.params = parameters or RZTParameters()
+        # Factor tables over RZT - optimal RZT (None: exact formulas)
+        self._factor_tables: Optional[Dict[str, ResponseTable]] = None
+
+    def factor_shape(self, factor: str) -> Tuple[float, float, float, float]:
+        if factor == 'growth':
+            return (self.params.linear_growth_slope, self.params.rapid_decline_slope, 0.2, 1.5)
+        return RZT_FACTOR_SHAPES[factor]
+
+    def use_response_tables(self, table_range: Optional[TableRange] = DEFAULT_TABLE_RANGE):
+        """Evaluate the RZT factors from shared tables (None restores the exact formulas)."""
+        if table_range is None:
+            self._factor_tables = None
+            return
+        # The optimum is clipped to the effective range, so RZT - optimum spans
+        # [t_min - max_effective, t_max - min_effective]
+        delta_range = TableRange(table_range.t_min - self.params.max_effective_rzt,
+                                 table_range.t_max - self.params.min_effective_rzt, table_range.step)
+        self._factor_tables = {}
+        for factor in ('growth',) + tuple(RZT_FACTOR_SHAPES):
+            key = (factor, self.params.base_growth_factor) + self.factor_shape(factor)
+            self._factor_tables[factor] = response_table('rzt.factor', key,
+                                                         partial(self._offset_factor_exact, factor),
+                                                         delta_range)
+
+    def _offset_factor_exact(self, factor: str, rzt_excess: float) -> float:
+        """Factor at RZT - optimal RZT = rzt_excess: linear on each side of the optimum, clipped."""
+        slope_below, slope_above, low, high = self.factor_shape(factor)
+        base = self.params.base_growth_factor if factor == 'growth' else 1.0
+        if rzt_excess <= 0:
+            value = base + (-rzt_excess * slope_below)
+        else:
+            value = base - (rzt_excess * slope_above)
+        return np.clip(value, low, high)
+
+    def _offset_factor(self, factor: str, current_rzt: float, air_temperature: float) -> float:
+        rzt_excess = current_rzt - self.calculate_optimal_rzt(air_temperature)
+        if self._factor_tables is not None:
+            return self._factor_tables[factor](rzt_excess)
+        return self._offset_factor_exact(factor, rzt_excess)
     
     def calculate_optimal_rzt(self, air_temperature: float) -> float:
         """
@@ -82,23 +134,11 @@ class RootZoneTemperatureModel:
         Returns:
             Growth factor (0.2 to 1.5)
         """
-        optimal_rzt = self.calculate_optimal_rzt(air_temperature)
-        
-        if current_rzt <= optimal_rzt:
-            # Linear growth up to optimum
-            if current_rzt >= self.params.min_effective_rzt:
-                temperature_diff = optimal_rzt - current_rzt
-                factor = self.params.base_growth_factor + (temperature_diff * self.params.linear_growth_slope)
-            else:
-                # Below minimum effective temperature
-                factor = 0.2
-        else:
-            # Rapid decline above optimum
-            temperature_excess = current_rzt - optimal_rzt
-            factor = self.params.base_growth_factor - (temperature_excess * self.params.rapid_decline_slope)
-        
-        # Constrain factor within reasonable bounds
-        return np.clip(factor, 0.2, 1.5)
+        if current_rzt < self.params.min_effective_rzt:
+            # Below minimum effective temperature (always below the clipped optimum)
+            return 0.2
+        # Linear growth up to optimum, rapid decline above it
+        return self._offset_factor('growth', current_rzt, air_temperature)
     
     def calculate_nutrient_uptake_factor(self, current_rzt: float, air_temperature: float) -> float:
         """
@@ -113,17 +153,7 @@ class RootZoneTemperatureModel:
         Returns:
             Nutrient uptake efficiency factor (0.3 to 1.4)
         """
-        optimal_rzt = self.calculate_optimal_rzt(air_temperature)
-        
-        # Uptake efficiency follows similar pattern but with different sensitivity
-        if current_rzt <= optimal_rzt:
-            temperature_diff = optimal_rzt - current_rzt
-            factor = 1.0 + (temperature_diff * 0.06)  # Slightly less sensitive
-        else:
-            temperature_excess = current_rzt - optimal_rzt
-            factor = 1.0 - (temperature_excess * 0.12)  # More sensitive to excess
-        
-        return np.clip(factor, 0.3, 1.4)
+        return self._offset_factor('nutrient_uptake', current_rzt, air_temperature)
     
     def calculate_water_uptake_factor(self, current_rzt: float, air_temperature: float) -> float:
         """
@@ -136,17 +166,7 @@ class RootZoneTemperatureModel:
         Returns:
             Water uptake factor (0.4 to 1.3)
         """
-        optimal_rzt = self.calculate_optimal_rzt(air_temperature)
-        
-        # Water uptake is less sensitive to temperature than growth
-        if current_rzt <= optimal_rzt:
-            temperature_diff = optimal_rzt - current_rzt
-            factor = 1.0 + (temperature_diff * 0.04)
-        else:
-            temperature_excess = current_rzt - optimal_rzt
-            factor = 1.0 - (temperature_excess * 0.08)
-        
-        return np.clip(factor, 0.4, 1.3)
+        return self._offset_factor('water_uptake', current_rzt, air_temperature)
     
     def calculate_photosynthesis_factor(self, current_rzt: float, air_temperature: float) -> float:
         """
@@ -159,17 +179,7 @@ class RootZoneTemperatureModel:
         Returns:
             Photosynthesis factor (0.5 to 1.2)
         """
-        optimal_rzt = self.calculate_optimal_rzt(air_temperature)
-        
-        # Photosynthesis has moderate sensitivity to RZT
-        if current_rzt <= optimal_rzt:
-            temperature_diff = optimal_rzt - current_rzt
-            factor = 1.0 + (temperature_diff * 0.03)
-        else:
-            temperature_excess = current_rzt - optimal_rzt
-            factor = 1.0 - (temperature_excess * 0.05)
-        
-        return np.clip(factor, 0.5, 1.2)
+        return self._offset_factor('photosynthesis', current_rzt, air_temperature)
     
     def calculate_root_metabolism_factor(self, current_rzt: float, air_temperature: float) -> float:
         """
@@ -184,17 +194,7 @@ class RootZoneTemperatureModel:
         Returns:
             Root metabolism factor (0.3 to 1.6)
         """
-        optimal_rzt = self.calculate_optimal_rzt(air_temperature)
-        
-        # Root metabolism is highly sensitive to temperature
-        if current_rzt <= optimal_rzt:
-            temperature_diff = optimal_rzt - current_rzt
-            factor = 1.0 + (temperature_diff * 0.1)
-        else:
-            temperature_excess = current_rzt - optimal_rzt
-            factor = 1.0 - (temperature_excess * 0.18)
-        
-        return np.clip(factor, 0.3, 1.6)
+        return self._offset_factor('root_metabolism', current_rzt, air_temperature)
     
     
 
@@ -15,13 +15,23 @@ Research basis:
 - Masclaux-Daubresse et al. (2010) - Nitrogen remobilization during senescence
 - Lim et al. (2007) - Leaf senescence
 - Bleecker & Patterson (1997) - Last exit: senescence, abscission and meristem arrest
+
+Cohort states are columns of a LeafCohortTable; update_table() advances all
+cohorts with array expressions, and the simulator passes the table owned by
+the leaf development model so both models update the same cohorts.
 """
 
 import numpy as np
-from typing import Dict, Tuple, Optional, Any, List
+from typing import Dict, Tuple, Optional, Any, List, TYPE_CHECKING
 from dataclasses import dataclass
 from enum import Enum
 
+from .leaf_cohort_table import LeafCohortTable
+from ..utils.ring_buffer import RingBuffer
+
+if TYPE_CHECKING:
+    from ..utils.config_loader import ConfigSnapshot
+
 
 class SenescenceType(Enum):
     """Types of senescence triggers."""
@@ -44,6 +54,21 @@ class SenescenceStage(Enum):
     DEAD = "dead"                            # Tissue death
 
 
+# Codes of LeafCohortTable.senescence_stage (ordered by severity) and bits of senescence_types
+SENESCENCE_STAGES: Tuple[SenescenceStage, ...] = tuple(SenescenceStage)
+SENESCENCE_TYPES: Tuple[SenescenceType, ...] = tuple(SenescenceType)
+_HEALTHY, _EARLY, _ACTIVE, _LATE, _DEAD = range(len(SENESCENCE_STAGES))
+_TYPE_BIT = {senescence_type: 1 << i for i, senescence_type in enumerate(SENESCENCE_TYPES)}
+# Stress key of environmental_stress -> senescence trigger
+_STRESS_TYPES = {
+    'water': SenescenceType.WATER_STRESS,
+    'nitrogen': SenescenceType.NITROGEN_STRESS,
+    'temperature': SenescenceType.TEMPERATURE_STRESS,
+    'light': SenescenceType.LIGHT_STRESS
+}
+DEFAULT_NUTRIENT_CONTENT = {'nitrogen': 0.04, 'phosphorus': 0.01, 'potassium': 0.03}
+
+
 @dataclass
 class SenescenceParameters:
     """Parameters for senescence model."""
@@ -149,10 +174,30 @@ class LeafCohortSenescence:
             self.remobilizable_nutrients = {}
 
 
+def cohort_senescence_states(table: LeafCohortTable) -> Dict[int, LeafCohortSenescence]:
+    """Senescence state of every cohort of a table as LeafCohortSenescence objects."""
+    states = {}
+    for i in range(table.n):
+        cohort_id = int(table.cohort_id[i])
+        mask = int(table.senescence_types[i])
+        states[cohort_id] = LeafCohortSenescence(
+            cohort_id=cohort_id,
+            age_gdd=float(table.age_gdd[i]),
+            senescence_damage=float(table.senescence_damage[i]),
+            senescence_stage=SENESCENCE_STAGES[table.senescence_stage[i]],
+            active_senescence_types=[t for t in SENESCENCE_TYPES if mask & _TYPE_BIT[t]],
+            daily_senescence_rate=float(table.daily_senescence_rate[i]),
+            nutrient_content=dict(zip(table.nutrients, table.nutrient_content[i].tolist())),
+            remobilizable_nutrients=dict(zip(table.nutrients, table.remobilizable[i].tolist())),
+            is_recoverable=bool(table.recoverable[i])
+        )
+    return states
+
+
 @dataclass
 class SenescenceResponse:
     """Daily senescence calculation results."""
-    cohort_responses: Dict[int, LeafCohortSenescence]
+    cohort_table: LeafCohortTable             # Copy of the cohort table after the update
     total_senescence_rate: float              # Total daily senescence across all cohorts
     remobilized_nutrients: Dict[str, float]   # Total nutrients remobilized (g/day)
     senesced_area: float                      # Total leaf area lost (m²/day)
@@ -160,6 +205,11 @@ class SenescenceResponse:
     active_senescence_types: List[SenescenceType]
     average_senescence_stage: SenescenceStage
 
+    @property
+    def cohort_responses(self) -> Dict[int, LeafCohortSenescence]:
+        """Per-cohort states (materialized on access)."""
+        return cohort_senescence_states(self.cohort_table)
+
 
 class AdvancedSenescenceModel:
     """
@@ -171,15 +221,24 @@ class AdvancedSenescenceModel:
     
     def __init__(self, parameters: Optional[SenescenceParameters] = None):
         self.params = parameters or SenescenceParameters()
-        self.cohort_states: Dict[int, LeafCohortSenescence] = {}
-        self.stress_history: Dict[str, List[float]] = {
-            'water': [],
-            'nitrogen': [],
-            'temperature': [],
-            'light': []
+        # Cohort table of the last update (the leaf model's table when shared)
+        self.table = LeafCohortTable()
+        self.stress_history: Dict[str, RingBuffer] = {
+            'water': RingBuffer(7),
+            'nitrogen': RingBuffer(7),
+            'temperature': RingBuffer(7),
+            'light': RingBuffer(7)
         }
         self.remobilization_pool: Dict[str, float] = {}
-        
+
+    @property
+    def cohort_states(self) -> Dict[int, LeafCohortSenescence]:
+        """Per-cohort senescence states (materialized on access)."""
+        return cohort_senescence_states(self.table)
+
+    def _efficiency_vector(self, table: LeafCohortTable) -> np.ndarray:
+        return np.array([self.params.remobilization_efficiency.get(nutrient, 0.0) for nutrient in table.nutrients])
+
     def initialize_cohort(self, cohort_id: int, initial_nutrient_content: Dict[str, float]):
         """
         Initialize senescence tracking for a new leaf cohort.
@@ -188,17 +247,22 @@ class AdvancedSenescenceModel:
             cohort_id: Unique identifier for the cohort
             initial_nutrient_content: Initial nutrient content (g nutrient/g biomass)
         """
-        self.cohort_states[cohort_id] = LeafCohortSenescence(
-            cohort_id=cohort_id,
-            nutrient_content=initial_nutrient_content.copy(),
-            remobilizable_nutrients={}
-        )
-        
-        # Calculate initial remobilizable nutrients
-        for nutrient, content in initial_nutrient_content.items():
-            if nutrient in self.params.remobilization_efficiency:
-                efficiency = self.params.remobilization_efficiency[nutrient]
-                self.cohort_states[cohort_id].remobilizable_nutrients[nutrient] = content * efficiency
+        table = self.table
+        row = table.rows_of([cohort_id])[0]
+        if row < 0:
+            row = table.append(cohort_id=cohort_id, leaf_stage=0)
+        self._initialize_rows(table, np.array([row]), initial_nutrient_content)
+
+    def _initialize_rows(self, table: LeafCohortTable, rows: np.ndarray,
+                         nutrient_content: Dict[str, float]):
+        """Set nutrient content and remobilizable nutrients of newly tracked rows."""
+        table.ensure_nutrients(list(nutrient_content))
+        content = np.array([nutrient_content.get(nutrient, 0.0) for nutrient in table.nutrients])
+        # Only nutrients with a remobilization efficiency become remobilizable
+        efficiency = self._efficiency_vector(table)
+        table.nutrient_content[rows] = content
+        table.remobilizable[rows] = content * efficiency
+        table.nutrients_initialized[rows] = True
     
     def calculate_age_senescence(self, cohort_state: LeafCohortSenescence) -> float:
         """
@@ -379,6 +443,9 @@ class AdvancedSenescenceModel:
         """
         Daily senescence update for all cohorts.
         
+        Cohorts are keyed by id into this model's cohort table; prefer
+        update_table() with a shared table to avoid building the dict.
+        
         Args:
             cohort_data: Dictionary with cohort info (age_gdd, area, biomass, etc.)
             environmental_stress: Current stress levels (water, nitrogen, temperature, light)
@@ -387,13 +454,51 @@ class AdvancedSenescenceModel:
         Returns:
             Complete senescence response
         """
-        # Update stress history
+        table = self.table
+        rows = table.rows_of(list(cohort_data))
+        for i, (cohort_id, data) in enumerate(cohort_data.items()):
+            # Initialize cohort if not exists
+            if rows[i] < 0:
+                rows[i] = table.append(cohort_id=cohort_id, leaf_stage=0)
+                self._initialize_rows(table, rows[i:i + 1],
+                                      data.get('nutrient_content', DEFAULT_NUTRIENT_CONTENT))
+            row = rows[i]
+            table.age_gdd[row] = data.get('age_gdd', 0.0)
+            table.area[row] = data.get('area', 0.0)
+            table.biomass[row] = data.get('biomass', 0.0)
+            table.canopy_position[row] = data.get('canopy_position', 0.5)
+
+        return self.update_table(table, environmental_stress, developmental_state, rows=rows)
+
+    def update_table(self, table: LeafCohortTable, environmental_stress: Dict[str, float],
+                     developmental_state: Dict[str, Any],
+                     nutrient_content: Optional[Dict[str, float]] = None,
+                     rows: Optional[np.ndarray] = None) -> SenescenceResponse:
+        """
+        Daily senescence update of a cohort table, in place.
+        
+        Args:
+            table: Cohort table (age_gdd, area, biomass and canopy_position are read)
+            environmental_stress: Current stress levels (water, nitrogen, temperature, light)
+            developmental_state: Plant developmental information
+            nutrient_content: Nutrient content (g nutrient/g biomass) of cohorts seen
+                for the first time (default: DEFAULT_NUTRIENT_CONTENT)
+            rows: Rows to update (default: all cohorts)
+            
+        Returns:
+            Complete senescence response
+        """
+        self.table = table
+        if rows is None:
+            rows = np.arange(table.n)
+        new_rows = rows[~table.nutrients_initialized[rows]]
+        if len(new_rows):
+            self._initialize_rows(table, new_rows, nutrient_content or DEFAULT_NUTRIENT_CONTENT)
+
+        # Update stress history (ring buffers keep the last 7 days)
         for stress_type, level in environmental_stress.items():
             if stress_type in self.stress_history:
                 self.stress_history[stress_type].append(level)
-                # Keep only recent history (7 days)
-                if len(self.stress_history[stress_type]) > 7:
-                    self.stress_history[stress_type] = self.stress_history[stress_type][-7:]
         
         # Calculate stress senescence rates
         stress_rates = self.calculate_stress_senescence(
@@ -402,113 +507,84 @@ class AdvancedSenescenceModel:
             environmental_stress.get('temperature', 1.0),
             environmental_stress.get('light', 1.0)
         )
-        
-        # Process each cohort
-        total_senescence = 0.0
-        total_remobilized = {}
-        total_senesced_area = 0.0
-        total_senesced_biomass = 0.0
-        active_senescence_types = []
-        stage_counts = {stage: 0 for stage in SenescenceStage}
-        
-        for cohort_id, data in cohort_data.items():
-            # Initialize cohort if not exists
-            if cohort_id not in self.cohort_states:
-                initial_nutrients = data.get('nutrient_content', {
-                    'nitrogen': 0.04,  # Default N content
-                    'phosphorus': 0.01,
-                    'potassium': 0.03
-                })
-                self.initialize_cohort(cohort_id, initial_nutrients)
-            
-            cohort_state = self.cohort_states[cohort_id]
-            
-            # Update age
-            cohort_state.age_gdd = data.get('age_gdd', 0.0)
-            
-            # Calculate different senescence components
-            age_senescence = self.calculate_age_senescence(cohort_state)
-            
-            dev_senescence = self.calculate_developmental_senescence(
-                developmental_state.get('is_reproductive', False),
-                data.get('canopy_position', 0.5)
-            )
-            
-            # Combine stress senescence rates
-            stress_senescence = max(stress_rates.values()) if stress_rates else 0.0
-            
-            # Calculate recovery
-            recovery_rate = self.calculate_recovery_rate(cohort_state, environmental_stress)
-            
-            # Total daily senescence rate
-            total_daily_rate = age_senescence + dev_senescence + stress_senescence - recovery_rate
-            total_daily_rate = max(0.0, total_daily_rate)  # Can't be negative
-            
-            cohort_state.daily_senescence_rate = total_daily_rate
-            
-            # Update senescence damage
-            cohort_state.senescence_damage += total_daily_rate
-            cohort_state.senescence_damage = min(1.0, max(0.0, cohort_state.senescence_damage))
-            
-            # Update senescence stage
-            self.update_senescence_stage(cohort_state)
-            
-            # Track active senescence types
-            cohort_state.active_senescence_types = []
-            if age_senescence > 0:
-                cohort_state.active_senescence_types.append(SenescenceType.AGE_BASED)
-            if stress_rates.get('water', 0) > 0:
-                cohort_state.active_senescence_types.append(SenescenceType.WATER_STRESS)
-            if stress_rates.get('nitrogen', 0) > 0:
-                cohort_state.active_senescence_types.append(SenescenceType.NITROGEN_STRESS)
-            if stress_rates.get('temperature', 0) > 0:
-                cohort_state.active_senescence_types.append(SenescenceType.TEMPERATURE_STRESS)
-            if stress_rates.get('light', 0) > 0:
-                cohort_state.active_senescence_types.append(SenescenceType.LIGHT_STRESS)
-            if dev_senescence > 0:
-                cohort_state.active_senescence_types.append(SenescenceType.DEVELOPMENTAL)
-            
-            # Calculate nutrient remobilization
-            remobilized = self.calculate_nutrient_remobilization(cohort_state, total_daily_rate)
-            
-            # Accumulate totals
-            cohort_area = data.get('area', 0.0)
-            cohort_biomass = data.get('biomass', 0.0)
-            
-            total_senescence += total_daily_rate
-            total_senesced_area += cohort_area * cohort_state.senescence_damage * 0.1  # 10% of damaged area lost per day
-            total_senesced_biomass += cohort_biomass * cohort_state.senescence_damage * 0.1
-            
-            for nutrient, amount in remobilized.items():
-                total_remobilized[nutrient] = total_remobilized.get(nutrient, 0.0) + amount
-            
-            active_senescence_types.extend(cohort_state.active_senescence_types)
-            stage_counts[cohort_state.senescence_stage] += 1
-        
-        # Determine average senescence stage
-        if stage_counts[SenescenceStage.DEAD] > 0:
-            avg_stage = SenescenceStage.DEAD
-        elif stage_counts[SenescenceStage.LATE_SENESCENCE] > 0:
-            avg_stage = SenescenceStage.LATE_SENESCENCE
-        elif stage_counts[SenescenceStage.ACTIVE_SENESCENCE] > 0:
-            avg_stage = SenescenceStage.ACTIVE_SENESCENCE
-        elif stage_counts[SenescenceStage.EARLY_SENESCENCE] > 0:
-            avg_stage = SenescenceStage.EARLY_SENESCENCE
-        else:
-            avg_stage = SenescenceStage.HEALTHY
-        
+        stress_senescence = max(stress_rates.values()) if stress_rates else 0.0
+        p = self.params
+
+        age = table.age_gdd[rows]
+        damage = table.senescence_damage[rows]
+        stage = table.senescence_stage[rows]
+        recoverable = table.recoverable[rows]
+        position = table.canopy_position[rows]
+
+        # Age senescence: rate increases with age beyond the natural lifespan
+        age_senescence = np.where(age > p.natural_lifespan_gdd,
+                                  p.age_senescence_rate * (1.0 + (age - p.natural_lifespan_gdd) / 100.0), 0.0)
+
+        # Developmental senescence: reproductive priority and lower-canopy shading
+        dev_senescence = np.where(position < 0.5,
+                                  p.age_senescence_rate * (0.5 - position) * 2.0 * (p.lower_canopy_factor - 1.0), 0.0)
+        if developmental_state.get('is_reproductive', False):
+            dev_senescence = dev_senescence + p.age_senescence_rate * (p.reproductive_priority_factor - 1.0)
+
+        # Recovery only in early senescence, under good conditions and below max_recovery damage
+        all_stress_low = all(level > 0.8 for level in environmental_stress.values())
+        recovering = recoverable & (damage <= p.max_recovery) & (stage == _EARLY) & all_stress_low
+        recovery_rate = np.where(recovering, np.minimum(p.recovery_rate, damage * 0.1), 0.0)
+
+        # Total daily senescence rate (can't be negative) and damage
+        total_daily_rate = np.maximum(0.0, age_senescence + dev_senescence + stress_senescence - recovery_rate)
+        damage = np.clip(damage + total_daily_rate, 0.0, 1.0)
+
+        # Senescence stage from accumulated damage; late stages are irreversible
+        stage = np.select(
+            [damage >= p.death_threshold, damage >= p.late_senescence_threshold,
+             damage >= p.active_senescence_threshold, damage >= p.early_senescence_threshold],
+            [_DEAD, _LATE, _ACTIVE, _EARLY], _HEALTHY).astype(np.int8)
+        recoverable = recoverable & (damage < p.late_senescence_threshold)
+
+        # Active senescence triggers as a bit mask
+        stress_bits = sum(_TYPE_BIT[_STRESS_TYPES[key]] for key, rate in stress_rates.items() if rate > 0)
+        types = (np.where(age_senescence > 0, _TYPE_BIT[SenescenceType.AGE_BASED], 0)
+                 | np.where(dev_senescence > 0, _TYPE_BIT[SenescenceType.DEVELOPMENTAL], 0)
+                 | stress_bits)
+
+        # Nutrient remobilization during senescence, doubled in active senescence
+        available = table.remobilizable[rows]
+        remob_rate = np.where(stage == _ACTIVE, total_daily_rate * 2.0, total_daily_rate)
+        remobilizing = ((total_daily_rate > 0) & (stage != _HEALTHY))[:, None] & (available > 0)
+        remobilized = np.where(remobilizing,
+                               available * remob_rate[:, None] * self._efficiency_vector(table)[None, :], 0.0)
+
+        table.senescence_damage[rows] = damage
+        table.senescence_stage[rows] = stage
+        table.recoverable[rows] = recoverable
+        table.daily_senescence_rate[rows] = total_daily_rate
+        table.senescence_types[rows] = types
+        table.remobilizable[rows] = np.maximum(0.0, available - remobilized)
+
+        # 10% of damaged area and biomass lost per day
+        senesced_area = float(np.dot(table.area[rows], damage)) * 0.1
+        senesced_biomass = float(np.dot(table.biomass[rows], damage)) * 0.1
+        total_remobilized = {
+            nutrient: float(amount)
+            for nutrient, amount, active in zip(table.nutrients, remobilized.sum(axis=0), remobilizing.any(axis=0))
+            if active
+        }
+
         # Store remobilized nutrients in pool
         for nutrient, amount in total_remobilized.items():
             self.remobilization_pool[nutrient] = self.remobilization_pool.get(nutrient, 0.0) + amount
-        
+
+        # Most advanced stage of any cohort
+        mask = int(np.bitwise_or.reduce(types)) if len(rows) else 0
         return SenescenceResponse(
-            cohort_responses=self.cohort_states.copy(),
-            total_senescence_rate=total_senescence,
+            cohort_table=table.copy(),
+            total_senescence_rate=float(total_daily_rate.sum()),
             remobilized_nutrients=total_remobilized,
-            senesced_area=total_senesced_area,
-            senesced_biomass=total_senesced_biomass,
-            active_senescence_types=list(set(active_senescence_types)),
-            average_senescence_stage=avg_stage
+            senesced_area=senesced_area,
+            senesced_biomass=senesced_biomass,
+            active_senescence_types=[t for t in SENESCENCE_TYPES if mask & _TYPE_BIT[t]],
+            average_senescence_stage=SENESCENCE_STAGES[int(stage.max()) if len(rows) else _HEALTHY]
         )
     
     def get_remobilization_pool(self) -> Dict[str, float]:
@@ -520,12 +596,11 @@ class AdvancedSenescenceModel:
         """
         return self.remobilization_pool.copy()
     
-def create_lettuce_senescence_model() -> AdvancedSenescenceModel:
+def create_lettuce_senescence_model(config: Optional['ConfigSnapshot'] = None) -> AdvancedSenescenceModel:
     """Create senescence model with lettuce-specific parameters."""
     try:
-        from ..utils.config_loader import get_config_loader
-        config_loader = get_config_loader()
-        senescence_config = config_loader.get_senescence_parameters()
+        from ..utils.config_loader import get_config_snapshot
+        senescence_config = (config or get_config_snapshot()).canopy.to_dict()
         parameters = SenescenceParameters.from_config(senescence_config)
         return AdvancedSenescenceModel(parameters)
     except ImportError:
@@ -0,0 +1,311 @@
+"""
+Compiled Integrated Stress Kernel
+The integrated multi-stress model as vector and matrix operations over a
+fixed stress axis, for one plant or a whole ensemble.
+
+IntegratedStressParameters is compiled once into vectors over the stress
+types (weights, onset/damage thresholds, memory, acclimation and recovery
+rates), a (processes, stresses) sensitivity matrix and (stresses, stresses)
+interaction factor matrices, one per combination rule. The daily update is
+then a handful of array expressions: the per-stress state update, the
+sensitivity product giving every process's individual stress effects, and
+one pairwise expression for the interactions between active stresses.
+
+Stress memory is a fixed (stresses, days) ring of levels per plant with an
+exponential age-weight row per stress, so chronic stress is a weighted
+contraction over the ring instead of a slice of a growing list. State arrays
+carry arbitrary leading (batch) axes: shape (stresses,) for a single plant,
+(members, stresses) for an ensemble.
+
+Key concepts implemented:
+1. Parameter vectors and interaction / sensitivity matrices built once per parameter set
+2. Fixed-size ring memory with per-stress exponential age weights (chronic stress)
+3. Acute stress, acclimation, recovery and damage accumulation as masked array updates
+4. Pairwise multiplicative, additive and threshold interactions of active stresses
+5. Batched daily updates of stress level matrices for ensembles
+
+Research basis:
+- Mittler (2006) - Abiotic stress, the field environment and stress combination
+- Niinemets (2010) - Responses of forest trees to single and multiple environmental stresses
+- Walter et al. (2011) - Ecological stress memory and cross stress tolerance in plants
+"""
+
+import logging
+from dataclasses import dataclass
+from typing import Dict, Hashable, List, Mapping, Sequence, Tuple
+
+import numpy as np
+
+logger = logging.getLogger(__name__)
+
+# Combination rules of StressInteraction types (anything else combines by max)
+SUMMED_INTERACTIONS = ('synergistic', 'additive')
+
+
+@dataclass
+class IntegratedStressMemory:
+    """
+    Stress state of one plant (batch shape ()) or of an ensemble (batch shape (members,)).
+
+    All per-stress arrays have shape batch + (stresses,); history is the
+    level ring of shape batch + (stresses, days), written at count % days.
+    """
+    current_level: np.ndarray
+    acute_stress: np.ndarray
+    chronic_stress: np.ndarray
+    acclimation_level: np.ndarray
+    recovery_progress: np.ndarray
+    damage_level: np.ndarray
+    days_under_stress: np.ndarray
+    history: np.ndarray
+    count: np.ndarray
+
+
+@dataclass
+class IntegratedStressEvaluation:
+    """Process responses of a memory state (leading batch axes as in the memory)."""
+    individual_effects: np.ndarray     # (..., processes, stresses)
+    interaction_effects: np.ndarray    # (..., processes, stresses, stresses), 0 for inactive pairs
+    combined_factors: np.ndarray       # (..., processes)
+    overall_stress_factor: np.ndarray  # (...)
+    impacts: np.ndarray                # (..., stresses) weighted acute stress impact
+
+
+class IntegratedStressKernel:
+    """
+    IntegratedStressParameters compiled to vectors and matrices over the stress types.
+
+    Stress and process axes follow the order of stress_weights and
+    process_sensitivity. Interactions are defined in the upper triangle of
+    the pair matrices: for i < j the stress_interactions[s_i][s_j] entry, as
+    in the pairwise loop of the scalar model. Kernels are immutable and
+    shared per parameter set (from_parameters).
+
+    Args:
+        parameters: IntegratedStressParameters to compile
+    """
+
+    def __init__(self, parameters):
+        p = parameters
+        self.stress_types: Tuple[str, ...] = tuple(p.stress_weights)
+        self.process_types: Tuple[str, ...] = tuple(p.process_sensitivity)
+        self.index = {name: i for i, name in enumerate(self.stress_types)}
+        n = len(self.stress_types)
+
+        def vector(table, default):
+            return np.array([(table or {}).get(name, default) for name in self.stress_types], dtype=float)
+
+        self.weights = vector(p.stress_weights, 0.1)
+        self.onset_thresholds = vector(p.stress_onset_thresholds, 0.8)
+        self.damage_thresholds = vector(p.damage_thresholds, 0.3)
+        self.memory_days = vector(p.stress_memory_duration, 5.0)
+        self.acclimation_rates = vector(p.acclimation_rates, 0.1)
+        self.recovery_rates = vector(p.recovery_rates, 0.2)
+
+        # Ring memory: per-stress capacity, exponential weight by age (0 = today)
+        capacity = np.maximum(1, self.memory_days.astype(int))
+        self.memory_capacity = int(capacity.max()) if n else 1
+        self.ages = np.arange(self.memory_capacity)
+        with np.errstate(divide='ignore', invalid='ignore'):
+            decay = np.exp(-self.ages[None, :] / (self.memory_days[:, None] / 3))
+        self.age_weights = np.where(self.ages[None, :] < capacity[:, None], decay, 0.0)
+
+        # (processes, stresses) sensitivity of each process to each stress
+        self.sensitivity = np.array(
+            [[p.process_sensitivity[proc].get(name, 0.5) for name in self.stress_types]
+             for proc in self.process_types], dtype=float).reshape(len(self.process_types), n)
+
+        # Pair factor matrices by combination rule (upper triangle)
+        self.multiplicative = np.zeros((n, n))
+        self.summed = np.zeros((n, n))
+        self.maximum = np.zeros((n, n))
+        self.defined = np.zeros((n, n), dtype=bool)
+        interactions = p.stress_interactions or {}
+        for i, s1 in enumerate(self.stress_types):
+            for j in range(i + 1, n):
+                interaction = interactions.get(s1, {}).get(self.stress_types[j])
+                if interaction is None:
+                    continue
+                rule = interaction["type"]
+                target = (self.multiplicative if rule == "multiplicative"
+                          else self.summed if rule in SUMMED_INTERACTIONS else self.maximum)
+                target[i, j] = interaction["factor"]
+                self.defined[i, j] = True
+        self.pair_names = {(i, j): f"{s1}_{self.stress_types[j]}"
+                           for i, s1 in enumerate(self.stress_types) for j in range(i + 1, n)
+                           if self.defined[i, j]}
+
+    @classmethod
+    def from_parameters(cls, parameters) -> 'IntegratedStressKernel':
+        """Shared kernel of an IntegratedStressParameters (compiled on first use)."""
+        key = _freeze(vars(parameters))
+        kernel = _kernels.get(key)
+        if kernel is None:
+            kernel = cls(parameters)
+            _kernels[key] = kernel
+            logger.debug("Compiled integrated stress kernel for %d stresses, %d processes",
+                         len(kernel.stress_types), len(kernel.process_types))
+        return kernel
+
+    # ------------------------------------------------------------------
+    # State
+    # ------------------------------------------------------------------
+
+    def initial_memory(self, batch: Tuple[int, ...] = ()) -> IntegratedStressMemory:
+        """Unstressed memory (level 1, empty history) for the given batch shape."""
+        if isinstance(batch, int):
+            batch = (batch,)
+        shape = tuple(batch) + (len(self.stress_types),)
+        return IntegratedStressMemory(
+            current_level=np.ones(shape),
+            acute_stress=np.zeros(shape),
+            chronic_stress=np.zeros(shape),
+            acclimation_level=np.zeros(shape),
+            recovery_progress=np.zeros(shape),
+            damage_level=np.zeros(shape),
+            days_under_stress=np.zeros(shape, dtype=int),
+            history=np.zeros(shape + (self.memory_capacity,)),
+            count=np.zeros(shape, dtype=int),
+        )
+
+    def levels_vector(self, levels: Mapping[str, float]) -> np.ndarray:
+        """(stresses,) level vector of a {stress: level} mapping; NaN for stresses not given."""
+        vector = np.full(len(self.stress_types), np.nan)
+        for name, level in levels.items():
+            i = self.index.get(name)
+            if i is not None:
+                vector[i] = level
+        return vector
+
+    def columns_of(self, names: Sequence[str]) -> Tuple[np.ndarray, np.ndarray]:
+        """Kernel stress indices of named level columns (and which of the columns are kernel stresses)."""
+        known = np.array([name in self.index for name in names], dtype=bool)
+        index = np.array([self.index[name] for name in names if name in self.index], dtype=int)
+        return index, known
+
+    def history_values(self, memory: IntegratedStressMemory, stress: int) -> np.ndarray:
+        """Remembered levels of one stress of a single-plant memory, oldest first."""
+        capacity = max(1, int(self.memory_days[stress]))
+        count = int(memory.count[stress])
+        ages = np.arange(min(count, capacity))[::-1]
+        return memory.history[stress, (count - 1 - ages) % self.memory_capacity]
+
+    # ------------------------------------------------------------------
+    # Daily update
+    # ------------------------------------------------------------------
+
+    def update(self, memory: IntegratedStressMemory, levels) -> IntegratedStressMemory:
+        """
+        Advance the memory by one day in place.
+
+        Args:
+            memory: State to update
+            levels: batch + (stresses,) stress levels (1 = unstressed); NaN
+                entries (stresses not reported, inactive members) are left unchanged
+
+        Returns:
+            The updated memory
+        """
+        levels = np.asarray(levels, dtype=float)
+        given = ~np.isnan(levels)
+        level = np.where(given, levels, memory.current_level)
+
+        # Level ring: write today's level at count % capacity
+        slot = (memory.count % self.memory_capacity)[..., None]
+        previous = np.take_along_axis(memory.history, slot, axis=-1)
+        np.put_along_axis(memory.history, slot, np.where(given[..., None], level[..., None], previous), axis=-1)
+        count = memory.count + given
+
+        onset = self.onset_thresholds
+        days = np.where(level < onset, memory.days_under_stress + 1, np.maximum(0, memory.days_under_stress - 1))
+
+        scaled = np.where(level < 0.5, (level / 0.5) ** 2, level)
+        acute = np.where(level >= onset, level, np.clip(scaled, 0.0, 1.0))
+
+        # Chronic stress: age-weighted mean of the remembered levels
+        age_index = (count[..., None] - 1 - self.ages) % self.memory_capacity
+        remembered = np.take_along_axis(memory.history, age_index, axis=-1)
+        weights = self.age_weights * (self.ages < count[..., None])
+        total = weights.sum(axis=-1)
+        with np.errstate(divide='ignore', invalid='ignore'):
+            weighted = np.where(total > 0, (weights * remembered).sum(axis=-1) / total, 1.0)
+        chronic = np.clip(np.where(days > self.memory_days, 1.0 - (1.0 - weighted) * 1.5, weighted), 0.1, 1.0)
+
+        potential = np.minimum(0.3, days * self.acclimation_rates)
+        acclimation = np.where(days < 3, 0.0, potential * np.maximum(0.2, 1.0 - (1.0 - level)))
+
+        daily = self.recovery_rates * np.where(chronic > 0.7, 1.0, np.where(chronic > 0.4, 0.7, 0.3))
+        recovery = np.where(level < 0.8, 0.0, np.minimum(1.0, memory.recovery_progress + daily))
+
+        threshold = self.damage_thresholds
+        damage = np.where(level < threshold,
+                          np.minimum(0.5, memory.damage_level + (threshold - level) / threshold * 0.01),
+                          memory.damage_level)
+
+        memory.current_level = level
+        memory.count = count
+        memory.days_under_stress = np.where(given, days, memory.days_under_stress)
+        memory.acute_stress = np.where(given, acute, memory.acute_stress)
+        memory.chronic_stress = np.where(given, chronic, memory.chronic_stress)
+        memory.acclimation_level = np.where(given, acclimation, memory.acclimation_level)
+        memory.recovery_progress = np.where(given, recovery, memory.recovery_progress)
+        memory.damage_level = np.where(given, damage, memory.damage_level)
+        return memory
+
+    def evaluate(self, memory: IntegratedStressMemory) -> IntegratedStressEvaluation:
+        """Individual, interaction and combined process stress factors of a memory state."""
+        acute, chronic = memory.acute_stress, memory.chronic_stress
+        combined = np.minimum(acute, chronic * 0.8 + acute * 0.2)
+        # (..., processes, stresses): 1 - (1 - combined) · sensitivity
+        individual = 1.0 - (1.0 - combined)[..., None, :] * self.sensitivity
+
+        # Pairwise interactions of stresses active (< 0.9) for a process
+        deficit = np.where(individual < 0.9, 1.0 - individual, np.nan)
+        first, second = deficit[..., :, None], deficit[..., None, :]
+        with np.errstate(invalid='ignore'):
+            pair = (np.minimum(1.0, first * second * self.multiplicative)
+                    + np.minimum(1.0, (first + second) * self.summed)
+                    + np.minimum(1.0, np.maximum(first, second) * self.maximum))
+        interactions = np.where(self.defined & ~np.isnan(pair), pair, 0.0)
+
+        if len(self.stress_types):
+            bonus = (memory.acclimation_level * 0.3).sum(axis=-1) * 0.1 + memory.recovery_progress.sum(axis=-1) * 0.05
+            penalty = memory.damage_level.sum(axis=-1) * 0.2
+            factors = (individual.min(axis=-1) - interactions.sum(axis=(-2, -1)) * 0.1
+                       + (bonus - penalty)[..., None])
+            factors = np.clip(factors, 0.1, 1.0)
+        else:
+            factors = np.ones(individual.shape[:-1])
+        overall = factors.mean(axis=-1) if len(self.process_types) else np.ones(factors.shape[:-1])
+        return IntegratedStressEvaluation(
+            individual_effects=individual,
+            interaction_effects=interactions,
+            combined_factors=factors,
+            overall_stress_factor=overall,
+            impacts=(1.0 - acute) * self.weights,
+        )
+
+    def active_pairs(self, evaluation: IntegratedStressEvaluation) -> List[str]:
+        """Names of the defined interactions between stresses active for any process (single plant)."""
+        active = evaluation.individual_effects < 0.9
+        pairs = (active[:, :, None] & active[:, None, :]).any(axis=0) & self.defined
+        return [name for (i, j), name in self.pair_names.items() if pairs[i, j]]
+
+    def __deepcopy__(self, memo):
+        return self
+
+    def __repr__(self) -> str:
+        return f"IntegratedStressKernel(stresses={self.stress_types}, processes={self.process_types})"
+
+
+def _freeze(value) -> Hashable:
+    """Hashable form of nested parameter dicts."""
+    if isinstance(value, Mapping):
+        return tuple((key, _freeze(item)) for key, item in value.items())
+    if isinstance(value, (list, tuple)):
+        return tuple(_freeze(item) for item in value)
+    return value
+
+
+# Kernels by parameter key, compiled on first use
+_kernels: Dict[Hashable, IntegratedStressKernel] = {}
@@ -5,6 +5,8 @@ Combines:
 - Temperature stress model (heat/cold/frost, acclimation, damage)
 - Integrated multi-stress model (water, temperature, nutrient, light, salinity, etc.)
 
+The integrated model runs on the compiled array kernel of stress_kernel.py.
+
 This consolidation replaces:
 - src/models/temperature_stress.py
 - src/models/integrated_stress.py
@@ -14,11 +16,15 @@ from __future__ import annotations
 
 from dataclasses import dataclass
 from enum import Enum
-from typing import Any, Dict, List, Optional, Tuple
+from typing import Any, Dict, List, Optional
 
 import math
 import numpy as np
 
+from ..utils.response_tables import DEFAULT_TABLE_RANGE, ResponseTable, TableRange, response_table
+from ..utils.ring_buffer import RingBuffer
+from .stress_kernel import IntegratedStressEvaluation, IntegratedStressKernel
+
 # =========================
 # Temperature Stress Model
 # =========================
@@ -102,11 +108,12 @@ class TemperatureStressParameters:
 class TemperatureAcclimation:
     heat_acclimation: float = 0.0
     cold_acclimation: float = 0.0
-    acclimation_history: List[float] = None
+    # Temperatures of the last max_acclimation_days days
+    acclimation_history: RingBuffer = None
 
     def __post_init__(self):
         if self.acclimation_history is None:
-            self.acclimation_history = []
+            self.acclimation_history = RingBuffer(TemperatureStressParameters.max_acclimation_days)
 
 
 @dataclass
@@ -141,11 +148,26 @@ class TemperatureStressResponse:
 class TemperatureStressModel:
     def __init__(self, params: TemperatureStressParameters):
         self.params = params
-        self.acclimation = TemperatureAcclimation()
+        self.acclimation = TemperatureAcclimation(
+            acclimation_history=RingBuffer(max(1, int(params.max_acclimation_days))))
         self.damage = TemperatureDamage()
-        self.stress_history: List[Tuple[float, float]] = []
+        # (stress level, temperature) of the last stress_memory_duration days
+        self.stress_history = RingBuffer(max(1, int(params.stress_memory_duration)), width=2)
         self.current_stress_duration = 0.0
         self.last_temperature: Optional[float] = None
+        # Base stress curve (None: exact formula)
+        self._base_stress_table: Optional[ResponseTable] = None
+
+    def use_response_tables(self, table_range: Optional[TableRange] = DEFAULT_TABLE_RANGE):
+        """Evaluate the base stress level from a shared table (None restores the exact formula)."""
+        if table_range is None:
+            self._base_stress_table = None
+            return
+        p = self.params
+        key = (p.optimal_temp_min, p.optimal_temp_max, p.heat_threshold_mild, p.heat_threshold_severe,
+               p.heat_lethal_temperature, p.cold_threshold_mild, p.cold_threshold_severe, p.frost_threshold)
+        self._base_stress_table = response_table('temperature_stress.base_level', key,
+                                                 self._base_stress_exact, table_range)
 
     def classify_temperature_stress(self, temperature: float) -> TemperatureStressType:
         if self.params.optimal_temp_min <= temperature <= self.params.optimal_temp_max:
@@ -158,6 +180,11 @@ class TemperatureStressModel:
             return TemperatureStressType.HEAT
 
     def calculate_base_stress_level(self, temperature: float) -> float:
+        if self._base_stress_table is not None:
+            return self._base_stress_table(temperature)
+        return self._base_stress_exact(temperature)
+
+    def _base_stress_exact(self, temperature: float) -> float:
         if self.params.optimal_temp_min <= temperature <= self.params.optimal_temp_max:
             return 0.0
         if temperature > self.params.optimal_temp_max:
@@ -191,9 +218,6 @@ class TemperatureStressModel:
 
     def update_acclimation(self, temperature: float, stress_type: TemperatureStressType):
         self.acclimation.acclimation_history.append(temperature)
-        max_history = self.params.max_acclimation_days
-        if len(self.acclimation.acclimation_history) > max_history:
-            self.acclimation.acclimation_history = self.acclimation.acclimation_history[-max_history:]
         if stress_type == TemperatureStressType.HEAT:
             target = min(
                 1.0,
@@ -226,18 +250,12 @@ class TemperatureStressModel:
         return base_stress
 
     def calculate_memory_effects(self) -> float:
-        if not self.stress_history:
-            return 0.0
-        recent = self.stress_history[-self.params.stress_memory_duration :]
-        if not recent:
+        if not len(self.stress_history):
             return 0.0
-        total_w = 0.0
-        weighted = 0.0
-        for i, (level, _) in enumerate(recent):
-            w = (i + 1) / len(recent)
-            weighted += level * w
-            total_w += w
-        return (weighted / total_w) * self.params.memory_effect_strength if total_w else 0.0
+        # Linearly increasing weights, most recent day heaviest
+        levels = self.stress_history.values()[:, 0]
+        weights = np.arange(1, len(levels) + 1) / len(levels)
+        return float(np.dot(levels, weights) / weights.sum()) * self.params.memory_effect_strength
 
     def calculate_process_stress_factors(self, stress_level: float, stress_type: TemperatureStressType) -> ProcessStressFactors:
         f = ProcessStressFactors()
@@ -300,8 +318,6 @@ class TemperatureStressModel:
 
         self.update_damage_and_recovery(final_stress, stress_type)
         self.stress_history.append((final_stress, temperature))
-        if len(self.stress_history) > self.params.stress_memory_duration:
-            self.stress_history = self.stress_history[-self.params.stress_memory_duration :]
 
         if stress_type == TemperatureStressType.HEAT:
             temp_dev = temperature - self.params.optimal_temp_max
@@ -545,11 +561,11 @@ class StressState:
     damage_level: float = 0.0
     recovery_progress: float = 0.0
     days_under_stress: int = 0
-    stress_history: List[float] = None
+    stress_history: RingBuffer = None
 
     def __post_init__(self):
         if self.stress_history is None:
-            self.stress_history = []
+            self.stress_history = RingBuffer(5)
 
 
 @dataclass
@@ -576,15 +592,64 @@ class IntegratedStressResponse:
     recovery_active: List[str]
 
 
+# Days of overall stress factors kept by IntegratedStressModel.stress_history
+STRESS_HISTORY_DAYS = 365
+
+
+def stress_severity(overall: float) -> str:
+    """Severity class of an overall stress factor (1 = unstressed)."""
+    if overall > 0.8:
+        return "mild"
+    elif overall > 0.6:
+        return "moderate"
+    elif overall > 0.3:
+        return "severe"
+    return "critical"
+
+
 class IntegratedStressModel:
+    """
+    Integrated multi-stress model of one plant on the compiled stress kernel.
+
+    The parameters are compiled once (IntegratedStressKernel); the per-stress
+    state lives in fixed-size arrays (self.memory) and the daily update is a
+    few vector and matrix operations. daily_update() returns the full
+    IntegratedStressResponse with per-process response objects;
+    daily_update_vectors() skips building them for callers that only need
+    the factors and state vectors (the simulation loop).
+    """
+
     def __init__(self, parameters: Optional[IntegratedStressParameters] = None):
         self.params = parameters or IntegratedStressParameters()
-        self.stress_states: Dict[str, StressState] = {}
-        self.stress_history: List[Dict[str, Any]] = []
-        self.cumulative_damage: Dict[str, float] = {}
-        for st in self.params.stress_weights.keys():
-            self.stress_states[st] = StressState(stress_type=st, current_level=1.0)
-            self.cumulative_damage[st] = 0.0
+        self.kernel = IntegratedStressKernel.from_parameters(self.params)
+        self.memory = self.kernel.initial_memory()
+        self.stress_history = RingBuffer(STRESS_HISTORY_DAYS)
+
+    @property
+    def stress_states(self) -> Dict[str, StressState]:
+        """Per-stress state objects built from the state vectors."""
+        m, kernel = self.memory, self.kernel
+        states: Dict[str, StressState] = {}
+        for i, st in enumerate(kernel.stress_types):
+            history = RingBuffer(max(1, int(kernel.memory_days[i])))
+            for level in kernel.history_values(m, i):
+                history.append(level)
+            states[st] = StressState(
+                stress_type=st,
+                current_level=float(m.current_level[i]),
+                acute_stress=float(m.acute_stress[i]),
+                chronic_stress=float(m.chronic_stress[i]),
+                acclimation_level=float(m.acclimation_level[i]),
+                damage_level=float(m.damage_level[i]),
+                recovery_progress=float(m.recovery_progress[i]),
+                days_under_stress=int(m.days_under_stress[i]),
+                stress_history=history,
+            )
+        return states
+
+    @property
+    def cumulative_damage(self) -> Dict[str, float]:
+        return dict(zip(self.kernel.stress_types, self.memory.damage_level.tolist()))
 
     def calculate_acute_stress(self, stress_type: str, current_level: float) -> float:
         """Calculate acute stress factor from current stress level.
@@ -612,181 +677,58 @@ class IntegratedStressModel:
         
         return max(0.0, min(1.0, stress_factor))
 
-    def calculate_chronic_stress(self, stress_state: StressState) -> float:
-        if not stress_state.stress_history:
-            return 1.0
-        st_type = stress_state.stress_type
-        memory_d = self.params.stress_memory_duration.get(st_type, 5.0)
-        recent = stress_state.stress_history[-int(memory_d) :]
-        if not recent:
-            return 1.0
-        weights = np.exp(-np.arange(len(recent)) / (memory_d / 3))[::-1]
-        weighted = np.average(recent, weights=weights)
-        if stress_state.days_under_stress > memory_d:
-            chronic_factor = 1.0 - (1.0 - weighted) * 1.5
-        else:
-            chronic_factor = weighted
-        return max(0.1, min(1.0, chronic_factor))
-
-    def calculate_acclimation_effect(self, stress_state: StressState) -> float:
-        if stress_state.days_under_stress < 3:
-            return 0.0
-        rate = self.params.acclimation_rates.get(stress_state.stress_type, 0.1)
-        max_acc = 0.3
-        potential = min(max_acc, stress_state.days_under_stress * rate)
-        severity = 1.0 - stress_state.current_level
-        eff = max(0.2, 1.0 - severity)
-        return potential * eff
-
-    def calculate_recovery_effect(self, stress_state: StressState) -> float:
-        if stress_state.current_level < 0.8:
-            return 0.0
-        rate = self.params.recovery_rates.get(stress_state.stress_type, 0.2)
-        if stress_state.chronic_stress > 0.7:
-            daily = rate
-        elif stress_state.chronic_stress > 0.4:
-            daily = rate * 0.7
-        else:
-            daily = rate * 0.3
-        return min(1.0, stress_state.recovery_progress + daily)
-
-    def calculate_stress_interactions(self, active_stresses: Dict[str, float]) -> Dict[str, float]:
-        effects: Dict[str, float] = {}
-        types = list(active_stresses.keys())
-        for i, s1 in enumerate(types):
-            for s2 in types[i + 1 :]:
-                if s1 in self.params.stress_interactions and s2 in self.params.stress_interactions[s1]:
-                    interaction = self.params.stress_interactions[s1][s2]
-                    t = interaction["type"]
-                    factor = interaction["factor"]
-                    l1 = 1.0 - active_stresses[s1]
-                    l2 = 1.0 - active_stresses[s2]
-                    if t == "multiplicative":
-                        combined = l1 * l2 * factor
-                    elif t in ("synergistic", "additive"):
-                        combined = (l1 + l2) * factor
-                    else:
-                        combined = max(l1, l2) * factor
-                    effects[f"{s1}_{s2}"] = min(1.0, combined)
-        return effects
-
-    def calculate_process_stress_response(self, process_type: str, stress_states: Dict[str, StressState]) -> StressResponse:
-        indiv: Dict[str, float] = {}
-        accl_benefits: Dict[str, float] = {}
-        recov: Dict[str, float] = {}
-        dmg: Dict[str, float] = {}
-        sensitivities = self.params.process_sensitivity.get(process_type, {})
-        active: Dict[str, float] = {}
-        for st, state in stress_states.items():
-            sensitivity = sensitivities.get(st, 0.5)
-            acute = state.acute_stress
-            chronic = state.chronic_stress
-            combined = min(acute, chronic * 0.8 + acute * 0.2)
-            proc_stress = 1.0 - ((1.0 - combined) * sensitivity)
-            indiv[st] = proc_stress
-            if proc_stress < 0.9:
-                active[st] = proc_stress
-            accl_benefits[st] = state.acclimation_level * 0.3
-            recov[st] = state.recovery_progress
-            dmg[st] = self.cumulative_damage.get(st, 0.0)
-        interactions = self.calculate_stress_interactions(active)
-        if not indiv:
-            combined_factor = 1.0
-        else:
-            base = min(indiv.values())
-            interaction_penalty = sum(interactions.values()) * 0.1
-            accl_bonus = sum(accl_benefits.values()) * 0.1
-            recov_bonus = sum(recov.values()) * 0.05
-            dmg_penalty = sum(dmg.values()) * 0.2
-            combined_factor = max(0.1, min(1.0, base - interaction_penalty + accl_bonus + recov_bonus - dmg_penalty))
-        limiting = [s for s, val in indiv.items() if val < 0.8]
-        limiting.sort(key=lambda x: indiv[x])
-        return StressResponse(
-            process_type=process_type,
-            individual_stress_effects=indiv,
-            combined_stress_factor=combined_factor,
-            interaction_effects=interactions,
-            acclimation_benefits=accl_benefits,
-            recovery_effects=recov,
-            damage_effects=dmg,
-            limiting_stress_types=limiting[:3],
-        )
-
     def update_stress_states(self, current_stress_levels: Dict[str, float]):
-        for st_type, level in current_stress_levels.items():
-            if st_type in self.stress_states:
-                state = self.stress_states[st_type]
-                state.current_level = level
-                state.stress_history.append(level)
-                memory = self.params.stress_memory_duration.get(st_type, 5.0)
-                if len(state.stress_history) > memory:
-                    state.stress_history = state.stress_history[-int(memory) :]
-                threshold = self.params.stress_onset_thresholds.get(st_type, 0.8)
-                if level < threshold:
-                    state.days_under_stress += 1
-                else:
-                    state.days_under_stress = max(0, state.days_under_stress - 1)
-                state.acute_stress = self.calculate_acute_stress(st_type, level)
-                state.chronic_stress = self.calculate_chronic_stress(state)
-                state.acclimation_level = self.calculate_acclimation_effect(state)
-                state.recovery_progress = self.calculate_recovery_effect(state)
-                damage_threshold = self.params.damage_thresholds.get(st_type, 0.3)
-                if level < damage_threshold:
-                    rate = (damage_threshold - level) / damage_threshold * 0.01
-                    self.cumulative_damage[st_type] += rate
-                    self.cumulative_damage[st_type] = min(0.5, self.cumulative_damage[st_type])
-                state.damage_level = self.cumulative_damage[st_type]
+        """Advance the state vectors by one day (stresses not in the parameters are ignored)."""
+        self.kernel.update(self.memory, self.kernel.levels_vector(current_stress_levels))
 
-    def daily_update(self, current_stress_levels: Dict[str, float]) -> IntegratedStressResponse:
+    def daily_update_vectors(self, current_stress_levels: Dict[str, float]) -> IntegratedStressEvaluation:
+        """Daily update returning the process factors as arrays (state vectors in self.memory)."""
         self.update_stress_states(current_stress_levels)
+        evaluation = self.kernel.evaluate(self.memory)
+        self.stress_history.append(evaluation.overall_stress_factor)
+        return evaluation
+
+    def daily_update(self, current_stress_levels: Dict[str, float]) -> IntegratedStressResponse:
+        evaluation = self.daily_update_vectors(current_stress_levels)
+        kernel, m = self.kernel, self.memory
+        names = kernel.stress_types
+        accl_benefits = dict(zip(names, (m.acclimation_level * 0.3).tolist()))
+        recov = dict(zip(names, m.recovery_progress.tolist()))
+        dmg = dict(zip(names, m.damage_level.tolist()))
         process_responses: Dict[str, StressResponse] = {}
-        for proc in self.params.process_sensitivity.keys():
-            process_responses[proc] = self.calculate_process_stress_response(proc, self.stress_states)
-        if process_responses:
-            overall = float(np.mean([r.combined_stress_factor for r in process_responses.values()]))
-        else:
-            overall = 1.0
-        if overall > 0.8:
-            severity = "mild"
-        elif overall > 0.6:
-            severity = "moderate"
-        elif overall > 0.3:
-            severity = "severe"
-        else:
-            severity = "critical"
-        impacts: Dict[str, float] = {}
-        for st, state in self.stress_states.items():
-            impacts[st] = (1.0 - state.acute_stress) * self.params.stress_weights.get(st, 0.1)
-        dominant = sorted(impacts.keys(), key=lambda x: impacts[x], reverse=True)[:3]
-        interactions_active: List[str] = []
-        for resp in process_responses.values():
-            interactions_active.extend(resp.interaction_effects.keys())
-        interactions_active = list(set(interactions_active))
-        accl_active = [st for st, s in self.stress_states.items() if s.acclimation_level > 0.1]
-        recov_active = [st for st, s in self.stress_states.items() if s.recovery_progress > 0.1]
-        self.stress_history.append(
-            {
-                "overall_stress_factor": overall,
-                "severity": severity,
-                "dominant_stresses": dominant,
-                "active_interactions": len(interactions_active),
-            }
-        )
+        for p, proc in enumerate(kernel.process_types):
+            effects = evaluation.individual_effects[p]
+            indiv = dict(zip(names, effects.tolist()))
+            active = effects < 0.9
+            interactions = {name: float(evaluation.interaction_effects[p, i, j])
+                            for (i, j), name in kernel.pair_names.items() if active[i] and active[j]}
+            limiting = [names[i] for i in np.argsort(effects, kind="stable") if effects[i] < 0.8]
+            process_responses[proc] = StressResponse(
+                process_type=proc,
+                individual_stress_effects=indiv,
+                combined_stress_factor=float(evaluation.combined_factors[p]),
+                interaction_effects=interactions,
+                acclimation_benefits=accl_benefits,
+                recovery_effects=recov,
+                damage_effects=dmg,
+                limiting_stress_types=limiting[:3],
+            )
+        overall = float(evaluation.overall_stress_factor)
+        dominant = [names[i] for i in np.argsort(-evaluation.impacts, kind="stable")[:3]]
         return IntegratedStressResponse(
-            stress_states=self.stress_states.copy(),
+            stress_states=self.stress_states,
             process_responses=process_responses,
             overall_stress_factor=overall,
-            stress_severity=severity,
+            stress_severity=stress_severity(overall),
             dominant_stresses=dominant,
-            stress_interactions_active=interactions_active,
-            acclimation_active=accl_active,
-            recovery_active=recov_active,
+            stress_interactions_active=kernel.active_pairs(evaluation),
+            acclimation_active=[st for st, level in zip(names, m.acclimation_level) if level > 0.1],
+            recovery_active=[st for st, level in zip(names, m.recovery_progress) if level > 0.1],
         )
 
     def get_stress_summary(self) -> Dict[str, Any]:
         current: Dict[str, Any] = {}
         accl_status: Dict[str, float] = {}
-        total_damage = 0.0
         for st, state in self.stress_states.items():
             current[st] = {
                 "current_level": state.current_level,
@@ -795,12 +737,12 @@ class IntegratedStressModel:
                 "days_under_stress": state.days_under_stress,
             }
             accl_status[st] = state.acclimation_level
-            total_damage += self.cumulative_damage.get(st, 0.0)
+        cumulative_damage = self.cumulative_damage
         return {
             "current_stresses": current,
             "acclimation_status": accl_status,
-            "cumulative_damage": self.cumulative_damage.copy(),
-            "total_damage": total_damage,
+            "cumulative_damage": cumulative_damage,
+            "total_damage": sum(cumulative_damage.values()),
             "stress_history_length": len(self.stress_history),
         }
 
@@ -0,0 +1,562 @@
+"""
+CROPGRO Global Sensitivity Analysis - Sobol and Morris Screening of Config Entries
+
+Ranks entries of cropgro_config.json by their influence on chosen season
+outputs (shoot fresh weight, total water consumption, days to harvest
+maturity). Every sample of the design is one set of config overrides
+("section.KEY" -> value); each sample is simulated for a set of base
+scenarios (cultivars, systems, weather seeds) and the outputs are averaged
+over them.
+
+Samples are evaluated in chunks, either through the parallel batch runner
+(one worker task per sample and scenario, with the overrides shipped in the
+ScenarioSpec) or through the ensemble engine (the base scenarios of one
+sample run in lock-step). Only the design and one row of outputs per sample
+are held in memory; after every chunk they are written to an .npz store,
+so an interrupted analysis resumes with the samples still missing.
+
+Key concepts implemented:
+1. Saltelli cross-sampling (A, B and the A_B^i matrices, N·(P+2) runs) from
+   a scrambled Sobol sequence
+2. Morris elementary-effect trajectories on a p-level grid
+3. Saltelli (2010) first-order and Jansen (1999) total-effect estimators
+   with bootstrap confidence intervals
+4. Morris μ, μ* and σ screening measures
+5. Chunked, resumable evaluation over per-sample config overrides
+
+Research basis:
+- Saltelli et al. (2010) Variance based sensitivity analysis of model output
+- Jansen (1999) Analysis of variance designs for model output
+- Morris (1991) Factorial sampling plans for preliminary computational experiments
+- Campolongo, Cariboni & Saltelli (2007) An effective screening design
+"""
+
+import os
+import json
+import time
+import hashlib
+import logging
+from dataclasses import dataclass, replace
+from pathlib import Path
+from statistics import NormalDist
+from typing import Any, Dict, List, Optional, Sequence, Tuple, Union, TYPE_CHECKING
+
+import numpy as np
+
+from .batch_runner import ScenarioSpec, build_scenario_input, run_batch
+from .utils.config_loader import config_overrides, get_config_snapshot
+
+if TYPE_CHECKING:
+    from .utils.config_loader import ConfigSnapshot
+
+logger = logging.getLogger(__name__)
+
+SENSITIVITY_OUTPUTS = ('fresh_weight_g', 'total_water_consumption_L', 'days_to_harvest')
+
+# Config entries the simulator reads directly, screened when none are configured
+DEFAULT_SENSITIVITY_PARAMETERS = (
+    'growth.LEAF_GROWTH_RATIO',
+    'canopy.SLA_YOUNG',
+    'water.LAI_WATER_DEMAND_FACTOR',
+    'phenology.BASE_TEMPERATURE',
+    'environment.OPTIMAL_TEMPERATURE',
+    'stress.HEAT_STRESS_THRESHOLD',
+)
+
+SHOOT_DRY_MATTER_FRACTION = 0.05  # g DW per g FW of lettuce shoots
+
+STORE_FORMAT = 1
+
+
+@dataclass(frozen=True)
+class SensitivityParameter:
+    """One config entry varied uniformly over [lower, upper]."""
+    path: str  # 'section.KEY' (or 'section.KEY.SUBKEY')
+    lower: float
+    upper: float
+
+    def __post_init__(self):
+        if not self.upper > self.lower:
+            raise ValueError(f"Sensitivity parameter {self.path}: upper bound must exceed lower bound")
+
+    @classmethod
+    def around(cls, path: str, config: Optional['ConfigSnapshot'] = None,
+               relative_range: float = 0.2,
+               bounds: Optional[Sequence[float]] = None) -> 'SensitivityParameter':
+        """Parameter with explicit bounds, or ±relative_range around its configured value."""
+        if bounds is not None:
+            return cls(path, float(bounds[0]), float(bounds[1]))
+        section, *keys = path.split('.')
+        value = (config or get_config_snapshot()).section(section)
+        for key in keys:
+            value = value[key]
+        spread = abs(float(value)) * relative_range
+        if spread == 0.0:
+            raise ValueError(f"Sensitivity parameter {path} is 0 in the config; give explicit bounds")
+        return cls(path, float(value) - spread, float(value) + spread)
+
+    def from_unit(self, u):
+        return self.lower + np.asarray(u, dtype=float) * (self.upper - self.lower)
+
+
+def _unit_sample(n: int, dimensions: int, seed: int) -> np.ndarray:
+    """(n, dimensions) points in the unit cube: scrambled Sobol if SciPy provides it."""
+    try:
+        from scipy.stats import qmc
+    except ImportError:
+        return np.random.default_rng(seed).random((n, dimensions))
+    return qmc.Sobol(dimensions, scramble=True, seed=seed).random(n)
+
+
+def saltelli_design(n_base: int, n_parameters: int, seed: int = 0) -> np.ndarray:
+    """
+    Saltelli cross-sampling design in the unit cube, (n_base·(P+2), P).
+
+    Rows come in groups of P+2 per base point: A, A_B^1 … A_B^P (A with
+    column i taken from B), B. Any prefix of whole groups is a valid
+    smaller design, which is what lets a partially evaluated design be
+    analyzed.
+    """
+    base = _unit_sample(n_base, 2 * n_parameters, seed)
+    a, b = base[:, :n_parameters], base[:, n_parameters:]
+    design = np.repeat(a[:, None, :], n_parameters + 2, axis=1)
+    design[:, -1] = b
+    columns = np.arange(n_parameters)
+    design[:, columns + 1, columns] = b
+    return design.reshape(-1, n_parameters)
+
+
+def morris_design(n_trajectories: int, n_parameters: int, levels: int = 4, seed: int = 0) -> np.ndarray:
+    """
+    Morris one-at-a-time trajectories on a `levels`-level grid, (r·(P+1), P).
+
+    Each trajectory starts at a random grid point and moves every parameter
+    once, in random order, by ±Δ with Δ = levels / (2·(levels − 1)).
+    """
+    rng = np.random.default_rng(seed)
+    delta = levels / (2.0 * (levels - 1))
+    starts = np.arange(levels // 2) / (levels - 1)  # grid points x with x + Δ ≤ 1
+
+    design = np.empty((n_trajectories, n_parameters + 1, n_parameters))
+    for t in range(n_trajectories):
+        signs = rng.choice((-1.0, 1.0), n_parameters)
+        point = rng.choice(starts, n_parameters) + np.where(signs < 0, delta, 0.0)
+        design[t, 0] = point
+        for k, j in enumerate(rng.permutation(n_parameters)):
+            point = point.copy()
+            point[j] += signs[j] * delta
+            design[t, k + 1] = point
+    return design.reshape(-1, n_parameters)
+
+
+@dataclass
+class SobolIndices:
+    """First-order and total Sobol indices of one output."""
+    parameters: Tuple[str, ...]
+    first_order: np.ndarray
+    total: np.ndarray
+    first_order_conf: np.ndarray  # Half-width of the bootstrap confidence interval
+    total_conf: np.ndarray
+    n_base: int                   # Base points the estimate uses
+    variance: float
+
+    def ranking(self) -> List[Tuple[str, float]]:
+        """Parameters by decreasing total index."""
+        order = np.argsort(-self.total)
+        return [(self.parameters[i], float(self.total[i])) for i in order]
+
+    def to_dict(self) -> Dict[str, Any]:
+        return {
+            name: {'S1': float(self.first_order[i]), 'S1_conf': float(self.first_order_conf[i]),
+                   'ST': float(self.total[i]), 'ST_conf': float(self.total_conf[i])}
+            for i, name in enumerate(self.parameters)
+        }
+
+
+@dataclass
+class MorrisIndices:
+    """Morris elementary-effect statistics of one output (unit-cube scale)."""
+    parameters: Tuple[str, ...]
+    mu: np.ndarray
+    mu_star: np.ndarray
+    sigma: np.ndarray
+    n_trajectories: int
+
+    def ranking(self) -> List[Tuple[str, float]]:
+        """Parameters by decreasing μ*."""
+        order = np.argsort(-self.mu_star)
+        return [(self.parameters[i], float(self.mu_star[i])) for i in order]
+
+    def to_dict(self) -> Dict[str, Any]:
+        return {
+            name: {'mu': float(self.mu[i]), 'mu_star': float(self.mu_star[i]), 'sigma': float(self.sigma[i])}
+            for i, name in enumerate(self.parameters)
+        }
+
+
+def sobol_indices(outputs: np.ndarray, parameters: Sequence[str], n_resamples: int = 100,
+                  confidence: float = 0.95, seed: int = 0) -> SobolIndices:
+    """
+    Sobol indices of one output evaluated on a saltelli_design.
+
+    S_i  = mean(f_B · (f_AB^i − f_A)) / V        (Saltelli et al. 2010)
+    ST_i = mean((f_A − f_AB^i)²) / (2·V)         (Jansen 1999)
+
+    Groups with a missing evaluation (NaN) are left out. Confidence
+    half-widths come from bootstrap resampling of the base points.
+    """
+    parameters = tuple(parameters)
+    d = len(parameters)
+    groups = np.asarray(outputs, dtype=float).reshape(-1, d + 2)
+    groups = groups[~np.isnan(groups).any(axis=1)]
+    n = len(groups)
+    zeros = np.zeros(d)
+    if n < 2:
+        return SobolIndices(parameters, zeros, zeros, zeros, zeros, n, 0.0)
+
+    def estimate(g):
+        # g: (..., n, P+2)
+        f_a, f_b, f_ab = g[..., :1], g[..., -1:], g[..., 1:-1]
+        variance = np.var(np.concatenate([f_a, f_b], axis=-2), axis=(-2, -1))[..., None]
+        with np.errstate(divide='ignore', invalid='ignore'):
+            first = np.mean(f_b * (f_ab - f_a), axis=-2) / variance
+            total = 0.5 * np.mean((f_a - f_ab) ** 2, axis=-2) / variance
+        return np.nan_to_num(first), np.nan_to_num(total), variance[..., 0]
+
+    first, total, variance = estimate(groups)
+    if variance == 0.0:
+        logger.warning("Output is constant over the evaluated samples; Sobol indices set to 0")
+    resamples = groups[np.random.default_rng(seed).integers(0, n, (n_resamples, n))]
+    boot_first, boot_total, _ = estimate(resamples)
+    z = NormalDist().inv_cdf(0.5 + confidence / 2.0)
+    return SobolIndices(parameters, first, total, z * boot_first.std(axis=0, ddof=1),
+                        z * boot_total.std(axis=0, ddof=1), n, float(variance))
+
+
+def morris_indices(design: np.ndarray, outputs: np.ndarray, parameters: Sequence[str]) -> MorrisIndices:
+    """μ, μ* and σ of the elementary effects of one output on a morris_design."""
+    parameters = tuple(parameters)
+    d = len(parameters)
+    x = np.asarray(design, dtype=float).reshape(-1, d + 1, d)
+    y = np.asarray(outputs, dtype=float).reshape(-1, d + 1)
+    complete = ~np.isnan(y).any(axis=1)
+    x, y = x[complete], y[complete]
+    r = len(y)
+    if r == 0:
+        zeros = np.zeros(d)
+        return MorrisIndices(parameters, zeros, zeros, zeros, 0)
+
+    steps = np.diff(x, axis=1)                          # (r, P, P): one moved parameter per step
+    moved = np.abs(steps).argmax(axis=2)                # (r, P)
+    step_size = np.take_along_axis(steps, moved[..., None], axis=2)[..., 0]
+    effects = np.empty((r, d))
+    np.put_along_axis(effects, moved, np.diff(y, axis=1) / step_size, axis=1)
+    sigma = effects.std(axis=0, ddof=1) if r > 1 else np.zeros(d)
+    return MorrisIndices(parameters, effects.mean(axis=0), np.abs(effects).mean(axis=0), sigma, r)
+
+
+def sample_outputs(summary_stats: Dict[str, Any], metadata: Dict[str, Any]) -> Tuple[Dict[str, float], bool]:
+    """
+    Sensitivity outputs of one run and whether it reached the target maturity.
+
+    days_to_harvest is the run length, so for runs stopped at max_days
+    before harvest maturity it is censored at max_days.
+    """
+    shoot = summary_stats.get('leaf_biomass_g', 0.0) + summary_stats.get('stem_biomass_g', 0.0)
+    values = {
+        'fresh_weight_g': shoot / SHOOT_DRY_MATTER_FRACTION,
+        'total_water_consumption_L': float(summary_stats.get('total_water_consumption_L', 0.0)),
+        'days_to_harvest': float(summary_stats.get('total_days', 0)),
+    }
+    return values, bool(metadata.get('maturity_reached', False))
+
+
+class SensitivityAnalysis:
+    """
+    Sobol or Morris analysis of config entries over a set of base scenarios.
+
+    Args:
+        parameters: Config entries to vary
+        scenarios: Base scenarios every sample is simulated for (outputs are
+            averaged over them)
+        method: 'sobol' (Saltelli design, n_samples base points) or 'morris'
+            (n_samples trajectories)
+        n_samples: Base points or trajectories
+        seed: Design seed
+        outputs: Output names (subset of SENSITIVITY_OUTPUTS)
+        morris_levels: Grid levels of the Morris design
+        store_path: .npz file holding the design and the evaluated outputs;
+            an existing store of the same analysis is resumed
+    """
+
+    def __init__(self, parameters: Sequence[SensitivityParameter],
+                 scenarios: Sequence[ScenarioSpec],
+                 method: str = 'sobol',
+                 n_samples: int = 64,
+                 seed: int = 0,
+                 outputs: Sequence[str] = SENSITIVITY_OUTPUTS,
+                 morris_levels: int = 4,
+                 store_path: Optional[Union[str, Path]] = None):
+        self.parameters = tuple(parameters)
+        self.scenarios = list(scenarios)
+        self.method = method.lower()
+        self.n_samples = n_samples
+        self.seed = seed
+        self.output_names = tuple(outputs)
+        self.morris_levels = morris_levels
+        self.store_path = Path(store_path) if store_path else None
+        if not self.parameters or not self.scenarios:
+            raise ValueError("Sensitivity analysis needs at least one parameter and one scenario")
+        unknown = set(self.output_names) - set(SENSITIVITY_OUTPUTS)
+        if unknown:
+            raise ValueError(f"Unknown sensitivity outputs: {sorted(unknown)}")
+
+        d = len(self.parameters)
+        if self.method == 'sobol':
+            self.design = saltelli_design(n_samples, d, seed)
+            self.group_size = d + 2
+        elif self.method == 'morris':
+            self.design = morris_design(n_samples, d, morris_levels, seed)
+            self.group_size = d + 1
+        else:
+            raise ValueError(f"Unknown sensitivity method {method!r} (use 'sobol' or 'morris')")
+
+        self.outputs = np.full((len(self.design), len(self.output_names)), np.nan)
+        self.maturity_fraction = np.full(len(self.design), np.nan)
+        self.fingerprint = self._fingerprint()
+        if self.store_path is not None and self.store_path.exists():
+            self._load()
+
+    # ------------------------------------------------------------------
+    # Design
+    # ------------------------------------------------------------------
+
+    @property
+    def parameter_names(self) -> Tuple[str, ...]:
+        return tuple(p.path for p in self.parameters)
+
+    @property
+    def n_runs(self) -> int:
+        return len(self.design)
+
+    @property
+    def completed(self) -> np.ndarray:
+        return ~np.isnan(self.outputs).any(axis=1)
+
+    @property
+    def n_pending(self) -> int:
+        return int((~self.completed).sum())
+
+    def values(self, rows=slice(None)) -> np.ndarray:
+        """Config values of design rows (rows, P)."""
+        unit = self.design[rows]
+        return np.stack([p.from_unit(unit[..., i]) for i, p in enumerate(self.parameters)], axis=-1)
+
+    def overrides(self, row: int) -> Tuple[Tuple[str, float], ...]:
+        """Config overrides of one design row."""
+        return tuple((p.path, float(value)) for p, value in zip(self.parameters, self.values(row)))
+
+    def _fingerprint(self) -> str:
+        spec = {
+            'format': STORE_FORMAT,
+            'method': self.method,
+            'n_samples': self.n_samples,
+            'seed': self.seed,
+            'levels': self.morris_levels if self.method == 'morris' else None,
+            'parameters': [(p.path, p.lower, p.upper) for p in self.parameters],
+            'outputs': self.output_names,
+            'scenarios': [(s.label, s.max_days, s.target_maturity, s.timestep) for s in self.scenarios],
+            'config': get_config_snapshot().source_hash,
+        }
+        return hashlib.sha256(json.dumps(spec, default=str).encode('utf-8')).hexdigest()
+
+    # ------------------------------------------------------------------
+    # Store
+    # ------------------------------------------------------------------
+
+    def _load(self):
+        with np.load(self.store_path, allow_pickle=False) as store:
+            if str(store['fingerprint']) != self.fingerprint:
+                raise ValueError(f"Sensitivity store {self.store_path} belongs to a different analysis "
+                                 f"(parameters, design, scenarios or config changed)")
+            self.outputs = store['outputs'].copy()
+            self.maturity_fraction = store['maturity_fraction'].copy()
+        logger.info(f"Resuming sensitivity analysis from {self.store_path}: "
+                    f"{self.n_runs - self.n_pending}/{self.n_runs} samples done")
+
+    def save(self):
+        """Write design and outputs to the store (atomically replaced)."""
+        if self.store_path is None:
+            return
+        self.store_path.parent.mkdir(parents=True, exist_ok=True)
+        tmp_path = self.store_path.with_name(self.store_path.name + '.tmp.npz')
+        np.savez(tmp_path, fingerprint=np.array(self.fingerprint), design=self.design,
+                 outputs=self.outputs, maturity_fraction=self.maturity_fraction,
+                 parameters=np.array(self.parameter_names), output_names=np.array(self.output_names))
+        os.replace(tmp_path, self.store_path)
+
+    # ------------------------------------------------------------------
+    # Evaluation
+    # ------------------------------------------------------------------
+
+    def evaluate(self, chunk_size: Optional[int] = None, backend: str = 'batch',
+                 max_workers: Optional[int] = None, config_path: Optional[str] = None,
+                 max_chunks: Optional[int] = None) -> 'SensitivityAnalysis':
+        """
+        Simulate the pending samples chunk by chunk, saving after every chunk.
+
+        Args:
+            chunk_size: Samples per chunk (default: 4 design groups per core);
+                bounds the scenarios in flight and in memory
+            backend: 'batch' (parallel batch runner) or 'ensemble' (the base
+                scenarios of a sample in one ensemble run)
+            max_workers: Batch runner worker processes
+            config_path: Configuration file the overrides apply to
+            max_chunks: Stop after this many chunks (resume later)
+        """
+        if backend not in ('batch', 'ensemble'):
+            raise ValueError(f"Unknown sensitivity backend {backend!r} (use 'batch' or 'ensemble')")
+        if backend == 'ensemble' and len({(s.max_days, s.target_maturity) for s in self.scenarios}) > 1:
+            raise ValueError("The ensemble backend needs scenarios with one max_days and target maturity")
+        if chunk_size is None:
+            chunk_size = 4 * self.group_size * max(1, max_workers or os.cpu_count() or 1)
+
+        pending = np.flatnonzero(~self.completed)
+        chunks = [pending[i:i + chunk_size] for i in range(0, len(pending), chunk_size)]
+        logger.info(f"Sensitivity analysis ({self.method}): {len(pending)}/{self.n_runs} samples pending, "
+                    f"{len(self.scenarios)} scenarios each, {len(chunks)} chunks ({backend})")
+        for c, rows in enumerate(chunks[:max_chunks]):
+            start = time.perf_counter()
+            if backend == 'batch':
+                self._evaluate_batch(rows, max_workers, config_path)
+            else:
+                self._evaluate_ensemble(rows, config_path)
+            self.save()
+            logger.info(f"Chunk {c + 1}/{len(chunks)}: {len(rows)} samples in "
+                        f"{time.perf_counter() - start:.1f} s, {self.n_pending} pending")
+        return self
+
+    def _record(self, rows: np.ndarray, values: np.ndarray, reached: np.ndarray):
+        """Store per-scenario outputs (rows, scenarios, outputs); samples with a failed run stay pending."""
+        self.outputs[rows] = values.mean(axis=1)
+        self.maturity_fraction[rows] = reached.mean(axis=1)
+
+    def _evaluate_batch(self, rows: np.ndarray, max_workers: Optional[int], config_path: Optional[str]):
+        n_scenarios = len(self.scenarios)
+        specs = [replace(base, config_overrides=self.overrides(row), label=f"{base.label}_sa{row}")
+                 for row in rows for base in self.scenarios]
+        values = np.full((len(rows), n_scenarios, len(self.output_names)), np.nan)
+        reached = np.zeros((len(rows), n_scenarios))
+        for result in run_batch(specs, max_workers=max_workers, config_path=config_path):
+            r, s = divmod(result.index, n_scenarios)
+            if not result.ok:
+                logger.warning(f"Sensitivity sample {rows[r]} failed for {self.scenarios[s].label}: {result.error}")
+                continue
+            outputs, reached[r, s] = sample_outputs(result.summary_stats, result.metadata)
+            values[r, s] = [outputs[name] for name in self.output_names]
+        self._record(rows, values, reached)
+
+    def _evaluate_ensemble(self, rows: np.ndarray, config_path: Optional[str]):
+        from .ensemble_engine import EnsembleMember, EnsembleSimulator
+        from .batch_runner import load_shared_tables
+
+        load_shared_tables(config_path)
+        first = self.scenarios[0]
+        values = np.full((len(rows), len(self.scenarios), len(self.output_names)), np.nan)
+        reached = np.zeros((len(rows), len(self.scenarios)))
+        for r, row in enumerate(rows):
+            try:
+                with config_overrides(self.overrides(row)):
+                    members = [EnsembleMember(build_scenario_input(s), s.cultivar_id, s.label) for s in self.scenarios]
+                    results = EnsembleSimulator().run(members, max_days=first.max_days,
+                                                      target_maturity=first.target_maturity)
+            except Exception as e:
+                logger.warning(f"Sensitivity sample {row} failed: {type(e).__name__}: {e}")
+                continue
+            for s, result in enumerate(results):
+                outputs, reached[r, s] = sample_outputs(result.summary_stats, result.metadata)
+                values[r, s] = [outputs[name] for name in self.output_names]
+        self._record(rows, values, reached)
+
+    # ------------------------------------------------------------------
+    # Analysis
+    # ------------------------------------------------------------------
+
+    def analyze(self, n_resamples: int = 100, confidence: float = 0.95) -> Dict[str, Union[SobolIndices, MorrisIndices]]:
+        """
+        Indices of every output from the samples evaluated so far.
+
+        Only complete design groups (Saltelli base points, Morris
+        trajectories) enter the estimates, so a partially evaluated design
+        already gives usable, if wider, estimates.
+        """
+        done = self.completed.reshape(-1, self.group_size).all(axis=1)
+        censored = np.nanmean(1.0 - self.maturity_fraction) if done.any() else 0.0
+        if 'days_to_harvest' in self.output_names and censored > 0:
+            logger.warning(f"{censored:.0%} of the evaluated runs stopped at max_days before harvest "
+                           f"maturity; days_to_harvest is censored for them")
+
+        indices = {}
+        for k, name in enumerate(self.output_names):
+            y = self.outputs[:, k]
+            if self.method == 'sobol':
+                indices[name] = sobol_indices(y, self.parameter_names, n_resamples, confidence, self.seed)
+            else:
+                indices[name] = morris_indices(self.design, y, self.parameter_names)
+        return indices
+
+
+def create_lettuce_sensitivity_analysis(scenarios: Sequence[ScenarioSpec],
+                                        config: Optional['ConfigSnapshot'] = None,
+                                        **options) -> SensitivityAnalysis:
+    """
+    Sensitivity analysis over base scenarios, configured from the JSON config
+    (environment.SENSITIVITY: PARAMETERS, BOUNDS, RELATIVE_RANGE, METHOD,
+    SAMPLES, SEED, OUTPUTS, MORRIS_LEVELS).
+    """
+    config = config or get_config_snapshot()
+    sensitivity_config = dict(config.environment.get('SENSITIVITY', {}))
+
+    if 'parameters' not in options:
+        bounds = sensitivity_config.get('BOUNDS', {})
+        relative_range = sensitivity_config.get('RELATIVE_RANGE', 0.2)
+        names = sensitivity_config.get('PARAMETERS', DEFAULT_SENSITIVITY_PARAMETERS)
+        options['parameters'] = [SensitivityParameter.around(name, config, relative_range, bounds.get(name))
+                                 for name in names]
+    options.setdefault('method', sensitivity_config.get('METHOD', 'sobol'))
+    options.setdefault('n_samples', sensitivity_config.get('SAMPLES', 64))
+    options.setdefault('seed', sensitivity_config.get('SEED', 0))
+    options.setdefault('outputs', tuple(sensitivity_config.get('OUTPUTS', SENSITIVITY_OUTPUTS)))
+    options.setdefault('morris_levels', sensitivity_config.get('MORRIS_LEVELS', 4))
+    return SensitivityAnalysis(scenarios=scenarios, **options)
+
+
+def demonstrate_sensitivity_analysis():
+    """Morris screening followed by Sobol indices of the same config entries."""
+    print("=" * 80)
+    print("GLOBAL SENSITIVITY ANALYSIS DEMONSTRATION")
+    print("=" * 80)
+
+    scenarios = [ScenarioSpec(max_days=40, weather_seed=seed) for seed in range(2)]
+    for method, n_samples in (('morris', 6), ('sobol', 16)):
+        analysis = create_lettuce_sensitivity_analysis(scenarios, method=method, n_samples=n_samples)
+        start = time.perf_counter()
+        analysis.evaluate()
+        print(f"\n{method.title()}: {analysis.n_runs} samples × {len(scenarios)} scenarios "
+              f"in {time.perf_counter() - start:.1f} s")
+        for output, result in analysis.analyze().items():
+            print(f"\n  {output}")
+            if isinstance(result, SobolIndices):
+                print(f"  {'Parameter':<34} {'S1':>8} {'±':>6} {'ST':>8} {'±':>6}")
+                for i in np.argsort(-result.total):
+                    print(f"  {result.parameters[i]:<34} {result.first_order[i]:>8.3f} "
+                          f"{result.first_order_conf[i]:>6.3f} {result.total[i]:>8.3f} {result.total_conf[i]:>6.3f}")
+            else:
+                print(f"  {'Parameter':<34} {'mu':>10} {'mu*':>10} {'sigma':>10}")
+                for i in np.argsort(-result.mu_star):
+                    print(f"  {result.parameters[i]:<34} {result.mu[i]:>10.3f} "
+                          f"{result.mu_star[i]:>10.3f} {result.sigma[i]:>10.3f}")
+
+
+if __name__ == "__main__":
+    demonstrate_sensitivity_analysis()
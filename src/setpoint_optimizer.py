@@ -0,0 +1,562 @@
+"""
+CROPGRO Setpoint Optimizer - Cheapest Climate Schedules for Maximum Yield
+
+Answers the reverse of EnvironmentalControlSystem's one-shot control
+question: which daily VPD, CO2 and root zone temperature (RZT) setpoints
+maximize the value of the harvested fresh weight of a cultivar net of the
+cost of holding them. Candidate schedules are run through the full
+simulator in parallel batches.
+
+Key concepts implemented:
+1. Schedules as phases of constant setpoints, quantized to the controller
+   resolution so that equal schedules are simulated only once
+2. Latin hypercube initial design over the setpoint bounds
+3. CMA-ES refinement started from the best design point
+4. Prefix reuse: every run is checkpointed at its phase boundaries, and a
+   later schedule that agrees with an earlier one up to a boundary resumes
+   from that checkpoint instead of re-simulating the shared days
+5. Cache of evaluated schedules across generations
+6. Setpoint cost model (CO2 enrichment, (de)humidification, solution
+   heating/chilling) driven by the scenario's weather
+
+Research basis:
+- McKay et al. (1979) Latin hypercube sampling for computer experiments
+- Hansen (2016) The CMA Evolution Strategy: A Tutorial
+- Van Straten et al. (2011) Optimal Control of Greenhouse Cultivation
+"""
+
+import os
+import math
+import time
+import logging
+import multiprocessing
+from collections import OrderedDict
+from concurrent.futures import ProcessPoolExecutor
+from dataclasses import dataclass, field
+from typing import Any, Dict, List, Optional, Sequence, Tuple, TYPE_CHECKING
+
+import numpy as np
+
+from .batch_runner import ScenarioSpec, build_scenario_input, load_shared_tables, scenario_simulator, _initialize_worker
+from .data.checkpoint import SimulationCheckpoint
+from .data.weather_series import as_weather_series
+from .models.environmental_control import EnvironmentalControlSystem, SetpointSchedule
+
+if TYPE_CHECKING:
+    from .utils.config_loader import ConfigSnapshot
+
+logger = logging.getLogger(__name__)
+
+SETPOINT_NAMES = ('vpd', 'co2', 'rzt')
+
+
+@dataclass
+class SetpointBounds:
+    """Search range and controller resolution of each setpoint."""
+    vpd: Tuple[float, float] = (0.5, 1.3)        # kPa
+    co2: Tuple[float, float] = (400.0, 1500.0)   # μmol/mol
+    rzt: Tuple[float, float] = (16.0, 28.0)      # °C
+    vpd_step: float = 0.05
+    co2_step: float = 50.0
+    rzt_step: float = 0.5
+
+    def __post_init__(self):
+        for name in SETPOINT_NAMES:
+            low, high = getattr(self, name)
+            if not low < high or getattr(self, f"{name}_step") <= 0:
+                raise ValueError(f"Invalid {name} setpoint bounds {low}-{high}")
+
+    @classmethod
+    def from_config(cls, config_dict: dict) -> 'SetpointBounds':
+        """Create SetpointBounds from configuration dictionary."""
+        return cls(
+            vpd=tuple(config_dict.get('vpd', (0.5, 1.3))),
+            co2=tuple(config_dict.get('co2', (400.0, 1500.0))),
+            rzt=tuple(config_dict.get('rzt', (16.0, 28.0))),
+            vpd_step=config_dict.get('vpd_step', 0.05),
+            co2_step=config_dict.get('co2_step', 50.0),
+            rzt_step=config_dict.get('rzt_step', 0.5)
+        )
+
+    def quantize(self, name: str, unit: np.ndarray) -> Tuple[float, ...]:
+        """Setpoints at positions `unit` (0-1) of a range, rounded to the controller step."""
+        low, high = getattr(self, name)
+        step = getattr(self, f"{name}_step")
+        values = low + np.round(np.clip(unit, 0.0, 1.0) * (high - low) / step) * step
+        return tuple(round(float(v), 6) for v in np.minimum(values, high))
+
+    def to_unit(self, name: str, values: Sequence[float]) -> np.ndarray:
+        low, high = getattr(self, name)
+        return (np.asarray(values, dtype=float) - low) / (high - low)
+
+
+@dataclass
+class SetpointCostModel:
+    """Harvest value and the daily cost of holding the setpoints."""
+    fresh_weight_price: float = 8.0            # $/kg fresh weight
+    shoot_dry_matter_fraction: float = 0.05    # g DW per g FW of lettuce shoots
+    electricity_cost: float = 0.12             # $/kWh
+    co2_price: float = 0.25                    # $/kg CO2
+    ambient_co2: float = 400.0                 # μmol/mol outside air
+    room_height: float = 3.0                   # m (air volume = system area × height)
+    air_exchange_rate: float = 0.5             # air changes per hour
+    latent_heat: float = 0.68                  # kWh per kg of water added or removed
+    humidity_equipment_efficiency: float = 0.85
+    solution_heat_loss: float = 5.0            # W/K per 1000 L of solution
+    heat_pump_cop: float = 3.0                 # Solution chiller/heater
+
+    @classmethod
+    def from_config(cls, config_dict: dict) -> 'SetpointCostModel':
+        """Create SetpointCostModel from configuration dictionary."""
+        return cls(**{name: config_dict[name] for name in cls.__dataclass_fields__ if name in config_dict})
+
+    def fresh_weight_g(self, shoot_dry_mass_g: float) -> float:
+        return shoot_dry_mass_g / self.shoot_dry_matter_fraction
+
+    def daily_costs(self, schedule: SetpointSchedule, weather, days: int,
+                    controller: EnvironmentalControlSystem, system_area: float,
+                    tank_volume: float) -> Dict[str, np.ndarray]:
+        """
+        Cost ($) of each setpoint on days 1..days.
+
+        CO2 replaces the enrichment lost by air exchange during the
+        photoperiod; (de)humidification moves the water needed to hold the
+        humidity of the VPD target against the outside air; the solution
+        heat pump covers the losses between the RZT target and the passive
+        solution temperature (air temperature plus solar gain).
+        """
+        weather = as_weather_series(weather)
+        index = np.arange(days) % len(weather)
+        temperature = weather.temp_avg[index]
+        humidity = weather.rel_humidity[index]
+        solar = weather.solar_radiation[index]
+        target_vpd, target_co2, target_rzt = schedule.daily_arrays(days)
+
+        air_volume = system_area * self.room_height                          # m³
+        exchanged_air = air_volume * self.air_exchange_rate                  # m³/h
+
+        co2_excess = np.maximum(0.0, target_co2 - self.ambient_co2) * 1e-6   # m³ CO2 / m³ air
+        co2_kg = co2_excess * exchanged_air * controller.setpoints.light_hours * 1.83
+        co2_cost = co2_kg * self.co2_price
+
+        held_humidity = np.array([controller.calculate_controlled_humidity(t, v)
+                                  for t, v in zip(temperature.tolist(), target_vpd.tolist())])
+        saturation = 0.6108 * np.exp(17.27 * temperature / (temperature + 237.3))   # kPa
+        vapour_density = saturation * 1000.0 / (461.5 * (temperature + 273.15))     # kg/m³ at 100 % RH
+        water_kg = np.abs(held_humidity - humidity) / 100.0 * vapour_density * exchanged_air * 24.0
+        humidity_cost = (water_kg * self.latent_heat / self.humidity_equipment_efficiency
+                         * self.electricity_cost)
+
+        passive_rzt = temperature + 0.15 * solar
+        heat_kwh = (self.solution_heat_loss * tank_volume / 1000.0 * np.abs(target_rzt - passive_rzt)
+                    * 24.0 / 1000.0)
+        rzt_cost = heat_kwh / self.heat_pump_cop * self.electricity_cost
+
+        return {'co2': co2_cost, 'humidity': humidity_cost, 'rzt': rzt_cost}
+
+
+@dataclass
+class ScheduleEvaluation:
+    """Simulated outcome of one setpoint schedule."""
+    schedule: SetpointSchedule
+    score: float = -math.inf            # $ harvest value minus setpoint cost
+    fresh_weight_g: float = 0.0         # Shoot fresh weight per plant
+    harvest_value: float = 0.0          # $ for all plants
+    setpoint_cost: float = 0.0          # $ over the run
+    cost_breakdown: Dict[str, float] = field(default_factory=dict)
+    days: int = 0
+    resumed_from_day: int = 0           # Day of the checkpoint the run resumed from (0: full run)
+    elapsed_seconds: float = 0.0
+    error: Optional[str] = None
+
+    @property
+    def ok(self) -> bool:
+        return self.error is None
+
+
+@dataclass
+class SetpointOptimizationResult:
+    """Best schedule and search statistics."""
+    best: ScheduleEvaluation
+    evaluations: List[ScheduleEvaluation]    # Every distinct schedule, best first
+    history: List[float]                     # Best score after the design and after each generation
+    simulations: int = 0
+    cache_hits: int = 0
+    resumed_runs: int = 0
+    simulated_days: int = 0
+    elapsed_seconds: float = 0.0
+
+
+class CMAES:
+    """
+    (μ/μ_w, λ)-CMA-ES minimizing over the unit cube (Hansen 2016).
+
+    Samples are clipped to the cube; the update uses the clipped points so
+    the search distribution follows what was actually evaluated.
+    """
+
+    def __init__(self, mean: np.ndarray, sigma: float, population: int, rng: np.random.Generator):
+        n = len(mean)
+        self.n = n
+        self.mean = np.array(mean, dtype=float)
+        self.sigma = sigma
+        self.population = population
+        self.rng = rng
+
+        self.mu = population // 2
+        weights = math.log(self.mu + 0.5) - np.log(np.arange(1, self.mu + 1))
+        self.weights = weights / weights.sum()
+        self.mueff = 1.0 / np.sum(self.weights ** 2)
+
+        self.cc = (4 + self.mueff / n) / (n + 4 + 2 * self.mueff / n)
+        self.cs = (self.mueff + 2) / (n + self.mueff + 5)
+        self.c1 = 2 / ((n + 1.3) ** 2 + self.mueff)
+        self.cmu = min(1 - self.c1, 2 * (self.mueff - 2 + 1 / self.mueff) / ((n + 2) ** 2 + self.mueff))
+        self.damps = 1 + 2 * max(0.0, math.sqrt((self.mueff - 1) / (n + 1)) - 1) + self.cs
+        self.chi_n = math.sqrt(n) * (1 - 1 / (4 * n) + 1 / (21 * n ** 2))
+
+        self.pc = np.zeros(n)
+        self.ps = np.zeros(n)
+        self.C = np.eye(n)
+        self.B = np.eye(n)
+        self.D = np.ones(n)
+        self.generation = 0
+
+    def ask(self) -> np.ndarray:
+        """One generation of candidates, shape (population, n)."""
+        z = self.rng.standard_normal((self.population, self.n))
+        return np.clip(self.mean + self.sigma * (z * self.D) @ self.B.T, 0.0, 1.0)
+
+    def tell(self, candidates: np.ndarray, losses: np.ndarray):
+        """Update the distribution from the losses of ask()'s candidates (lower is better)."""
+        n = self.n
+        selected = candidates[np.argsort(losses, kind='stable')[:self.mu]]
+        y = (selected - self.mean) / self.sigma
+        y_w = self.weights @ y
+        self.mean = self.mean + self.sigma * y_w
+
+        c_inv_sqrt = self.B @ np.diag(1.0 / self.D) @ self.B.T
+        self.ps = (1 - self.cs) * self.ps + math.sqrt(self.cs * (2 - self.cs) * self.mueff) * (c_inv_sqrt @ y_w)
+        ps_norm = np.linalg.norm(self.ps)
+        h_sigma = (ps_norm / math.sqrt(1 - (1 - self.cs) ** (2 * (self.generation + 1))) / self.chi_n
+                   < 1.4 + 2 / (n + 1))
+        self.pc = (1 - self.cc) * self.pc + h_sigma * math.sqrt(self.cc * (2 - self.cc) * self.mueff) * y_w
+
+        rank_one = np.outer(self.pc, self.pc) + (1 - h_sigma) * self.cc * (2 - self.cc) * self.C
+        rank_mu = (y.T * self.weights) @ y
+        self.C = (1 - self.c1 - self.cmu) * self.C + self.c1 * rank_one + self.cmu * rank_mu
+        self.sigma *= math.exp((self.cs / self.damps) * (ps_norm / self.chi_n - 1))
+
+        self.C = np.triu(self.C) + np.triu(self.C, 1).T
+        eigenvalues, self.B = np.linalg.eigh(self.C)
+        self.D = np.sqrt(np.maximum(eigenvalues, 1e-20))
+        self.generation += 1
+
+
+def default_phase_starts(days: int, n_phases: int = 3) -> Tuple[int, ...]:
+    """First days of n equal setpoint phases of a season."""
+    n_phases = max(1, min(n_phases, days))
+    return tuple(1 + (i * days) // n_phases for i in range(n_phases))
+
+
+def _simulate_schedule(scenario: ScenarioSpec, schedule: SetpointSchedule,
+                       resume_from: Optional[SimulationCheckpoint],
+                       checkpoint_days: Sequence[int]) -> Tuple[Dict[str, Any], Dict[int, SimulationCheckpoint],
+                                                                float, Optional[str]]:
+    """Worker entry point: run one schedule, checkpointing at its phase boundaries."""
+    start = time.perf_counter()
+    try:
+        simulator = scenario_simulator(scenario)
+        results = simulator.run_simulation(
+            build_scenario_input(scenario),
+            max_days=scenario.max_days,
+            target_maturity=scenario.target_maturity,
+            timestep=scenario.timestep,
+            resume_from=resume_from,
+            checkpoint_days=checkpoint_days,
+            setpoint_schedule=schedule
+        )
+        return results.summary_stats, results.checkpoints, time.perf_counter() - start, None
+    except Exception as e:
+        logger.error(f"Setpoint schedule {schedule} failed: {e}")
+        return {}, {}, time.perf_counter() - start, f"{type(e).__name__}: {e}"
+
+
+class SetpointOptimizer:
+    """
+    Batched, parallel search for the most profitable setpoint schedule of a scenario.
+
+    Args:
+        scenario: Cultivar, system, weather and season length to optimize for
+        phase_starts: First day of each setpoint phase (default: three equal phases)
+        bounds: Search ranges and controller resolution of the setpoints
+        cost_model: Harvest value and setpoint costs
+        max_workers: Worker processes (default: number of cores; 1 runs in-process)
+        checkpoint_cache_size: Phase-boundary checkpoints kept for prefix reuse
+        seed: Seed of the design and CMA-ES sampling
+    """
+
+    def __init__(self, scenario: Optional[ScenarioSpec] = None,
+                 phase_starts: Optional[Sequence[int]] = None,
+                 bounds: Optional[SetpointBounds] = None,
+                 cost_model: Optional[SetpointCostModel] = None,
+                 max_workers: Optional[int] = None,
+                 checkpoint_cache_size: int = 64,
+                 seed: int = 0,
+                 worker_log_level: int = logging.WARNING):
+        self.scenario = scenario or ScenarioSpec(max_days=60)
+        self.phase_starts = tuple(phase_starts) if phase_starts else default_phase_starts(self.scenario.max_days)
+        self.bounds = bounds or SetpointBounds()
+        self.cost_model = cost_model or SetpointCostModel()
+        self.max_workers = max(1, max_workers or os.cpu_count() or 1)
+        self.checkpoint_cache_size = checkpoint_cache_size
+        self.worker_log_level = worker_log_level
+        self.rng = np.random.default_rng(seed)
+
+        # Evaluated schedules, and phase-boundary checkpoints by schedule prefix
+        self.evaluations: Dict[SetpointSchedule, ScheduleEvaluation] = {}
+        self._checkpoints: 'OrderedDict[Tuple, SimulationCheckpoint]' = OrderedDict()
+        self.stats = {'simulations': 0, 'cache_hits': 0, 'resumed_runs': 0, 'simulated_days': 0}
+
+        # Weather and system the costs are computed for
+        self._input = build_scenario_input(self.scenario)
+        self._controller = EnvironmentalControlSystem()
+        self._executor: Optional[ProcessPoolExecutor] = None
+
+    @property
+    def n_phases(self) -> int:
+        return len(self.phase_starts)
+
+    @property
+    def dimension(self) -> int:
+        return len(SETPOINT_NAMES) * self.n_phases
+
+    # -------------------------
+    # Search space
+    # -------------------------
+
+    def schedule_from_unit(self, unit: np.ndarray) -> SetpointSchedule:
+        """Schedule at a point of the unit cube (VPD, CO2 and RZT of every phase)."""
+        rows = np.asarray(unit, dtype=float).reshape(len(SETPOINT_NAMES), self.n_phases)
+        vpd, co2, rzt = (self.bounds.quantize(name, row) for name, row in zip(SETPOINT_NAMES, rows))
+        return SetpointSchedule(self.phase_starts, target_vpd=vpd, target_co2=co2, target_rzt=rzt)
+
+    def unit_from_schedule(self, schedule: SetpointSchedule) -> np.ndarray:
+        return np.concatenate([self.bounds.to_unit(name, values) for name, values in
+                               zip(SETPOINT_NAMES, (schedule.target_vpd, schedule.target_co2,
+                                                    schedule.target_rzt))])
+
+    def latin_hypercube(self, n_samples: int) -> np.ndarray:
+        """n points in the unit cube with one point in every 1/n slice of each axis."""
+        strata = np.argsort(self.rng.random((self.dimension, n_samples)), axis=1).T
+        return (strata + self.rng.random((n_samples, self.dimension))) / n_samples
+
+    # -------------------------
+    # Evaluation
+    # -------------------------
+
+    def evaluate(self, schedules: Sequence[SetpointSchedule]) -> List[ScheduleEvaluation]:
+        """
+        Evaluations of the schedules (cached ones are not simulated again).
+
+        Uncached schedules run in parallel. Those that share a first phase not
+        yet checkpointed are split into two waves: one of them runs first and
+        the others resume from its phase-boundary checkpoint.
+        """
+        pending = [schedule for schedule in dict.fromkeys(schedules) if schedule not in self.evaluations]
+        self.stats['cache_hits'] += len(schedules) - len(pending)
+
+        leaders, followers = [], []
+        first_phases = set()
+        for schedule in pending:
+            if self.n_phases > 1 and self._resume_point(schedule, touch=False)[0] is None:
+                key = schedule.prefix(1)
+                if key in first_phases:
+                    followers.append(schedule)
+                    continue
+                first_phases.add(key)
+            leaders.append(schedule)
+        for wave in (leaders, followers):
+            if wave:
+                self._run_wave(wave)
+        return [self.evaluations[schedule] for schedule in schedules]
+
+    def _resume_point(self, schedule: SetpointSchedule, touch: bool = True) -> Tuple[Optional[SimulationCheckpoint], int]:
+        """Latest cached checkpoint on the schedule's path and the phase it resumes into."""
+        for phase in range(self.n_phases - 1, 0, -1):
+            key = schedule.prefix(phase)
+            checkpoint = self._checkpoints.get(key)
+            if checkpoint is not None:
+                if touch:
+                    self._checkpoints.move_to_end(key)
+                return checkpoint, phase
+        return None, 0
+
+    def _store_checkpoint(self, key: Tuple, checkpoint: SimulationCheckpoint):
+        self._checkpoints[key] = checkpoint
+        self._checkpoints.move_to_end(key)
+        while len(self._checkpoints) > self.checkpoint_cache_size:
+            self._checkpoints.popitem(last=False)
+
+    def _run_wave(self, schedules: List[SetpointSchedule]):
+        tasks = []
+        for schedule in schedules:
+            checkpoint, phase = self._resume_point(schedule)
+            boundaries = [start - 1 for start in schedule.phase_starts[phase + 1:]]
+            tasks.append((schedule, checkpoint, boundaries))
+
+        for (schedule, checkpoint, _), outcome in zip(tasks, self._map(tasks)):
+            summary, checkpoints, elapsed, error = outcome
+            start_day = checkpoint.day if checkpoint is not None else 0
+            self.stats['simulations'] += 1
+            self.stats['resumed_runs'] += checkpoint is not None
+            for day, boundary_checkpoint in checkpoints.items():
+                self._store_checkpoint(schedule.prefix(schedule.phase_of(day + 1)), boundary_checkpoint)
+            evaluation = self._score(schedule, summary, error)
+            evaluation.resumed_from_day = start_day
+            evaluation.elapsed_seconds = elapsed
+            self.stats['simulated_days'] += max(0, evaluation.days - start_day)
+            self.evaluations[schedule] = evaluation
+
+    def _map(self, tasks) -> List[Tuple]:
+        if self.max_workers == 1 or len(tasks) == 1 and self._executor is None:
+            load_shared_tables()
+            return [_simulate_schedule(self.scenario, *task) for task in tasks]
+        executor = self._pool()
+        futures = [executor.submit(_simulate_schedule, self.scenario, *task) for task in tasks]
+        return [future.result() for future in futures]
+
+    def _pool(self) -> ProcessPoolExecutor:
+        if self._executor is None:
+            # Load once in the parent so forked workers inherit the built tables
+            load_shared_tables()
+            methods = multiprocessing.get_all_start_methods()
+            context = multiprocessing.get_context('fork' if 'fork' in methods else None)
+            self._executor = ProcessPoolExecutor(max_workers=self.max_workers, mp_context=context,
+                                                 initializer=_initialize_worker,
+                                                 initargs=(None, self.worker_log_level))
+        return self._executor
+
+    def close(self):
+        """Shut the worker pool down (it is restarted on the next evaluation)."""
+        if self._executor is not None:
+            self._executor.shutdown()
+            self._executor = None
+
+    def _score(self, schedule: SetpointSchedule, summary: Dict[str, Any],
+               error: Optional[str]) -> ScheduleEvaluation:
+        if error is not None:
+            return ScheduleEvaluation(schedule=schedule, error=error)
+        days = int(summary.get('total_days', 0))
+        system = self._input.system_config
+        costs = self.cost_model.daily_costs(schedule, self._input.weather_data, days, self._controller,
+                                            system.system_area, system.tank_volume)
+        breakdown = {name: float(cost.sum()) for name, cost in costs.items()}
+        fresh_weight = self.cost_model.fresh_weight_g(summary.get('leaf_biomass_g', 0.0) +
+                                                      summary.get('stem_biomass_g', 0.0))
+        harvest_value = fresh_weight / 1000.0 * system.n_plants * self.cost_model.fresh_weight_price
+        setpoint_cost = sum(breakdown.values())
+        return ScheduleEvaluation(
+            schedule=schedule,
+            score=harvest_value - setpoint_cost,
+            fresh_weight_g=fresh_weight,
+            harvest_value=harvest_value,
+            setpoint_cost=setpoint_cost,
+            cost_breakdown=breakdown,
+            days=days
+        )
+
+    # -------------------------
+    # Search
+    # -------------------------
+
+    def best(self) -> Optional[ScheduleEvaluation]:
+        evaluations = [e for e in self.evaluations.values() if e.ok]
+        return max(evaluations, key=lambda e: e.score) if evaluations else None
+
+    def optimize(self, n_initial: Optional[int] = None, generations: int = 8,
+                 population: Optional[int] = None, sigma: float = 0.25) -> SetpointOptimizationResult:
+        """
+        Latin hypercube design followed by CMA-ES generations.
+
+        Args:
+            n_initial: Design size (default: twice the number of setpoints, at least 8)
+            generations: CMA-ES generations after the design
+            population: Candidates per generation (default: 4 + 3 ln(dimension))
+            sigma: Initial CMA-ES step size, as a fraction of each setpoint range
+        """
+        start = time.perf_counter()
+        n_initial = n_initial or max(8, 2 * self.dimension)
+        population = population or 4 + int(3 * math.log(self.dimension))
+        try:
+            design = self.latin_hypercube(n_initial)
+            self.evaluate([self.schedule_from_unit(point) for point in design])
+            history = [self._best_score()]
+            logger.info(f"Design of {n_initial} schedules: best score {history[-1]:.3f}")
+
+            best = self.best()
+            mean = self.unit_from_schedule(best.schedule) if best is not None else np.full(self.dimension, 0.5)
+            strategy = CMAES(mean, sigma, population, self.rng)
+            for generation in range(generations):
+                candidates = strategy.ask()
+                evaluations = self.evaluate([self.schedule_from_unit(point) for point in candidates])
+                losses = np.array([-e.score if e.ok else math.inf for e in evaluations])
+                strategy.tell(candidates, losses)
+                history.append(self._best_score())
+                logger.info(f"Generation {generation + 1}: best score {history[-1]:.3f}, "
+                            f"step size {strategy.sigma:.3f}")
+        finally:
+            self.close()
+
+        ranked = sorted(self.evaluations.values(), key=lambda e: e.score, reverse=True)
+        return SetpointOptimizationResult(
+            best=ranked[0],
+            evaluations=ranked,
+            history=history,
+            elapsed_seconds=time.perf_counter() - start,
+            **self.stats
+        )
+
+    def _best_score(self) -> float:
+        best = self.best()
+        return best.score if best is not None else -math.inf
+
+
+def create_lettuce_setpoint_optimizer(scenario: Optional[ScenarioSpec] = None,
+                                      config: Optional['ConfigSnapshot'] = None,
+                                      **options) -> SetpointOptimizer:
+    """Create setpoint optimizer with bounds and costs from the JSON config (environment.SETPOINT_OPTIMIZATION)."""
+    from .utils.config_loader import get_config_snapshot
+    optimizer_config = dict((config or get_config_snapshot()).environment.get('SETPOINT_OPTIMIZATION', {}))
+    options.setdefault('bounds', SetpointBounds.from_config(optimizer_config))
+    options.setdefault('cost_model', SetpointCostModel.from_config(optimizer_config))
+    return SetpointOptimizer(scenario, **options)
+
+
+def demonstrate_setpoint_optimizer():
+    """Demonstrate a short setpoint optimization."""
+    print("=" * 80)
+    print("SETPOINT OPTIMIZER DEMONSTRATION")
+    print("=" * 80)
+
+    optimizer = create_lettuce_setpoint_optimizer(ScenarioSpec(max_days=42, weather_seed=1),
+                                                  phase_starts=(1, 15, 29))
+    result = optimizer.optimize(n_initial=8, generations=3)
+    best = result.best
+
+    print(f"{'Phase':<8} {'Days':<10} {'VPD (kPa)':>10} {'CO2 (ppm)':>10} {'RZT (°C)':>9}")
+    print("-" * 80)
+    ends = best.schedule.phase_starts[1:] + (best.days + 1,)
+    for i, (start, end) in enumerate(zip(best.schedule.phase_starts, ends)):
+        print(f"{i + 1:<8} {f'{start}-{end - 1}':<10} {best.schedule.target_vpd[i]:>10.2f} "
+              f"{best.schedule.target_co2[i]:>10.0f} {best.schedule.target_rzt[i]:>9.1f}")
+
+    print(f"\nFresh weight: {best.fresh_weight_g:.1f} g/plant, harvest value ${best.harvest_value:.2f}, "
+          f"setpoint cost ${best.setpoint_cost:.2f}")
+    print(f"Schedules evaluated: {len(result.evaluations)}, simulations: {result.simulations} "
+          f"({result.resumed_runs} resumed from checkpoints), cache hits: {result.cache_hits}")
+    print(f"Simulated days: {result.simulated_days}, wall time: {result.elapsed_seconds:.1f} s")
+
+
+if __name__ == "__main__":
+    demonstrate_setpoint_optimizer()
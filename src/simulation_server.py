@@ -0,0 +1,795 @@
+"""
+CROPGRO Simulation Server - Long-Running HTTP Service for Scenario Runs
+
+Serves scenario runs over HTTP/JSON from one warm process instead of one
+`cropgro_cli.py` process per run, so callers no longer pay interpreter
+start-up, library imports, configuration parsing and sub-model construction
+for every simulation.
+
+Request path:
+1. Normalization: the JSON body becomes a ScenarioSpec (CLI-style aliases
+   accepted, unknown fields rejected) and an engine; their canonical JSON
+   plus the configuration hash is the request key
+2. Result cache: answered from an LRU cache of outcomes by key; identical
+   requests already queued or running are coalesced onto the same result
+3. Micro-batching: one batcher thread collects the queued requests for a
+   short window; 'simulator' requests run on the warm scalar simulators,
+   'ensemble' requests with the same horizon, maturity target and
+   photoperiod share one lock-step ensemble run
+4. Warm pool: the configuration, cultivar tables, one reset-and-reuse
+   simulator per (cultivar, system type) and the ensemble engine are built
+   at start-up
+
+The engine is chosen by the request ('engine': 'simulator', the default,
+or 'ensemble' for daily scenarios without config overrides or setpoint
+schedules), never by what else happens to be queued: ensemble members are
+independent, so a result does not depend on the batch it ran in. The two
+engines agree only to floating-point noise (ensemble_engine.ensemble_parity),
+so the engine is part of the request key and the response.
+
+Requests are bounded: bodies over MAX_BODY_BYTES and lists over
+MAX_SCENARIOS_PER_REQUEST are rejected with 413, max_days over MAX_DAYS
+with 400, before anything is queued. weather_file names a file inside the
+configured WEATHER_DIR (the field is refused when none is configured);
+names that resolve outside it are rejected like missing files.
+
+Endpoints: POST /simulate (one scenario object or a list), GET /metrics
+(Prometheus text format: queue depth, latency quantiles, simulated
+days per second, cache and batch counters) and GET /health.
+
+Key concepts implemented:
+1. Canonical request hashing (normalized scenario + configuration hash)
+2. LRU result cache with in-flight request coalescing
+3. Time-window micro-batching of concurrent requests into ensemble runs
+4. Pre-initialized simulator pool per cultivar and system type
+5. Prometheus exposition of queue, latency and throughput metrics
+
+Research basis:
+- Crankshaw et al. (2017) Clipper: A low-latency online prediction serving system
+- Dean & Barroso (2013) The tail at scale
+- Jones et al. (2003) The DSSAT cropping system model
+"""
+
+import json
+import time
+import queue
+import hashlib
+import logging
+import threading
+from collections import OrderedDict
+from concurrent.futures import Future, TimeoutError as FutureTimeout
+from dataclasses import dataclass, field, replace
+from datetime import datetime
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+from pathlib import Path
+from typing import Any, Dict, List, Mapping, Optional, Sequence, Tuple, Union, TYPE_CHECKING
+from urllib.parse import urlsplit
+
+import numpy as np
+
+from .batch_runner import ScenarioSpec, build_scenario_input, load_shared_tables, run_scenario, scenario_simulator
+from .ensemble_engine import SYSTEM_TYPE_MAP, EnsembleMember, EnsembleSimulator
+from .sensitivity import sample_outputs
+from .utils.config_loader import get_config_loader, get_config_snapshot
+from .utils.ring_buffer import RingBuffer
+
+if TYPE_CHECKING:
+    from .utils.config_loader import ConfigSnapshot
+
+logger = logging.getLogger(__name__)
+
+# ScenarioSpec fields a request may set, with their JSON types
+REQUEST_FIELDS = {
+    'cultivar_id': str,
+    'system_type': str,
+    'weather_seed': int,
+    'max_days': int,
+    'target_maturity': str,
+    'timestep': str,
+    'weather_file': str,
+    'temperature_offset': float,
+    'photoperiod_hours': float,
+    'solution_strength': float,
+}
+
+# cropgro_cli.py option names accepted for the same fields
+REQUEST_ALIASES = {'cultivar': 'cultivar_id', 'system': 'system_type', 'days': 'max_days'}
+
+TIMESTEPS = ('daily', 'hourly')
+
+# Requests kept for the latency quantiles
+LATENCY_WINDOW = 2048
+LATENCY_QUANTILES = (0.5, 0.9, 0.99)
+
+# Engines a request can ask for (the first is the default)
+ENGINES = ('simulator', 'ensemble')
+
+# Request sources reported in responses and metrics
+REQUEST_SOURCES = ('cache', 'coalesced', 'simulator', 'ensemble', 'error')
+
+# Default request limits (environment.SIMULATION_SERVER overrides them)
+DEFAULT_MAX_DAYS = 730
+DEFAULT_MAX_SCENARIOS_PER_REQUEST = 256
+DEFAULT_MAX_BODY_BYTES = 1 << 20
+
+
+class ServerBusyError(RuntimeError):
+    """The request queue is full."""
+
+
+class RequestTooLargeError(ValueError):
+    """The request body or its scenario list exceeds the server limits."""
+
+
+def resolve_weather_file(name: str, weather_dir: Optional[str]) -> str:
+    """
+    Path of a requested weather file inside the server's weather directory.
+
+    Raises ValueError when no directory is configured and, with the same
+    message whether the file is missing or the name escapes the directory,
+    for anything that does not resolve to a file inside it.
+    """
+    if weather_dir is None:
+        raise ValueError("weather_file is not accepted by this server")
+    base = Path(weather_dir).resolve()
+    path = (base / name).resolve()
+    if not path.is_relative_to(base) or not path.is_file():
+        raise ValueError(f"Unknown weather_file {name!r} (name a file in the server's weather directory)")
+    return str(path)
+
+
+def ensemble_group(scenario: ScenarioSpec) -> Optional[Tuple[Any, ...]]:
+    """Key of the scenarios a scenario can share an ensemble run with (None: no ensemble run)."""
+    if scenario.timestep != 'daily' or scenario.config_overrides or scenario.setpoint_schedule is not None:
+        return None
+    return scenario.max_days, scenario.target_maturity, scenario.photoperiod_hours
+
+
+def check_engine(engine: Any, scenario: ScenarioSpec) -> str:
+    """Validated engine of a request (ValueError if unknown or unable to run the scenario)."""
+    if engine not in ENGINES:
+        raise ValueError(f"Unknown engine {engine!r} (use one of {list(ENGINES)})")
+    if engine == 'ensemble' and ensemble_group(scenario) is None:
+        raise ValueError("engine 'ensemble' runs daily scenarios without config_overrides or setpoint schedules")
+    return engine
+
+
+def normalize_request(data: Mapping[str, Any], max_days: Optional[int] = None,
+                      weather_dir: Optional[str] = None) -> Tuple[ScenarioSpec, str]:
+    """
+    Scenario and engine of a request body.
+
+    Accepts the ScenarioSpec fields of REQUEST_FIELDS (or their CLI aliases),
+    config_overrides as a {'section.KEY': value} object and engine (one of
+    ENGINES); weather_file is resolved inside weather_dir. Raises ValueError
+    for unknown fields, values of the wrong type, horizons over max_days,
+    weather files outside weather_dir and engines unable to run the scenario.
+    """
+    if not isinstance(data, Mapping):
+        raise ValueError("Request must be a JSON object")
+    fields: Dict[str, Any] = {}
+    engine = data.get('engine', ENGINES[0])
+    for name, value in data.items():
+        name = REQUEST_ALIASES.get(name, name)
+        if name == 'engine':
+            continue
+        if name == 'config_overrides':
+            if not isinstance(value, Mapping):
+                raise ValueError("config_overrides must be an object of 'section.KEY': value")
+            fields[name] = tuple(sorted(value.items()))
+            continue
+        kind = REQUEST_FIELDS.get(name)
+        if kind is None:
+            raise ValueError(f"Unknown request field {name!r} "
+                             f"(use {sorted(REQUEST_FIELDS)}, engine or config_overrides)")
+        if value is None and name in ('weather_file', 'photoperiod_hours'):
+            fields[name] = None
+        elif kind is float and isinstance(value, (int, float)) and not isinstance(value, bool):
+            fields[name] = float(value)
+        elif isinstance(value, kind) and not isinstance(value, bool):
+            fields[name] = value
+        else:
+            raise ValueError(f"Request field {name!r} must be of type {kind.__name__}")
+    scenario = ScenarioSpec(**fields)
+    if scenario.system_type not in SYSTEM_TYPE_MAP:
+        raise ValueError(f"Unknown system type {scenario.system_type!r} (use one of {list(SYSTEM_TYPE_MAP)})")
+    if scenario.timestep not in TIMESTEPS:
+        raise ValueError(f"Unknown timestep {scenario.timestep!r} (use one of {list(TIMESTEPS)})")
+    if scenario.max_days < 1:
+        raise ValueError("max_days must be positive")
+    if max_days is not None and scenario.max_days > max_days:
+        raise ValueError(f"max_days must not exceed {max_days}")
+    if scenario.weather_file is not None:
+        scenario = replace(scenario, weather_file=resolve_weather_file(scenario.weather_file, weather_dir))
+    return scenario, check_engine(engine, scenario)
+
+
+def request_key(scenario: ScenarioSpec, engine: str = ENGINES[0], config_hash: str = '') -> str:
+    """Hash of the normalized scenario, the engine and the configuration it runs with."""
+    fields = {name: getattr(scenario, name) for name in REQUEST_FIELDS}
+    fields['config_overrides'] = [list(item) for item in scenario.config_overrides]
+    text = json.dumps({'scenario': fields, 'engine': engine, 'config': config_hash}, sort_keys=True, default=str)
+    return hashlib.sha256(text.encode('utf-8')).hexdigest()
+
+
+def json_default(value: Any) -> Any:
+    """json.dumps fallback for NumPy values and datetimes in results."""
+    if isinstance(value, np.generic):
+        return value.item()
+    if isinstance(value, np.ndarray):
+        return value.tolist()
+    if isinstance(value, datetime):
+        return value.isoformat()
+    return str(value)
+
+
+def _outcome(key: str, scenario: ScenarioSpec, engine: str, summary_stats: Dict[str, Any],
+             metadata: Dict[str, Any]) -> Dict[str, Any]:
+    outputs, reached = sample_outputs(summary_stats, metadata)
+    return {'key': key, 'label': scenario.label, 'engine': engine, 'outputs': outputs,
+            'maturity_reached': reached, 'summary_stats': summary_stats, 'metadata': metadata}
+
+
+@dataclass
+class SimulationRequest:
+    """One queued scenario run."""
+    scenario: ScenarioSpec
+    key: str
+    engine: str = ENGINES[0]
+    future: Future = field(default_factory=Future)
+    enqueued: float = field(default_factory=time.perf_counter)
+
+
+class ResultCache:
+    """Outcomes of the most recent `capacity` distinct requests (thread safe)."""
+
+    def __init__(self, capacity: int = 1024):
+        self.capacity = capacity
+        self._entries: 'OrderedDict[str, Dict[str, Any]]' = OrderedDict()
+        self._lock = threading.Lock()
+
+    def get(self, key: str) -> Optional[Dict[str, Any]]:
+        with self._lock:
+            outcome = self._entries.get(key)
+            if outcome is not None:
+                self._entries.move_to_end(key)
+            return outcome
+
+    def put(self, key: str, outcome: Dict[str, Any]):
+        if self.capacity <= 0:
+            return
+        with self._lock:
+            self._entries[key] = outcome
+            self._entries.move_to_end(key)
+            while len(self._entries) > self.capacity:
+                self._entries.popitem(last=False)
+
+    def __len__(self) -> int:
+        return len(self._entries)
+
+
+class ServerMetrics:
+    """Counters, gauges and latency window of the service in Prometheus text format."""
+
+    def __init__(self):
+        self._lock = threading.Lock()
+        self.requests = {source: 0 for source in REQUEST_SOURCES}
+        self.latencies = RingBuffer(LATENCY_WINDOW)
+        self.latency_count = 0
+        self.latency_sum = 0.0
+        self.batches = 0
+        self.batch_members = 0
+        self.ensemble_runs = 0
+        self.simulated_days = 0
+        self.busy_seconds = 0.0
+        self.started = time.time()
+
+    def request(self, source: str, latency: float):
+        with self._lock:
+            self.requests[source] += 1
+            self.latencies.append(latency)
+            self.latency_count += 1
+            self.latency_sum += latency
+
+    def batch(self, members: int, ensemble_runs: int, simulated_days: int, seconds: float):
+        with self._lock:
+            self.batches += 1
+            self.batch_members += members
+            self.ensemble_runs += ensemble_runs
+            self.simulated_days += simulated_days
+            self.busy_seconds += seconds
+
+    def latency_quantiles(self) -> Dict[float, float]:
+        with self._lock:
+            values = self.latencies.values()
+        if not len(values):
+            return {q: 0.0 for q in LATENCY_QUANTILES}
+        return dict(zip(LATENCY_QUANTILES, np.quantile(values, LATENCY_QUANTILES).tolist()))
+
+    def render(self, queue_depth: int, in_flight: int, cache_entries: int, warm_simulators: int) -> str:
+        """Prometheus text exposition of all metrics."""
+        quantiles = self.latency_quantiles()
+        with self._lock:
+            steps_per_second = self.simulated_days / self.busy_seconds if self.busy_seconds > 0 else 0.0
+            lines = [
+                '# HELP cropgro_server_requests_total Scenario requests by how they were answered.',
+                '# TYPE cropgro_server_requests_total counter',
+                *(f'cropgro_server_requests_total{{source="{source}"}} {count}'
+                  for source, count in self.requests.items()),
+                '# HELP cropgro_server_request_latency_seconds Request latency (quantiles over the last '
+                f'{LATENCY_WINDOW} requests).',
+                '# TYPE cropgro_server_request_latency_seconds summary',
+                *(f'cropgro_server_request_latency_seconds{{quantile="{q:g}"}} {value:.6f}'
+                  for q, value in quantiles.items()),
+                f'cropgro_server_request_latency_seconds_sum {self.latency_sum:.6f}',
+                f'cropgro_server_request_latency_seconds_count {self.latency_count}',
+                '# HELP cropgro_server_queue_depth Requests waiting for the batcher.',
+                '# TYPE cropgro_server_queue_depth gauge',
+                f'cropgro_server_queue_depth {queue_depth}',
+                '# HELP cropgro_server_in_flight Distinct scenarios queued or running.',
+                '# TYPE cropgro_server_in_flight gauge',
+                f'cropgro_server_in_flight {in_flight}',
+                '# HELP cropgro_server_batches_total Micro-batches executed.',
+                '# TYPE cropgro_server_batches_total counter',
+                f'cropgro_server_batches_total {self.batches}',
+                '# HELP cropgro_server_batch_members_total Scenarios run in micro-batches.',
+                '# TYPE cropgro_server_batch_members_total counter',
+                f'cropgro_server_batch_members_total {self.batch_members}',
+                '# HELP cropgro_server_ensemble_runs_total Lock-step ensemble runs.',
+                '# TYPE cropgro_server_ensemble_runs_total counter',
+                f'cropgro_server_ensemble_runs_total {self.ensemble_runs}',
+                '# HELP cropgro_server_simulated_days_total Simulated scenario-days (daily steps).',
+                '# TYPE cropgro_server_simulated_days_total counter',
+                f'cropgro_server_simulated_days_total {self.simulated_days}',
+                '# HELP cropgro_server_steps_per_second Simulated scenario-days per second of batcher time.',
+                '# TYPE cropgro_server_steps_per_second gauge',
+                f'cropgro_server_steps_per_second {steps_per_second:.3f}',
+                '# HELP cropgro_server_cache_entries Outcomes held by the result cache.',
+                '# TYPE cropgro_server_cache_entries gauge',
+                f'cropgro_server_cache_entries {cache_entries}',
+                '# HELP cropgro_server_warm_simulators Pre-initialized simulators in the pool.',
+                '# TYPE cropgro_server_warm_simulators gauge',
+                f'cropgro_server_warm_simulators {warm_simulators}',
+                '# HELP cropgro_server_uptime_seconds Seconds since the service started.',
+                '# TYPE cropgro_server_uptime_seconds gauge',
+                f'cropgro_server_uptime_seconds {time.time() - self.started:.1f}',
+            ]
+        return "\n".join(lines) + "\n"
+
+
+class SimulatorPool:
+    """
+    Warm simulators of the service process.
+
+    Scalar runs reuse the batch runner's per-process simulators (one per
+    cultivar, system type and configuration, reset between runs);
+    warm() builds them, the shared tables and the ensemble engine up front.
+    Only the batcher thread runs simulations, so pooled simulators are never
+    used concurrently. The base configuration hash is captured here and by
+    warm() on the starting thread: the batcher swaps the process loader while
+    it runs config_overrides, so request threads must never read it.
+
+    Args:
+        cultivars: Cultivar IDs to pre-initialize
+        systems: System types to pre-initialize
+        config_path: Configuration file (default: the process configuration)
+    """
+
+    def __init__(self, cultivars: Sequence[str] = ('HYDRO_001',), systems: Sequence[str] = ('NFT',),
+                 config_path: Optional[str] = None):
+        self.cultivars = tuple(cultivars)
+        self.systems = tuple(system.upper() for system in systems)
+        self.config_path = config_path
+        self.warm_keys: List[Tuple[str, str]] = []
+        self._ensemble: Optional[EnsembleSimulator] = None
+        self.config_hash = get_config_loader().source_hash
+
+    def warm(self) -> 'SimulatorPool':
+        start = time.perf_counter()
+        load_shared_tables(self.config_path)
+        self.config_hash = get_config_loader().source_hash
+        for cultivar in self.cultivars:
+            for system in self.systems:
+                scenario_simulator(ScenarioSpec(cultivar_id=cultivar, system_type=system))
+                self.warm_keys.append((cultivar, system))
+        self.ensemble()
+        logger.info(f"Simulator pool warm: {len(self.warm_keys)} simulators and the ensemble engine "
+                    f"in {time.perf_counter() - start:.1f} s")
+        return self
+
+    def ensemble(self) -> EnsembleSimulator:
+        if self._ensemble is None:
+            self._ensemble = EnsembleSimulator(backend='numpy')
+        return self._ensemble
+
+    def run_scalar(self, request: SimulationRequest) -> Dict[str, Any]:
+        result = run_scenario(request.scenario)
+        if not result.ok:
+            raise RuntimeError(result.error)
+        return _outcome(request.key, request.scenario, 'simulator', result.summary_stats, result.metadata)
+
+    def run_ensemble(self, requests: Sequence[SimulationRequest]) -> List[Dict[str, Any]]:
+        first = requests[0].scenario
+        members = [EnsembleMember(build_scenario_input(r.scenario), r.scenario.cultivar_id, r.scenario.label)
+                   for r in requests]
+        results = self.ensemble().run(members, max_days=first.max_days, target_maturity=first.target_maturity)
+        return [_outcome(r.key, r.scenario, 'ensemble', result.summary_stats, getattr(result, 'metadata', {}))
+                for r, result in zip(requests, results)]
+
+
+class SimulationService:
+    """
+    In-process request handling of the server: cache, coalescing, queue and batcher.
+
+    Args:
+        pool: Warm simulator pool
+        batch_window_ms: Time the batcher waits for more requests after the first
+        max_batch: Maximum requests per micro-batch
+        cache_size: Outcomes kept in the result cache (0: no cache)
+        max_queue: Queued requests before new ones are rejected
+        request_timeout_s: Time a request waits for its result
+        max_days: Longest simulation horizon a request may ask for
+        max_scenarios_per_request: Longest scenario list of one request
+        max_body_bytes: Largest request body the HTTP front end reads
+        weather_dir: Directory request weather files are resolved in (None: weather_file refused)
+    """
+
+    def __init__(self, pool: SimulatorPool, batch_window_ms: float = 20.0, max_batch: int = 64,
+                 cache_size: int = 1024, max_queue: int = 1024, request_timeout_s: float = 300.0,
+                 max_days: int = DEFAULT_MAX_DAYS,
+                 max_scenarios_per_request: int = DEFAULT_MAX_SCENARIOS_PER_REQUEST,
+                 max_body_bytes: int = DEFAULT_MAX_BODY_BYTES, weather_dir: Optional[str] = None):
+        self.pool = pool
+        self.batch_window = batch_window_ms / 1000.0
+        self.max_batch = max(1, max_batch)
+        self.cache = ResultCache(cache_size)
+        self.queue: 'queue.Queue[Optional[SimulationRequest]]' = queue.Queue(maxsize=max_queue)
+        self.request_timeout = request_timeout_s
+        self.max_days = max_days
+        self.max_scenarios_per_request = max_scenarios_per_request
+        self.max_body_bytes = max_body_bytes
+        self.weather_dir = weather_dir
+        self.metrics = ServerMetrics()
+        self._pending: Dict[str, Future] = {}
+        self._lock = threading.Lock()
+        self._batcher: Optional[threading.Thread] = None
+        self._stopping = threading.Event()
+
+    # ------------------------------------------------------------------
+    # Lifecycle
+    # ------------------------------------------------------------------
+
+    def start(self, warm: bool = True) -> 'SimulationService':
+        if warm:
+            self.pool.warm()
+        self._stopping.clear()
+        self._batcher = threading.Thread(target=self._batch_loop, name='cropgro-batcher', daemon=True)
+        self._batcher.start()
+        return self
+
+    def stop(self):
+        self._stopping.set()
+        if self._batcher is not None:
+            self.queue.put(None)
+            self._batcher.join()
+            self._batcher = None
+
+    # ------------------------------------------------------------------
+    # Requests
+    # ------------------------------------------------------------------
+
+    def normalize(self, data: Union[ScenarioSpec, Mapping[str, Any]],
+                  engine: str = ENGINES[0]) -> Tuple[ScenarioSpec, str]:
+        """
+        Scenario and engine of a request under this service's limits and
+        weather directory (engine applies to ScenarioSpec requests; request
+        bodies carry their own).
+        """
+        if isinstance(data, ScenarioSpec):
+            return data, check_engine(engine, data)
+        return normalize_request(data, self.max_days, self.weather_dir)
+
+    def submit(self, data: Union[ScenarioSpec, Mapping[str, Any]], engine: str = ENGINES[0]) -> Tuple[Future, str]:
+        """
+        Queue a scenario (or answer it from the cache).
+
+        Returns the future of its outcome and how it is answered: 'cache',
+        'coalesced' (an identical request is already queued or running) or
+        'queued'. Raises ValueError for invalid requests and ServerBusyError
+        when the queue is full.
+        """
+        scenario, engine = self.normalize(data, engine)
+        key = request_key(scenario, engine, self.pool.config_hash)
+        with self._lock:
+            outcome = self.cache.get(key)
+            if outcome is not None:
+                future: Future = Future()
+                future.set_result(outcome)
+                return future, 'cache'
+            future = self._pending.get(key)
+            if future is not None:
+                return future, 'coalesced'
+            request = SimulationRequest(scenario, key, engine)
+            try:
+                self.queue.put_nowait(request)
+            except queue.Full:
+                raise ServerBusyError(f"Request queue full ({self.queue.maxsize} requests)")
+            self._pending[key] = request.future
+        return request.future, 'queued'
+
+    def simulate_many(self, requests: Sequence[Union[ScenarioSpec, Mapping[str, Any]]]) -> List[Dict[str, Any]]:
+        """Submit all requests, then wait for them (so they can share micro-batches)."""
+        start = time.perf_counter()
+        if len(requests) > self.max_scenarios_per_request:
+            raise RequestTooLargeError(f"At most {self.max_scenarios_per_request} scenarios per request")
+        normalized = [self.normalize(data) for data in requests]
+        submitted = [self.submit(scenario, engine) for scenario, engine in normalized]
+        responses = []
+        for future, how in submitted:
+            try:
+                outcome = future.result(timeout=max(0.0, self.request_timeout - (time.perf_counter() - start)))
+            except FutureTimeout:
+                raise TimeoutError(f"Simulation did not finish within {self.request_timeout:g} s")
+            except Exception as e:
+                self.metrics.request('error', time.perf_counter() - start)
+                responses.append({'error': f"{type(e).__name__}: {e}"})
+                continue
+            source = outcome['engine'] if how == 'queued' else how
+            latency = time.perf_counter() - start
+            self.metrics.request(source, latency)
+            responses.append(dict(outcome, source=source, latency_ms=latency * 1000.0))
+        return responses
+
+    def simulate(self, data: Union[ScenarioSpec, Mapping[str, Any]]) -> Dict[str, Any]:
+        return self.simulate_many([data])[0]
+
+    def render_metrics(self) -> str:
+        with self._lock:
+            in_flight = len(self._pending)
+        return self.metrics.render(self.queue.qsize(), in_flight, len(self.cache), len(self.pool.warm_keys))
+
+    def health(self) -> Dict[str, Any]:
+        return {'status': 'ok' if self._batcher is not None else 'stopped',
+                'warm': [f"{cultivar}/{system}" for cultivar, system in self.pool.warm_keys],
+                'queue_depth': self.queue.qsize(),
+                'config_hash': self.pool.config_hash[:12]}
+
+    # ------------------------------------------------------------------
+    # Batcher
+    # ------------------------------------------------------------------
+
+    def _collect(self) -> List[SimulationRequest]:
+        """First queued request plus whatever arrives within the batch window."""
+        try:
+            first = self.queue.get(timeout=0.5)
+        except queue.Empty:
+            return []
+        if first is None:
+            return []
+        batch = [first]
+        deadline = time.perf_counter() + self.batch_window
+        while len(batch) < self.max_batch:
+            remaining = deadline - time.perf_counter()
+            try:
+                request = self.queue.get(timeout=remaining) if remaining > 0 else self.queue.get_nowait()
+            except queue.Empty:
+                break
+            if request is None:
+                self._stopping.set()
+                break
+            batch.append(request)
+        return batch
+
+    def _batch_loop(self):
+        while not self._stopping.is_set():
+            batch = self._collect()
+            if batch:
+                self._execute(batch)
+        # Fail what is still queued at shutdown
+        while True:
+            try:
+                request = self.queue.get_nowait()
+            except queue.Empty:
+                break
+            if request is not None:
+                self._fail(request, RuntimeError("Simulation server stopped"))
+
+    def _execute(self, batch: List[SimulationRequest]):
+        start = time.perf_counter()
+        groups: Dict[Tuple[Any, ...], List[SimulationRequest]] = {}
+        scalar: List[SimulationRequest] = []
+        for request in batch:
+            if request.engine == 'ensemble':
+                groups.setdefault(ensemble_group(request.scenario), []).append(request)
+            else:
+                scalar.append(request)
+
+        days, ensemble_runs = 0, 0
+        for requests in groups.values():
+            try:
+                outcomes = self.pool.run_ensemble(requests)
+            except Exception as e:
+                for request in requests:
+                    self._fail(request, e)
+                continue
+            ensemble_runs += 1
+            for request, outcome in zip(requests, outcomes):
+                days += int(outcome['summary_stats'].get('total_days', 0))
+                self._complete(request, outcome)
+        for request in scalar:
+            try:
+                outcome = self.pool.run_scalar(request)
+            except Exception as e:
+                self._fail(request, e)
+                continue
+            days += int(outcome['summary_stats'].get('total_days', 0))
+            self._complete(request, outcome)
+        self.metrics.batch(len(batch), ensemble_runs, days, time.perf_counter() - start)
+        logger.debug("Micro-batch of %d requests: %d ensemble runs, %d simulated days",
+                     len(batch), ensemble_runs, days)
+
+    def _complete(self, request: SimulationRequest, outcome: Dict[str, Any]):
+        with self._lock:
+            self.cache.put(request.key, outcome)
+            self._pending.pop(request.key, None)
+        request.future.set_result(outcome)
+
+    def _fail(self, request: SimulationRequest, error: Exception):
+        logger.error(f"Simulation request {request.scenario.label} failed: {error}")
+        with self._lock:
+            self._pending.pop(request.key, None)
+        request.future.set_exception(error)
+
+
+class SimulationRequestHandler(BaseHTTPRequestHandler):
+    """HTTP front end of a SimulationService (self.server.service)."""
+
+    server_version = "CROPGRO-Server/1.0"
+
+    def do_GET(self):
+        path = urlsplit(self.path).path
+        service: SimulationService = self.server.service
+        if path == '/metrics':
+            self._send(200, service.render_metrics().encode('utf-8'), 'text/plain; version=0.0.4')
+        elif path == '/health':
+            self._send_json(200, service.health())
+        else:
+            self._send_json(404, {'error': f"Unknown path {path}"})
+
+    def do_POST(self):
+        path = urlsplit(self.path).path
+        if path != '/simulate':
+            self._send_json(404, {'error': f"Unknown path {path}"})
+            return
+        service: SimulationService = self.server.service
+        try:
+            length = int(self.headers.get('Content-Length', 0))
+        except ValueError:
+            self._send_json(400, {'error': "Invalid Content-Length"})
+            return
+        if length > service.max_body_bytes:
+            self.close_connection = True
+            self._send_json(413, {'error': f"Request body exceeds {service.max_body_bytes} bytes"})
+            return
+        try:
+            body = json.loads(self.rfile.read(max(0, length)) or b'{}')
+            requests = body if isinstance(body, list) else [body]
+            responses = service.simulate_many(requests)
+        except RequestTooLargeError as e:
+            self._send_json(413, {'error': str(e)})
+            return
+        except (ValueError, TypeError) as e:
+            self._send_json(400, {'error': str(e)})
+            return
+        except ServerBusyError as e:
+            self._send_json(503, {'error': str(e)})
+            return
+        except TimeoutError as e:
+            self._send_json(504, {'error': str(e)})
+            return
+        status = 500 if all('error' in r for r in responses) else 200
+        self._send_json(status, responses if isinstance(body, list) else responses[0])
+
+    def _send_json(self, status: int, payload: Any):
+        self._send(status, json.dumps(payload, default=json_default).encode('utf-8'), 'application/json')
+
+    def _send(self, status: int, body: bytes, content_type: str):
+        self.send_response(status)
+        self.send_header('Content-Type', content_type)
+        self.send_header('Content-Length', str(len(body)))
+        self.end_headers()
+        self.wfile.write(body)
+
+    def log_message(self, format, *args):
+        logger.debug("%s - %s", self.address_string(), format % args)
+
+
+class SimulationHTTPServer(ThreadingHTTPServer):
+    """Threaded HTTP server bound to one SimulationService."""
+
+    daemon_threads = True
+
+    def __init__(self, address: Tuple[str, int], service: SimulationService):
+        super().__init__(address, SimulationRequestHandler)
+        self.service = service
+
+
+def create_lettuce_simulation_server(config: Optional['ConfigSnapshot'] = None,
+                                     host: Optional[str] = None, port: Optional[int] = None,
+                                     warm: bool = True, **options) -> SimulationHTTPServer:
+    """
+    Started service behind an HTTP server that is ready to serve_forever()
+    (environment.SIMULATION_SERVER: HOST, PORT, CULTIVARS, SYSTEMS,
+    BATCH_WINDOW_MS, MAX_BATCH, CACHE_SIZE, MAX_QUEUE,
+    REQUEST_TIMEOUT_S, MAX_DAYS, MAX_SCENARIOS_PER_REQUEST, MAX_BODY_BYTES,
+    WEATHER_DIR).
+    """
+    config = config or get_config_snapshot()
+    server_config = dict(config.environment.get('SIMULATION_SERVER', {}))
+    pool = SimulatorPool(cultivars=options.pop('cultivars', None) or server_config.get('CULTIVARS', ('HYDRO_001',)),
+                         systems=options.pop('systems', None) or server_config.get('SYSTEMS', ('NFT',)),
+                         config_path=options.pop('config_path', None))
+    options.setdefault('batch_window_ms', server_config.get('BATCH_WINDOW_MS', 20.0))
+    options.setdefault('max_batch', server_config.get('MAX_BATCH', 64))
+    options.setdefault('cache_size', server_config.get('CACHE_SIZE', 1024))
+    options.setdefault('max_queue', server_config.get('MAX_QUEUE', 1024))
+    options.setdefault('request_timeout_s', server_config.get('REQUEST_TIMEOUT_S', 300.0))
+    options.setdefault('max_days', server_config.get('MAX_DAYS', DEFAULT_MAX_DAYS))
+    options.setdefault('max_scenarios_per_request',
+                       server_config.get('MAX_SCENARIOS_PER_REQUEST', DEFAULT_MAX_SCENARIOS_PER_REQUEST))
+    options.setdefault('max_body_bytes', server_config.get('MAX_BODY_BYTES', DEFAULT_MAX_BODY_BYTES))
+    options.setdefault('weather_dir', server_config.get('WEATHER_DIR'))
+    service = SimulationService(pool, **options).start(warm=warm)
+    host = host if host is not None else server_config.get('HOST', '127.0.0.1')
+    port = port if port is not None else server_config.get('PORT', 8470)
+    server = SimulationHTTPServer((host, port), service)
+    logger.info(f"CROPGRO simulation server listening on http://{host}:{server.server_address[1]}")
+    return server
+
+
+def demonstrate_simulation_server():
+    """Serve concurrent requests over HTTP and show caching, batching and metrics."""
+    from urllib.request import Request, urlopen
+
+    print("=" * 80)
+    print("SIMULATION SERVER DEMONSTRATION")
+    print("=" * 80)
+
+    start = time.perf_counter()
+    server = create_lettuce_simulation_server(port=0, cultivars=('HYDRO_001', 'HYDRO_002'))
+    thread = threading.Thread(target=server.serve_forever, daemon=True)
+    thread.start()
+    url = f"http://127.0.0.1:{server.server_address[1]}"
+    print(f"\nServer warm in {time.perf_counter() - start:.1f} s at {url}")
+
+    def post(payload):
+        request = Request(f"{url}/simulate", data=json.dumps(payload).encode('utf-8'),
+                          headers={'Content-Type': 'application/json'})
+        with urlopen(request) as response:
+            return json.loads(response.read())
+
+    scenarios = [{'cultivar': cultivar, 'days': 40, 'weather_seed': seed, 'engine': engine}
+                 for cultivar in ('HYDRO_001', 'HYDRO_002') for engine in ENGINES for seed in range(2)]
+    print(f"\n{'Pass':<8} {'Label':<28} {'Engine':>10} {'FW (g)':>9} {'Source':>10} {'ms':>9}")
+    print("-" * 80)
+    for name in ('cold', 'cached'):
+        for response in post(scenarios):
+            print(f"{name:<8} {response['label']:<28} {response['engine']:>10} "
+                  f"{response['outputs']['fresh_weight_g']:>9.2f} {response['source']:>10} "
+                  f"{response['latency_ms']:>9.2f}")
+
+    with urlopen(f"{url}/metrics") as response:
+        metrics = response.read().decode('utf-8')
+    print("\nMetrics:")
+    for line in metrics.splitlines():
+        if not line.startswith('#'):
+            print(f"  {line}")
+
+    server.shutdown()
+    server.service.stop()
+    server.server_close()
+    return metrics
+
+
+if __name__ == "__main__":
+    demonstrate_simulation_server()
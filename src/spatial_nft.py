@@ -0,0 +1,465 @@
+"""
+CROPGRO Spatial NFT - Plant-by-Plant Channel Simulation
+
+Simulates every plant position along every channel of an NFT system instead
+of treating the system's plants as identical copies. Solution leaves the
+shared tank, flows down each channel past the plants in order and returns
+to the tank, so plants further down a channel see solution that upstream
+plants have already depleted of nutrients and oxygen and that has warmed
+towards the air temperature.
+
+Per-plant state is the struct-of-arrays state of the ensemble engine (one
+member per plant position), so a daily step of a room of thousands of
+plants is one lock-step array update plus a sweep down the channels that is
+vectorized across channels.
+
+Key concepts implemented:
+1. Channel layout (channels × positions) mapped onto ensemble members
+2. Plug-flow solution transport: per-position depletion from
+   EnhancedRootUptakeModel.calculate_nutrient_uptake at the local solution
+   concentration and film temperature
+3. Dissolved oxygen consumed by root respiration and re-aerated along
+   the channel; local oxygen limitation of growth
+4. Film temperature relaxing from the tank temperature towards the air
+   (plus solar gain) along the channel
+5. Shared tank mass balance: the summed uptake of all positions depletes
+   the tank, which feeds every channel inlet
+
+Research basis:
+- Cooper (1979) The ABC of NFT
+- Gislerød & Kempton (1983) Oxygen concentration gradients along NFT channels
+- Genuncio et al. (2012) Nutrient depletion along NFT channels in lettuce
+"""
+
+import math
+import time
+import logging
+from copy import copy
+from dataclasses import dataclass, field
+from typing import Any, Dict, List, Optional, Sequence, Tuple, TYPE_CHECKING
+
+import numpy as np
+
+from .cropgro_hydroponic_simulator import ROOT_RNG_STREAM
+from .ensemble_engine import EnsembleMember, EnsembleSimulator, ROOT_METRICS, ROOT_NUTRIENT_MAP, SYSTEM_TYPE_MAP
+from .models.root_system_model import HydroponicSystemType, create_enhanced_root_uptake_model
+from .data.hydroponic_system import HydroInputData, HydroSystemConfig
+
+if TYPE_CHECKING:
+    from .cropgro_hydroponic_simulator import SimulationParameters
+    from .utils.config_loader import ConfigSnapshot
+
+logger = logging.getLogger(__name__)
+
+# mg NO3 per mg N (the tank is depleted in nitrate notation, as in run_simulation)
+NO3_PER_N = 62.0 / 14.0
+
+# Per-position fields recorded every day
+POSITION_FIELDS = ('total_biomass', 'leaf_biomass', 'lai', 'solution_no3', 'solution_temperature',
+                   'dissolved_oxygen', 'no3_uptake')
+
+
+def oxygen_saturation(temperature):
+    """Dissolved oxygen at air saturation (mg/L) of fresh water at temperature (°C)."""
+    t = temperature
+    return 14.652 - 0.41022 * t + 0.007991 * t ** 2 - 0.000077774 * t ** 3
+
+
+@dataclass
+class NFTChannelParameters:
+    """Channel geometry and solution transport parameters."""
+    n_channels: int = 4
+    channel_length: float = 2.0               # m
+    inlet_oxygen_saturation: float = 0.95     # Tank DO as fraction of saturation (aerated tank)
+    root_oxygen_demand: float = 400.0         # mg O2 per g root dry mass per day
+    reaeration_rate: float = 0.5              # 1/m, film DO relaxation towards saturation
+    thermal_exchange_rate: float = 0.3        # 1/m, film temperature relaxation towards the air
+    solar_heating: float = 0.15               # °C per MJ/m²/day (as the simulator's solution model)
+    critical_oxygen: float = 6.0              # mg/L below which roots are oxygen limited
+    base_oxygen_factor: float = 0.95          # Oxygen factor of well-aerated solution
+
+    def __post_init__(self):
+        if self.n_channels < 1 or self.channel_length <= 0:
+            raise ValueError("NFT layout needs at least one channel of positive length")
+
+    @classmethod
+    def from_config(cls, config_dict: dict) -> 'NFTChannelParameters':
+        """Create NFTChannelParameters from configuration dictionary."""
+        return cls(**{name: config_dict[name] for name in cls.__dataclass_fields__ if name in config_dict})
+
+
+@dataclass(frozen=True)
+class NFTChannelLayout:
+    """Plant positions of a system: member index of (channel, position)."""
+    n_channels: int
+    plants_per_channel: int
+    channel_length: float        # m
+    channel_flow: float          # L/h per channel
+
+    @classmethod
+    def from_system(cls, system_config: HydroSystemConfig, params: NFTChannelParameters) -> 'NFTChannelLayout':
+        n_channels = max(1, min(params.n_channels, system_config.n_plants))
+        plants_per_channel = max(1, math.ceil(system_config.n_plants / n_channels))
+        if n_channels * plants_per_channel != system_config.n_plants:
+            logger.info(f"{system_config.n_plants} plants do not fill {n_channels} channels evenly; "
+                        f"simulating {n_channels * plants_per_channel} positions")
+        return cls(n_channels, plants_per_channel, params.channel_length,
+                   system_config.flow_rate / n_channels)
+
+    @property
+    def shape(self) -> Tuple[int, int]:
+        return (self.n_channels, self.plants_per_channel)
+
+    @property
+    def n_positions(self) -> int:
+        return self.n_channels * self.plants_per_channel
+
+    @property
+    def spacing(self) -> float:
+        return self.channel_length / self.plants_per_channel
+
+    @property
+    def daily_throughput(self) -> float:
+        """Solution passing each position per day (L)."""
+        return max(1e-6, self.channel_flow * 24.0)
+
+    def members(self, position: int) -> np.ndarray:
+        """Member indices of one position in every channel (channel-major numbering)."""
+        return np.arange(self.n_channels) * self.plants_per_channel + position
+
+    def labels(self) -> List[str]:
+        return [f"C{c + 1}P{p + 1}" for c in range(self.n_channels) for p in range(self.plants_per_channel)]
+
+
+@dataclass
+class TankState:
+    """Shared nutrient tank."""
+    volume: float                       # L
+    concentrations: np.ndarray          # mg/L per ensemble nutrient column
+    ph: float = 6.0
+    temperature: Optional[float] = None  # °C (None until the first day)
+
+
+@dataclass
+class SpatialNFTResults:
+    """Per-position trajectories and the tank history of a spatial run."""
+    layout: NFTChannelLayout
+    nutrient_ids: List[str]
+    positions: Dict[str, np.ndarray]            # Field -> (days, channels, positions)
+    tank: List[Dict[str, Any]] = field(default_factory=list)
+    days_completed: Optional[np.ndarray] = None  # (channels, positions)
+    maturity_reached: Optional[np.ndarray] = None
+    elapsed_seconds: float = 0.0
+    step_seconds: float = 0.0
+
+    @property
+    def days(self) -> int:
+        return len(self.tank)
+
+    def final(self, name: str) -> np.ndarray:
+        """Last recorded value of a field per (channel, position)."""
+        return self.positions[name][-1]
+
+    def summary(self) -> Dict[str, Any]:
+        biomass = self.final('total_biomass')
+        mean = float(biomass.mean())
+        return {
+            'positions': self.layout.n_positions,
+            'days': self.days,
+            'mean_biomass_g': mean,
+            'biomass_cv': float(biomass.std() / mean) if mean > 0 else 0.0,
+            'inlet_biomass_g': float(biomass[:, 0].mean()),
+            'outlet_biomass_g': float(biomass[:, -1].mean()),
+            'min_outlet_oxygen_mg_L': float(self.positions['dissolved_oxygen'][:, :, -1].min()),
+            'max_temperature_rise_C': float((self.positions['solution_temperature'][:, :, -1] -
+                                             self.positions['solution_temperature'][:, :, 0]).max()),
+            'step_seconds_per_day': self.step_seconds / max(1, self.days),
+        }
+
+
+class SpatialNFTSimulator:
+    """
+    Plant-by-plant NFT simulation on the ensemble engine.
+
+    Args:
+        channel_params: Channel geometry and transport parameters
+        simulation_params: Simulator parameters (as for the ensemble engine)
+        ensemble: Existing ensemble engine to reuse (its prototype parameters)
+    """
+
+    def __init__(self, channel_params: Optional[NFTChannelParameters] = None,
+                 simulation_params: Optional['SimulationParameters'] = None,
+                 ensemble: Optional[EnsembleSimulator] = None):
+        self.channel_params = channel_params or NFTChannelParameters()
+        # Channel transport writes the ensemble state in place on the host
+        self.ensemble = ensemble or EnsembleSimulator(simulation_params=simulation_params, backend='numpy')
+        if self.ensemble.backend.name != 'numpy':
+            raise ValueError("Spatial NFT simulation requires an ensemble engine on the numpy backend")
+        self._uptake_models: Dict[Tuple[HydroponicSystemType, float], Any] = {}
+
+    def _uptake_model(self, system_config: HydroSystemConfig):
+        system_enum = SYSTEM_TYPE_MAP.get(system_config.system_type, HydroponicSystemType.NFT)
+        key = (system_enum, system_config.tank_volume)
+        model = self._uptake_models.get(key)
+        if model is None:
+            model = create_enhanced_root_uptake_model(system_enum, system_config.tank_volume)
+            self._uptake_models[key] = model
+        return model
+
+    def run(self, input_data: HydroInputData, cultivar_id: str = 'HYDRO_001',
+            max_days: int = 365, target_maturity: str = "harvest",
+            cultivars: Optional[Sequence[str]] = None) -> SpatialNFTResults:
+        """
+        Simulate every plant position until all reach the target maturity or max_days.
+
+        Args:
+            input_data: System, weather and nutrient inputs of the whole room
+            cultivar_id: Cultivar of every position
+            max_days: Maximum simulated days
+            target_maturity: 'harvest' (HM) or 'physiological' (PM)
+            cultivars: Optional cultivar per position (channel-major order)
+        """
+        start = time.perf_counter()
+        params = self.channel_params
+        ensemble = self.ensemble
+        layout = NFTChannelLayout.from_system(input_data.system_config, params)
+        n = layout.n_positions
+        if cultivars is not None and len(cultivars) != n:
+            raise ValueError(f"Expected {n} cultivars (one per position), got {len(cultivars)}")
+
+        # Every position sees the room's system (plant density for LAI); the tank is shared
+        room_config = copy(input_data.system_config)
+        room_config.n_plants = n
+        member_input = copy(input_data)
+        member_input.system_config = room_config
+        # One root cohort stream per position (all positions share the input's seed)
+        seed = input_data.random_seed
+        members = [EnsembleMember(member_input, cultivars[i] if cultivars is not None else cultivar_id, label,
+                                  root_seed=None if seed is None else (seed, ROOT_RNG_STREAM, i))
+                   for i, label in enumerate(layout.labels())]
+
+        state = ensemble._initialize_state(members, max_days)
+        state.external_solution = True
+        uptake_model = self._uptake_model(room_config)
+        flow = layout.channel_flow / 60.0  # L/min, as the uptake model's flow response expects
+        state.root_flow_factor[:] = uptake_model.calculate_flow_factor(flow)
+        target_table = ensemble._target_table(target_maturity)
+
+        tank = TankState(volume=room_config.tank_volume, concentrations=state.concentrations[0].copy())
+        recharge = state.recharge_concentrations[0]
+        present = state.nutrient_present[0]
+        activity = np.ones(n)
+        history = {name: [] for name in POSITION_FIELDS}
+        results = SpatialNFTResults(layout, list(state.nutrient_ids), {})
+        step_seconds = 0.0
+
+        logger.info(f"Starting spatial NFT simulation: {layout.n_channels} channels × "
+                    f"{layout.plants_per_channel} positions, maximum {max_days} days")
+        day = 1
+        while day <= max_days and state.active.any():
+            step_start = time.perf_counter()
+            widx = (day - 1) % int(state.weather_length[0])
+            air_temperature = float(state.weather_temp[0, widx])
+            solar = float(state.weather_solar[0, widx])
+
+            # Weekly solution change of the tank (as run_simulation)
+            if day % 7 == 1 and day > 1:
+                tank.concentrations = np.where(present, recharge, tank.concentrations)
+                tank.ph = 6.0
+
+            # Tank temperature with thermal mass lag
+            thermal_mass = min(1.0, max(0.1, tank.volume / 1000.0))
+            previous = air_temperature if tank.temperature is None else tank.temperature
+            tank.temperature = min(35.0, max(10.0, previous + (air_temperature + params.solar_heating * solar -
+                                                               previous) * (0.3 / thermal_mass)))
+
+            sweep = self._channel_sweep(state, layout, tank, uptake_model, flow, activity,
+                                        air_temperature, solar)
+
+            # Local solution of every position for the lock-step plant update
+            state.concentrations[:] = sweep['concentrations']
+            state.ph[:] = tank.ph
+            state.tank_volume[:] = tank.volume
+            state.solution_temperature_override = sweep['temperature']
+            state.oxygen_factor = params.base_oxygen_factor * np.minimum(
+                1.0, sweep['oxygen'] / params.critical_oxygen)
+            active = state.active.copy()
+            record = ensemble._step(state, day)
+            ensemble._close_day(state, day, target_table)
+            activity = np.where(active, record['root_activity_young'], activity)
+
+            # Shared tank mass balance: summed uptake of the positions, one water draw
+            uptake = sweep['uptake'] * active[:, None]
+            volume_L = max(0.001, tank.volume / 1000.0)
+            tank.concentrations = np.where(present, np.maximum(0.0, tank.concentrations -
+                                                               uptake.sum(axis=0) / volume_L),
+                                           tank.concentrations)
+            no3_total = float(uptake[:, state.no3_column].sum()) if state.no3_column >= 0 else 0.0
+            tank.ph = max(5.5, min(6.5, tank.ph - min(0.03, no3_total / 20000.0) - 0.005))
+            if active.any():
+                tank.volume = max(0.0, tank.volume - float(record['water_uptake_total'][active].mean()))
+
+            step_seconds += time.perf_counter() - step_start
+            self._record(history, results, state, layout, record, sweep, tank, day)
+            day += 1
+
+        results.positions = {name: np.array(values).reshape((-1,) + layout.shape)
+                             for name, values in history.items()}
+        results.days_completed = state.days_completed.reshape(layout.shape)
+        results.maturity_reached = state.maturity_reached.reshape(layout.shape)
+        results.step_seconds = step_seconds
+        results.elapsed_seconds = time.perf_counter() - start
+        logger.info(f"Spatial NFT simulation completed: {results.days} days, "
+                    f"{step_seconds / max(1, results.days) * 1000:.1f} ms per day")
+        return results
+
+    def _channel_sweep(self, state, layout: NFTChannelLayout, tank: TankState, uptake_model,
+                       flow: float, activity: np.ndarray, air_temperature: float,
+                       solar: float) -> Dict[str, np.ndarray]:
+        """
+        Solution at every position and the uptake it loses there, swept down all channels at once.
+
+        Plants' root systems are those at the end of the previous day; each
+        position takes up from the solution arriving at it, and the solution
+        passed on is its daily throughput less that uptake.
+        """
+        params = self.channel_params
+        n, k = state.concentrations.shape
+        spacing = layout.spacing
+        throughput = layout.daily_throughput
+        equilibrium = air_temperature + params.solar_heating * solar
+        thermal_decay = math.exp(-params.thermal_exchange_rate * spacing)
+        oxygen_decay = math.exp(-params.reaeration_rate * spacing)
+
+        # Root architecture of every position (the ensemble's per-position cohort metrics)
+        metrics = dict(zip(ROOT_METRICS, state.root_metrics.T))
+        architecture = {
+            'total_root_surface_area': metrics['total_root_surface_area'],
+            'average_root_activity': activity,
+            'fine_root_length': metrics['fine_root_length'],
+            'medium_root_length': metrics['medium_root_length'],
+            'coarse_root_length': metrics['coarse_root_length'],
+        }
+        root_mass = state.pool_mass[:, 2]
+        root_columns = [(root_key, state.root_columns[root_key], root_key == 'NO3')
+                        for root_key in ROOT_NUTRIENT_MAP.values() if state.root_columns[root_key] >= 0]
+
+        concentrations = np.empty((n, k))
+        temperature = np.empty(n)
+        oxygen = np.empty(n)
+        uptake = np.zeros((n, k))
+
+        solution = np.tile(tank.concentrations, (layout.n_channels, 1))
+        film_temperature = np.full(layout.n_channels, tank.temperature)
+        dissolved_oxygen = oxygen_saturation(film_temperature) * params.inlet_oxygen_saturation
+        for position in range(layout.plants_per_channel):
+            # Travel to the position (half a spacing to the first plant)
+            decay = 0.5 if position == 0 else 1.0
+            film_temperature = equilibrium + (film_temperature - equilibrium) * thermal_decay ** decay
+            saturation = oxygen_saturation(film_temperature)
+            dissolved_oxygen = saturation + (dissolved_oxygen - saturation) * oxygen_decay ** decay
+
+            members = layout.members(position)
+            concentrations[members] = solution
+            temperature[members] = film_temperature
+            oxygen[members] = dissolved_oxygen
+
+            response = uptake_model.calculate_nutrient_uptake(
+                {name: values[members] for name, values in architecture.items()},
+                {'temperature': film_temperature, 'flow_rate': flow},
+                {root_key: solution[:, column] for root_key, column, _ in root_columns}
+            )
+            lost = np.zeros((layout.n_channels, k))
+            for root_key, column, is_nitrate in root_columns:
+                rate = response[f'{root_key}_uptake_rate']
+                lost[:, column] = rate * NO3_PER_N if is_nitrate else rate
+            lost *= state.nutrient_present[members] & state.active[members][:, None]
+            uptake[members] = lost
+
+            solution = np.maximum(0.0, solution - lost / throughput)
+            demand = params.root_oxygen_demand * root_mass[members] * state.active[members]
+            dissolved_oxygen = np.maximum(0.0, dissolved_oxygen - demand / throughput)
+
+        return {'concentrations': concentrations, 'temperature': temperature,
+                'oxygen': oxygen, 'uptake': uptake}
+
+    def _record(self, history: Dict[str, list], results: SpatialNFTResults, state, layout: NFTChannelLayout,
+                record: Dict[str, Any], sweep: Dict[str, np.ndarray], tank: TankState, day: int):
+        no3 = state.no3_column
+        history['total_biomass'].append(record['total_biomass'])
+        history['leaf_biomass'].append(record['leaf_biomass'])
+        history['lai'].append(record['lai'])
+        history['solution_no3'].append(sweep['concentrations'][:, no3] if no3 >= 0 else np.zeros(state.n_members))
+        history['solution_temperature'].append(sweep['temperature'])
+        history['dissolved_oxygen'].append(sweep['oxygen'])
+        history['no3_uptake'].append(sweep['uptake'][:, no3] if no3 >= 0 else np.zeros(state.n_members))
+        results.tank.append({
+            'day': day,
+            'volume': tank.volume,
+            'ph': tank.ph,
+            'ec': float(np.clip((tank.concentrations * state.ec_coefficients * state.nutrient_present[0]).sum(),
+                                0.05, 5.0)),
+            'temperature': tank.temperature,
+            'concentrations': dict(zip(state.nutrient_ids, tank.concentrations.tolist())),
+            'active_positions': int(state.active.sum()),
+        })
+
+
+def create_lettuce_spatial_nft_simulator(config: Optional['ConfigSnapshot'] = None,
+                                         **options) -> SpatialNFTSimulator:
+    """Create spatial NFT simulator with channel parameters from the JSON config (environment.SPATIAL_NFT)."""
+    from .utils.config_loader import get_config_snapshot
+    channel_config = dict((config or get_config_snapshot()).environment.get('SPATIAL_NFT', {}))
+    options.setdefault('channel_params', NFTChannelParameters.from_config(channel_config))
+    return SpatialNFTSimulator(**options)
+
+
+def demonstrate_spatial_nft():
+    """Demonstrate gradients along the channels of a 2,000-plant NFT room."""
+    from datetime import datetime
+    from .data.hydroponic_system import DefaultConfigurations
+    from .utils.weather_generator import WeatherGenerator
+
+    print("=" * 80)
+    print("SPATIAL NFT CHANNEL SIMULATION DEMONSTRATION")
+    print("=" * 80)
+
+    days = 35
+    system_config = DefaultConfigurations.get_nft_lettuce_system()
+    system_config.n_plants = 2000
+    system_config.system_area = 100.0
+    system_config.tank_volume = 2000.0
+    system_config.flow_rate = 40 * 60.0   # 1 L/min per channel
+    input_data = HydroInputData(
+        system_config=system_config,
+        crop_params=DefaultConfigurations.get_lettuce_parameters(),
+        weather_data=WeatherGenerator().generate_weather_series(datetime(2024, 1, 1), days),
+        nutrient_params=DefaultConfigurations.get_default_nutrients(),
+        simulation_days=days
+    )
+    simulator = create_lettuce_spatial_nft_simulator(
+        channel_params=NFTChannelParameters(n_channels=40, channel_length=10.0))
+    results = simulator.run(input_data, max_days=days)
+    summary = results.summary()
+    layout = results.layout
+
+    print(f"{layout.n_channels} channels × {layout.plants_per_channel} positions, {results.days} days")
+    print(f"\n{'Position':>9} {'Biomass (g)':>12} {'NO3 (mg/L)':>11} {'DO (mg/L)':>10} {'Film (°C)':>10}")
+    print("-" * 80)
+    for position in sorted({0, layout.plants_per_channel // 4, layout.plants_per_channel // 2,
+                            3 * layout.plants_per_channel // 4, layout.plants_per_channel - 1}):
+        print(f"{position + 1:>9} {results.final('total_biomass')[:, position].mean():>12.2f} "
+              f"{results.final('solution_no3')[:, position].mean():>11.1f} "
+              f"{results.final('dissolved_oxygen')[:, position].mean():>10.2f} "
+              f"{results.final('solution_temperature')[:, position].mean():>10.2f}")
+
+    print(f"\nMean biomass {summary['mean_biomass_g']:.2f} g (CV {summary['biomass_cv']:.1%}), "
+          f"inlet {summary['inlet_biomass_g']:.2f} g vs outlet {summary['outlet_biomass_g']:.2f} g")
+    print(f"Tank: {results.tank[-1]['volume']:.0f} L, EC {results.tank[-1]['ec']:.2f} dS/m, "
+          f"pH {results.tank[-1]['ph']:.2f}")
+    print(f"Daily step: {summary['step_seconds_per_day'] * 1000:.1f} ms for {layout.n_positions} plants")
+    return results
+
+
+if __name__ == "__main__":
+    demonstrate_spatial_nft()
@@ -0,0 +1,178 @@
+"""
+Array Backends for the Vectorized Kernels
+Pluggable array namespace (NumPy, CuPy or JAX) behind the ensemble engine
+and the photosynthesis, canopy, respiration, uptake and stress kernels.
+
+Kernels are written once against `backend.xp`, the backend's NumPy-compatible
+namespace, and never convert to NumPy themselves, so state created on a
+device stays there for the whole run. The few operations that differ between
+libraries go through the backend:
+
+- element and masked writes (set, where_set): in place for NumPy and CuPy,
+  functional updates for JAX, whose arrays are immutable;
+- device -> host copies (to_host), which callers make only for the values
+  they need on the host.
+
+Selecting the JAX backend turns on `jax_enable_x64` for the whole process:
+the kernels rely on float64 to match the NumPy path, and JAX has no
+per-array switch for it. Other JAX code in the same process then also
+defaults to 64-bit; the flag is only touched when the backend is built,
+never by listing the available backends.
+
+Key concepts implemented:
+1. Named backends built on first use and shared (get_array_backend)
+2. One in-place / functional write interface for mutable and immutable arrays
+3. Explicit, caller-controlled host transfers
+4. Default backend selected in the JSON config (environment.ARRAY_BACKEND)
+
+Research basis:
+- Harris et al. (2020) Array programming with NumPy
+- Okuta et al. (2017) CuPy: A NumPy-compatible library for NVIDIA GPU calculations
+- Bradbury et al. (2018) JAX: composable transformations of Python+NumPy programs
+"""
+
+import logging
+import importlib.util
+from contextlib import nullcontext
+from typing import Any, Callable, Dict, List, Optional, Union
+
+import numpy as np
+
+logger = logging.getLogger(__name__)
+
+DEFAULT_ARRAY_BACKEND = 'numpy'
+
+
+class ArrayBackend:
+    """
+    One array library as seen by the kernels.
+
+    Args:
+        name: Backend name ('numpy', 'cupy', 'jax')
+        xp: NumPy-compatible array namespace
+        to_host: Function copying an array of the backend to a NumPy array
+        immutable: Arrays cannot be written in place (JAX)
+        on_device: Arrays live in accelerator memory
+        synchronize: Function waiting for queued device work (timing)
+    """
+
+    def __init__(self, name: str, xp: Any, to_host: Callable[[Any], np.ndarray],
+                 immutable: bool = False, on_device: bool = False,
+                 synchronize: Optional[Callable[[], None]] = None):
+        self.name = name
+        self.xp = xp
+        self._to_host = to_host
+        self.immutable = immutable
+        self.on_device = on_device
+        self._synchronize = synchronize
+
+    def asarray(self, value, dtype=None):
+        """Array of this backend (host values are copied to the device)."""
+        return self.xp.asarray(value, dtype=dtype)
+
+    def to_host(self, value) -> np.ndarray:
+        """NumPy copy of an array of this backend (NumPy arrays are returned as is)."""
+        if isinstance(value, np.ndarray):
+            return value
+        return self._to_host(value)
+
+    def set(self, array, index, value):
+        """array[index] = value; returns the updated array (a new one for JAX)."""
+        if self.immutable:
+            return array.at[index].set(value)
+        array[index] = value
+        return array
+
+    def where_set(self, array, value, mask):
+        """Write value into array where mask is true; returns the updated array."""
+        if self.immutable:
+            return self.xp.where(mask, value, array).astype(array.dtype)
+        self.xp.copyto(array, value, where=mask)
+        return array
+
+    def errstate(self):
+        """Context silencing divide/invalid/overflow warnings (NumPy only warns)."""
+        if self.xp is np:
+            return np.errstate(divide='ignore', invalid='ignore', over='ignore')
+        return nullcontext()
+
+    def synchronize(self):
+        if self._synchronize is not None:
+            self._synchronize()
+
+    def __repr__(self) -> str:
+        return f"ArrayBackend({self.name!r})"
+
+
+def _numpy_backend() -> ArrayBackend:
+    return ArrayBackend('numpy', np, np.asarray)
+
+
+def _cupy_backend() -> ArrayBackend:
+    import cupy
+    return ArrayBackend('cupy', cupy, cupy.asnumpy, on_device=True,
+                        synchronize=lambda: cupy.cuda.Device().synchronize())
+
+
+def _jax_backend() -> ArrayBackend:
+    import jax
+    # Double precision, so that results match the NumPy path (process-wide)
+    if not getattr(jax.config, 'jax_enable_x64', False):
+        logger.info("Enabling jax_enable_x64 for this process (JAX array backend)")
+        jax.config.update('jax_enable_x64', True)
+    import jax.numpy as jnp
+    on_device = jax.default_backend() != 'cpu'
+    return ArrayBackend('jax', jnp, np.asarray, immutable=True, on_device=on_device,
+                        synchronize=lambda: jnp.zeros(()).block_until_ready())
+
+
+ARRAY_BACKEND_FACTORIES: Dict[str, Callable[[], ArrayBackend]] = {
+    'numpy': _numpy_backend,
+    'cupy': _cupy_backend,
+    'jax': _jax_backend,
+}
+
+# Module each backend imports (probed without importing by available_array_backends)
+ARRAY_BACKEND_MODULES: Dict[str, str] = {'numpy': 'numpy', 'cupy': 'cupy', 'jax': 'jax'}
+
+# Backends by name, built on first use
+_backends: Dict[str, ArrayBackend] = {}
+
+
+def get_array_backend(backend: Union[str, ArrayBackend, None] = None) -> ArrayBackend:
+    """
+    Shared backend by name (or the given backend itself).
+
+    None selects environment.ARRAY_BACKEND of the configuration ('numpy' if
+    unset). Raises ImportError if the backend's library is not installed.
+    """
+    if isinstance(backend, ArrayBackend):
+        return backend
+    if backend is None:
+        from .config_loader import get_config_snapshot
+        backend = get_config_snapshot().environment.get('ARRAY_BACKEND', DEFAULT_ARRAY_BACKEND)
+    name = backend.lower()
+    instance = _backends.get(name)
+    if instance is None:
+        factory = ARRAY_BACKEND_FACTORIES.get(name)
+        if factory is None:
+            raise ValueError(f"Unknown array backend {backend!r} (use one of {sorted(ARRAY_BACKEND_FACTORIES)})")
+        try:
+            instance = factory()
+        except ImportError as e:
+            raise ImportError(f"Array backend {name!r} is not available: {e}") from e
+        _backends[name] = instance
+        logger.info(f"Array backend {name} ready (device arrays: {instance.on_device})")
+    return instance
+
+
+def available_array_backends() -> List[str]:
+    """
+    Names of the backends whose libraries are installed.
+
+    Only looks the modules up (nothing is imported or built, so no device is
+    initialized and no global library flag is set); a listed backend can
+    still fail in get_array_backend, e.g. CuPy without a usable GPU.
+    """
+    return [name for name in ARRAY_BACKEND_FACTORIES
+            if name in _backends or importlib.util.find_spec(ARRAY_BACKEND_MODULES[name]) is not None]
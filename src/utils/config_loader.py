@@ -1,12 +1,31 @@
 """
 Configuration Loader for Hydroponic Simulation System
 Loads all static values from JSON configuration files
+
+Besides the mutable SimulationConfig, every load produces a ConfigSnapshot:
+a frozen, slotted view of the same sections that models receive once at
+construction instead of going through get_config_loader() on every call.
+Validation results are kept per SHA-256 of the config file, so reloading
+an unchanged file (a worker process, reload_config()) skips validation.
+Parsing itself is not cached: the file parses in well under a millisecond,
+less than reading a cache back would take.
+
+with_overrides() and config_overrides() derive in-memory variants of a
+loaded file (one per sensitivity sample, say) with their own hash.
 """
 
+import copy
+import hashlib
 import json
+import logging
+from collections.abc import Mapping
+from contextlib import contextmanager
+from dataclasses import dataclass, fields
 from pathlib import Path
-from typing import Dict, Any, Optional
-from dataclasses import dataclass
+from types import MappingProxyType
+from typing import Dict, Any, Iterator, Optional, Tuple, Union
+
+logger = logging.getLogger(__name__)
 
 
 @dataclass
@@ -28,6 +47,140 @@ class SimulationConfig:
     genetics: Dict[str, Any]
 
 
+SECTION_NAMES = tuple(f.name for f in fields(SimulationConfig))
+
+
+def _freeze(value: Any) -> Any:
+    """Read-only copy of nested config values."""
+    if isinstance(value, dict):
+        return MappingProxyType({key: _freeze(item) for key, item in value.items()})
+    if isinstance(value, list):
+        return tuple(_freeze(item) for item in value)
+    return value
+
+
+def _thaw(value: Any) -> Any:
+    if isinstance(value, Mapping):
+        return {key: _thaw(item) for key, item in value.items()}
+    if isinstance(value, tuple):
+        return [_thaw(item) for item in value]
+    return value
+
+
+class ConfigSection(Mapping):
+    """
+    Frozen config section with attribute access (section.PLANT_DENSITY).
+
+    Each section gets its own subclass whose __slots__ are the section's keys,
+    so lookups are slot reads. The Mapping interface (get, [], keys, items)
+    keeps it a drop-in for the dicts returned by ConfigLoader. Keys that are
+    not identifiers are still reachable through the mapping interface.
+    """
+    __slots__ = ('_extra',)
+    _fields: Tuple[str, ...] = ()
+    _section: str = ''
+
+    def __getattr__(self, name: str) -> Any:
+        # Only reached for names that are not slots
+        raise AttributeError(f"Config section '{self._section}' has no key {name!r}")
+
+    def __setattr__(self, name: str, value: Any):
+        raise AttributeError(f"Config section '{self._section}' is read-only")
+
+    def __delattr__(self, name: str):
+        raise AttributeError(f"Config section '{self._section}' is read-only")
+
+    def __getitem__(self, key: str) -> Any:
+        if key in self._fields:
+            return getattr(self, key)
+        return self._extra[key]
+
+    def get(self, key: str, default: Any = None) -> Any:
+        if key in self._fields:
+            return getattr(self, key)
+        return self._extra.get(key, default)
+
+    def __contains__(self, key: object) -> bool:
+        return key in self._fields or key in self._extra
+
+    def __iter__(self) -> Iterator[str]:
+        yield from self._fields
+        yield from self._extra
+
+    def __len__(self) -> int:
+        return len(self._fields) + len(self._extra)
+
+    def to_dict(self) -> Dict[str, Any]:
+        """Mutable deep copy of the section."""
+        return {key: _thaw(value) for key, value in self.items()}
+
+    def __reduce__(self):
+        return (make_config_section, (self._section, self.to_dict()))
+
+    def __repr__(self) -> str:
+        return f"ConfigSection({self._section!r}, {len(self)} keys)"
+
+
+_SECTION_CLASSES: Dict[Tuple[str, Tuple[str, ...]], type] = {}
+
+
+def make_config_section(name: str, values: Dict[str, Any]) -> ConfigSection:
+    """Frozen section for one config group (classes are reused per key set)."""
+    keys = tuple(key for key in values if isinstance(key, str) and key.isidentifier()
+                 and not key.startswith('_') and not hasattr(ConfigSection, key))
+    cls = _SECTION_CLASSES.get((name, keys))
+    if cls is None:
+        class_name = ''.join(part.capitalize() for part in name.split('_')) + 'Section'
+        cls = type(class_name, (ConfigSection,), {'__slots__': keys, '_fields': keys, '_section': name})
+        _SECTION_CLASSES[(name, keys)] = cls
+    section = object.__new__(cls)
+    for key in keys:
+        object.__setattr__(section, key, _freeze(values[key]))
+    object.__setattr__(section, '_extra', MappingProxyType(
+        {key: _freeze(value) for key, value in values.items() if key not in keys}))
+    return section
+
+
+class ConfigSnapshot:
+    """
+    Frozen, typed view of a whole configuration file.
+
+    Built once per load; models take it at construction and keep the section
+    they need (snapshot.genetics, snapshot.canopy, ...). It pickles small, so
+    it can be handed to worker processes.
+    """
+    __slots__ = SECTION_NAMES + ('config_path', 'source_hash', 'validation_issues')
+
+    def __init__(self, config_data: Dict[str, Any], config_path: Optional[Path] = None,
+                 source_hash: str = '', validation_issues: Optional[Dict[str, list]] = None):
+        for name in SECTION_NAMES:
+            object.__setattr__(self, name, make_config_section(name, config_data.get(name, {})))
+        object.__setattr__(self, 'config_path', str(config_path) if config_path else None)
+        object.__setattr__(self, 'source_hash', source_hash)
+        object.__setattr__(self, 'validation_issues', _freeze(validation_issues or {}))
+
+    def __setattr__(self, name: str, value: Any):
+        raise AttributeError("ConfigSnapshot is read-only")
+
+    def section(self, name: str) -> ConfigSection:
+        return getattr(self, name)
+
+    def to_dict(self) -> Dict[str, Dict[str, Any]]:
+        return {name: getattr(self, name).to_dict() for name in SECTION_NAMES}
+
+    def __reduce__(self):
+        return (ConfigSnapshot, (self.to_dict(), self.config_path, self.source_hash,
+                                 _thaw(self.validation_issues)))
+
+    def __repr__(self) -> str:
+        return f"ConfigSnapshot({self.config_path!r}, sha256={self.source_hash[:12]})"
+
+
+# Validation results per config file hash, shared by every loader in the
+# process (and inherited by forked batch workers)
+_VALIDATION_RESULTS: Dict[str, Dict[str, list]] = {}
+
+
 class ConfigLoader:
     """Loads and manages configuration from JSON files."""
     
@@ -40,35 +193,91 @@ class ConfigLoader:
             self.config_path = default_root
         
         self.config: Optional[SimulationConfig] = None
+        self.snapshot: Optional[ConfigSnapshot] = None
+        self.source_hash = ''
+        self.from_cache = False
+        self._validation_issues: Optional[Dict[str, list]] = None
         self._load_config()
     
     def _load_config(self):
         """Load configuration from JSON file using unified canonical schema."""
         try:
-            with open(self.config_path, 'r') as f:
-                config_data = json.load(f)
-
-            # Directly map canonical schema to SimulationConfig
-            self.config = SimulationConfig(
-                physical=config_data.get('physical', {}),
-                conversion=config_data.get('conversion', {}),
-                physiology=config_data.get('physiology', {}),
-                environment=config_data.get('environment', {}),
-                growth=config_data.get('growth', {}),
-                canopy=config_data.get('canopy', {}),
-                water=config_data.get('water', {}),
-                nutrients=config_data.get('nutrients', {}),
-                stress=config_data.get('stress', {}),
-                roots=config_data.get('roots', {}),
-                phenology=config_data.get('phenology', {}),
-                photosynthesis=config_data.get('photosynthesis', {}),
-                system=config_data.get('system', {}),
-                genetics=config_data.get('genetics', {})
-            )
+            raw = self.config_path.read_bytes()
         except FileNotFoundError:
             raise FileNotFoundError(f"Configuration file not found: {self.config_path}")
-        except json.JSONDecodeError as e:
+
+        self.source_hash = hashlib.sha256(raw).hexdigest()
+        try:
+            config_data = json.loads(raw.decode('utf-8'))
+        except (json.JSONDecodeError, UnicodeDecodeError) as e:
             raise ValueError(f"Invalid JSON in configuration file: {e}")
+
+        self._build_config(config_data)
+        cached = _VALIDATION_RESULTS.get(self.source_hash)
+        self.from_cache = cached is not None
+        if cached is None:
+            cached = _VALIDATION_RESULTS[self.source_hash] = self._check_config()
+        self._validation_issues = copy.deepcopy(cached)
+        self.snapshot = ConfigSnapshot(config_data, self.config_path, self.source_hash,
+                                       self._validation_issues)
+
+    def with_overrides(self, overrides: Union[Mapping, Tuple[Tuple[str, Any], ...]]) -> 'ConfigLoader':
+        """
+        In-memory copy of this configuration with entries replaced.
+
+        Overrides map dotted paths ('section.KEY' or 'section.KEY.SUBKEY') to
+        values; every path must name an existing entry. The copy gets its own
+        source hash (derived from this file's hash and the overrides), so
+        prototype and worker simulator caches keep it apart from the file.
+        """
+        items = tuple(sorted(dict(overrides).items()))
+        if not items:
+            return self
+        config_data = self.snapshot.to_dict()
+        for path, value in items:
+            section, *keys = path.split('.')
+            if section not in SECTION_NAMES or not keys:
+                raise KeyError(f"Config override {path!r} does not name a 'section.KEY' entry")
+            node = config_data[section]
+            for key in keys[:-1]:
+                node = node.get(key) if isinstance(node, dict) else None
+                if not isinstance(node, dict):
+                    raise KeyError(f"Config override {path!r}: no subsection {key!r}")
+            if keys[-1] not in node:
+                raise KeyError(f"Config override {path!r}: no entry {keys[-1]!r}")
+            node[keys[-1]] = value
+
+        derived = ConfigLoader.__new__(ConfigLoader)
+        derived.config_path = self.config_path
+        derived.source_hash = hashlib.sha256(
+            (self.source_hash + json.dumps(items, default=str)).encode('utf-8')).hexdigest()
+        derived.from_cache = False
+        derived._build_config(config_data)
+        derived._validation_issues = derived._check_config()
+        derived.snapshot = ConfigSnapshot(config_data, derived.config_path, derived.source_hash,
+                                          derived._validation_issues)
+        return derived
+
+    def _build_config(self, config_data: Dict[str, Any]):
+        # Directly map canonical schema to SimulationConfig (sections copied so
+        # callers mutating them cannot alter the snapshot)
+        config_data = copy.deepcopy(config_data)
+        self.config = SimulationConfig(
+            physical=config_data.get('physical', {}),
+            conversion=config_data.get('conversion', {}),
+            physiology=config_data.get('physiology', {}),
+            environment=config_data.get('environment', {}),
+            growth=config_data.get('growth', {}),
+            canopy=config_data.get('canopy', {}),
+            water=config_data.get('water', {}),
+            nutrients=config_data.get('nutrients', {}),
+            stress=config_data.get('stress', {}),
+            roots=config_data.get('roots', {}),
+            phenology=config_data.get('phenology', {}),
+            photosynthesis=config_data.get('photosynthesis', {}),
+            system=config_data.get('system', {}),
+            genetics=config_data.get('genetics', {})
+        )
     
     def get_system_config(self) -> Dict[str, Any]:
         """Get system configuration."""
@@ -224,7 +433,12 @@ class ConfigLoader:
         self._load_config()
     
     def validate_config(self) -> Dict[str, list]:
-        """Validate configuration and return any issues."""
+        """Validate configuration and return any issues (computed once per file version)."""
+        if self._validation_issues is None:
+            self._validation_issues = self._check_config()
+        return {section: list(problems) for section, problems in self._validation_issues.items()}
+
+    def _check_config(self) -> Dict[str, list]:
         issues = {}
         
         if not self.config:
@@ -262,6 +476,24 @@ def get_config_loader(config_path: Optional[str] = None) -> ConfigLoader:
     return _config_loader
 
 
+@contextmanager
+def config_overrides(overrides: Union[Mapping, Tuple[Tuple[str, Any], ...]]):
+    """
+    Make a derived configuration (ConfigLoader.with_overrides) the global one.
+
+    Simulators and parameter objects built inside the block see the
+    overridden values; the previous loader is restored on exit. Yields the
+    derived snapshot.
+    """
+    global _config_loader
+    base = get_config_loader()
+    _config_loader = base.with_overrides(overrides)
+    try:
+        yield _config_loader.snapshot
+    finally:
+        _config_loader = base
+
+
 def get_config() -> SimulationConfig:
     """Get the current configuration."""
     loader = get_config_loader()
@@ -270,6 +502,11 @@ def get_config() -> SimulationConfig:
     return loader.config
 
 
+def get_config_snapshot(config_path: Optional[str] = None) -> ConfigSnapshot:
+    """Frozen snapshot of the current (or given) configuration file."""
+    return get_config_loader(config_path).snapshot
+
+
 # Convenience functions for accessing common configuration values
 def get_default_value(key: str, default: Any = None) -> Any:
     """Get a default system value from configuration."""
@@ -0,0 +1,120 @@
+"""
+Structured Diagnostics for the Simulation Loop
+Leveled, lazily evaluated run events and sampled consistency checks.
+
+The simulator reports through emit(level, event, **fields) instead of
+formatting log messages eagerly. Events above the configured level return
+after one integer comparison; fields may be zero-argument callables (e.g.
+a sum over the biomass pools), which are only called for emitted events.
+Emitted events are kept as DiagnosticEvent records (bounded buffer, attached
+to the results) and logged with lazy %-style formatting, so a logger that
+filters the record never builds the message string.
+
+Levels:
+- off:     nothing (batch production runs)
+- summary: run start and completion, maturity
+- events:  plus weekly solution changes, periodic progress and failed checks
+- debug:   plus per-nutrient detail of solution changes
+
+Consistency checks (carbon balance) run on every check_interval-th day at
+level events and above; check_interval 0 disables them.
+"""
+
+import logging
+from collections import deque
+from dataclasses import dataclass, field
+from typing import Any, Deque, Dict, List, Optional
+
+OFF = 0
+SUMMARY = 1
+EVENTS = 2
+DEBUG = 3
+
+DIAGNOSTICS_LEVELS = {'off': OFF, 'summary': SUMMARY, 'events': EVENTS, 'debug': DEBUG}
+
+# Events kept per run (oldest dropped first)
+DEFAULT_EVENT_CAPACITY = 4096
+
+
+def diagnostics_level(level) -> int:
+    """Numeric level of a level name (or number)."""
+    if isinstance(level, str):
+        try:
+            return DIAGNOSTICS_LEVELS[level.lower()]
+        except KeyError:
+            raise ValueError(f"Unknown diagnostics level {level!r} (use one of {list(DIAGNOSTICS_LEVELS)})")
+    return max(OFF, min(DEBUG, int(level)))
+
+
+@dataclass
+class DiagnosticEvent:
+    """One emitted run event."""
+    event: str
+    day: Optional[int] = None
+    severity: int = logging.INFO
+    fields: Dict[str, Any] = field(default_factory=dict)
+
+    def to_dict(self) -> Dict[str, Any]:
+        return {'event': self.event, 'day': self.day,
+                'severity': logging.getLevelName(self.severity), **self.fields}
+
+    def __str__(self) -> str:
+        prefix = f"Day {self.day}: {self.event}" if self.day is not None else self.event
+        details = ", ".join(f"{key}={_format_value(value)}" for key, value in self.fields.items())
+        return f"{prefix} ({details})" if details else prefix
+
+
+def _format_value(value: Any) -> str:
+    return f"{value:.3f}" if isinstance(value, float) else str(value)
+
+
+class DiagnosticsRecorder:
+    """
+    Leveled event sink and check sampler of one simulator.
+
+    Args:
+        level: Level name ('off', 'summary', 'events', 'debug') or number
+        check_interval: Run consistency checks every N-th day (0: never)
+        logger_name: Logger the events are written to
+        capacity: Events kept per run
+    """
+
+    def __init__(self, level='events', check_interval: int = 1,
+                 logger_name: str = __name__, capacity: int = DEFAULT_EVENT_CAPACITY):
+        self.level = diagnostics_level(level)
+        self.check_interval = max(0, int(check_interval))
+        self.logger_name = logger_name
+        self.capacity = capacity
+        self.reset()
+
+    def reset(self):
+        self.events: Deque[DiagnosticEvent] = deque(maxlen=self.capacity)
+        self.checks_run = 0
+
+    def enabled(self, level: int) -> bool:
+        return level <= self.level
+
+    def emit(self, level: int, event: str, day: Optional[int] = None,
+             severity: int = logging.INFO, **fields):
+        """Record and log an event if its level is enabled; callable fields are evaluated here."""
+        if level > self.level:
+            return
+        for key, value in fields.items():
+            if callable(value):
+                fields[key] = value()
+        record = DiagnosticEvent(event, day, severity, fields)
+        self.events.append(record)
+        logger = logging.getLogger(self.logger_name)
+        if logger.isEnabledFor(severity):
+            logger.log(severity, "%s", record)
+
+    def should_check(self, day: int) -> bool:
+        """Whether the consistency checks run on a day (counted when they do)."""
+        if self.level < EVENTS or not self.check_interval or day % self.check_interval:
+            return False
+        self.checks_run += 1
+        return True
+
+    def report(self) -> List[Dict[str, Any]]:
+        """Emitted events of the run as plain dicts."""
+        return [event.to_dict() for event in self.events]
@@ -0,0 +1,200 @@
+"""
+Diurnal Profiles for Sub-Daily Simulation
+Builds hourly PAR, temperature, humidity and VPD curves from daily weather and
+caches them, so the hourly timestep mode evaluates each weather day's shape
+once and reuses it across the photosynthesis, transpiration and environmental
+control kernels.
+"""
+
+import math
+from dataclasses import dataclass
+from typing import Dict, Optional, Tuple
+
+import numpy as np
+
+from ..data.hydroponic_system import WeatherData
+
+
+HOURS_PER_DAY = 24
+HOUR_CENTERS = np.arange(HOURS_PER_DAY, dtype=float) + 0.5
+
+# Light schedule shapes
+LIGHT_SHAPE_SINE = "sine"      # Natural/sun-like half sine over the photoperiod
+LIGHT_SHAPE_SQUARE = "square"  # LED schedule: constant intensity while lights are on
+
+
+@dataclass(frozen=True)
+class DiurnalProfile:
+    """Hourly environmental curves for one weather day (arrays of length 24)."""
+    photoperiod: float             # Light period (h)
+    light_fraction: np.ndarray     # Fraction of each hour with lights on (0-1)
+    par: np.ndarray                # Hourly mean PPFD (μmol/m²/s)
+    solar_radiation: np.ndarray    # Daily-equivalent solar rate per hour (MJ/m²/day)
+    temperature: np.ndarray        # Air temperature (°C)
+    humidity: np.ndarray           # Relative humidity (%)
+    vpd: np.ndarray                # Vapor pressure deficit (kPa)
+
+    @property
+    def light_on(self) -> np.ndarray:
+        """Hours with any light."""
+        return self.light_fraction > 0.0
+
+    @property
+    def mean_temperature(self) -> float:
+        return float(self.temperature.mean())
+
+    @property
+    def mean_humidity(self) -> float:
+        return float(self.humidity.mean())
+
+
+def seasonal_daylength_table(max_days: int) -> np.ndarray:
+    """Seasonal photoperiod (h) for days 1..max_days, indexed by day - 1."""
+    days = np.arange(1, max_days + 1, dtype=float)
+    return 13.5 + 1.5 * np.sin(days * 2 * np.pi / 365)
+
+
+def _light_window_fraction(photoperiod: float, center_hour: float = 12.0) -> np.ndarray:
+    """Overlap of each clock hour with a photoperiod centered at center_hour."""
+    photoperiod = max(0.0, min(float(HOURS_PER_DAY), photoperiod))
+    start = center_hour - photoperiod / 2.0
+    end = center_hour + photoperiod / 2.0
+    hour_start = HOUR_CENTERS - 0.5
+    overlap = np.minimum(hour_start + 1.0, end) - np.maximum(hour_start, start)
+    return np.clip(overlap, 0.0, 1.0)
+
+
+def build_light_curves(photoperiod: float,
+                       light_shape: str = LIGHT_SHAPE_SINE) -> Tuple[np.ndarray, np.ndarray]:
+    """
+    Hourly light-window fractions and normalized light weights for a photoperiod.
+
+    The weights sum to 1 over the day (or are all zero without light), so the
+    hourly PAR of a day is daily PPFD * photoperiod * weights.
+    """
+    light_fraction = _light_window_fraction(photoperiod)
+    if light_shape == LIGHT_SHAPE_SQUARE:
+        shape = light_fraction.copy()
+    elif light_shape == LIGHT_SHAPE_SINE:
+        if photoperiod > 0:
+            phase = (HOUR_CENTERS - (12.0 - photoperiod / 2.0)) / photoperiod
+            shape = np.sin(np.pi * np.clip(phase, 0.0, 1.0)) * light_fraction
+        else:
+            shape = np.zeros(HOURS_PER_DAY)
+    else:
+        raise ValueError(f"Unknown light shape '{light_shape}' (use 'sine' or 'square')")
+
+    shape_total = shape.sum()
+    weights = shape / shape_total if shape_total > 0 else np.zeros(HOURS_PER_DAY)
+    return light_fraction, weights
+
+
+def build_thermal_curves(weather: WeatherData,
+                         peak_temperature_hour: float = 14.0) -> Tuple[np.ndarray, np.ndarray, np.ndarray]:
+    """
+    Hourly temperature, relative humidity and VPD for one weather day.
+
+    Temperature follows a cosine between temp_min and temp_max peaking at
+    peak_temperature_hour; actual vapor pressure is held at its daily mean so
+    humidity and VPD respond to the temperature cycle.
+    """
+    temp_min = getattr(weather, 'temp_min', weather.temp_avg)
+    temp_max = getattr(weather, 'temp_max', weather.temp_avg)
+    amplitude = max(0.0, temp_max - temp_min) / 2.0
+    temperature = weather.temp_avg + amplitude * np.cos(
+        2 * np.pi * (HOUR_CENTERS - peak_temperature_hour) / HOURS_PER_DAY)
+
+    es_mean = 0.6108 * math.exp(17.27 * weather.temp_avg / (weather.temp_avg + 237.3))
+    ea = es_mean * weather.rel_humidity / 100.0
+    es = 0.6108 * np.exp(17.27 * temperature / (temperature + 237.3))
+    humidity = np.clip(ea / es * 100.0, 0.0, 100.0)
+    vpd = np.maximum(0.0, es - es * humidity / 100.0)
+    return temperature, humidity, vpd
+
+
+def build_diurnal_profile(weather: WeatherData, photoperiod: float,
+                          light_shape: str = LIGHT_SHAPE_SINE,
+                          peak_temperature_hour: float = 14.0) -> DiurnalProfile:
+    """
+    Build hourly curves for one weather day.
+
+    PAR is distributed over the photoperiod so that its integral equals the
+    daily-mode value (solar_radiation * 45 held for `photoperiod` hours).
+    """
+    light_fraction, weights = build_light_curves(photoperiod, light_shape)
+    temperature, humidity, vpd = build_thermal_curves(weather, peak_temperature_hour)
+    return _assemble_profile(weather, photoperiod, light_fraction, weights, temperature, humidity, vpd)
+
+
+def _assemble_profile(weather: WeatherData, photoperiod: float, light_fraction: np.ndarray,
+                      weights: np.ndarray, temperature: np.ndarray, humidity: np.ndarray,
+                      vpd: np.ndarray) -> DiurnalProfile:
+    par = weather.solar_radiation * 45.0 * max(0.0, photoperiod) * weights
+    solar = weather.solar_radiation * HOURS_PER_DAY * weights
+    for array in (light_fraction, par, solar, temperature, humidity, vpd):
+        array.setflags(write=False)
+    return DiurnalProfile(
+        photoperiod=float(photoperiod),
+        light_fraction=light_fraction,
+        par=par,
+        solar_radiation=solar,
+        temperature=temperature,
+        humidity=humidity,
+        vpd=vpd
+    )
+
+
+class DiurnalProfileCache:
+    """
+    Cache of diurnal curves for the hourly timestep.
+
+    Temperature/humidity/VPD curves are cached per weather day (reused when a
+    weather series is cycled) and light curves per photoperiod, so each shape
+    is evaluated once and shared by every model run inside the day.
+    """
+
+    def __init__(self, light_shape: str = LIGHT_SHAPE_SINE, max_entries: Optional[int] = 4096):
+        if light_shape not in (LIGHT_SHAPE_SINE, LIGHT_SHAPE_SQUARE):
+            raise ValueError(f"Unknown light shape '{light_shape}' (use 'sine' or 'square')")
+        self.light_shape = light_shape
+        self.max_entries = max_entries
+        self._thermal: Dict[int, Tuple[np.ndarray, np.ndarray, np.ndarray]] = {}
+        self._light: Dict[float, Tuple[np.ndarray, np.ndarray]] = {}
+        self._profiles: Dict[Tuple[int, float], DiurnalProfile] = {}
+        self.hits = 0
+        self.misses = 0
+
+    def get_profile(self, weather_index: int, weather: WeatherData, photoperiod: float) -> DiurnalProfile:
+        """Return the profile for a weather day, building missing curves on first use."""
+        photoperiod = float(photoperiod)
+        key = (weather_index, photoperiod)
+        profile = self._profiles.get(key)
+        if profile is not None:
+            self.hits += 1
+            return profile
+        self.misses += 1
+
+        thermal = self._thermal.get(weather_index)
+        if thermal is None:
+            thermal = build_thermal_curves(weather)
+            self._store(self._thermal, weather_index, thermal)
+        light = self._light.get(photoperiod)
+        if light is None:
+            light = build_light_curves(photoperiod, self.light_shape)
+            self._store(self._light, photoperiod, light)
+
+        profile = _assemble_profile(weather, photoperiod, light[0].copy(), light[1], *thermal)
+        self._store(self._profiles, key, profile)
+        return profile
+
+    def _store(self, table: Dict, key, value):
+        if self.max_entries is not None and len(table) >= self.max_entries:
+            table.pop(next(iter(table)))
+        table[key] = value
+
+    def clear(self):
+        self._thermal.clear()
+        self._light.clear()
+        self._profiles.clear()
+        self.hits = 0
+        self.misses = 0
@@ -0,0 +1,162 @@
+"""
+Temperature Response Tables
+Precomputed, linearly interpolated tables of one-variable response curves
+(Arrhenius, Q10, cardinal-temperature thermal time, stress ramps, RZT factors).
+
+A table is built once per (curve, parameter set, range) by sampling the exact
+formula on a uniform grid and is shared by every model in the process.
+Lookups accept scalars or arrays; inputs outside the tabulated range fall back
+to the exact formula, so tables never extrapolate.
+
+Error bound:
+    Linear interpolation with grid step h differs from the exact curve f by at
+    most h²/8 · max|f''| on smooth segments, and by at most h · |Δf'| / 4 where
+    the slope jumps by Δf' inside a grid interval (kinks of piecewise curves;
+    kinks that fall on grid nodes, such as whole-degree cardinal temperatures,
+    are reproduced to rounding error). With the default step of 0.01 °C the
+    Arrhenius and Q10 curves of the models stay within 2e-7 relative error.
+    Every table also measures its error against the exact formula on a grid
+    four times finer when it is built and reports it as max_abs_error.
+"""
+
+import logging
+from dataclasses import dataclass
+from typing import Any, Callable, Dict, Hashable, Optional, TYPE_CHECKING
+
+import numpy as np
+
+if TYPE_CHECKING:
+    from .config_loader import ConfigSnapshot
+
+logger = logging.getLogger(__name__)
+
+
+@dataclass(frozen=True)
+class TableRange:
+    """Tabulated input range and grid step."""
+    t_min: float = -10.0       # °C
+    t_max: float = 50.0        # °C
+    step: float = 0.01         # °C
+
+    def shifted(self, offset: float, margin: float = 0.0) -> 'TableRange':
+        """Range of a derived input such as temperature - reference."""
+        return TableRange(self.t_min + offset - margin, self.t_max + offset + margin, self.step)
+
+
+DEFAULT_TABLE_RANGE = TableRange()
+
+
+def configured_table_range(config: Optional['ConfigSnapshot'] = None) -> TableRange:
+    """Table range from the environment section of the configuration."""
+    try:
+        from .config_loader import get_config_snapshot
+        environment = (config or get_config_snapshot()).environment.to_dict()
+    except Exception:
+        return DEFAULT_TABLE_RANGE
+    return TableRange(
+        t_min=float(environment.get('RESPONSE_TABLE_TEMP_MIN', DEFAULT_TABLE_RANGE.t_min)),
+        t_max=float(environment.get('RESPONSE_TABLE_TEMP_MAX', DEFAULT_TABLE_RANGE.t_max)),
+        step=float(environment.get('RESPONSE_TABLE_STEP', DEFAULT_TABLE_RANGE.step))
+    )
+
+
+class ResponseTable:
+    """
+    Interpolated table of a scalar response curve.
+
+    Tables are immutable: copies share the instance, and pickles resolve to
+    the process's shared table of the same curve (see response_table).
+
+    Args:
+        func: Exact curve, called with one float
+        table_range: Range and grid step to tabulate
+        name: Curve name
+        parameters: Parameter key of the curve
+    """
+
+    def __init__(self, func: Callable[[float], float], table_range: TableRange = DEFAULT_TABLE_RANGE,
+                 name: str = "", parameters: Hashable = ()):
+        if table_range.t_max <= table_range.t_min or table_range.step <= 0:
+            raise ValueError(f"Invalid response table range {table_range}")
+        self.func = func
+        self.name = name
+        self.parameters = parameters
+        self.range = table_range
+        self.t_min = table_range.t_min
+        self.step = table_range.step
+        n_points = int(round((table_range.t_max - table_range.t_min) / table_range.step)) + 1
+        self.t_max = self.t_min + (n_points - 1) * self.step
+        self.grid = self.t_min + self.step * np.arange(n_points)
+        self.values = self._exact(self.grid)
+        self._last = n_points - 1
+        self._value_list = self.values.tolist()
+        self.max_abs_error = self._measure_error()
+
+    def _exact(self, x: np.ndarray) -> np.ndarray:
+        return np.fromiter((self.func(float(t)) for t in x), dtype=float, count=len(x))
+
+    def _measure_error(self, subdivisions: int = 4) -> float:
+        check = np.linspace(self.t_min, self.t_max, self._last * subdivisions + 1)
+        return float(np.max(np.abs(np.interp(check, self.grid, self.values) - self._exact(check))))
+
+    def __call__(self, x):
+        if np.ndim(x) == 0:
+            t = float(x)
+            if not self.t_min <= t <= self.t_max:
+                return self.func(t)
+            position = (t - self.t_min) / self.step
+            i = min(int(position), self._last - 1)
+            fraction = position - i
+            low = self._value_list[i]
+            return low + (self._value_list[i + 1] - low) * fraction
+
+        x = np.asarray(x, dtype=float)
+        result = np.interp(x, self.grid, self.values)
+        outside = (x < self.t_min) | (x > self.t_max)
+        if outside.any():
+            result[outside] = self._exact(x[outside])
+        return result
+
+    def __deepcopy__(self, memo):
+        return self
+
+    def __reduce__(self):
+        return (response_table, (self.name, self.parameters, self.func, self.range))
+
+    def __repr__(self) -> str:
+        return (f"ResponseTable([{self.t_min:g}, {self.t_max:g}] step {self.step:g}, "
+                f"max_abs_error={self.max_abs_error:.2e})")
+
+
+# Tables by (curve name, parameter key, range), built on first use
+_response_tables: Dict[Hashable, ResponseTable] = {}
+
+
+def response_table(name: str, parameters: Hashable, func: Callable[[float], float],
+                   table_range: TableRange = DEFAULT_TABLE_RANGE) -> ResponseTable:
+    """
+    Shared table of a curve for one parameter set.
+
+    Args:
+        name: Curve name (e.g. "phenology.thermal_time")
+        parameters: Hashable tuple of every parameter the curve depends on
+        func: Exact curve for that parameter set
+        table_range: Range and grid step
+    """
+    key = (name, parameters, table_range)
+    table = _response_tables.get(key)
+    if table is None:
+        table = ResponseTable(func, table_range, name, parameters)
+        _response_tables[key] = table
+        logger.debug("Built response table %s %s: %r", name, parameters, table)
+    return table
+
+
+def response_table_info() -> Dict[str, Any]:
+    """Number of tables built and the largest measured error among them."""
+    errors = [table.max_abs_error for table in _response_tables.values()]
+    return {'tables': len(errors), 'max_abs_error': max(errors) if errors else 0.0}
+
+
+def clear_response_tables():
+    _response_tables.clear()
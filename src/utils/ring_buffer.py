@@ -0,0 +1,67 @@
+"""
+Fixed-Size Ring Buffer
+Rolling history of the last N daily values without re-slicing a list.
+
+append() overwrites the oldest entry once the buffer is full, so keeping a
+7-day stress memory costs one array write per day. values() returns the
+history oldest-first, which is what the weighted-memory calculations of the
+stress and senescence models expect. Rows may be scalars (width=None) or
+fixed-width records such as (stress level, temperature).
+"""
+
+from typing import Iterator, Optional
+
+import numpy as np
+
+
+class RingBuffer:
+    """
+    Last `capacity` values, oldest first.
+
+    Args:
+        capacity: Number of values kept
+        width: Values per entry (None for scalar entries)
+    """
+
+    def __init__(self, capacity: int, width: Optional[int] = None):
+        if capacity < 1:
+            raise ValueError("Ring buffer capacity must be positive")
+        shape = (capacity,) if width is None else (capacity, width)
+        self._data = np.zeros(shape)
+        self._start = 0
+        self._count = 0
+
+    @property
+    def capacity(self) -> int:
+        return len(self._data)
+
+    def __len__(self) -> int:
+        return self._count
+
+    def append(self, value):
+        end = (self._start + self._count) % self.capacity
+        self._data[end] = value
+        if self._count < self.capacity:
+            self._count += 1
+        else:
+            self._start = (self._start + 1) % self.capacity
+
+    def values(self) -> np.ndarray:
+        """Chronological copy of the stored values."""
+        index = (self._start + np.arange(self._count)) % self.capacity
+        return self._data[index]
+
+    def last(self):
+        if not self._count:
+            raise IndexError("empty ring buffer")
+        return self._data[(self._start + self._count - 1) % self.capacity]
+
+    def clear(self):
+        self._start = 0
+        self._count = 0
+
+    def __iter__(self) -> Iterator:
+        return iter(self.values())
+
+    def __repr__(self) -> str:
+        return f"RingBuffer({self._count}/{self.capacity})"
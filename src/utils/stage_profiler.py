@@ -0,0 +1,133 @@
+"""
+Stage Profiler for the Daily Simulation Step
+Lap-timer instrumentation of the sub-models called by _simulate_daily_step.
+
+Each simulated day is one "step": begin_step() starts the clock and every
+lap(stage) charges the time since the previous lap to that stage, so the
+timers follow the linear data flow of the daily step without wrapping code
+blocks. Totals, call counts and min/max per stage accumulate over a run.
+
+Disabled profilers return from begin_step()/lap() after a single attribute
+check, and sample_interval > 1 times only every N-th step, so the profiler can
+stay on for production sampling.
+"""
+
+import time
+from dataclasses import dataclass, asdict
+from typing import Any, Dict, Optional
+
+
+@dataclass
+class StageTiming:
+    """Accumulated timing of one stage."""
+    calls: int = 0
+    total_seconds: float = 0.0
+    min_seconds: float = float('inf')
+    max_seconds: float = 0.0
+
+    def add(self, seconds: float):
+        self.calls += 1
+        self.total_seconds += seconds
+        if seconds < self.min_seconds:
+            self.min_seconds = seconds
+        if seconds > self.max_seconds:
+            self.max_seconds = seconds
+
+    @property
+    def mean_seconds(self) -> float:
+        return self.total_seconds / self.calls if self.calls else 0.0
+
+
+class StageProfiler:
+    """Per-stage timers and call counts for the daily simulation step."""
+
+    STEP_TOTAL = 'daily_step_total'
+
+    def __init__(self, enabled: bool = False, sample_interval: int = 1):
+        self.enabled = enabled
+        self.sample_interval = max(1, int(sample_interval))
+        self.reset()
+
+    def reset(self):
+        self.stages: Dict[str, StageTiming] = {}
+        self.steps_seen = 0
+        self.steps_sampled = 0
+        self._active = False
+        self._step_start = 0.0
+        self._last = 0.0
+
+    def begin_step(self):
+        """Start timing a step (only on sampled steps)."""
+        if not self.enabled:
+            return
+        self.steps_seen += 1
+        self._active = (self.steps_seen - 1) % self.sample_interval == 0
+        if self._active:
+            self.steps_sampled += 1
+            self._step_start = self._last = time.perf_counter()
+
+    def lap(self, stage: str):
+        """Charge the time since the previous lap to `stage`."""
+        if not self._active:
+            return
+        now = time.perf_counter()
+        timing = self.stages.get(stage)
+        if timing is None:
+            timing = self.stages[stage] = StageTiming()
+        timing.add(now - self._last)
+        self._last = now
+
+    def end_step(self):
+        """Close the current step and record its total time."""
+        if not self._active:
+            return
+        self._active = False
+        timing = self.stages.get(self.STEP_TOTAL)
+        if timing is None:
+            timing = self.stages[self.STEP_TOTAL] = StageTiming()
+        timing.add(time.perf_counter() - self._step_start)
+
+    def report(self) -> Dict[str, Any]:
+        """Machine-readable breakdown (JSON-serializable)."""
+        step_total = self.stages.get(self.STEP_TOTAL)
+        step_seconds = step_total.total_seconds if step_total else 0.0
+        stages = {}
+        for name, timing in self.stages.items():
+            entry = asdict(timing)
+            if not timing.calls:
+                entry['min_seconds'] = 0.0
+            entry['mean_seconds'] = timing.mean_seconds
+            entry['share_of_step'] = timing.total_seconds / step_seconds if step_seconds > 0 else 0.0
+            stages[name] = entry
+        return {
+            'enabled': self.enabled,
+            'sample_interval': self.sample_interval,
+            'steps_seen': self.steps_seen,
+            'steps_sampled': self.steps_sampled,
+            'step_seconds_total': step_seconds,
+            'stages': stages
+        }
+
+    def format_table(self, report: Optional[Dict[str, Any]] = None) -> str:
+        """Breakdown table sorted by total time."""
+        report = report or self.report()
+        lines = [
+            f"Daily step profile ({report['steps_sampled']} of {report['steps_seen']} steps sampled)",
+            f"{'Stage':<24} {'Calls':>7} {'Total (ms)':>12} {'Mean (µs)':>11} {'Max (µs)':>10} {'Share':>7}",
+            "-" * 76
+        ]
+        stages = report['stages']
+        ordered = sorted((name for name in stages if name != self.STEP_TOTAL),
+                         key=lambda name: stages[name]['total_seconds'], reverse=True)
+        if self.STEP_TOTAL in stages:
+            ordered.append(self.STEP_TOTAL)
+        for name in ordered:
+            entry = stages[name]
+            if name == self.STEP_TOTAL:
+                lines.append("-" * 76)
+            lines.append(
+                f"{name:<24} {entry['calls']:>7} {entry['total_seconds'] * 1e3:>12.2f} "
+                f"{entry['mean_seconds'] * 1e6:>11.1f} {entry['max_seconds'] * 1e6:>10.1f} "
+                f"{entry['share_of_step'] * 100:>6.1f}%"
+            )
+        return "\n".join(lines)
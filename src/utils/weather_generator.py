@@ -5,10 +5,11 @@ Generates realistic weather data for testing and simulation
 
 import numpy as np
 from datetime import datetime, timedelta
-from typing import List
+from typing import List, Optional, Union
 import math
 
 from ..data.hydroponic_system import WeatherData
+from ..data.weather_series import WeatherSeries, WeatherBlock
 
 
 class WeatherGenerator:
@@ -89,6 +90,53 @@ class WeatherGenerator:
             ))
             
         return weather_data
+
+    def generate_weather_arrays(self, start_date: datetime, days: int,
+                                rng: Union[None, int, np.random.Generator] = None,
+                                n_scenarios: Optional[int] = None,
+                                location: str = "USGA") -> Union[WeatherSeries, WeatherBlock]:
+        """
+        Generate a whole weather series (or scenario × day block) in one vectorized call.
+        
+        Uses the same seasonal model as generate_weather_series, but draws from
+        an explicit np.random.Generator instead of the global RNG, so a seed
+        reproduces the same series in any process regardless of what else has
+        drawn random numbers.
+        
+        Args:
+            start_date: Starting date for weather series
+            days: Number of days to generate
+            rng: np.random.Generator, integer seed, or None (fresh entropy)
+            n_scenarios: When given, generate a (n_scenarios, days) block
+                from the one stream
+            location: Location identifier
+            
+        Returns:
+            WeatherSeries of column arrays, or a WeatherBlock for n_scenarios
+        """
+        if not isinstance(rng, np.random.Generator):
+            rng = np.random.default_rng(rng)
+        shape = (days,) if n_scenarios is None else (n_scenarios, days)
+
+        # Seasonal factor from each date's day of year (leap years included)
+        dates = np.datetime64(start_date.date(), 'D') + np.arange(days)
+        day_of_year = (dates - dates.astype('datetime64[Y]').astype('datetime64[D]')).astype(int) + 1
+        seasonal_factor = np.sin(2 * np.pi * (day_of_year - 80) / 365)
+
+        temp_avg = self.base_temp + self.temp_variation * seasonal_factor + rng.normal(0.0, 1.0, shape)
+        temp_min = temp_avg - rng.uniform(2.0, 5.0, shape)
+        temp_max = temp_avg + rng.uniform(3.0, 7.0, shape)
+        solar_rad = np.maximum(5.0, self.base_solar + 5 * seasonal_factor + rng.normal(0.0, 2.0, shape))
+        rel_humidity = np.clip(self.base_humidity + rng.normal(0.0, 5.0, shape), 30.0, 95.0)
+        wind_speed = np.maximum(0.5, rng.uniform(1.5, 3.0, shape))
+        rainfall = np.zeros(shape)
+
+        columns = dict(temp_avg=temp_avg, temp_min=temp_min, temp_max=temp_max,
+                       solar_radiation=solar_rad, rel_humidity=rel_humidity,
+                       wind_speed=wind_speed, rainfall=rainfall)
+        if n_scenarios is None:
+            return WeatherSeries(start_date=start_date, location=location, **columns)
+        return WeatherBlock(start_date=start_date, location=location, **columns)
     
     def generate_from_template(self, template_type: str = "spring",
                               start_date: datetime = None, days: int = 30) -> List[WeatherData]: